@@ -0,0 +1,277 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+/** \file
+ \brief Benchmark of the methods of pxcontrastenhanceimage.
+
+ The ITK AdaptiveHistogramEqualizationImageFilter is compared to the
+ SlidingHistogramEqualizationImageFilter on random 3D short images, for
+ several image sizes and window radii. Every method is timed for 1..N
+ threads, its peak memory usage is recorded, and the maximum difference
+ of the sliding method with the ITK result is computed. The results are
+ written as JSON.
+ */
+
+#include "itkCommandLineArgumentParser.h"
+#include "ITKToolsHelpers.h"
+
+#include "itktoolsBenchmarkHelpers.h"
+
+#include "itkImage.h"
+#include "itkRandomImageSource.h"
+#include "itkAdaptiveHistogramEqualizationImageFilter.h"
+#include "itkSlidingHistogramEqualizationImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMultiThreader.h"
+#include "itkTimeProbe.h"
+
+
+/**
+ * ******************* GetHelpString *******************
+ */
+
+std::string GetHelpString( void )
+{
+  std::stringstream ss;
+  ss << "ITKTools v" << itktools::GetITKToolsVersion() << "\n"
+    << "This program benchmarks the methods of pxcontrastenhanceimage.\n"
+    << "Usage:\n"
+    << "ContrastEnhanceBenchmark\n"
+    << "  -out     output JSON file with the results\n"
+    << "  [-sz]    image sizes (voxels per side of a 3D cube), default 32 64\n"
+    << "  [-r]     window radii, default 2 5 10\n"
+    << "  [-m]     methods, default ITK sliding\n"
+    << "  [-alpha] alpha, default 0.3\n"
+    << "  [-beta]  beta, default 0.3\n"
+    << "  [-range] the random intensities are in [0,range), default 1000\n"
+    << "  [-threads] maximum number of threads, default the number of CPUs\n"
+    << "The difference is the maximum absolute difference with the ITK\n"
+    << "method, or -1 if the ITK method is not benchmarked.";
+  return ss.str();
+
+} // end GetHelpString()
+
+
+/**
+ * ******************* Enhance *******************
+ */
+
+template <class TImage>
+typename TImage::Pointer Enhance(
+  const TImage * input,
+  const std::string & method,
+  const unsigned int & radius,
+  const float & alpha,
+  const float & beta )
+{
+  typedef itk::AdaptiveHistogramEqualizationImageFilter<TImage>   EnhancerType;
+  typedef itk::SlidingHistogramEqualizationImageFilter<TImage>    SlidingEnhancerType;
+
+  typename TImage::SizeType radiusSize;
+  radiusSize.Fill( radius );
+
+  typename TImage::Pointer output;
+  if( method == "sliding" )
+  {
+    typename SlidingEnhancerType::Pointer enhancer = SlidingEnhancerType::New();
+    enhancer->SetAlpha( alpha );
+    enhancer->SetBeta( beta );
+    enhancer->SetRadius( radiusSize );
+    enhancer->SetInput( input );
+    enhancer->Update();
+    output = enhancer->GetOutput();
+  }
+  else if( method == "ITK" )
+  {
+    typename EnhancerType::Pointer enhancer = EnhancerType::New();
+    enhancer->SetUseLookupTable( true );
+    enhancer->SetAlpha( alpha );
+    enhancer->SetBeta( beta );
+    enhancer->SetRadius( radiusSize );
+    enhancer->SetInput( input );
+    enhancer->Update();
+    output = enhancer->GetOutput();
+  }
+  else
+  {
+    itkGenericExceptionMacro( << "Unknown method: " << method );
+  }
+
+  output->DisconnectPipeline();
+  return output;
+
+} // end Enhance()
+
+
+/**
+ * ******************* ComputeMaximumDifference *******************
+ */
+
+template <class TImage>
+double ComputeMaximumDifference( const TImage * image, const TImage * reference )
+{
+  itk::ImageRegionConstIterator<TImage> it( image, image->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator<TImage> itRef( reference, reference->GetLargestPossibleRegion() );
+  double maxDifference = 0.0;
+  for( it.GoToBegin(), itRef.GoToBegin(); !it.IsAtEnd(); ++it, ++itRef )
+  {
+    const double difference = static_cast<double>( it.Get() ) - itRef.Get();
+    maxDifference = vnl_math_max( maxDifference, vcl_abs( difference ) );
+  }
+  return maxDifference;
+
+} // end ComputeMaximumDifference()
+
+
+//-------------------------------------------------------------------------------------
+
+int main( int argc, char **argv )
+{
+  /** Create a command line argument parser. */
+  itk::CommandLineArgumentParser::Pointer parser = itk::CommandLineArgumentParser::New();
+  parser->SetCommandLineArguments( argc, argv );
+  parser->SetProgramHelpText( GetHelpString() );
+
+  parser->MarkArgumentAsRequired( "-out", "The output JSON filename." );
+
+  itk::CommandLineArgumentParser::ReturnValue validateArguments = parser->CheckForRequiredArguments();
+
+  if( validateArguments == itk::CommandLineArgumentParser::FAILED )
+  {
+    return EXIT_FAILURE;
+  }
+  else if( validateArguments == itk::CommandLineArgumentParser::HELPREQUESTED )
+  {
+    return EXIT_SUCCESS;
+  }
+
+  /** Get arguments. */
+  std::string outputFileName = "";
+  parser->GetCommandLineArgument( "-out", outputFileName );
+
+  std::vector<unsigned int> sizes;
+  sizes.push_back( 32 ); sizes.push_back( 64 );
+  parser->GetCommandLineArgument( "-sz", sizes );
+
+  std::vector<unsigned int> radii;
+  radii.push_back( 2 ); radii.push_back( 5 ); radii.push_back( 10 );
+  parser->GetCommandLineArgument( "-r", radii );
+
+  /** ITK first, so that it serves as the reference. */
+  std::vector<std::string> methods;
+  methods.push_back( "ITK" ); methods.push_back( "sliding" );
+  parser->GetCommandLineArgument( "-m", methods );
+
+  float alpha = 0.3f;
+  parser->GetCommandLineArgument( "-alpha", alpha );
+
+  float beta = 0.3f;
+  parser->GetCommandLineArgument( "-beta", beta );
+
+  double range = 1000.0;
+  parser->GetCommandLineArgument( "-range", range );
+
+  unsigned int maximumNumberOfThreads
+    = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  parser->GetCommandLineArgument( "-threads", maximumNumberOfThreads );
+
+  /** Typedefs. */
+  const unsigned int Dimension = 3;
+  typedef itk::Image< short, Dimension >            ImageType;
+  typedef itk::RandomImageSource< ImageType >       RandomSourceType;
+
+  const std::vector<unsigned int> threadCounts
+    = itktools::benchmark::GetThreadCounts( maximumNumberOfThreads );
+
+  std::vector<itktools::benchmark::JSONRecord> records;
+
+  try
+  {
+    for( std::size_t sz = 0; sz < sizes.size(); ++sz )
+    {
+      /** Create the random input. */
+      ImageType::SizeType size;
+      size.Fill( sizes[ sz ] );
+      RandomSourceType::Pointer source = RandomSourceType::New();
+      source->SetSize( size );
+      source->SetMin( 0 );
+      source->SetMax( static_cast<short>( range - 1.0 ) );
+      source->Update();
+      ImageType::Pointer input = source->GetOutput();
+      input->DisconnectPipeline();
+
+      for( std::size_t r = 0; r < radii.size(); ++r )
+      {
+        ImageType::Pointer reference = 0;
+        for( std::size_t m = 0; m < methods.size(); ++m )
+        {
+          for( std::size_t t = 0; t < threadCounts.size(); ++t )
+          {
+            /** Filters take the default number of threads at construction. */
+            itk::MultiThreader::SetGlobalDefaultNumberOfThreads( threadCounts[ t ] );
+            itktools::benchmark::ResetPeakMemoryUsage();
+
+            itk::TimeProbe timer;
+            timer.Start();
+            ImageType::Pointer output = Enhance<ImageType>(
+              input, methods[ m ], radii[ r ], alpha, beta );
+            timer.Stop();
+
+            double maxDifference = -1.0;
+            if( methods[ m ] == "ITK" )
+            {
+              reference = output;
+            }
+            else if( reference.IsNotNull() )
+            {
+              maxDifference = ComputeMaximumDifference<ImageType>( output, reference );
+            }
+
+            itktools::benchmark::JSONRecord record;
+            record.AddNumber( "size", sizes[ sz ] );
+            record.AddNumber( "radius", radii[ r ] );
+            record.Add( "method", methods[ m ] );
+            record.AddNumber( "threads", threadCounts[ t ] );
+            record.AddNumber( "wallTime", timer.GetMean() );
+            record.AddNumber( "peakMemory", itktools::benchmark::GetPeakMemoryUsage() );
+            record.AddNumber( "maximumDifference", maxDifference );
+            records.push_back( record );
+
+            std::cout << record.ToString() << std::endl;
+          }
+        }
+      }
+    }
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    std::cerr << "ERROR: Caught ITK exception: " << excp << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** Write the results. */
+  if( !itktools::benchmark::WriteJSONRecords( outputFileName,
+    "ContrastEnhanceBenchmark", records ) )
+  {
+    std::cerr << "ERROR: could not write \"" << outputFileName << "\"." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** End program. */
+  return EXIT_SUCCESS;
+
+} // end main
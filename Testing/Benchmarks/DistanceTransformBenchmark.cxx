@@ -0,0 +1,397 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+/** \file
+ \brief Benchmark of the methods of pxdistancetransform.
+
+ Synthetic inputs are created with the pxcreatesphere, pxcreatebox and
+ pxcreaterandomimage code, for several image sizes and spacings. Every
+ distance transform method is timed for 1..N threads, its peak memory
+ usage is recorded (where the peak can be reset per run, see
+ ResetPeakMemoryUsage()), and its maximum error with respect to the exact
+ (Maurer) distance is computed. The results are written as JSON.
+ */
+
+#include "itkCommandLineArgumentParser.h"
+#include "ITKToolsHelpers.h"
+#include "CommandLineArgumentHelper.h"
+
+#include "createsphere.h"
+#include "createbox.h"
+#include "createrandomimage.h"
+#include "distancetransform.h"
+#include "itktoolsBenchmarkHelpers.h"
+
+#include "itkBinaryThresholdImageFilter.h"
+#include "itkMultiThreader.h"
+#include "itkTimeProbe.h"
+
+#include <algorithm>
+#include <cstdio>
+
+
+/**
+ * ******************* GetHelpString *******************
+ */
+
+std::string GetHelpString( void )
+{
+  std::stringstream ss;
+  ss << "ITKTools v" << itktools::GetITKToolsVersion() << "\n"
+    << "This program benchmarks the methods of pxdistancetransform.\n"
+    << "Usage:\n"
+    << "DistanceTransformBenchmark\n"
+    << "  -out     output JSON file with the results\n"
+    << "  [-sz]    image sizes (voxels per side of a 3D cube), default 64 128\n"
+    << "  [-sp]    slice spacings, for anisotropy; in-plane spacing is 1, default 1 3\n"
+    << "  [-shape] synthetic inputs, choose from {sphere, box, random}, default all\n"
+    << "  [-m]     methods, default Maurer Danielsson Morphological MorphologicalSigned\n"
+    << "  [-maxdist] also benchmark the bounded-distance mode with this maximum\n"
+    << "  [-threads] maximum number of threads, default the number of CPUs\n"
+    << "  [-tmp]   directory for the synthetic inputs, default the current directory\n"
+    << "The error is the maximum absolute difference with the Maurer method\n"
+    << "at the maximum number of threads, computed where |distance| < maxdist\n"
+    << "for the bounded-distance runs. For the unsigned Morphological method\n"
+    << "the distances inside the object are taken as zero.\n"
+    << "The peak memory is per run where it can be reset (Linux), and is\n"
+    << "reported as processPeakMemory otherwise.";
+  return ss.str();
+
+} // end GetHelpString()
+
+
+/**
+ * ******************* CreateSyntheticInput *******************
+ *
+ * Write a synthetic binary 3D image using the ITKTools creation code.
+ */
+
+void CreateSyntheticInput(
+  const std::string & shape,
+  const unsigned int & size,
+  const double & sliceSpacing,
+  const std::string & fileName )
+{
+  const unsigned int Dimension = 3;
+  std::vector<unsigned int> sizes( Dimension, size );
+  std::vector<double> spacing( Dimension, 1.0 );
+  spacing[ Dimension - 1 ] = sliceSpacing;
+
+  std::vector<double> center( Dimension ), radius( Dimension );
+  for( unsigned int i = 0; i < Dimension; ++i )
+  {
+    center[ i ] = 0.5 * size * spacing[ i ];
+    radius[ i ] = 0.25 * size * spacing[ i ];
+  }
+
+  if( shape == "sphere" )
+  {
+    ITKToolsCreateSphere<Dimension, unsigned char> sphere;
+    sphere.m_OutputFileName = fileName;
+    sphere.m_Size = sizes;
+    sphere.m_Spacing = spacing;
+    sphere.m_Center = center;
+    sphere.m_Radius = radius[ 0 ];
+    sphere.Run();
+  }
+  else if( shape == "box" )
+  {
+    std::vector<double> origin( Dimension, 0.0 );
+    std::vector<double> direction( Dimension * Dimension, 0.0 );
+    for( unsigned int i = 0; i < Dimension; ++i )
+    {
+      direction[ i * ( Dimension + 1 ) ] = 1.0;
+    }
+
+    ITKToolsCreateBox<Dimension, unsigned char> box;
+    itktools::FillImageIOBase( box.m_ReferenceImageIOBase,
+      "scalar", "unsigned_char", Dimension, 1,
+      sizes, spacing, origin, direction );
+    box.m_OutputFileName = fileName;
+    box.m_Input1 = center;
+    box.m_Input2 = radius;
+    box.m_OrientationOfBox = std::vector<double>( Dimension, 0.0 );
+    box.m_BoxDefinition = "CenterRadius";
+    box.Run();
+  }
+  else if( shape == "random" )
+  {
+    /** Uniform noise in [0,1] in every voxel, blurred with a sigma of 2
+     * voxels, gives many blobs when thresholded at its median after reading.
+     */
+    ITKToolsCreateRandomImage<Dimension, float> random;
+    random.m_OutputFileName = fileName;
+    random.m_Sizes.SetSize( Dimension );
+    random.m_Sizes.Fill( size );
+    random.m_Min_value = 0.0;
+    random.m_Max_value = 1.0;
+    random.m_Resolution = 0;
+    random.m_Sigma = 2.0;
+    random.m_Rand_seed = 1;
+    random.m_SpaceDimension = 1;
+    random.Run();
+  }
+
+} // end CreateSyntheticInput()
+
+
+/**
+ * ******************* ReadSyntheticInput *******************
+ *
+ * Read a synthetic input as a binary image. The sphere and box are
+ * thresholded at 0.5, the random image at its median, so that about half
+ * of it is object; its object fraction is checked.
+ */
+
+template <class TImage>
+typename TImage::Pointer ReadSyntheticInput(
+  const std::string & fileName,
+  const double & sliceSpacing,
+  const bool thresholdAtMedian )
+{
+  typedef itk::Image<float, TImage::ImageDimension>     FloatImageType;
+  typedef itk::ImageFileReader< FloatImageType >        ReaderType;
+  typedef itk::BinaryThresholdImageFilter<
+    FloatImageType, TImage >                            ThresholdType;
+
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( fileName.c_str() );
+  reader->Update();
+
+  float lowerThreshold = 0.5f;
+  const FloatImageType * floatImage = reader->GetOutput();
+  const std::size_t numberOfPixels
+    = floatImage->GetLargestPossibleRegion().GetNumberOfPixels();
+  if( thresholdAtMedian && numberOfPixels > 0 )
+  {
+    std::vector<float> values( floatImage->GetBufferPointer(),
+      floatImage->GetBufferPointer() + numberOfPixels );
+    std::nth_element( values.begin(), values.begin() + numberOfPixels / 2, values.end() );
+    lowerThreshold = values[ numberOfPixels / 2 ];
+  }
+
+  typename ThresholdType::Pointer threshold = ThresholdType::New();
+  threshold->SetInput( reader->GetOutput() );
+  threshold->SetLowerThreshold( lowerThreshold );
+  threshold->SetInsideValue( 1 );
+  threshold->SetOutsideValue( 0 );
+  threshold->Update();
+
+  if( thresholdAtMedian )
+  {
+    const typename TImage::PixelType * mask = threshold->GetOutput()->GetBufferPointer();
+    const std::size_t numberOfObjectPixels
+      = std::count( mask, mask + numberOfPixels, 1 );
+    const double fraction = numberOfPixels > 0
+      ? static_cast<double>( numberOfObjectPixels ) / numberOfPixels : 0.0;
+    if( fraction < 0.4 || fraction > 0.6 )
+    {
+      itkGenericExceptionMacro( << "The object fraction of " << fileName
+        << " is " << fraction << ", instead of about one half." );
+    }
+  }
+
+  /** The random image is created with unit spacing. */
+  typename TImage::Pointer image = threshold->GetOutput();
+  typename TImage::SpacingType spacing = image->GetSpacing();
+  spacing[ TImage::ImageDimension - 1 ] = sliceSpacing;
+  image->SetSpacing( spacing );
+  image->DisconnectPipeline();
+
+  return image;
+
+} // end ReadSyntheticInput()
+
+
+/**
+ * ******************* ComputeMaximumError *******************
+ */
+
+template <class TImage>
+double ComputeMaximumError(
+  const TImage * image, const TImage * reference,
+  const double & maximumDistance, const bool outsideOnly )
+{
+  itk::ImageRegionConstIterator<TImage> it( image, image->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator<TImage> itRef( reference, reference->GetLargestPossibleRegion() );
+  double maxError = 0.0;
+  for( it.GoToBegin(), itRef.GoToBegin(); !it.IsAtEnd(); ++it, ++itRef )
+  {
+    /** An unsigned method gives zero inside the object. */
+    double ref = itRef.Get();
+    if( outsideOnly ) ref = vnl_math_max( ref, 0.0 );
+    if( maximumDistance > 0.0 && vcl_abs( ref ) >= maximumDistance ) continue;
+    maxError = vnl_math_max( maxError, vcl_abs( it.Get() - ref ) );
+  }
+  return maxError;
+
+} // end ComputeMaximumError()
+
+
+//-------------------------------------------------------------------------------------
+
+int main( int argc, char **argv )
+{
+  /** Create a command line argument parser. */
+  itk::CommandLineArgumentParser::Pointer parser = itk::CommandLineArgumentParser::New();
+  parser->SetCommandLineArguments( argc, argv );
+  parser->SetProgramHelpText( GetHelpString() );
+
+  parser->MarkArgumentAsRequired( "-out", "The output JSON filename." );
+
+  itk::CommandLineArgumentParser::ReturnValue validateArguments = parser->CheckForRequiredArguments();
+
+  if( validateArguments == itk::CommandLineArgumentParser::FAILED )
+  {
+    return EXIT_FAILURE;
+  }
+  else if( validateArguments == itk::CommandLineArgumentParser::HELPREQUESTED )
+  {
+    return EXIT_SUCCESS;
+  }
+
+  /** Get arguments. */
+  std::string outputFileName = "";
+  parser->GetCommandLineArgument( "-out", outputFileName );
+
+  std::vector<unsigned int> sizes;
+  sizes.push_back( 64 ); sizes.push_back( 128 );
+  parser->GetCommandLineArgument( "-sz", sizes );
+
+  std::vector<double> sliceSpacings;
+  sliceSpacings.push_back( 1.0 ); sliceSpacings.push_back( 3.0 );
+  parser->GetCommandLineArgument( "-sp", sliceSpacings );
+
+  std::vector<std::string> shapes;
+  shapes.push_back( "sphere" ); shapes.push_back( "box" ); shapes.push_back( "random" );
+  parser->GetCommandLineArgument( "-shape", shapes );
+
+  std::vector<std::string> methods;
+  methods.push_back( "Maurer" ); methods.push_back( "Danielsson" );
+  methods.push_back( "Morphological" ); methods.push_back( "MorphologicalSigned" );
+  parser->GetCommandLineArgument( "-m", methods );
+
+  double maximumDistance = 0.0;
+  parser->GetCommandLineArgument( "-maxdist", maximumDistance );
+
+  unsigned int maximumNumberOfThreads
+    = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  parser->GetCommandLineArgument( "-threads", maximumNumberOfThreads );
+
+  std::string tmpDirectory = ".";
+  parser->GetCommandLineArgument( "-tmp", tmpDirectory );
+
+  /** Typedefs. */
+  const unsigned int Dimension = 3;
+  typedef itk::Image< unsigned char, Dimension >    InputImageType;
+  typedef itk::Image< float, Dimension >            OutputImageType;
+
+  const std::vector<unsigned int> threadCounts
+    = itktools::benchmark::GetThreadCounts( maximumNumberOfThreads );
+  std::vector<double> maximumDistances( 1, 0.0 );
+  if( maximumDistance > 0.0 ) maximumDistances.push_back( maximumDistance );
+
+  std::vector<itktools::benchmark::JSONRecord> records;
+
+  try
+  {
+    for( std::size_t sh = 0; sh < shapes.size(); ++sh )
+    {
+      for( std::size_t sz = 0; sz < sizes.size(); ++sz )
+      {
+        for( std::size_t sp = 0; sp < sliceSpacings.size(); ++sp )
+        {
+          /** Create the synthetic input. */
+          std::ostringstream name;
+          name << tmpDirectory << "/dtbenchmark_" << shapes[ sh ]
+            << "_" << sizes[ sz ] << "_" << sliceSpacings[ sp ] << ".mha";
+          CreateSyntheticInput( shapes[ sh ], sizes[ sz ], sliceSpacings[ sp ], name.str() );
+          InputImageType::Pointer input
+            = ReadSyntheticInput<InputImageType>( name.str(), sliceSpacings[ sp ],
+            shapes[ sh ] == "random" );
+          std::remove( name.str().c_str() );
+
+          /** The exact distance, as reference. */
+          itk::MultiThreader::SetGlobalDefaultNumberOfThreads( maximumNumberOfThreads );
+          OutputImageType::Pointer reference
+            = ComputeDistanceMap<InputImageType, OutputImageType>(
+            input, false, "Maurer", 0.0 );
+
+          for( std::size_t m = 0; m < methods.size(); ++m )
+          {
+            for( std::size_t d = 0; d < maximumDistances.size(); ++d )
+            {
+              for( std::size_t t = 0; t < threadCounts.size(); ++t )
+              {
+                /** Filters take the default number of threads at construction. */
+                itk::MultiThreader::SetGlobalDefaultNumberOfThreads( threadCounts[ t ] );
+                const bool peakReset = itktools::benchmark::ResetPeakMemoryUsage();
+
+                itk::TimeProbe timer;
+                timer.Start();
+                OutputImageType::Pointer distance
+                  = ComputeDistanceMap<InputImageType, OutputImageType>(
+                  input, false, methods[ m ], maximumDistances[ d ] );
+                timer.Stop();
+
+                /** The unsigned morphological method only gives outside
+                 * distances, so it is compared to those.
+                 */
+                const double maxError = ComputeMaximumError<OutputImageType>(
+                  distance, reference, maximumDistances[ d ],
+                  methods[ m ] == "Morphological" );
+
+                itktools::benchmark::JSONRecord record;
+                record.Add( "shape", shapes[ sh ] );
+                record.AddNumber( "size", sizes[ sz ] );
+                record.AddNumber( "sliceSpacing", sliceSpacings[ sp ] );
+                record.Add( "method", methods[ m ] );
+                record.AddNumber( "maximumDistance", maximumDistances[ d ] );
+                record.AddNumber( "threads", threadCounts[ t ] );
+                record.AddNumber( "wallTime", timer.GetMean() );
+                /** Without a reset the peak is that of the whole process so far. */
+                record.AddNumber( peakReset ? "peakMemory" : "processPeakMemory",
+                  itktools::benchmark::GetPeakMemoryUsage() );
+                record.AddNumber( "maximumError", maxError );
+                records.push_back( record );
+
+                std::cout << record.ToString() << std::endl;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    std::cerr << "ERROR: Caught ITK exception: " << excp << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** Write the results. */
+  if( !itktools::benchmark::WriteJSONRecords( outputFileName,
+    "DistanceTransformBenchmark", records ) )
+  {
+    std::cerr << "ERROR: could not write \"" << outputFileName << "\"." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** End program. */
+  return EXIT_SUCCESS;
+
+} // end main
@@ -0,0 +1,420 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+/** \file
+ \brief Benchmark of a representative set of ITKTools executables.
+
+ Large synthetic inputs are created with the pxcreatesphere and
+ pxcreaterandomimage code. The px executables are run on them as child
+ processes, for 1..N threads, and their wall time, CPU time and peak memory
+ usage are recorded. The results are written as JSON, and optionally
+ compared with the results of a previous run: a run that is slower, or
+ uses more memory, by more than the tolerance is a failure.
+ */
+
+#include "itkCommandLineArgumentParser.h"
+#include "ITKToolsHelpers.h"
+
+#include "createsphere.h"
+#include "createrandomimage.h"
+#include "itktoolsBenchmarkHelpers.h"
+
+#include "itkMultiThreader.h"
+
+#include <algorithm>
+#include <cstdio>
+
+
+/**
+ * ******************* GetHelpString *******************
+ */
+
+std::string GetHelpString( void )
+{
+  std::stringstream ss;
+  ss << "ITKTools v" << itktools::GetITKToolsVersion() << "\n"
+    << "This program benchmarks a set of ITKTools executables.\n"
+    << "Usage:\n"
+    << "ToolsBenchmark\n"
+    << "  -exe     directory of the px executables\n"
+    << "  -out     output JSON file with the results\n"
+    << "  [-sz]    image sizes (voxels per side of a 3D cube), default 256\n"
+    << "  [-tools] tools, default statisticsonimage texture morphology\n"
+    << "           distancetransform combinesegmentations resizeimage castconvert\n"
+    << "  [-threads] maximum number of threads, default the number of CPUs\n"
+    << "  [-repeat] number of runs of which the fastest is kept, default 1\n"
+    << "  [-tmp]   directory for the synthetic inputs and outputs, default the current directory\n"
+    << "  [-baseline] JSON file of a previous run to compare with\n"
+    << "  [-tolerance] allowed increase of the wall time and peak memory\n"
+    << "           with respect to the baseline, in percent, default 20\n"
+    << "The program fails if a tool fails, or if a run regresses with respect\n"
+    << "to the run with the same tool, size and threads in the baseline.";
+  return ss.str();
+
+} // end GetHelpString()
+
+
+/**
+ * ******************* CreateSyntheticInputs *******************
+ *
+ * Write a smoothed random float image, and three binary spheres of which the
+ * centres are shifted, as segmentations by three observers.
+ */
+
+void CreateSyntheticInputs(
+  const unsigned int & size,
+  const std::string & randomFileName,
+  const std::vector<std::string> & sphereFileNames )
+{
+  const unsigned int Dimension = 3;
+
+  ITKToolsCreateRandomImage<Dimension, float> random;
+  random.m_OutputFileName = randomFileName;
+  random.m_Sizes.SetSize( Dimension );
+  random.m_Sizes.Fill( size );
+  random.m_Min_value = 0.0;
+  random.m_Max_value = 1000.0;
+  random.m_Resolution = 0;
+  random.m_Sigma = 2.0;
+  random.m_Rand_seed = 1;
+  random.m_SpaceDimension = 1;
+  random.Run();
+
+  for( std::size_t i = 0; i < sphereFileNames.size(); ++i )
+  {
+    ITKToolsCreateSphere<Dimension, unsigned char> sphere;
+    sphere.m_OutputFileName = sphereFileNames[ i ];
+    sphere.m_Size = std::vector<unsigned int>( Dimension, size );
+    sphere.m_Spacing = std::vector<double>( Dimension, 1.0 );
+    sphere.m_Center = std::vector<double>( Dimension, 0.5 * size );
+    sphere.m_Center[ 0 ] += 0.02 * size * i;
+    sphere.m_Radius = 0.25 * size;
+    sphere.Run();
+  }
+
+} // end CreateSyntheticInputs()
+
+
+/**
+ * ******************* GetToolCommand *******************
+ *
+ * The command line of a benchmarked tool, or an empty list for an unknown
+ * tool.
+ */
+
+std::vector<std::string> GetToolCommand(
+  const std::string & tool,
+  const std::string & exeDirectory,
+  const std::string & tmpDirectory,
+  const std::string & randomFileName,
+  const std::vector<std::string> & sphereFileNames )
+{
+  std::vector<std::string> command;
+  command.push_back( exeDirectory + "/px" + tool );
+  const std::string output = tmpDirectory + "/toolsbenchmark_output.mha";
+
+  if( tool == "statisticsonimage" )
+  {
+    command.push_back( "-in" ); command.push_back( randomFileName );
+  }
+  else if( tool == "texture" )
+  {
+    command.push_back( "-in" ); command.push_back( randomFileName );
+    command.push_back( "-out" ); command.push_back( tmpDirectory );
+    command.push_back( "-r" ); command.push_back( "1" );
+    command.push_back( "-b" ); command.push_back( "32" );
+    command.push_back( "-noo" ); command.push_back( "1" );
+  }
+  else if( tool == "morphology" )
+  {
+    command.push_back( "-in" ); command.push_back( sphereFileNames[ 0 ] );
+    command.push_back( "-op" ); command.push_back( "dilation" );
+    command.push_back( "-type" ); command.push_back( "binary" );
+    command.push_back( "-r" ); command.push_back( "2" );
+    command.push_back( "-out" ); command.push_back( output );
+  }
+  else if( tool == "distancetransform" )
+  {
+    command.push_back( "-in" ); command.push_back( sphereFileNames[ 0 ] );
+    command.push_back( "-out" ); command.push_back( output );
+  }
+  else if( tool == "combinesegmentations" )
+  {
+    command.push_back( "-m" ); command.push_back( "STAPLE" );
+    command.push_back( "-in" );
+    command.insert( command.end(), sphereFileNames.begin(), sphereFileNames.end() );
+    command.push_back( "-outh" ); command.push_back( output );
+  }
+  else if( tool == "resizeimage" )
+  {
+    command.push_back( "-in" ); command.push_back( randomFileName );
+    command.push_back( "-f" ); command.push_back( "0.5" );
+    command.push_back( "-out" ); command.push_back( output );
+  }
+  else if( tool == "castconvert" )
+  {
+    command.push_back( "-in" ); command.push_back( randomFileName );
+    command.push_back( "-opct" ); command.push_back( "short" );
+    command.push_back( "-out" ); command.push_back( output );
+  }
+  else
+  {
+    command.clear();
+  }
+
+  return command;
+
+} // end GetToolCommand()
+
+
+/**
+ * ******************* RemoveFiles *******************
+ */
+
+void RemoveFiles( const std::vector<std::string> & fileNames )
+{
+  for( std::size_t i = 0; i < fileNames.size(); ++i )
+  {
+    std::remove( fileNames[ i ].c_str() );
+  }
+
+} // end RemoveFiles()
+
+
+/**
+ * ******************* GetRecordKey *******************
+ */
+
+std::string GetRecordKey( const std::string & tool,
+  const std::string & size, const std::string & threads )
+{
+  return tool + " size " + size + " threads " + threads;
+
+} // end GetRecordKey()
+
+
+//-------------------------------------------------------------------------------------
+
+int main( int argc, char **argv )
+{
+  /** Create a command line argument parser. */
+  itk::CommandLineArgumentParser::Pointer parser = itk::CommandLineArgumentParser::New();
+  parser->SetCommandLineArguments( argc, argv );
+  parser->SetProgramHelpText( GetHelpString() );
+
+  parser->MarkArgumentAsRequired( "-exe", "The directory of the executables." );
+  parser->MarkArgumentAsRequired( "-out", "The output JSON filename." );
+
+  itk::CommandLineArgumentParser::ReturnValue validateArguments = parser->CheckForRequiredArguments();
+
+  if( validateArguments == itk::CommandLineArgumentParser::FAILED )
+  {
+    return EXIT_FAILURE;
+  }
+  else if( validateArguments == itk::CommandLineArgumentParser::HELPREQUESTED )
+  {
+    return EXIT_SUCCESS;
+  }
+
+  /** Get arguments. */
+  std::string exeDirectory = "";
+  parser->GetCommandLineArgument( "-exe", exeDirectory );
+
+  std::string outputFileName = "";
+  parser->GetCommandLineArgument( "-out", outputFileName );
+
+  std::vector<unsigned int> sizes( 1, 256 );
+  parser->GetCommandLineArgument( "-sz", sizes );
+
+  std::vector<std::string> tools;
+  tools.push_back( "statisticsonimage" ); tools.push_back( "texture" );
+  tools.push_back( "morphology" ); tools.push_back( "distancetransform" );
+  tools.push_back( "combinesegmentations" ); tools.push_back( "resizeimage" );
+  tools.push_back( "castconvert" );
+  parser->GetCommandLineArgument( "-tools", tools );
+
+  unsigned int maximumNumberOfThreads
+    = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  parser->GetCommandLineArgument( "-threads", maximumNumberOfThreads );
+
+  unsigned int numberOfRepeats = 1;
+  parser->GetCommandLineArgument( "-repeat", numberOfRepeats );
+  numberOfRepeats = std::max( numberOfRepeats, 1u );
+
+  std::string tmpDirectory = ".";
+  parser->GetCommandLineArgument( "-tmp", tmpDirectory );
+
+  std::string baselineFileName = "";
+  parser->GetCommandLineArgument( "-baseline", baselineFileName );
+
+  double tolerance = 20.0;
+  parser->GetCommandLineArgument( "-tolerance", tolerance );
+
+  /** Read the baseline, keyed by tool, size and threads. */
+  typedef std::map<std::string, std::string>    RecordMapType;
+  std::map<std::string, RecordMapType> baseline;
+  if( !baselineFileName.empty() )
+  {
+    std::vector<RecordMapType> baselineRecords;
+    if( !itktools::benchmark::ReadJSONRecords( baselineFileName, baselineRecords ) )
+    {
+      std::cerr << "ERROR: could not read \"" << baselineFileName << "\"." << std::endl;
+      return EXIT_FAILURE;
+    }
+    for( std::size_t i = 0; i < baselineRecords.size(); ++i )
+    {
+      RecordMapType & record = baselineRecords[ i ];
+      baseline[ GetRecordKey( record[ "tool" ], record[ "size" ], record[ "threads" ] ) ] = record;
+    }
+  }
+
+  /** Check the tools before creating any input. */
+  for( std::size_t tl = 0; tl < tools.size(); ++tl )
+  {
+    if( GetToolCommand( tools[ tl ], "", "", "", std::vector<std::string>( 3 ) ).empty() )
+    {
+      std::cerr << "ERROR: unknown tool \"" << tools[ tl ] << "\"." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  const std::vector<unsigned int> threadCounts
+    = itktools::benchmark::GetThreadCounts( maximumNumberOfThreads );
+
+  std::vector<itktools::benchmark::JSONRecord> records;
+  bool success = true;
+
+  /** The synthetic inputs and the tool output of the current size, which
+   * are removed before every exit. */
+  std::vector<std::string> temporaryFileNames;
+
+  try
+  {
+    for( std::size_t sz = 0; sz < sizes.size(); ++sz )
+    {
+      /** Create the synthetic inputs. */
+      std::ostringstream prefix;
+      prefix << tmpDirectory << "/toolsbenchmark_" << sizes[ sz ];
+      const std::string randomFileName = prefix.str() + "_random.mha";
+      std::vector<std::string> sphereFileNames;
+      for( unsigned int i = 0; i < 3; ++i )
+      {
+        std::ostringstream name;
+        name << prefix.str() << "_sphere" << i << ".mha";
+        sphereFileNames.push_back( name.str() );
+      }
+      temporaryFileNames = sphereFileNames;
+      temporaryFileNames.push_back( randomFileName );
+      temporaryFileNames.push_back( tmpDirectory + "/toolsbenchmark_output.mha" );
+      CreateSyntheticInputs( sizes[ sz ], randomFileName, sphereFileNames );
+
+      for( std::size_t tl = 0; tl < tools.size(); ++tl )
+      {
+        const std::vector<std::string> command = GetToolCommand( tools[ tl ],
+          exeDirectory, tmpDirectory, randomFileName, sphereFileNames );
+
+        for( std::size_t t = 0; t < threadCounts.size(); ++t )
+        {
+          /** Keep the fastest run. */
+          itktools::benchmark::ProcessUsage usage;
+          for( unsigned int r = 0; r < numberOfRepeats; ++r )
+          {
+            itktools::benchmark::ProcessUsage run;
+            if( !itktools::benchmark::RunProcess( command, threadCounts[ t ], run ) )
+            {
+              std::cerr << "ERROR: could not run \"" << command[ 0 ] << "\"." << std::endl;
+              RemoveFiles( temporaryFileNames );
+              return EXIT_FAILURE;
+            }
+            if( r == 0 || run.m_WallTime < usage.m_WallTime ) usage = run;
+          }
+
+          itktools::benchmark::JSONRecord record;
+          record.Add( "tool", tools[ tl ] );
+          record.AddNumber( "size", sizes[ sz ] );
+          record.AddNumber( "threads", threadCounts[ t ] );
+          record.AddNumber( "exitCode", usage.m_ExitCode );
+          record.AddNumber( "wallTime", usage.m_WallTime );
+          record.AddNumber( "cpuTime", usage.m_CPUTime );
+          record.AddNumber( "peakMemory", usage.m_PeakMemory );
+          records.push_back( record );
+
+          std::cout << record.ToString() << std::endl;
+
+          if( usage.m_ExitCode != 0 )
+          {
+            std::cerr << "ERROR: " << tools[ tl ] << " failed with exit code "
+              << usage.m_ExitCode << "." << std::endl;
+            success = false;
+            continue;
+          }
+
+          /** Compare with the baseline. */
+          std::ostringstream sizeString, threadsString;
+          sizeString << sizes[ sz ];
+          threadsString << threadCounts[ t ];
+          std::map<std::string, RecordMapType>::iterator it = baseline.find(
+            GetRecordKey( tools[ tl ], sizeString.str(), threadsString.str() ) );
+          if( it == baseline.end() ) continue;
+
+          const double factor = 1.0 + tolerance / 100.0;
+          const double baselineWallTime = std::atof( it->second[ "wallTime" ].c_str() );
+          const double baselinePeakMemory = std::atof( it->second[ "peakMemory" ].c_str() );
+          if( baselineWallTime > 0.0 && usage.m_WallTime > factor * baselineWallTime )
+          {
+            std::cerr << "REGRESSION: " << it->first << ": wall time "
+              << usage.m_WallTime << " s, baseline " << baselineWallTime << " s." << std::endl;
+            success = false;
+          }
+          if( baselinePeakMemory > 0.0 && usage.m_PeakMemory > factor * baselinePeakMemory )
+          {
+            std::cerr << "REGRESSION: " << it->first << ": peak memory "
+              << usage.m_PeakMemory << " B, baseline " << baselinePeakMemory << " B." << std::endl;
+            success = false;
+          }
+        }
+      }
+
+      RemoveFiles( temporaryFileNames );
+      temporaryFileNames.clear();
+    }
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    std::cerr << "ERROR: Caught ITK exception: " << excp << std::endl;
+    RemoveFiles( temporaryFileNames );
+    return EXIT_FAILURE;
+  }
+  catch( std::exception & excp )
+  {
+    std::cerr << "ERROR: Caught std::exception: " << excp.what() << std::endl;
+    RemoveFiles( temporaryFileNames );
+    return EXIT_FAILURE;
+  }
+
+  /** Write the results. */
+  if( !itktools::benchmark::WriteJSONRecords( outputFileName,
+    "ToolsBenchmark", records ) )
+  {
+    std::cerr << "ERROR: could not write \"" << outputFileName << "\"." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** End program. */
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+
+} // end main
@@ -0,0 +1,276 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+/** \file
+ \brief Benchmark of the functors of pxunaryimageoperator.
+
+ For a selection of the functors in itkUnaryFunctors.h the
+ itk::UnaryFunctorImageFilter, which pxunaryimageoperator used before, is
+ compared to the ContiguousUnaryFunctorImageFilter, on a random 3D float
+ image. Every filter is timed for 1..N threads, and the maximum difference
+ of the contiguous filter with the ITK filter is computed. The results are
+ written as JSON.
+ */
+
+#include "itkCommandLineArgumentParser.h"
+#include "ITKToolsHelpers.h"
+
+#include "itktoolsBenchmarkHelpers.h"
+
+#include "itkImage.h"
+#include "itkRandomImageSource.h"
+#include "itkUnaryFunctorImageFilter.h"
+#include "itkUnaryFunctors.h"
+#include "itkContiguousUnaryFunctorImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMultiThreader.h"
+#include "itkTimeProbe.h"
+
+
+/**
+ * ******************* GetHelpString *******************
+ */
+
+std::string GetHelpString( void )
+{
+  std::stringstream ss;
+  ss << "ITKTools v" << itktools::GetITKToolsVersion() << "\n"
+    << "This program benchmarks the functors of pxunaryimageoperator.\n"
+    << "Usage:\n"
+    << "UnaryFunctorBenchmark\n"
+    << "  -out     output JSON file with the results\n"
+    << "  [-sz]    image size (voxels per side of a 3D cube), default 128\n"
+    << "  [-arg]   argument of the functors that need one, default 3\n"
+    << "  [-r]     number of repetitions per measurement, default 3\n"
+    << "  [-threads] maximum number of threads, default the number of CPUs\n"
+    << "The random intensities are in [0.5,10). The wall time is the mean over\n"
+    << "the repetitions; the difference is the maximum absolute difference of\n"
+    << "the contiguous filter with the ITK filter.";
+  return ss.str();
+
+} // end GetHelpString()
+
+
+/**
+ * ******************* ComputeMaximumDifference *******************
+ */
+
+template <class TImage>
+double ComputeMaximumDifference( const TImage * image, const TImage * reference )
+{
+  itk::ImageRegionConstIterator<TImage> it( image, image->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator<TImage> itRef( reference, reference->GetLargestPossibleRegion() );
+  double maxDifference = 0.0;
+  for( it.GoToBegin(), itRef.GoToBegin(); !it.IsAtEnd(); ++it, ++itRef )
+  {
+    const double difference = static_cast<double>( it.Get() ) - itRef.Get();
+    maxDifference = vnl_math_max( maxDifference, vcl_abs( difference ) );
+  }
+  return maxDifference;
+
+} // end ComputeMaximumDifference()
+
+
+/**
+ * ******************* BenchmarkFunctor *******************
+ */
+
+template <class TImage, class TFunctor>
+void BenchmarkFunctor(
+  const std::string & name,
+  const TImage * input,
+  const TFunctor & functor,
+  const std::vector<unsigned int> & threadCounts,
+  const unsigned int & repetitions,
+  std::vector<itktools::benchmark::JSONRecord> & records )
+{
+  typedef itk::UnaryFunctorImageFilter<TImage, TImage, TFunctor>           ITKFilterType;
+  typedef itk::ContiguousUnaryFunctorImageFilter<TImage, TImage, TFunctor> ContiguousFilterType;
+
+  for( std::size_t t = 0; t < threadCounts.size(); ++t )
+  {
+    /** Filters take the default number of threads at construction. */
+    itk::MultiThreader::SetGlobalDefaultNumberOfThreads( threadCounts[ t ] );
+
+    typename ITKFilterType::Pointer itkFilter = ITKFilterType::New();
+    itkFilter->GetFunctor() = functor;
+    itkFilter->SetInput( input );
+
+    typename ContiguousFilterType::Pointer contiguousFilter = ContiguousFilterType::New();
+    contiguousFilter->SetFunctor( functor );
+    contiguousFilter->SetInput( input );
+
+    itk::TimeProbe itkTimer;
+    itk::TimeProbe contiguousTimer;
+    for( unsigned int r = 0; r < repetitions; ++r )
+    {
+      itkFilter->Modified();
+      itkTimer.Start();
+      itkFilter->Update();
+      itkTimer.Stop();
+
+      contiguousFilter->Modified();
+      contiguousTimer.Start();
+      contiguousFilter->Update();
+      contiguousTimer.Stop();
+    }
+
+    const double maxDifference = ComputeMaximumDifference<TImage>(
+      contiguousFilter->GetOutput(), itkFilter->GetOutput() );
+
+    const std::string methods[ 2 ] = { "ITK", "contiguous" };
+    const double wallTimes[ 2 ] = { itkTimer.GetMean(), contiguousTimer.GetMean() };
+    for( unsigned int m = 0; m < 2; ++m )
+    {
+      itktools::benchmark::JSONRecord record;
+      record.Add( "functor", name );
+      record.Add( "method", methods[ m ] );
+      record.AddNumber( "threads", threadCounts[ t ] );
+      record.AddNumber( "wallTime", wallTimes[ m ] );
+      record.AddNumber( "speedup", wallTimes[ 0 ] / wallTimes[ m ] );
+      record.AddNumber( "maximumDifference", m == 0 ? 0.0 : maxDifference );
+      records.push_back( record );
+
+      std::cout << record.ToString() << std::endl;
+    }
+  }
+
+} // end BenchmarkFunctor()
+
+
+//-------------------------------------------------------------------------------------
+
+int main( int argc, char **argv )
+{
+  /** Create a command line argument parser. */
+  itk::CommandLineArgumentParser::Pointer parser = itk::CommandLineArgumentParser::New();
+  parser->SetCommandLineArguments( argc, argv );
+  parser->SetProgramHelpText( GetHelpString() );
+
+  parser->MarkArgumentAsRequired( "-out", "The output JSON filename." );
+
+  itk::CommandLineArgumentParser::ReturnValue validateArguments = parser->CheckForRequiredArguments();
+
+  if( validateArguments == itk::CommandLineArgumentParser::FAILED )
+  {
+    return EXIT_FAILURE;
+  }
+  else if( validateArguments == itk::CommandLineArgumentParser::HELPREQUESTED )
+  {
+    return EXIT_SUCCESS;
+  }
+
+  /** Get arguments. */
+  std::string outputFileName = "";
+  parser->GetCommandLineArgument( "-out", outputFileName );
+
+  unsigned int imageSize = 128;
+  parser->GetCommandLineArgument( "-sz", imageSize );
+
+  float argument = 3.0f;
+  parser->GetCommandLineArgument( "-arg", argument );
+
+  unsigned int repetitions = 3;
+  parser->GetCommandLineArgument( "-r", repetitions );
+
+  unsigned int maximumNumberOfThreads
+    = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  parser->GetCommandLineArgument( "-threads", maximumNumberOfThreads );
+
+  /** Typedefs. */
+  const unsigned int Dimension = 3;
+  typedef float                                     PixelType;
+  typedef itk::Image< PixelType, Dimension >        ImageType;
+  typedef itk::RandomImageSource< ImageType >       RandomSourceType;
+
+  const std::vector<unsigned int> threadCounts
+    = itktools::benchmark::GetThreadCounts( maximumNumberOfThreads );
+
+  std::vector<itktools::benchmark::JSONRecord> records;
+
+  try
+  {
+    /** Create the random input; positive, so that all functors are defined. */
+    ImageType::SizeType size;
+    size.Fill( imageSize );
+    RandomSourceType::Pointer source = RandomSourceType::New();
+    source->SetSize( size );
+    source->SetMin( 0.5 );
+    source->SetMax( 10.0 );
+    source->Update();
+    ImageType::Pointer input = source->GetOutput();
+    input->DisconnectPipeline();
+
+    /** Functors with an argument. */
+    itk::Functor::PLUS<PixelType, PixelType, PixelType> plus;
+    plus.SetArgument( argument );
+    BenchmarkFunctor( "PLUS", input.GetPointer(), plus, threadCounts, repetitions, records );
+
+    itk::Functor::TIMES<PixelType, PixelType, PixelType> times;
+    times.SetArgument( argument );
+    BenchmarkFunctor( "TIMES", input.GetPointer(), times, threadCounts, repetitions, records );
+
+    itk::Functor::RMODINT<PixelType, PixelType, PixelType> rmodint;
+    rmodint.SetArgument( argument );
+    BenchmarkFunctor( "RMODINT", input.GetPointer(), rmodint, threadCounts, repetitions, records );
+
+    itk::Functor::NLOG<PixelType, PixelType, PixelType> nlog;
+    nlog.SetArgument( argument );
+    BenchmarkFunctor( "NLOG", input.GetPointer(), nlog, threadCounts, repetitions, records );
+
+    itk::Functor::RPOWER<PixelType, PixelType, PixelType> rpower;
+    rpower.SetArgument( argument );
+    BenchmarkFunctor( "RPOWER", input.GetPointer(), rpower, threadCounts, repetitions, records );
+
+    /** Functors without an argument. */
+    BenchmarkFunctor( "NEG", input.GetPointer(),
+      itk::Functor::NEG<PixelType, PixelType, PixelType>(), threadCounts, repetitions, records );
+    BenchmarkFunctor( "SIGNDOUBLE", input.GetPointer(),
+      itk::Functor::SIGNDOUBLE<PixelType, PixelType, PixelType>(), threadCounts, repetitions, records );
+    BenchmarkFunctor( "ABSINT", input.GetPointer(),
+      itk::Functor::ABSINT<PixelType, PixelType, PixelType>(), threadCounts, repetitions, records );
+    BenchmarkFunctor( "ABSDOUBLE", input.GetPointer(),
+      itk::Functor::ABSDOUBLE<PixelType, PixelType, PixelType>(), threadCounts, repetitions, records );
+    BenchmarkFunctor( "FLOOR", input.GetPointer(),
+      itk::Functor::FLOOR<PixelType, PixelType, PixelType>(), threadCounts, repetitions, records );
+    BenchmarkFunctor( "ROUND", input.GetPointer(),
+      itk::Functor::ROUND<PixelType, PixelType, PixelType>(), threadCounts, repetitions, records );
+    BenchmarkFunctor( "LN", input.GetPointer(),
+      itk::Functor::LN<PixelType, PixelType, PixelType>(), threadCounts, repetitions, records );
+    BenchmarkFunctor( "EXP", input.GetPointer(),
+      itk::Functor::EXP<PixelType, PixelType, PixelType>(), threadCounts, repetitions, records );
+    BenchmarkFunctor( "SIN", input.GetPointer(),
+      itk::Functor::SIN<PixelType, PixelType, PixelType>(), threadCounts, repetitions, records );
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    std::cerr << "ERROR: Caught ITK exception: " << excp << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** Write the results. */
+  if( !itktools::benchmark::WriteJSONRecords( outputFileName,
+    "UnaryFunctorBenchmark", records ) )
+  {
+    std::cerr << "ERROR: could not write \"" << outputFileName << "\"." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** End program. */
+  return EXIT_SUCCESS;
+
+} // end main
@@ -0,0 +1,337 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itktoolsBenchmarkHelpers_h_
+#define __itktoolsBenchmarkHelpers_h_
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "itkRealTimeClock.h"
+
+#if defined( _WIN32 )
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+namespace itktools
+{
+namespace benchmark
+{
+
+/** Reset the peak resident set size of this process, if the OS allows it.
+ * On Linux (>= 4.0) this is done by writing "5" to /proc/self/clear_refs.
+ * Elsewhere the peak is monotone over the lifetime of the process.
+ * Returns whether the peak was reset.
+ */
+inline bool ResetPeakMemoryUsage( void )
+{
+#if defined( __linux__ )
+  std::ofstream clearRefs( "/proc/self/clear_refs" );
+  if( !clearRefs.is_open() ) return false;
+  clearRefs << "5";
+  clearRefs.close();
+  return !clearRefs.fail();
+#else
+  return false;
+#endif
+} // end ResetPeakMemoryUsage()
+
+
+/** Get the peak resident set size of this process in bytes. */
+inline unsigned long long GetPeakMemoryUsage( void )
+{
+#if defined( __linux__ )
+  /** Read VmHWM from /proc/self/status, which is reset by clear_refs. */
+  std::ifstream status( "/proc/self/status" );
+  std::string line;
+  while( std::getline( status, line ) )
+  {
+    if( line.compare( 0, 6, "VmHWM:" ) == 0 )
+    {
+      std::istringstream iss( line.substr( 6 ) );
+      unsigned long long kiloBytes = 0;
+      iss >> kiloBytes;
+      return kiloBytes * 1024;
+    }
+  }
+  return 0;
+#elif defined( _WIN32 )
+  PROCESS_MEMORY_COUNTERS counters;
+  if( GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) )
+  {
+    return static_cast<unsigned long long>( counters.PeakWorkingSetSize );
+  }
+  return 0;
+#else
+  struct rusage usage;
+  getrusage( RUSAGE_SELF, &usage );
+#if defined( __APPLE__ )
+  return static_cast<unsigned long long>( usage.ru_maxrss );
+#else
+  return static_cast<unsigned long long>( usage.ru_maxrss ) * 1024;
+#endif
+#endif
+} // end GetPeakMemoryUsage()
+
+
+/** Escape a string for use in JSON. */
+inline std::string JSONEscape( const std::string & arg )
+{
+  std::string escaped;
+  for( std::string::size_type i = 0; i < arg.size(); ++i )
+  {
+    const char c = arg[ i ];
+    if( c == '"' || c == '\\' ) escaped += '\\';
+    if( c == '\n' ) { escaped += "\\n"; continue; }
+    escaped += c;
+  }
+  return escaped;
+} // end JSONEscape()
+
+
+/** \class JSONRecord
+ * \brief A flat JSON object of key/value pairs, written in insertion order.
+ */
+
+class JSONRecord
+{
+public:
+  void Add( const std::string & key, const std::string & value )
+  {
+    this->m_Entries.push_back( "\"" + JSONEscape( key ) + "\": \""
+      + JSONEscape( value ) + "\"" );
+  }
+
+  template <class T>
+  void AddNumber( const std::string & key, const T & value )
+  {
+    std::ostringstream oss;
+    oss.precision( 10 );
+    oss << value;
+    this->m_Entries.push_back( "\"" + JSONEscape( key ) + "\": " + oss.str() );
+  }
+
+  std::string ToString( void ) const
+  {
+    std::string s = "{ ";
+    for( std::size_t i = 0; i < this->m_Entries.size(); ++i )
+    {
+      if( i > 0 ) s += ", ";
+      s += this->m_Entries[ i ];
+    }
+    return s + " }";
+  }
+
+private:
+  std::vector<std::string> m_Entries;
+
+}; // end class JSONRecord
+
+
+/** Write a list of records as a JSON document { "<name>": [ ... ] }. */
+inline bool WriteJSONRecords(
+  const std::string & fileName,
+  const std::string & name,
+  const std::vector<JSONRecord> & records )
+{
+  std::ofstream out( fileName.c_str() );
+  if( !out.is_open() ) return false;
+
+  out << "{\n  \"" << JSONEscape( name ) << "\": [\n";
+  for( std::size_t i = 0; i < records.size(); ++i )
+  {
+    out << "    " << records[ i ].ToString();
+    out << ( i + 1 < records.size() ? ",\n" : "\n" );
+  }
+  out << "  ]\n}\n";
+
+  return true;
+} // end WriteJSONRecords()
+
+
+/** Read the records of a JSON document written by WriteJSONRecords(). Every
+ * record is returned as a map from key to value; string values are returned
+ * without quotes and escapes, numbers as written.
+ */
+inline bool ReadJSONRecords(
+  const std::string & fileName,
+  std::vector< std::map<std::string, std::string> > & records )
+{
+  std::ifstream in( fileName.c_str() );
+  if( !in.is_open() ) return false;
+
+  /** WriteJSONRecords() writes one flat record per line. */
+  std::string line;
+  while( std::getline( in, line ) )
+  {
+    const std::string::size_type open = line.find( '{' );
+    if( open == std::string::npos || line.find( '[' ) != std::string::npos ) continue;
+    if( line.find( '"', open ) == std::string::npos ) continue;
+
+    std::map<std::string, std::string> record;
+    std::string key, token;
+    bool inString = false, haveKey = false;
+    for( std::string::size_type i = open + 1; i < line.size(); ++i )
+    {
+      const char c = line[ i ];
+      if( inString )
+      {
+        if( c == '\\' && i + 1 < line.size() )
+        {
+          ++i;
+          token += ( line[ i ] == 'n' ? '\n' : line[ i ] );
+        }
+        else if( c == '"' ) inString = false;
+        else token += c;
+        continue;
+      }
+      if( c == '"' ) inString = true;
+      else if( c == ':' ) { key = token; token.clear(); haveKey = true; }
+      else if( c == ',' || c == '}' )
+      {
+        if( haveKey ) record[ key ] = token;
+        token.clear();
+        haveKey = false;
+      }
+      else if( c != ' ' ) token += c;
+    }
+    records.push_back( record );
+  }
+
+  return true;
+} // end ReadJSONRecords()
+
+
+/** The resources used by a child process. The CPU time is the user plus
+ * system time; the CPU time and peak memory are 0 where they can not be
+ * measured.
+ */
+struct ProcessUsage
+{
+  int                 m_ExitCode;
+  double              m_WallTime;
+  double              m_CPUTime;
+  unsigned long long  m_PeakMemory;
+};
+
+
+/** Run a command, with its standard output discarded, and measure it.
+ * The command is a list of arguments, of which the first is the full path
+ * of the executable. If numberOfThreads is larger than 0, the environment
+ * variable ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS is set for the child.
+ *
+ * Returns false if the process could not be started.
+ */
+inline bool RunProcess(
+  const std::vector<std::string> & command,
+  const unsigned int & numberOfThreads,
+  ProcessUsage & usage )
+{
+  usage.m_ExitCode = -1;
+  usage.m_WallTime = 0.0;
+  usage.m_CPUTime = 0.0;
+  usage.m_PeakMemory = 0;
+  if( command.empty() ) return false;
+
+  std::ostringstream threads;
+  threads << numberOfThreads;
+  itk::RealTimeClock::Pointer clock = itk::RealTimeClock::New();
+  const double start = clock->GetTimeInSeconds();
+
+#if defined( _WIN32 )
+  /** Only the wall time is measured here. */
+  if( numberOfThreads > 0 )
+  {
+    _putenv( ( "ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS=" + threads.str() ).c_str() );
+  }
+  std::string commandLine;
+  for( std::size_t i = 0; i < command.size(); ++i )
+  {
+    commandLine += "\"" + command[ i ] + "\" ";
+  }
+  usage.m_ExitCode = std::system( ( "\"" + commandLine + "> NUL\"" ).c_str() );
+  usage.m_WallTime = clock->GetTimeInSeconds() - start;
+  return true;
+#else
+  std::vector<char *> argv;
+  for( std::size_t i = 0; i < command.size(); ++i )
+  {
+    argv.push_back( const_cast<char *>( command[ i ].c_str() ) );
+  }
+  argv.push_back( 0 );
+
+  const pid_t pid = fork();
+  if( pid < 0 ) return false;
+  if( pid == 0 )
+  {
+    if( numberOfThreads > 0 )
+    {
+      setenv( "ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS", threads.str().c_str(), 1 );
+    }
+    const int devNull = open( "/dev/null", O_WRONLY );
+    if( devNull >= 0 ) dup2( devNull, STDOUT_FILENO );
+    execv( argv[ 0 ], &argv[ 0 ] );
+    _exit( 127 );
+  }
+
+  int status = 0;
+  struct rusage resources;
+  if( wait4( pid, &status, 0, &resources ) != pid ) return false;
+  usage.m_WallTime = clock->GetTimeInSeconds() - start;
+
+  usage.m_ExitCode = WIFEXITED( status ) ? WEXITSTATUS( status ) : -1;
+  usage.m_CPUTime
+    = resources.ru_utime.tv_sec + 1e-6 * resources.ru_utime.tv_usec
+    + resources.ru_stime.tv_sec + 1e-6 * resources.ru_stime.tv_usec;
+#if defined( __APPLE__ )
+  usage.m_PeakMemory = static_cast<unsigned long long>( resources.ru_maxrss );
+#else
+  usage.m_PeakMemory = static_cast<unsigned long long>( resources.ru_maxrss ) * 1024;
+#endif
+  return usage.m_ExitCode != 127;
+#endif
+} // end RunProcess()
+
+
+/** The thread counts to benchmark: 1, 2, 4, ..., up to and including max. */
+inline std::vector<unsigned int> GetThreadCounts( const unsigned int & maximum )
+{
+  std::vector<unsigned int> counts;
+  for( unsigned int t = 1; t < maximum; t *= 2 )
+  {
+    counts.push_back( t );
+  }
+  counts.push_back( maximum > 0 ? maximum : 1 );
+  return counts;
+} // end GetThreadCounts()
+
+} // end namespace benchmark
+} // end namespace itktools
+
+#endif // end #ifndef __itktoolsBenchmarkHelpers_h_
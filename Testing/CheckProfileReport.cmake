@@ -0,0 +1,28 @@
+#---------------------------------------------------------------------
+#
+# Checks a report written by a tool run with -profile <file>.
+# Run it with
+#   cmake -DREPORT=<file> -DSTAGES=<stage1,stage2,...> -P CheckProfileReport.cmake
+# It fails if the report has no "stages" list, or if one of the stages,
+# e.g. ImageFileReader#1, is missing or was not executed.
+#
+#---------------------------------------------------------------------
+
+if( NOT EXISTS "${REPORT}" )
+  message( FATAL_ERROR "The profile report ${REPORT} does not exist." )
+endif()
+
+file( READ "${REPORT}" report )
+
+if( NOT report MATCHES "\"stages\": \\[" )
+  message( FATAL_ERROR "The profile report ${REPORT} has no stages." )
+endif()
+
+string( REPLACE "," ";" stages "${STAGES}" )
+foreach( stage ${stages} )
+  if( NOT report MATCHES "\"name\": \"${stage}\", \"executions\": [1-9]" )
+    message( FATAL_ERROR "The profile report ${REPORT} has no executed stage ${stage}." )
+  endif()
+endforeach()
+
+message( "The profile report ${REPORT} has the stages ${STAGES}." )
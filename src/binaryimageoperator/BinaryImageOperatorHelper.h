@@ -21,12 +21,50 @@
 #include "itkImage.h"
 #include "itkBinaryFunctors.h"
 #include "itkBinaryFunctorImageFilter.h"
+#include "itkSaturatingBinaryImageFilter.h"
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
 
 #include <vector>
 #include <itksys/SystemTools.hxx>
 
+/** \class NativeBinaryFilterSelector
+ *
+ * Creates a SaturatingBinaryImageFilter if both inputs and the output are
+ * of the same type and the operator has a native kernel for that type.
+ * Returns NULL otherwise.
+ */
+
+template< class TInputImage1, class TInputImage2, class TOutputImage >
+struct NativeBinaryFilterSelector
+{
+  typedef itk::ImageToImageFilter<TInputImage1, TOutputImage> BaseFilterType;
+  static typename BaseFilterType::Pointer New( const std::string & )
+  {
+    return 0;
+  }
+};
+
+template< class TImage >
+struct NativeBinaryFilterSelector< TImage, TImage, TImage >
+{
+  typedef itk::ImageToImageFilter<TImage, TImage>   BaseFilterType;
+  typedef itk::SaturatingBinaryImageFilter<TImage>  FilterType;
+  static typename BaseFilterType::Pointer New( const std::string & operatorName )
+  {
+    typename FilterType::OperationType operation;
+    if( !itk::SaturatingBinaryTraits<typename TImage::PixelType>::Supported
+      || !FilterType::GetOperation( operatorName, operation ) )
+    {
+      return 0;
+    }
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetOperation( operation );
+    return filter.GetPointer();
+  }
+};
+
+
 /** \class ITKToolsBinaryImageOperatorBase
  *
  * Untemplated pure virtual base class that holds
@@ -150,9 +188,17 @@ public:
     /** Get the binaryOperatorName. */
     std::string binaryOperatorName = this->m_Ops;
 
-    /** Set up the binaryFilter. */
-    typename BaseFilterType::Pointer binaryFilter = 0;
-    if( binaryOperatorName == "ADDITION" )
+    /** Set up the binaryFilter. Images of the same native type use the
+     * kernels of the SaturatingBinaryImageFilter where available.
+     */
+    typename BaseFilterType::Pointer binaryFilter
+      = NativeBinaryFilterSelector<InputImage1Type, InputImage2Type,
+      OutputImageType>::New( binaryOperatorName );
+    if( binaryFilter.IsNotNull() )
+    {
+      // already set up
+    }
+    else if( binaryOperatorName == "ADDITION" )
     {
       typename ADDITIONFilterType::Pointer tempBinaryFilter = ADDITIONFilterType::New();
       binaryFilter = tempBinaryFilter.GetPointer();
@@ -124,12 +124,39 @@ int DetermineComponentTypes(
     }
   }
 
-  /** The output type is the largest of the input types. The input types are
-   * then set to long or double, depending on the output type.
-   */
+  /** The output type is the largest of the input types. */
   componentTypeOut = itktools::GetLargestComponentType( componentType1, componentType2 );
-  bool outIsInteger = itktools::ComponentTypeIsInteger( componentTypeOut );
-  if( outIsInteger )
+
+  /** Return a value. */
+  return 0;
+
+} // end DetermineComponentTypes()
+
+
+/**
+ * ******************* DetermineInputComponentTypes *******************
+ *
+ * Two images of the same type are read in their native type if the output
+ * is of that type too and a native kernel exists for it; otherwise the
+ * input types are set to long or double, depending on the output type.
+ */
+
+void DetermineInputComponentTypes(
+  itk::ImageIOBase::IOComponentType & componentType1,
+  itk::ImageIOBase::IOComponentType & componentType2,
+  const itk::ImageIOBase::IOComponentType & componentTypeOut )
+{
+  if( componentType1 == componentTypeOut && componentType2 == componentTypeOut
+    && ( componentTypeOut == itk::ImageIOBase::UCHAR
+    || componentTypeOut == itk::ImageIOBase::CHAR
+    || componentTypeOut == itk::ImageIOBase::USHORT
+    || componentTypeOut == itk::ImageIOBase::SHORT
+    || componentTypeOut == itk::ImageIOBase::FLOAT ) )
+  {
+    return;
+  }
+
+  if( itktools::ComponentTypeIsInteger( componentTypeOut ) )
   {
     componentType1 = componentType2 = itk::ImageIOBase::LONG;
   }
@@ -138,10 +165,7 @@ int DetermineComponentTypes(
     componentType1 = componentType2 = itk::ImageIOBase::DOUBLE;
   }
 
-  /** Return a value. */
-  return 0;
-
-} // end DetermineComponentTypes()
+} // end DetermineInputComponentTypes()
 
 
 /**
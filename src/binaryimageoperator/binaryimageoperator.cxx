@@ -62,6 +62,9 @@ std::string GetHelpString( void )
     << "  [-z]     compression flag; if provided, the output image is compressed\n"
     << "  [-opct]  output component type, by default the largest of the two input images\n"
     << "           choose one of: {[unsigned_]{char,short,int,long},float,double}\n"
+    << "Two images of the same (unsigned) char, (unsigned) short or float type are\n"
+    << "processed in that type if the output is of that type too; otherwise they are\n"
+    << "converted to long or double.\n"
     << "Supported: 2D, 3D, (unsigned) char, (unsigned) short, (unsigned) int, (unsigned) long, float, double.";
   return ss.str();
 
@@ -138,12 +141,11 @@ int main( int argc, char **argv )
       std::cerr << "ERROR: the you specified a wrong opct." << std::endl;
       return EXIT_FAILURE;
     }
-    if( !itktools::ComponentTypeIsInteger( componentTypeOut ) )
-    {
-      componentType1 = componentType2 = itk::ImageIOBase::DOUBLE;
-    }
   }
 
+  /** Read the inputs in their native type if possible, else as long or double. */
+  DetermineInputComponentTypes( componentType1, componentType2, componentTypeOut );
+
   /** Check if a valid operator is given. */
   std::string opsCopy = ops;
   int retCO  = CheckOperator( ops );
@@ -167,6 +169,11 @@ int main( int argc, char **argv )
   try
   {
     // now call all possible template combinations.
+    if( !filter ) filter = ITKToolsBinaryImageOperator< 2, unsigned char, unsigned char, unsigned char >::New( dim, inCType1, inCType2, outCType );
+    if( !filter ) filter = ITKToolsBinaryImageOperator< 2, char, char, char >::New( dim, inCType1, inCType2, outCType );
+    if( !filter ) filter = ITKToolsBinaryImageOperator< 2, unsigned short, unsigned short, unsigned short >::New( dim, inCType1, inCType2, outCType );
+    if( !filter ) filter = ITKToolsBinaryImageOperator< 2, short, short, short >::New( dim, inCType1, inCType2, outCType );
+    if( !filter ) filter = ITKToolsBinaryImageOperator< 2, float, float, float >::New( dim, inCType1, inCType2, outCType );
     if( !filter ) filter = ITKToolsBinaryImageOperator< 2, long, long, char >::New( dim, inCType1, inCType2, outCType );
     if( !filter ) filter = ITKToolsBinaryImageOperator< 2, long, long, unsigned char >::New( dim, inCType1, inCType2, outCType );
     if( !filter ) filter = ITKToolsBinaryImageOperator< 2, long, long, short >::New( dim, inCType1, inCType2, outCType );
@@ -179,6 +186,11 @@ int main( int argc, char **argv )
     if( !filter ) filter = ITKToolsBinaryImageOperator< 2, double, double, double >::New( dim, inCType1, inCType2, outCType );
 
 #ifdef ITKTOOLS_3D_SUPPORT
+    if( !filter ) filter = ITKToolsBinaryImageOperator< 3, unsigned char, unsigned char, unsigned char >::New( dim, inCType1, inCType2, outCType );
+    if( !filter ) filter = ITKToolsBinaryImageOperator< 3, char, char, char >::New( dim, inCType1, inCType2, outCType );
+    if( !filter ) filter = ITKToolsBinaryImageOperator< 3, unsigned short, unsigned short, unsigned short >::New( dim, inCType1, inCType2, outCType );
+    if( !filter ) filter = ITKToolsBinaryImageOperator< 3, short, short, short >::New( dim, inCType1, inCType2, outCType );
+    if( !filter ) filter = ITKToolsBinaryImageOperator< 3, float, float, float >::New( dim, inCType1, inCType2, outCType );
     if( !filter ) filter = ITKToolsBinaryImageOperator< 3, long, long, char >::New( dim, inCType1, inCType2, outCType );
     if( !filter ) filter = ITKToolsBinaryImageOperator< 3, long, long, unsigned char >::New( dim, inCType1, inCType2, outCType );
     if( !filter ) filter = ITKToolsBinaryImageOperator< 3, long, long, short >::New( dim, inCType1, inCType2, outCType );
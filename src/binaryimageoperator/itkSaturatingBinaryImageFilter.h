@@ -0,0 +1,143 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkSaturatingBinaryImageFilter_h_
+#define __itkSaturatingBinaryImageFilter_h_
+
+#include "itkImageToImageFilter.h"
+
+
+namespace itk
+{
+
+/** \class SaturatingBinaryTraits
+ * \brief The arithmetic types of the native binary kernels.
+ *
+ * WideType holds the sum and difference of two values of type T exactly,
+ * ProductType their product. Only the types for which this can be done in a
+ * type narrower than the long or double that the functors use are supported.
+ * For float the kernels compute in double, exactly as the functors do.
+ */
+template <class T>
+struct SaturatingBinaryTraits
+{
+  static const bool Supported = false;
+  typedef double WideType;
+  typedef double ProductType;
+};
+
+template <> struct SaturatingBinaryTraits<unsigned char>
+{ static const bool Supported = true; typedef int WideType; typedef int ProductType; };
+template <> struct SaturatingBinaryTraits<char>
+{ static const bool Supported = true; typedef int WideType; typedef int ProductType; };
+template <> struct SaturatingBinaryTraits<unsigned short>
+{ static const bool Supported = true; typedef int WideType; typedef unsigned int ProductType; };
+template <> struct SaturatingBinaryTraits<short>
+{ static const bool Supported = true; typedef int WideType; typedef int ProductType; };
+template <> struct SaturatingBinaryTraits<float>
+{ static const bool Supported = true; typedef double WideType; typedef double ProductType; };
+
+
+/** \class SaturatingBinaryImageFilter
+ * \brief Pixel-wise arithmetic on two images of the same, native type.
+ *
+ * This filter computes ADDITION, MINUS, TIMES, MAXIMUM, MINIMUM and
+ * ABSOLUTEDIFFERENCE with the same result, bit for bit, as the functors in
+ * itkBinaryFunctors.h, but without converting the images to long or
+ * double. Each thread processes its region line by line on the raw
+ * buffers; the operation is selected once per region, so the inner loops
+ * are free of branches and calls and are vectorised by the compiler for
+ * the instruction set the tools are built for.
+ *
+ * The computation is done in SaturatingBinaryTraits<T>::WideType, which
+ * is exact for these operations, and ADDITION, MINUS and TIMES saturate to
+ * the range of T, as the functors do.
+ *
+ * \ingroup IntensityImageFilters Multithreaded
+ */
+template <class TImage>
+class SaturatingBinaryImageFilter:
+    public ImageToImageFilter<TImage,TImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef SaturatingBinaryImageFilter         Self;
+  typedef ImageToImageFilter<TImage,TImage>   Superclass;
+  typedef SmartPointer<Self>                  Pointer;
+  typedef SmartPointer<const Self>            ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( SaturatingBinaryImageFilter, ImageToImageFilter );
+
+  /** Typedef to describe the input/output image types. */
+  typedef TImage                                ImageType;
+  typedef typename ImageType::PixelType         PixelType;
+  typedef typename ImageType::RegionType        OutputImageRegionType;
+
+  /** The supported operations. */
+  typedef enum {
+    Addition, Minus, Times, Maximum, Minimum, AbsoluteDifference
+  } OperationType;
+
+  /** Set/Get the operation. Default Addition. */
+  itkSetMacro( Operation, OperationType );
+  itkGetConstMacro( Operation, OperationType );
+
+  /** Whether the operator name of pxbinaryimageoperator is supported, and if
+   * so the corresponding operation.
+   */
+  static bool GetOperation( const std::string & name, OperationType & operation );
+
+  /** Set the inputs. */
+  void SetInput1( const ImageType * input ) { this->SetNthInput( 0, const_cast<ImageType *>( input ) ); }
+  void SetInput2( const ImageType * input ) { this->SetNthInput( 1, const_cast<ImageType *>( input ) ); }
+
+protected:
+  SaturatingBinaryImageFilter();
+  ~SaturatingBinaryImageFilter() {};
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** Dispatch on the operation. */
+  virtual void ThreadedGenerateData(
+    const OutputImageRegionType & outputRegionForThread,
+    ThreadIdType threadId );
+
+  /** Apply the kernel to all lines of the region. */
+  template <class TKernel>
+  void ThreadedGenerateDataForKernel(
+    const OutputImageRegionType & outputRegionForThread,
+    ThreadIdType threadId );
+
+private:
+  SaturatingBinaryImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  OperationType m_Operation;
+
+}; // end class SaturatingBinaryImageFilter
+
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSaturatingBinaryImageFilter.hxx"
+#endif
+
+#endif // end #ifndef __itkSaturatingBinaryImageFilter_h_
@@ -0,0 +1,230 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef _itkSaturatingBinaryImageFilter_hxx_
+#define _itkSaturatingBinaryImageFilter_hxx_
+
+#include "itkSaturatingBinaryImageFilter.h"
+
+#include "itkImageLinearIteratorWithIndex.h"
+#include "itkNumericTraits.h"
+#include "itkProgressReporter.h"
+
+
+namespace itk
+{
+namespace Functor
+{
+
+/** The kernels of the SaturatingBinaryImageFilter. Apply() mirrors the
+ * corresponding functor in itkBinaryFunctors.h; Saturate tells whether that
+ * functor clamps the result to the output range.
+ */
+
+template <class T>
+struct SaturatingADDITION
+{
+  typedef typename SaturatingBinaryTraits<T>::WideType WideType;
+  static const bool Saturate = true;
+  static inline WideType Apply( const WideType & a, const WideType & b )
+  { return a + b; }
+};
+
+template <class T>
+struct SaturatingMINUS
+{
+  typedef typename SaturatingBinaryTraits<T>::WideType WideType;
+  static const bool Saturate = true;
+  static inline WideType Apply( const WideType & a, const WideType & b )
+  { return a - b; }
+};
+
+template <class T>
+struct SaturatingTIMES
+{
+  typedef typename SaturatingBinaryTraits<T>::ProductType WideType;
+  static const bool Saturate = true;
+  static inline WideType Apply( const WideType & a, const WideType & b )
+  { return a * b; }
+};
+
+template <class T>
+struct SaturatingMAXIMUM
+{
+  typedef typename SaturatingBinaryTraits<T>::WideType WideType;
+  static const bool Saturate = true;
+  static inline WideType Apply( const WideType & a, const WideType & b )
+  { return a < b ? b : a; } // as vnl_math_max
+};
+
+template <class T>
+struct SaturatingMINIMUM
+{
+  typedef typename SaturatingBinaryTraits<T>::WideType WideType;
+  static const bool Saturate = true;
+  static inline WideType Apply( const WideType & a, const WideType & b )
+  { return a < b ? a : b; } // as vnl_math_min
+};
+
+template <class T>
+struct SaturatingABSOLUTEDIFFERENCE
+{
+  typedef typename SaturatingBinaryTraits<T>::WideType WideType;
+  static const bool Saturate = false;
+  static inline WideType Apply( const WideType & a, const WideType & b )
+  { return a - b > 0 ? a - b : b - a; }
+};
+
+} // end namespace Functor
+
+
+template<class TImage>
+SaturatingBinaryImageFilter<TImage>
+::SaturatingBinaryImageFilter()
+{
+  this->SetNumberOfRequiredInputs( 2 );
+  this->m_Operation = Addition;
+}
+
+
+template<class TImage>
+bool
+SaturatingBinaryImageFilter<TImage>
+::GetOperation( const std::string & name, OperationType & operation )
+{
+  if( name == "ADDITION" ) operation = Addition;
+  else if( name == "MINUS" ) operation = Minus;
+  else if( name == "TIMES" ) operation = Times;
+  else if( name == "MAXIMUM" ) operation = Maximum;
+  else if( name == "MINIMUM" ) operation = Minimum;
+  else if( name == "ABSOLUTEDIFFERENCE" ) operation = AbsoluteDifference;
+  else return false;
+  return true;
+
+} // end GetOperation()
+
+
+template<class TImage>
+void
+SaturatingBinaryImageFilter<TImage>
+::ThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread,
+  ThreadIdType threadId )
+{
+  switch( this->m_Operation )
+  {
+    case Addition:
+      this->template ThreadedGenerateDataForKernel< Functor::SaturatingADDITION<PixelType> >(
+        outputRegionForThread, threadId );
+      break;
+    case Minus:
+      this->template ThreadedGenerateDataForKernel< Functor::SaturatingMINUS<PixelType> >(
+        outputRegionForThread, threadId );
+      break;
+    case Times:
+      this->template ThreadedGenerateDataForKernel< Functor::SaturatingTIMES<PixelType> >(
+        outputRegionForThread, threadId );
+      break;
+    case Maximum:
+      this->template ThreadedGenerateDataForKernel< Functor::SaturatingMAXIMUM<PixelType> >(
+        outputRegionForThread, threadId );
+      break;
+    case Minimum:
+      this->template ThreadedGenerateDataForKernel< Functor::SaturatingMINIMUM<PixelType> >(
+        outputRegionForThread, threadId );
+      break;
+    case AbsoluteDifference:
+      this->template ThreadedGenerateDataForKernel< Functor::SaturatingABSOLUTEDIFFERENCE<PixelType> >(
+        outputRegionForThread, threadId );
+      break;
+  }
+
+} // end ThreadedGenerateData()
+
+
+template<class TImage>
+template<class TKernel>
+void
+SaturatingBinaryImageFilter<TImage>
+::ThreadedGenerateDataForKernel(
+  const OutputImageRegionType & outputRegionForThread,
+  ThreadIdType threadId )
+{
+  typedef typename TKernel::WideType                WideType;
+  typedef typename ImageType::IndexType             IndexType;
+  typedef ImageLinearIteratorWithIndex<ImageType>   IteratorType;
+
+  const ImageType * input1 = this->GetInput( 0 );
+  const ImageType * input2 = this->GetInput( 1 );
+  ImageType * output = this->GetOutput();
+
+  const WideType maximum = static_cast<WideType>( NumericTraits<PixelType>::max() );
+  const WideType minimum = static_cast<WideType>( NumericTraits<PixelType>::NonpositiveMin() );
+  const std::size_t lineLength = outputRegionForThread.GetSize( 0 );
+
+  ProgressReporter progress( this, threadId,
+    outputRegionForThread.GetNumberOfPixels() / lineLength );
+
+  /** Pixels along dimension 0 are contiguous in all buffers. */
+  IteratorType it( output, outputRegionForThread );
+  it.SetDirection( 0 );
+  it.GoToBegin();
+  while( !it.IsAtEnd() )
+  {
+    const IndexType index = it.GetIndex();
+    const PixelType * in1 = input1->GetBufferPointer() + input1->ComputeOffset( index );
+    const PixelType * in2 = input2->GetBufferPointer() + input2->ComputeOffset( index );
+    PixelType * out = output->GetBufferPointer() + output->ComputeOffset( index );
+
+    for( std::size_t j = 0; j < lineLength; ++j )
+    {
+      const WideType result = TKernel::Apply(
+        static_cast<WideType>( in1[ j ] ), static_cast<WideType>( in2[ j ] ) );
+      if( TKernel::Saturate )
+      {
+        const WideType result1 = result < maximum ? result : maximum;
+        const WideType result2 = result1 > minimum ? result1 : minimum;
+        out[ j ] = static_cast<PixelType>( result2 );
+      }
+      else
+      {
+        out[ j ] = static_cast<PixelType>( result );
+      }
+    }
+
+    it.NextLine();
+    progress.CompletedPixel();
+  } // end while lines
+
+} // end ThreadedGenerateDataForKernel()
+
+
+template<class TImage>
+void
+SaturatingBinaryImageFilter<TImage>
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "Operation: " << this->m_Operation << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef _itkSaturatingBinaryImageFilter_hxx_
@@ -0,0 +1,473 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#include "ChangeImageInformationInHeader.h"
+#include "ITKToolsMetaImageHeader.h"
+
+#include <itksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+
+namespace itktools
+{
+
+namespace
+{
+
+/** Print values with enough digits for spacings and origins. */
+std::string JoinValues( const std::vector<double> & values,
+  const std::string & separator )
+{
+  std::ostringstream stream;
+  stream << std::setprecision( 16 );
+  for( std::size_t i = 0; i < values.size(); ++i )
+  {
+    stream << ( i == 0 ? "" : separator ) << values[ i ];
+  }
+  return stream.str();
+
+} // end JoinValues()
+
+
+/**
+ * ***************** ChangeMetaImageHeader ************************
+ *
+ * TransformMatrix has the direction of axis i in row i, which is the
+ * layout of the direction argument.
+ */
+
+bool ChangeMetaImageHeader(
+  const std::string & fileName,
+  const std::vector<double> & spacing,
+  const std::vector<double> & origin,
+  const std::vector<double> & direction )
+{
+  MetaImageHeaderType header;
+  if( !ReadMetaImageHeader( fileName, header ) ) return false;
+  if( GetMetaImageDataFileName( fileName, header ).empty() ) return false;
+
+  std::string nDims;
+  if( !GetMetaImageHeaderField( header, "NDims", nDims )
+    || std::atoi( nDims.c_str() ) != static_cast<int>( spacing.size() ) )
+  {
+    return false;
+  }
+
+  /** The readers accept several names for the origin and the direction;
+   * replace the ones that are present, or add the names ITK writes.
+   */
+  bool hasOrigin = false;
+  bool hasDirection = false;
+  for( std::size_t i = 0; i < header.size(); ++i )
+  {
+    const std::string & key = header[ i ].first;
+    if( key == "Offset" || key == "Position" || key == "Origin" )
+    {
+      header[ i ].second = JoinValues( origin, " " );
+      hasOrigin = true;
+    }
+    else if( key == "TransformMatrix" || key == "Rotation" || key == "Orientation" )
+    {
+      header[ i ].second = JoinValues( direction, " " );
+      hasDirection = true;
+    }
+  }
+  if( !hasOrigin ) SetMetaImageHeaderField( header, "Offset", JoinValues( origin, " " ) );
+  if( !hasDirection ) SetMetaImageHeaderField( header, "TransformMatrix", JoinValues( direction, " " ) );
+  SetMetaImageHeaderField( header, "ElementSpacing", JoinValues( spacing, " " ) );
+
+  /** The anatomical orientation would no longer match the direction. */
+  for( std::size_t i = 0; i < header.size(); ++i )
+  {
+    if( header[ i ].first == "AnatomicalOrientation" )
+    {
+      header.erase( header.begin() + i );
+      break;
+    }
+  }
+
+  return WriteMetaImageHeader( fileName, header );
+
+} // end ChangeMetaImageHeader()
+
+
+/**
+ * ***************** ChangeNrrdHeader ************************
+ *
+ * A detached header has "field: value" lines. The space directions are the
+ * direction vectors scaled by the spacing, one per spatial axis; non-spatial
+ * axes have "none". Coordinates are converted from LPS to the space of the
+ * header; headers without a space or in other spaces are not changed.
+ */
+
+bool ChangeNrrdHeader(
+  const std::string & fileName,
+  const std::vector<double> & spacing,
+  const std::vector<double> & origin,
+  const std::vector<double> & direction )
+{
+  std::ifstream file( fileName.c_str() );
+  if( !file.is_open() ) return false;
+  std::vector<std::string> lines;
+  std::string line;
+  while( std::getline( file, line ) ) lines.push_back( line );
+  file.close();
+  if( lines.empty() || lines[ 0 ].compare( 0, 4, "NRRD" ) != 0 ) return false;
+
+  /** Find the fields. */
+  const std::size_t none = lines.size();
+  std::size_t spaceLine = none;
+  std::size_t directionsLine = none;
+  std::size_t originLine = none;
+  bool hasDataFile = false;
+  for( std::size_t i = 1; i < lines.size(); ++i )
+  {
+    if( lines[ i ].empty() ) break;
+    if( lines[ i ][ 0 ] == '#' ) continue;
+    const std::string::size_type colon = lines[ i ].find( ": " );
+    if( colon == std::string::npos ) continue;
+    const std::string key = lines[ i ].substr( 0, colon );
+    if( key == "space" || key == "space dimension" ) spaceLine = i;
+    else if( key == "space directions" ) directionsLine = i;
+    else if( key == "space origin" ) originLine = i;
+    else if( key == "data file" || key == "datafile" ) hasDataFile = true;
+  }
+  if( !hasDataFile || spaceLine == none || directionsLine == none ) return false;
+
+  /** The sign of each LPS coordinate in the space of the header. */
+  const unsigned int dimension = spacing.size();
+  const std::string space = lines[ spaceLine ].substr( lines[ spaceLine ].find( ": " ) + 2 );
+  std::vector<double> sign( dimension, 1.0 );
+  if( lines[ spaceLine ].compare( 0, 7, "space: " ) == 0 )
+  {
+    if( dimension != 3 ) return false;
+    if( space == "right-anterior-superior" || space == "RAS" )
+    {
+      sign[ 0 ] = sign[ 1 ] = -1.0;
+    }
+    else if( space == "left-anterior-superior" || space == "LAS" )
+    {
+      sign[ 1 ] = -1.0;
+    }
+    else if( space != "left-posterior-superior" && space != "LPS" )
+    {
+      return false;
+    }
+  }
+  else if( std::atoi( space.c_str() ) != static_cast<int>( dimension ) )
+  {
+    return false;
+  }
+
+  /** Replace the vectors of the spatial axes, keep the "none" entries. */
+  std::istringstream directionsStream(
+    lines[ directionsLine ].substr( lines[ directionsLine ].find( ": " ) + 2 ) );
+  std::vector<std::string> entries;
+  std::string entry;
+  while( directionsStream >> entry ) entries.push_back( entry );
+  unsigned int axis = 0;
+  for( std::size_t e = 0; e < entries.size(); ++e )
+  {
+    if( entries[ e ] == "none" ) continue;
+    if( axis == dimension ) return false;
+    std::vector<double> vector( dimension );
+    for( unsigned int j = 0; j < dimension; ++j )
+    {
+      vector[ j ] = sign[ j ] * spacing[ axis ] * direction[ axis * dimension + j ];
+    }
+    entries[ e ] = "(" + JoinValues( vector, "," ) + ")";
+    ++axis;
+  }
+  if( axis != dimension ) return false;
+
+  std::vector<double> spaceOrigin( dimension );
+  for( unsigned int j = 0; j < dimension; ++j )
+  {
+    spaceOrigin[ j ] = sign[ j ] * origin[ j ];
+  }
+
+  std::ostringstream directionsValue;
+  for( std::size_t e = 0; e < entries.size(); ++e )
+  {
+    directionsValue << ( e == 0 ? "" : " " ) << entries[ e ];
+  }
+  lines[ directionsLine ] = "space directions: " + directionsValue.str();
+  const std::string originValue = "space origin: (" + JoinValues( spaceOrigin, "," ) + ")";
+  if( originLine != none ) lines[ originLine ] = originValue;
+  else lines.insert( lines.begin() + directionsLine + 1, originValue );
+
+  std::string contents;
+  for( std::size_t i = 0; i < lines.size(); ++i )
+  {
+    contents += lines[ i ] + "\n";
+  }
+  return ReplaceFileAtomically( fileName, contents );
+
+} // end ChangeNrrdHeader()
+
+
+/** Access to the fields of a NIfTI-1 header in the byte order of the file. */
+class NiftiHeader
+{
+public:
+  static const std::size_t Size = 348;
+
+  bool Read( const std::string & fileName )
+  {
+    std::ifstream file( fileName.c_str(), std::ios::binary );
+    if( !file.is_open() ) return false;
+    this->m_Bytes.resize( Size );
+    file.read( &this->m_Bytes[ 0 ], Size );
+    if( file.gcount() != static_cast<std::streamsize>( Size ) ) return false;
+
+    int sizeOfHeader = 0;
+    std::memcpy( &sizeOfHeader, &this->m_Bytes[ 0 ], 4 );
+    this->m_Swap = false;
+    if( sizeOfHeader != static_cast<int>( Size ) )
+    {
+      this->m_Swap = true;
+      this->Get( 0, sizeOfHeader );
+      if( sizeOfHeader != static_cast<int>( Size ) ) return false;
+    }
+    return std::memcmp( &this->m_Bytes[ 344 ], "n+1", 4 ) == 0
+      || std::memcmp( &this->m_Bytes[ 344 ], "ni1", 4 ) == 0;
+  }
+
+  template <class T> void Get( std::size_t offset, T & value ) const
+  {
+    char bytes[ sizeof( T ) ];
+    std::memcpy( bytes, &this->m_Bytes[ offset ], sizeof( T ) );
+    if( this->m_Swap ) std::reverse( bytes, bytes + sizeof( T ) );
+    std::memcpy( &value, bytes, sizeof( T ) );
+  }
+
+  template <class T> void Set( std::size_t offset, const T & value )
+  {
+    char bytes[ sizeof( T ) ];
+    std::memcpy( bytes, &value, sizeof( T ) );
+    if( this->m_Swap ) std::reverse( bytes, bytes + sizeof( T ) );
+    std::memcpy( &this->m_Bytes[ offset ], bytes, sizeof( T ) );
+  }
+
+  const std::vector<char> & GetBytes( void ) const { return this->m_Bytes; }
+
+private:
+  std::vector<char> m_Bytes;
+  bool              m_Swap;
+};
+
+
+/**
+ * ***************** ChangeNiftiHeader ************************
+ *
+ * Writes the orientation as the itk::NiftiImageIO does: the direction and
+ * origin are converted from LPS to RAS, and stored both as the qform
+ * quaternion and as the sform matrix, see nifti_mat44_to_quatern() of
+ * nifti1_io.c for the quaternion.
+ */
+
+bool ChangeNiftiHeader(
+  const std::string & fileName,
+  const std::vector<double> & spacing,
+  const std::vector<double> & origin,
+  const std::vector<double> & direction )
+{
+  NiftiHeader header;
+  if( !header.Read( fileName ) ) return false;
+
+  const unsigned int dimension = spacing.size();
+  short fileDimension = 0;
+  header.Get( 40, fileDimension );
+  if( dimension > 3 || fileDimension != static_cast<short>( dimension ) ) return false;
+
+  /** The 3D spacing, origin and unit direction columns, in RAS. */
+  float pixdim3 = 1.0f;
+  header.Get( 76 + 3 * 4, pixdim3 );
+  double s[ 3 ] = { 1.0, 1.0, pixdim3 > 0.0f ? pixdim3 : 1.0 };
+  double o[ 3 ] = { 0.0, 0.0, 0.0 };
+  double r[ 3 ][ 3 ] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+  const double ras[ 3 ] = { -1.0, -1.0, 1.0 };
+  for( unsigned int i = 0; i < dimension; ++i )
+  {
+    s[ i ] = spacing[ i ];
+    o[ i ] = ras[ i ] * origin[ i ];
+    for( unsigned int j = 0; j < dimension; ++j )
+    {
+      r[ j ][ i ] = ras[ j ] * direction[ i * dimension + j ];
+    }
+  }
+  for( unsigned int j = 0; j < 3; ++j )
+  {
+    for( unsigned int i = dimension; i < 3; ++i ) r[ j ][ i ] = ( i == j ? 1.0 : 0.0 );
+  }
+
+  /** The quaternion of the rotation; a left-handed frame has qfac -1. */
+  const double determinant
+    = r[ 0 ][ 0 ] * ( r[ 1 ][ 1 ] * r[ 2 ][ 2 ] - r[ 1 ][ 2 ] * r[ 2 ][ 1 ] )
+    - r[ 0 ][ 1 ] * ( r[ 1 ][ 0 ] * r[ 2 ][ 2 ] - r[ 1 ][ 2 ] * r[ 2 ][ 0 ] )
+    + r[ 0 ][ 2 ] * ( r[ 1 ][ 0 ] * r[ 2 ][ 1 ] - r[ 1 ][ 1 ] * r[ 2 ][ 0 ] );
+  const double qfac = determinant > 0.0 ? 1.0 : -1.0;
+  double q[ 3 ][ 3 ];
+  for( unsigned int j = 0; j < 3; ++j )
+  {
+    q[ j ][ 0 ] = r[ j ][ 0 ];
+    q[ j ][ 1 ] = r[ j ][ 1 ];
+    q[ j ][ 2 ] = qfac * r[ j ][ 2 ];
+  }
+
+  double a = q[ 0 ][ 0 ] + q[ 1 ][ 1 ] + q[ 2 ][ 2 ] + 1.0;
+  double b, c, d;
+  if( a > 0.5 )
+  {
+    a = 0.5 * std::sqrt( a );
+    b = 0.25 * ( q[ 2 ][ 1 ] - q[ 1 ][ 2 ] ) / a;
+    c = 0.25 * ( q[ 0 ][ 2 ] - q[ 2 ][ 0 ] ) / a;
+    d = 0.25 * ( q[ 1 ][ 0 ] - q[ 0 ][ 1 ] ) / a;
+  }
+  else
+  {
+    const double xd = 1.0 + q[ 0 ][ 0 ] - ( q[ 1 ][ 1 ] + q[ 2 ][ 2 ] );
+    const double yd = 1.0 + q[ 1 ][ 1 ] - ( q[ 0 ][ 0 ] + q[ 2 ][ 2 ] );
+    const double zd = 1.0 + q[ 2 ][ 2 ] - ( q[ 0 ][ 0 ] + q[ 1 ][ 1 ] );
+    if( xd > 1.0 )
+    {
+      b = 0.5 * std::sqrt( xd );
+      c = 0.25 * ( q[ 0 ][ 1 ] + q[ 1 ][ 0 ] ) / b;
+      d = 0.25 * ( q[ 0 ][ 2 ] + q[ 2 ][ 0 ] ) / b;
+      a = 0.25 * ( q[ 2 ][ 1 ] - q[ 1 ][ 2 ] ) / b;
+    }
+    else if( yd > 1.0 )
+    {
+      c = 0.5 * std::sqrt( yd );
+      b = 0.25 * ( q[ 0 ][ 1 ] + q[ 1 ][ 0 ] ) / c;
+      d = 0.25 * ( q[ 1 ][ 2 ] + q[ 2 ][ 1 ] ) / c;
+      a = 0.25 * ( q[ 0 ][ 2 ] - q[ 2 ][ 0 ] ) / c;
+    }
+    else
+    {
+      d = 0.5 * std::sqrt( zd );
+      b = 0.25 * ( q[ 0 ][ 2 ] + q[ 2 ][ 0 ] ) / d;
+      c = 0.25 * ( q[ 1 ][ 2 ] + q[ 2 ][ 1 ] ) / d;
+      a = 0.25 * ( q[ 1 ][ 0 ] - q[ 0 ][ 1 ] ) / d;
+    }
+    if( a < 0.0 )
+    {
+      b = -b; c = -c; d = -d;
+    }
+  }
+
+  /** pixdim[ 0 ] is qfac, then the spacings. */
+  header.Set( 76, static_cast<float>( qfac ) );
+  for( unsigned int i = 0; i < 3; ++i )
+  {
+    header.Set( 76 + ( i + 1 ) * 4, static_cast<float>( s[ i ] ) );
+  }
+
+  /** The codes stay if set, otherwise scanner anatomical, as ITK writes. */
+  short qformCode = 0;
+  short sformCode = 0;
+  header.Get( 252, qformCode );
+  header.Get( 254, sformCode );
+  header.Set( 252, static_cast<short>( qformCode > 0 ? qformCode : 1 ) );
+  header.Set( 254, static_cast<short>( sformCode > 0 ? sformCode : 1 ) );
+
+  header.Set( 256, static_cast<float>( b ) );
+  header.Set( 260, static_cast<float>( c ) );
+  header.Set( 264, static_cast<float>( d ) );
+  for( unsigned int j = 0; j < 3; ++j )
+  {
+    header.Set( 268 + j * 4, static_cast<float>( o[ j ] ) );
+    for( unsigned int i = 0; i < 3; ++i )
+    {
+      header.Set( 280 + j * 16 + i * 4, static_cast<float>( r[ j ][ i ] * s[ i ] ) );
+    }
+    header.Set( 280 + j * 16 + 12, static_cast<float>( o[ j ] ) );
+  }
+
+  /** A .hdr file is replaced; the header of a .nii file is overwritten,
+   * since replacing it would mean copying the pixel data.
+   */
+  const std::vector<char> & bytes = header.GetBytes();
+  const std::string extension = itksys::SystemTools::LowerCase(
+    itksys::SystemTools::GetFilenameLastExtension( fileName ) );
+  if( extension == ".hdr" )
+  {
+    std::ifstream file( fileName.c_str(), std::ios::binary );
+    std::string contents( ( std::istreambuf_iterator<char>( file ) ),
+      std::istreambuf_iterator<char>() );
+    file.close();
+    contents.replace( 0, bytes.size(), &bytes[ 0 ], bytes.size() );
+    return ReplaceFileAtomically( fileName, contents );
+  }
+
+  std::fstream file( fileName.c_str(), std::ios::binary | std::ios::in | std::ios::out );
+  if( !file.is_open() ) return false;
+  file.seekp( 0 );
+  file.write( &bytes[ 0 ], bytes.size() );
+  file.close();
+  return !file.fail();
+
+} // end ChangeNiftiHeader()
+
+} // end anonymous namespace
+
+
+/**
+ * ***************** ChangeImageInformationInHeader ************************
+ */
+
+bool ChangeImageInformationInHeader(
+  const std::string & fileName,
+  const std::vector<double> & spacing,
+  const std::vector<double> & origin,
+  const std::vector<double> & direction )
+{
+  const unsigned int dimension = spacing.size();
+  if( dimension == 0 || origin.size() != dimension
+    || direction.size() != dimension * dimension )
+  {
+    return false;
+  }
+
+  const std::string extension = itksys::SystemTools::LowerCase(
+    itksys::SystemTools::GetFilenameLastExtension( fileName ) );
+  if( extension == ".mhd" )
+  {
+    return ChangeMetaImageHeader( fileName, spacing, origin, direction );
+  }
+  else if( extension == ".nhdr" )
+  {
+    return ChangeNrrdHeader( fileName, spacing, origin, direction );
+  }
+  else if( extension == ".nii" || extension == ".hdr" )
+  {
+    return ChangeNiftiHeader( fileName, spacing, origin, direction );
+  }
+
+  return false;
+
+} // end ChangeImageInformationInHeader()
+
+} // end namespace itktools
@@ -0,0 +1,51 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __ChangeImageInformationInHeader_h_
+#define __ChangeImageInformationInHeader_h_
+
+#include <string>
+#include <vector>
+
+
+namespace itktools
+{
+
+/** Change the spacing, origin and direction of an image file by editing its
+ * header only; the pixel data is not read or written. The direction is
+ * given as by GetImageDirection(): element i * dimension + j is component j
+ * of the direction of axis i. All values are in ITK (LPS) coordinates.
+ *
+ * Supported are:
+ * - MetaImage headers (.mhd) with a detached data file;
+ * - detached NRRD headers (.nhdr) with space directions and a space origin;
+ * - NIfTI-1 images (.nii) and header files (.hdr) of at most 3 dimensions.
+ * Text headers and .hdr files are replaced atomically via a temporary file.
+ * The 348 byte header of a .nii file is overwritten in place.
+ *
+ * Returns false, without changing the file, if the file can not be edited
+ * this way, e.g. for compressed or attached data, or other formats.
+ */
+bool ChangeImageInformationInHeader(
+  const std::string & fileName,
+  const std::vector<double> & spacing,
+  const std::vector<double> & origin,
+  const std::vector<double> & direction );
+
+} // end namespace itktools
+
+#endif // end #ifndef __ChangeImageInformationInHeader_h_
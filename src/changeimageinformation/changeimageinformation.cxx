@@ -27,6 +27,8 @@
 #include "itkCommandLineArgumentParser.h"
 #include "ITKToolsHelpers.h"
 #include "changeimageinformation.h"
+#include "ChangeImageInformationInHeader.h"
+#include <itksys/SystemTools.hxx>
 
 
 /**
@@ -43,6 +45,9 @@ std::string GetHelpString( void )
     << "  -in      inputFilename\n"
     << "  -out     outputFilename\n"
     << "  -ref     reference image filename from which header info is taken\n"
+    << "If the output is the input file, and it is a .mhd or .nhdr file with a\n"
+    << "detached data file, or a .nii or .hdr NIfTI file, only its header is\n"
+    << "rewritten; the pixel data is not read or written.\n"
     << "Supported: 2D, 3D, (unsigned) char, (unsigned) short, (unsigned) int,\n"
     << "(unsigned) long, float, double.";
 
@@ -86,6 +91,26 @@ int main( int argc, char ** argv )
   std::string referenceFileName = "";
   parser->GetCommandLineArgument( "-ref", referenceFileName );
 
+  /** Change the header only, if the input file itself is changed and its
+   * format allows it.
+   */
+  if( itksys::SystemTools::SameFile( inputFileName.c_str(), outputFileName.c_str() ) )
+  {
+    itk::ImageIOBase::Pointer inputIO;
+    itk::ImageIOBase::Pointer referenceIO;
+    std::vector<double> spacing, origin, direction;
+    if( itktools::GetImageIOBase( inputFileName, inputIO )
+      && itktools::GetImageIOBase( referenceFileName, referenceIO )
+      && inputIO->GetNumberOfDimensions() == referenceIO->GetNumberOfDimensions()
+      && itktools::GetImageSpacing( referenceIO, spacing )
+      && itktools::GetImageOrigin( referenceIO, origin )
+      && itktools::GetImageDirection( referenceIO, direction )
+      && itktools::ChangeImageInformationInHeader( inputFileName, spacing, origin, direction ) )
+    {
+      return EXIT_SUCCESS;
+    }
+  }
+
   /** Determine image properties. */
   itk::ImageIOBase::IOPixelType pixelType = itk::ImageIOBase::UNKNOWNPIXELTYPE;
   itk::ImageIOBase::IOComponentType componentType = itk::ImageIOBase::UNKNOWNCOMPONENTTYPE;
@@ -19,6 +19,7 @@
 #define __combinesegmentations_h_
 
 #include "ITKToolsBase.h"
+#include "ITKToolsProfiler.h"
 
 #include <string>
 #include <vector>
@@ -193,6 +194,9 @@ public:
     LabelImagePointer hardSegmentation = 0;
     ConfusionMatrixImagePointer confusionMatrixImage = 0;
 
+    /** Time the stages if -profile is given. */
+    itktools::Profiler * profiler = itktools::Profiler::GetInstance();
+
     /** Initialize some variables */
     numberOfObservers = this->m_InputSegmentationFileNames.size();
     labelImageArray.resize( numberOfObservers );
@@ -208,6 +212,7 @@ public:
       typename LabelImageReaderType::Pointer labelImageReader =
         LabelImageReaderType::New();
       labelImageReader->SetFileName( this->m_InputSegmentationFileNames[ i ].c_str() );
+      profiler->Observe( labelImageReader );
       labelImageReader->Update();
 
       /** Check size. */
@@ -230,6 +235,7 @@ public:
           LabelPixelType labout = static_cast<LabelPixelType>( this->m_OutValues[lab] );
           relabeler->SetChange( labin, labout );
         }
+        profiler->Observe( relabeler );
         relabeler->Update();
         labelImageArray[ i ] = relabeler->GetOutput();
       } // end relabel
@@ -249,6 +255,7 @@ public:
         typename ProbImageReaderType::Pointer probImageReader =
           ProbImageReaderType::New();
         probImageReader->SetFileName( this->m_PriorProbImageFileNames[ i ].c_str() );
+        profiler->Observe( probImageReader );
         probImageReader->Update();
         priorProbImageArray[ i ] = probImageReader->GetOutput();
       }
@@ -283,6 +290,7 @@ public:
         staple->SetConfidenceWeight( this->m_PriorProbs[1] );
       }
       std::cout << "Performing STAPLE algorithm..." << std::endl;
+      profiler->Observe( staple );
       staple->Update();
       std::cout << "Done performing STAPLE algorithm." << std::endl;
       std::cout << "NumberOfIterations = " << staple->GetElapsedIterations() << std::endl;
@@ -296,6 +304,7 @@ public:
       inverter->SetMaximum( itk::NumericTraits<ProbPixelType>::One );
       inverter->SetInput( softSegmentationArray[1] );
       std::cout << "Generating soft segmentation for class 0..." << std::endl;
+      profiler->Observe( inverter );
       inverter->Update();
       std::cout << "Done generating soft segmentation for class 0..." << std::endl;
       softSegmentationArray[0] = inverter->GetOutput();
@@ -313,6 +322,7 @@ public:
         thresholder->SetOutsideValue( itk::NumericTraits<LabelPixelType>::Zero );
         thresholder->SetInput( softSegmentationArray[0] );
         std::cout << "Generating hard segmentation..." << std::endl;
+        profiler->Observe( thresholder );
         thresholder->Update();
         std::cout << "Done generating hard segmentation." << std::endl;
         hardSegmentation = thresholder->GetOutput();
@@ -364,6 +374,7 @@ public:
       std::cout << "TerminationUpdateThreshold = " << this->m_TerminationThreshold << std::endl;
       multistaple->SetTerminationUpdateThreshold( this->m_TerminationThreshold );
       std::cout << "Performing MULTISTAPLE algorithm..." << std::endl;
+      profiler->Observe( multistaple );
       multistaple->Update();
       std::cout << "Done performing MULTISTAPLE algorithm." << std::endl;
       std::cout
@@ -429,6 +440,7 @@ public:
         dilater->SetBackgroundValue( itk::NumericTraits<MaskPixelType>::Zero );
         dilater->SetInput( maskGenerator->GetOutput() );
         std::cout << "Creating mask (this->m_MaskDilationRadius = " << this->m_MaskDilationRadius << ")..." << std::endl;
+        profiler->Observe( dilater );
         dilater->Update();
         multistaple2->SetMaskImage( dilater->GetOutput() );
         std::cout << "Done creating mask." << std::endl;
@@ -489,6 +501,7 @@ public:
 
       /** Run!! */
       std::cout << "Performing " << this->m_CombinationMethod << " algorithm..." << std::endl;
+      profiler->Observe( multistaple2 );
       multistaple2->Update();
       std::cout << "Done performing " << this->m_CombinationMethod << " algorithm." << std::endl;
       if( this->m_PriorProbImageFileNames.size() != this->m_NumberOfClasses )
@@ -576,6 +589,7 @@ public:
         dilater->SetInput( maskGenerator->GetOutput() );
         std::cout << "Creating mask (this->m_MaskDilationRadius = "
           << this->m_MaskDilationRadius << ")..." << std::endl;
+        profiler->Observe( dilater );
         dilater->Update();
         voting->SetMaskImage( dilater->GetOutput() );
         std::cout << "Done creating mask." << std::endl;
@@ -612,6 +626,7 @@ public:
 
       /** Run!! */
       std::cout << "Performing VOTE algorithm..." << std::endl;
+      profiler->Observe( voting );
       voting->Update();
       std::cout << "Done performing VOTE algorithm." << std::endl;
 
@@ -681,6 +696,7 @@ public:
         {
           softWriter->SetInput( softSegmentationArray[ i ] );
           softWriter->SetUseCompression( this->m_UseCompression );
+          profiler->Observe( softWriter );
           softWriter->Update();
         }
       }
@@ -698,6 +714,7 @@ public:
         hardWriter->SetInput( hardSegmentation );
         hardWriter->SetUseCompression( this->m_UseCompression );
         std::cout << "Writing hard segmentation..." << std::endl;
+        profiler->Observe( hardWriter );
         hardWriter->Update();
         std::cout << "Done writing hard segmentation." << std::endl;
       }
@@ -714,6 +731,7 @@ public:
         confusionWriter->SetInput( confusionMatrixImage );
         confusionWriter->SetUseCompression( this->m_UseCompression );
         std::cout << "Writing confusion matrix image..." << std::endl;
+        profiler->Observe( confusionWriter );
         confusionWriter->Update();
         std::cout << "Done writing confusion matrix image..." << std::endl;
       }
@@ -275,6 +275,21 @@ namespace itk
 
     void PrintSelf(std::ostream&, Indent) const;
 
+    /** A label together with its number of votes, weighted by the observer
+     * trust. Per pixel at most numberOfInputs labels receive votes, so the
+     * votes are stored sparsely, sorted by label. */
+    struct LabelVoteType
+    {
+      InputPixelType m_Label;
+      WeightsType    m_Weight;
+    };
+
+    /** Determine the winning label from the sparse votes, with exactly the
+     * semantics of a scan over all m_NumberOfClasses (normalized) weights,
+     * including the tie-breaking by prior preference. */
+    virtual OutputPixelType SelectWinningLabel(
+      const LabelVoteType * votes, const unsigned int numberOfVotes ) const;
+
     /** The number of different labels found in the input segmentations */
     InputPixelType m_NumberOfClasses;
 
@@ -185,15 +185,74 @@ namespace itk
   } // end BeforeThreadedGenerateData
 
 
+  template< typename TInputImage, typename TOutputImage, typename TWeights >
+    typename LabelVoting2ImageFilter<TInputImage,TOutputImage, TWeights>::OutputPixelType
+    LabelVoting2ImageFilter< TInputImage, TOutputImage, TWeights >
+    ::SelectWinningLabel( const LabelVoteType * votes,
+    const unsigned int numberOfVotes ) const
+  {
+    /** Labels without votes have weight 0. As soon as some label has a
+     * positive weight, they can not win, and only the voted labels need
+     * to be inspected. The votes are sorted by label, so the scan visits
+     * them in the same order as a scan over all classes. */
+    OutputPixelType winningLabel = this->m_LeastPreferredLabel;
+    WeightsType winningLabelW = 0.0;
+    for( unsigned int v = 0; v < numberOfVotes; ++v )
+    {
+      const OutputPixelType ci = static_cast<OutputPixelType>( votes[ v ].m_Label );
+      const WeightsType w = votes[ v ].m_Weight;
+      if( w > winningLabelW )
+      {
+        winningLabelW = w;
+        winningLabel = ci;
+      }
+      else if( !( w < winningLabelW )
+        && this->m_PriorPreference[ ci ] < this->m_PriorPreference[ winningLabel ] )
+      {
+        winningLabel = ci;
+      }
+    }
+    if( winningLabelW > 0.0 ) return winningLabel;
+
+    /** No positive weights (e.g. zero or negative observer trust): the
+     * labels without votes take part in the tie-breaking, so scan all
+     * classes, merging in the sparse votes. */
+    winningLabel = this->m_LeastPreferredLabel;
+    winningLabelW = 0.0;
+    unsigned int v = 0;
+    for ( OutputPixelType ci = 0; ci < this->m_NumberOfClasses; ++ci )
+    {
+      WeightsType w = 0.0;
+      if( v < numberOfVotes
+        && static_cast<OutputPixelType>( votes[ v ].m_Label ) == ci )
+      {
+        w = votes[ v ].m_Weight;
+        ++v;
+      }
+      if( w > winningLabelW )
+      {
+        winningLabelW = w;
+        winningLabel = ci;
+      }
+      else if( !( w < winningLabelW )
+        && this->m_PriorPreference[ ci ] < this->m_PriorPreference[ winningLabel ] )
+      {
+        winningLabel = ci;
+      }
+    }
+
+    return winningLabel;
+  } // end SelectWinningLabel
+
+
   template< typename TInputImage, typename TOutputImage, typename TWeights >
     void
     LabelVoting2ImageFilter< TInputImage, TOutputImage, TWeights >
     ::ThreadedGenerateData( const OutputImageRegionType &outputRegionForThread,
     ThreadIdType threadId)
   {
-    typedef Array<WeightsType>                  WType;
     typedef std::vector<InputConstIteratorType> InputConstIteratorArrayType;
-    typedef std::vector<ProbIteratorType>       ProbIteratorArrayType;
+    typedef typename ProbabilityImageType::PixelType ProbabilityPixelType;
 
     typename TOutputImage::Pointer output = this->GetOutput();
     const bool generateProbSeg =
@@ -201,8 +260,20 @@ namespace itk
     const bool generateConfusionMatrix = this->GetGenerateConfusionMatrix();
     const unsigned int numberOfInputs = this->GetNumberOfInputs();
     const bool useMask = this->m_MaskImage.IsNotNull();
-    /** Votes by label, weighted by the observer trust */
-    WType W( this->m_NumberOfClasses );
+
+    /** The normalized weights are only needed for the probabilistic
+     * segmentations and the confusion matrix. Without observer trust all
+     * votes count 1, and normalization by the (positive) number of inputs
+     * does not change the winner, so it can be skipped. */
+    const bool normalize = generateProbSeg || generateConfusionMatrix
+      || this->m_HasObserverTrust;
+
+    /** Votes by label, weighted by the observer trust. Only the labels that
+     * actually receive a vote are stored, so the scratch space is bounded
+     * by the number of inputs instead of the number of classes. */
+    std::vector<LabelVoteType> voteBuffer( numberOfInputs > 0 ? numberOfInputs : 1 );
+    LabelVoteType * votes = &voteBuffer[ 0 ];
+    unsigned int numberOfVotes = 0;
 
     /** create and initialize all input image iterators */
     InputConstIteratorArrayType it(numberOfInputs);
@@ -212,15 +283,22 @@ namespace itk
         ( this->GetInput( k ), outputRegionForThread );
     }
 
-    /** Create and initialize the output probabilistic segmentation image iterators */
-    ProbIteratorArrayType psit;
+    /** The probabilistic segmentations are written sparsely: zero them
+     * here, and only write the labels that received votes. All of them
+     * share the region of the output. */
+    std::vector<ProbabilityPixelType *> psBuffers;
     if( generateProbSeg )
     {
-      psit = ProbIteratorArrayType( this->m_NumberOfClasses );
+      psBuffers.resize( this->m_NumberOfClasses );
       for( unsigned int k = 0; k < this->m_NumberOfClasses; ++k )
       {
-        psit[k] = ProbIteratorType(
+        ProbIteratorType psit(
           this->m_ProbabilisticSegmentationArray[k], outputRegionForThread );
+        for( psit.GoToBegin(); !psit.IsAtEnd(); ++psit )
+        {
+          psit.Set( NumericTraits<ProbabilityPixelType>::Zero );
+        }
+        psBuffers[k] = this->m_ProbabilisticSegmentationArray[k]->GetBufferPointer();
       }
     }
 
@@ -239,8 +317,8 @@ namespace itk
     /** Loop over the output pixels */
     for ( out.GoToBegin(); !out.IsAtEnd(); ++out )
     {
-      // reset number of votes per label for all labels
-      W.Fill(0.0);
+      // reset the votes
+      numberOfVotes = 0;
       OutputPixelType winningLabel = this->m_LeastPreferredLabel;
 
       bool insideMask = true;
@@ -252,7 +330,9 @@ namespace itk
         {
           insideMask = false;
           winningLabel = it[0].Get();
-          W[ winningLabel ] = 1.0;
+          votes[ 0 ].m_Label = it[0].Get();
+          votes[ 0 ].m_Weight = 1.0;
+          numberOfVotes = 1;
           /** Set the winning label to the output pixel */
           out.Set( winningLabel );
           /** move the it iterators */
@@ -267,54 +347,60 @@ namespace itk
       if(insideMask)
       {
 
-        // count number of votes for the labels
+        // count number of votes for the labels, keeping them sorted by label
         for( unsigned int i = 0; i < numberOfInputs; ++i )
         {
           const InputPixelType label = it[ i ].Get();
-          W[label] += this->m_ObserverTrust( i );
-        }
-
-        /** normalize: */
-        WeightsType sumW = W.sum();
-        if( sumW )
-        {
-          W /= sumW;
+          unsigned int v = 0;
+          while( v < numberOfVotes && votes[ v ].m_Label < label ) ++v;
+          if( v == numberOfVotes || votes[ v ].m_Label != label )
+          {
+            for( unsigned int j = numberOfVotes; j > v; --j )
+            {
+              votes[ j ] = votes[ j - 1 ];
+            }
+            votes[ v ].m_Label = label;
+            votes[ v ].m_Weight = 0.0;
+            ++numberOfVotes;
+          }
+          votes[ v ].m_Weight += this->m_ObserverTrust( i );
         }
 
-        /** now determine the label with the maximum W, i.e.,
-        * determine the label with the most votes for this pixel */
-        WeightsType winningLabelW = 0.0;
-        for ( OutputPixelType ci = 0; ci < this->m_NumberOfClasses; ++ci )
+        /** normalize: summing in label order gives the same sum as a
+         * sum over all classes */
+        if( normalize )
         {
-          if( W[ci] > winningLabelW )
+          WeightsType sumW = 0.0;
+          for( unsigned int v = 0; v < numberOfVotes; ++v )
           {
-            winningLabelW = W[ci];
-            winningLabel = ci;
+            sumW += votes[ v ].m_Weight;
           }
-          else
+          if( sumW )
           {
-            if( ! (W[ci] < winningLabelW ) )
+            for( unsigned int v = 0; v < numberOfVotes; ++v )
             {
-              if( this->m_PriorPreference[ci] < this->m_PriorPreference[winningLabel] )
-              {
-                winningLabel = ci;
-              }
+              votes[ v ].m_Weight /= sumW;
             }
           }
-        } // next ci
+        }
+
+        /** now determine the label with the maximum W, i.e.,
+        * determine the label with the most votes for this pixel */
+        winningLabel = this->SelectWinningLabel( votes, numberOfVotes );
 
         /** Set the winning label to the output pixel */
         out.Set( winningLabel );
 
-        /** Update the confusion matrix */
+        /** Update the confusion matrix; labels without votes add 0 */
         if( generateConfusionMatrix )
         {
           for( unsigned int i = 0; i < numberOfInputs; ++i )
           {
             const InputPixelType label = it[ i ].Get();
-            for ( OutputPixelType ci = 0; ci < this->m_NumberOfClasses; ++ci )
+            for( unsigned int v = 0; v < numberOfVotes; ++v )
             {
-              this->m_ConfusionMatrixArrays[threadId][ i ][label][ci] += W[ci];
+              this->m_ConfusionMatrixArrays[threadId][ i ][label][ votes[ v ].m_Label ]
+                += votes[ v ].m_Weight;
             }
           }
         } // end if generateConfusionMatrix
@@ -326,14 +412,14 @@ namespace itk
         }
       } // end if insideMask
 
-      /** copy the W values into the probabilistic segmentation images
-       * and move the psit iterators */
+      /** copy the nonzero W values into the probabilistic segmentation images */
       if( generateProbSeg )
       {
-        for ( OutputPixelType ci = 0; ci < this->m_NumberOfClasses; ++ci )
+        const OffsetValueType offset
+          = this->m_ProbabilisticSegmentationArray[0]->ComputeOffset( out.GetIndex() );
+        for( unsigned int v = 0; v < numberOfVotes; ++v )
         {
-          psit[ci].Set( W[ci] );
-          ++(psit[ci]);
+          psBuffers[ votes[ v ].m_Label ][ offset ] = votes[ v ].m_Weight;
         }
       } // end if generateProbSeg
 
@@ -19,6 +19,11 @@
 
 #include "itkImageIOFactory.h"
 
+#include <itksys/Glob.hxx>
+
+#include <algorithm>
+#include <fstream>
+
 
 namespace itktools
 {
@@ -314,4 +319,44 @@ bool NumberOfComponentsCheck( const unsigned int & numberOfComponents )
 } // end NumberOfComponentsCheck()
 
 
+/**
+ * ***************** ExpandImageFileNames ************************
+ */
+
+bool ExpandImageFileNames(
+  const std::vector<std::string> & patterns,
+  const std::string & listFileName,
+  std::vector<std::string> & fileNames )
+{
+  for( std::size_t i = 0; i < patterns.size(); ++i )
+  {
+    if( patterns[ i ].find_first_of( "*?[" ) == std::string::npos )
+    {
+      fileNames.push_back( patterns[ i ] );
+      continue;
+    }
+
+    itksys::Glob glob;
+    glob.FindFiles( patterns[ i ] );
+    std::vector<std::string> found = glob.GetFiles();
+    std::sort( found.begin(), found.end() );
+    fileNames.insert( fileNames.end(), found.begin(), found.end() );
+  }
+
+  if( listFileName.empty() ) return true;
+
+  std::ifstream list( listFileName.c_str() );
+  if( !list.is_open() ) return false;
+
+  std::string line;
+  while( std::getline( list, line ) )
+  {
+    if( !line.empty() && line[ line.size() - 1 ] == '\r' ) line.erase( line.size() - 1 );
+    if( !line.empty() ) fileNames.push_back( line );
+  }
+  return true;
+
+} // end ExpandImageFileNames()
+
+
 } // end itktools namespace
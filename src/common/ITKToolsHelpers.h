@@ -93,6 +93,18 @@ bool IsFilterSupportedCheck(
 /** NumberOfComponentsCheck. Unify error message printing. */
 bool NumberOfComponentsCheck( const unsigned int & numberOfComponents );
 
+/** Expand the input patterns into a list of file names. Patterns with
+ * wildcards (*, ?, [...]) are globbed; other patterns are taken as they are.
+ * If listFileName is not empty, the lines of that file are appended, one
+ * file name per line; empty lines are skipped.
+ *
+ * Returns false if the list file can not be read.
+ */
+bool ExpandImageFileNames(
+  const std::vector<std::string> & patterns,
+  const std::string & listFileName,
+  std::vector<std::string> & fileNames );
+
 } // end itktools namespace
 
 #endif // end #ifndef __ITKToolsHelpers_h_
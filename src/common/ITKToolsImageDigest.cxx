@@ -0,0 +1,276 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#include "ITKToolsImageDigest.h"
+
+#include "itkByteSwapper.h"
+#include "itkImageIOBase.h"
+#include "itkImageIOFactory.h"
+#include "itkMultiThreader.h"
+
+#include <itksys/MD5.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+
+namespace itktools
+{
+
+namespace
+{
+
+/** The number of bytes of pixel data per leaf of the hash tree. */
+const std::size_t LeafSize = 1 << 20;
+
+/** The number of bytes that is read at once, if the ImageIO can stream. */
+const std::size_t SlabSize = 64 << 20;
+
+/** The size of an MD5 digest. */
+const std::size_t DigestSize = 16;
+
+
+/** MD5 of a block of bytes. */
+void ComputeMD5( const unsigned char * data, std::size_t length, unsigned char * digest )
+{
+  itksysMD5 * md5 = itksysMD5_New();
+  itksysMD5_Initialize( md5 );
+  itksysMD5_Append( md5, data, static_cast<int>( length ) );
+  itksysMD5_Finalize( md5, digest );
+  itksysMD5_Delete( md5 );
+
+} // end ComputeMD5()
+
+
+/** The full leaves of a slab, hashed by the threads. */
+struct LeafBlock
+{
+  const unsigned char *   m_Data;
+  std::size_t             m_NumberOfLeaves;
+  unsigned char *         m_Digests;
+};
+
+
+/**
+ * ***************** HashLeavesThreaderCallback ************************
+ */
+
+ITK_THREAD_RETURN_TYPE HashLeavesThreaderCallback( void * arg )
+{
+  itk::MultiThreader::ThreadInfoStruct * info
+    = static_cast<itk::MultiThreader::ThreadInfoStruct *>( arg );
+  const LeafBlock * block = static_cast<const LeafBlock *>( info->UserData );
+
+  for( std::size_t i = info->ThreadID; i < block->m_NumberOfLeaves; i += info->NumberOfThreads )
+  {
+    ComputeMD5( block->m_Data + i * LeafSize, LeafSize, block->m_Digests + i * DigestSize );
+  }
+
+  return ITK_THREAD_RETURN_VALUE;
+
+} // end HashLeavesThreaderCallback()
+
+
+/** Swap the components of a buffer to little endian, on big endian systems. */
+void SwapToLittleEndian( unsigned char * data, std::size_t length, std::size_t componentSize )
+{
+  if( componentSize < 2 || !itk::ByteSwapper<int>::SystemIsBigEndian() ) return;
+
+  for( std::size_t i = 0; i + componentSize <= length; i += componentSize )
+  {
+    std::reverse( data + i, data + i + componentSize );
+  }
+
+} // end SwapToLittleEndian()
+
+
+/** The geometry part of the digest. The pixel type is left out: formats
+ * differ in how they label the same components, e.g. a PNG is read as RGB
+ * and its MetaImage conversion as VECTOR. */
+std::string GetGeometryString( const itk::ImageIOBase * imageIO )
+{
+  const unsigned int dimension = imageIO->GetNumberOfDimensions();
+
+  std::ostringstream stream;
+  stream << std::setprecision( 7 );
+  stream << "dimension " << dimension
+    << "\ncomponent type " << imageIO->GetComponentTypeAsString( imageIO->GetComponentType() )
+    << "\ncomponents " << imageIO->GetNumberOfComponents();
+  stream << "\nsize";
+  for( unsigned int i = 0; i < dimension; ++i ) stream << " " << imageIO->GetDimensions( i );
+  stream << "\nspacing";
+  for( unsigned int i = 0; i < dimension; ++i ) stream << " " << imageIO->GetSpacing( i );
+  stream << "\norigin";
+  for( unsigned int i = 0; i < dimension; ++i ) stream << " " << imageIO->GetOrigin( i );
+  stream << "\ndirection";
+  for( unsigned int i = 0; i < dimension; ++i )
+  {
+    const std::vector<double> direction = imageIO->GetDirection( i );
+    for( unsigned int j = 0; j < dimension; ++j )
+    {
+      /** Avoid printing -0. */
+      stream << " " << ( direction[ j ] == 0.0 ? 0.0 : direction[ j ] );
+    }
+  }
+  stream << "\n";
+  return stream.str();
+
+} // end GetGeometryString()
+
+
+} // end namespace anonymous
+
+
+/**
+ * ***************** ComputeImageDigest ************************
+ */
+
+bool ComputeImageDigest(
+  const std::string & fileName,
+  unsigned int numberOfThreads,
+  std::string & digest,
+  std::string & error )
+{
+  try
+  {
+    itk::ImageIOBase::Pointer imageIO = itk::ImageIOFactory::CreateImageIO(
+      fileName.c_str(), itk::ImageIOFactory::ReadMode );
+    if( imageIO.IsNull() )
+    {
+      error = "no ImageIO can read " + fileName;
+      return false;
+    }
+    imageIO->SetFileName( fileName.c_str() );
+    imageIO->ReadImageInformation();
+
+    const unsigned int dimension = imageIO->GetNumberOfDimensions();
+    const unsigned int lastAxis = dimension - 1;
+    const std::size_t componentSize = imageIO->GetComponentSize();
+
+    /** The size of a slice along the last axis, and the region of the image. */
+    itk::ImageIORegion largestRegion( dimension );
+    std::size_t sliceSize = componentSize * imageIO->GetNumberOfComponents();
+    for( unsigned int i = 0; i < dimension; ++i )
+    {
+      largestRegion.SetSize( i, imageIO->GetDimensions( i ) );
+      if( i != lastAxis ) sliceSize *= imageIO->GetDimensions( i );
+    }
+    const std::size_t numberOfSlices = imageIO->GetDimensions( lastAxis );
+
+    /** Read slabs of whole slices if the ImageIO can read exactly them, and
+     * otherwise the whole image at once.
+     */
+    std::size_t slicesPerSlab = std::max<std::size_t>( 1, SlabSize / std::max<std::size_t>( 1, sliceSize ) );
+    slicesPerSlab = std::min( slicesPerSlab, numberOfSlices );
+    imageIO->SetUseStreamedReading( imageIO->CanStreamRead() );
+    if( slicesPerSlab < numberOfSlices )
+    {
+      itk::ImageIORegion slab = largestRegion;
+      slab.SetSize( lastAxis, slicesPerSlab );
+      if( !imageIO->CanStreamRead()
+        || !( imageIO->GenerateStreamableReadRegionFromRequestedRegion( slab ) == slab ) )
+      {
+        slicesPerSlab = numberOfSlices;
+        imageIO->SetUseStreamedReading( false );
+      }
+    }
+
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    if( numberOfThreads > 0 ) threader->SetNumberOfThreads( numberOfThreads );
+
+    /** The leaves may span slabs; the bytes of an incomplete leaf are kept. */
+    std::vector<unsigned char> buffer;
+    std::vector<unsigned char> partialLeaf;
+    std::vector<unsigned char> leafDigests;
+    for( std::size_t first = 0; first < numberOfSlices; first += slicesPerSlab )
+    {
+      const std::size_t slices = std::min( slicesPerSlab, numberOfSlices - first );
+      itk::ImageIORegion slab = largestRegion;
+      slab.SetIndex( lastAxis, first );
+      slab.SetSize( lastAxis, slices );
+
+      buffer.resize( slices * sliceSize );
+      if( buffer.empty() ) break;
+      imageIO->SetIORegion( slab );
+      imageIO->Read( &buffer[ 0 ] );
+      SwapToLittleEndian( &buffer[ 0 ], buffer.size(), componentSize );
+
+      /** Complete the partial leaf of the previous slab. */
+      std::size_t offset = 0;
+      if( !partialLeaf.empty() )
+      {
+        offset = std::min( LeafSize - partialLeaf.size(), buffer.size() );
+        partialLeaf.insert( partialLeaf.end(), buffer.begin(), buffer.begin() + offset );
+        if( partialLeaf.size() < LeafSize ) continue;
+        leafDigests.resize( leafDigests.size() + DigestSize );
+        ComputeMD5( &partialLeaf[ 0 ], LeafSize, &leafDigests[ leafDigests.size() - DigestSize ] );
+        partialLeaf.clear();
+      }
+
+      /** Hash the full leaves in parallel. */
+      LeafBlock block;
+      block.m_Data = &buffer[ 0 ] + offset;
+      block.m_NumberOfLeaves = ( buffer.size() - offset ) / LeafSize;
+      if( block.m_NumberOfLeaves > 0 )
+      {
+        const std::size_t begin = leafDigests.size();
+        leafDigests.resize( begin + block.m_NumberOfLeaves * DigestSize );
+        block.m_Digests = &leafDigests[ begin ];
+        threader->SetSingleMethod( HashLeavesThreaderCallback, &block );
+        threader->SingleMethodExecute();
+      }
+
+      offset += block.m_NumberOfLeaves * LeafSize;
+      partialLeaf.assign( buffer.begin() + offset, buffer.end() );
+    }
+
+    /** The last leaf may be shorter. */
+    if( !partialLeaf.empty() )
+    {
+      leafDigests.resize( leafDigests.size() + DigestSize );
+      ComputeMD5( &partialLeaf[ 0 ], partialLeaf.size(), &leafDigests[ leafDigests.size() - DigestSize ] );
+    }
+
+    /** The root of the tree. */
+    const std::string geometry = GetGeometryString( imageIO );
+    char hex[ 32 ];
+    itksysMD5 * md5 = itksysMD5_New();
+    itksysMD5_Initialize( md5 );
+    itksysMD5_Append( md5, reinterpret_cast<const unsigned char *>( geometry.c_str() ),
+      static_cast<int>( geometry.size() ) );
+    if( !leafDigests.empty() )
+    {
+      itksysMD5_Append( md5, &leafDigests[ 0 ], static_cast<int>( leafDigests.size() ) );
+    }
+    itksysMD5_FinalizeHex( md5, hex );
+    itksysMD5_Delete( md5 );
+
+    digest.assign( hex, 32 );
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    error = excp.GetDescription();
+    return false;
+  }
+
+  return true;
+
+} // end ComputeImageDigest()
+
+} // end namespace itktools
@@ -0,0 +1,52 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __ITKToolsImageDigest_h_
+#define __ITKToolsImageDigest_h_
+
+#include <string>
+
+
+namespace itktools
+{
+
+/** Compute a content digest of an image file: a 32 character hexadecimal
+ * MD5 tree hash of the geometry and the decoded pixel data.
+ *
+ * The geometry part is the dimension, component type, number of components,
+ * size, and the spacing, origin and direction rounded to 7
+ * significant digits. The pixel data is hashed as little endian components
+ * of the stored component type, in leaves of 1 MiB; the digest is the MD5 of
+ * the geometry followed by the MD5's of the leaves. So two files have the
+ * same digest if they hold the same pixels and geometry, whatever the file
+ * format or compression.
+ *
+ * The pixel data is read in slabs of whole slices if the ImageIO can stream,
+ * and otherwise at once. The leaves of a slab are hashed by numberOfThreads
+ * threads (0 means the ITK default).
+ *
+ * Returns false, with a message in error, if the file can not be read.
+ */
+bool ComputeImageDigest(
+  const std::string & fileName,
+  unsigned int numberOfThreads,
+  std::string & digest,
+  std::string & error );
+
+} // end namespace itktools
+
+#endif // end #ifndef __ITKToolsImageDigest_h_
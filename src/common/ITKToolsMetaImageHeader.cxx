@@ -0,0 +1,216 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#include "ITKToolsMetaImageHeader.h"
+
+#include <itksys/SystemTools.hxx>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+
+namespace itktools
+{
+
+/**
+ * ***************** IsMetaImageHeaderFileName ************************
+ */
+
+bool IsMetaImageHeaderFileName( const std::string & fileName )
+{
+  const std::string extension = itksys::SystemTools::LowerCase(
+    itksys::SystemTools::GetFilenameLastExtension( fileName ) );
+  return extension == ".mhd";
+
+} // end IsMetaImageHeaderFileName()
+
+
+/**
+ * ***************** ReadMetaImageHeader ************************
+ */
+
+bool ReadMetaImageHeader(
+  const std::string & fileName,
+  MetaImageHeaderType & header )
+{
+  header.clear();
+  std::ifstream file( fileName.c_str() );
+  if( !file.is_open() ) return false;
+
+  const char * whiteSpace = " \t\r";
+  std::string line;
+  while( std::getline( file, line ) )
+  {
+    const std::string::size_type equal = line.find( '=' );
+    if( equal == std::string::npos ) continue;
+
+    std::string key = line.substr( 0, equal );
+    std::string value = line.substr( equal + 1 );
+    key.erase( key.find_last_not_of( whiteSpace ) + 1 );
+    key.erase( 0, key.find_first_not_of( whiteSpace ) );
+    value.erase( value.find_last_not_of( whiteSpace ) + 1 );
+    value.erase( 0, value.find_first_not_of( whiteSpace ) );
+    header.push_back( std::make_pair( key, value ) );
+
+    /** The data follows ElementDataFile = LOCAL, so it is the last field. */
+    if( key == "ElementDataFile" ) break;
+  }
+
+  return !header.empty();
+
+} // end ReadMetaImageHeader()
+
+
+/**
+ * ***************** GetMetaImageHeaderField ************************
+ */
+
+bool GetMetaImageHeaderField(
+  const MetaImageHeaderType & header,
+  const std::string & key,
+  std::string & value )
+{
+  for( std::size_t i = 0; i < header.size(); ++i )
+  {
+    if( header[ i ].first == key )
+    {
+      value = header[ i ].second;
+      return true;
+    }
+  }
+  return false;
+
+} // end GetMetaImageHeaderField()
+
+
+/**
+ * ***************** SetMetaImageHeaderField ************************
+ */
+
+void SetMetaImageHeaderField(
+  MetaImageHeaderType & header,
+  const std::string & key,
+  const std::string & value )
+{
+  for( std::size_t i = 0; i < header.size(); ++i )
+  {
+    if( header[ i ].first == key )
+    {
+      header[ i ].second = value;
+      return;
+    }
+  }
+
+  /** ElementDataFile has to stay the last field. */
+  std::size_t position = header.size();
+  if( position > 0 && header.back().first == "ElementDataFile" ) --position;
+  header.insert( header.begin() + position, std::make_pair( key, value ) );
+
+} // end SetMetaImageHeaderField()
+
+
+/**
+ * ***************** GetMetaImageDataFileName ************************
+ */
+
+std::string GetMetaImageDataFileName(
+  const std::string & headerFileName,
+  const MetaImageHeaderType & header )
+{
+  std::string dataFile;
+  if( !GetMetaImageHeaderField( header, "ElementDataFile", dataFile ) ) return "";
+  if( dataFile == "LOCAL" || dataFile.compare( 0, 4, "LIST" ) == 0
+    || dataFile.find( '%' ) != std::string::npos )
+  {
+    return "";
+  }
+
+  /** A relative data file is relative to the directory of the header. */
+  const std::string headerDirectory = itksys::SystemTools::GetFilenamePath(
+    itksys::SystemTools::CollapseFullPath( headerFileName ) );
+  return itksys::SystemTools::CollapseFullPath( dataFile, headerDirectory );
+
+} // end GetMetaImageDataFileName()
+
+
+/**
+ * ***************** WriteMetaImageHeader ************************
+ */
+
+bool WriteMetaImageHeader(
+  const std::string & fileName,
+  const MetaImageHeaderType & header )
+{
+  std::ostringstream contents;
+  for( std::size_t i = 0; i < header.size(); ++i )
+  {
+    contents << header[ i ].first << " = " << header[ i ].second << "\n";
+  }
+  return ReplaceFileAtomically( fileName, contents.str() );
+
+} // end WriteMetaImageHeader()
+
+
+/**
+ * ***************** ReplaceFileAtomically ************************
+ */
+
+bool ReplaceFileAtomically(
+  const std::string & fileName,
+  const std::string & contents )
+{
+  const std::string temporaryFileName = fileName + ".tmp";
+  {
+    std::ofstream file( temporaryFileName.c_str(), std::ios::binary );
+    if( !file.is_open() ) return false;
+    file.write( contents.data(), contents.size() );
+    file.close();
+    if( file.fail() )
+    {
+      itksys::SystemTools::RemoveFile( temporaryFileName.c_str() );
+      return false;
+    }
+  }
+
+  /** The new file gets the permissions of the file it replaces. */
+  mode_t mode = 0;
+  if( itksys::SystemTools::GetPermissions( fileName.c_str(), mode )
+    && !itksys::SystemTools::SetPermissions( temporaryFileName.c_str(), mode ) )
+  {
+    itksys::SystemTools::RemoveFile( temporaryFileName.c_str() );
+    return false;
+  }
+
+  /** rename() replaces the target atomically on POSIX systems; elsewhere the
+   * target has to be removed first.
+   */
+  if( std::rename( temporaryFileName.c_str(), fileName.c_str() ) != 0 )
+  {
+    itksys::SystemTools::RemoveFile( fileName.c_str() );
+    if( std::rename( temporaryFileName.c_str(), fileName.c_str() ) != 0 )
+    {
+      itksys::SystemTools::RemoveFile( temporaryFileName.c_str() );
+      return false;
+    }
+  }
+
+  return true;
+
+} // end ReplaceFileAtomically()
+
+} // end namespace itktools
@@ -0,0 +1,72 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __ITKToolsMetaImageHeader_h_
+#define __ITKToolsMetaImageHeader_h_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace itktools
+{
+
+/** The fields of a MetaImage header, in the order of the file. */
+typedef std::vector< std::pair<std::string, std::string> > MetaImageHeaderType;
+
+/** Whether a file name has the MetaImage header extension .mhd. */
+bool IsMetaImageHeaderFileName( const std::string & fileName );
+
+/** Read the "Key = Value" lines of a .mhd file. */
+bool ReadMetaImageHeader(
+  const std::string & fileName,
+  MetaImageHeaderType & header );
+
+/** Get/Set the value of a field; Set appends a field that does not exist. */
+bool GetMetaImageHeaderField(
+  const MetaImageHeaderType & header,
+  const std::string & key,
+  std::string & value );
+void SetMetaImageHeaderField(
+  MetaImageHeaderType & header,
+  const std::string & key,
+  const std::string & value );
+
+/** The full path of the single detached data file of a header, or an empty
+ * string if the data is LOCAL, a LIST or a file name pattern.
+ */
+std::string GetMetaImageDataFileName(
+  const std::string & headerFileName,
+  const MetaImageHeaderType & header );
+
+/** Write a header to fileName with ReplaceFileAtomically(). */
+bool WriteMetaImageHeader(
+  const std::string & fileName,
+  const MetaImageHeaderType & header );
+
+/** Write contents to a temporary file next to fileName, and rename it to
+ * fileName, so that readers see either the old or the new file. An
+ * existing fileName keeps its permissions.
+ */
+bool ReplaceFileAtomically(
+  const std::string & fileName,
+  const std::string & contents );
+
+} // end namespace itktools
+
+#endif // end #ifndef __ITKToolsMetaImageHeader_h_
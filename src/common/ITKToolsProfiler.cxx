@@ -0,0 +1,483 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#include "ITKToolsProfiler.h"
+
+#include "itkCommand.h"
+#include "itkMultiThreader.h"
+#include "itkRealTimeClock.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+#if defined( _WIN32 )
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+
+namespace itktools
+{
+
+namespace
+{
+
+/** Seconds since the epoch. */
+double GetWallTime( void )
+{
+  static itk::RealTimeClock::Pointer clock = itk::RealTimeClock::New();
+  return clock->GetTimeInSeconds();
+
+} // end GetWallTime()
+
+
+/** CPU time of all threads of this process, in seconds. */
+double GetCPUTime( void )
+{
+  return static_cast<double>( std::clock() ) / CLOCKS_PER_SEC;
+
+} // end GetCPUTime()
+
+
+/** The bytes this process read and wrote so far, from /proc/self/io. */
+void GetIOCounters( unsigned long long & bytesRead, unsigned long long & bytesWritten )
+{
+  bytesRead = bytesWritten = 0;
+#if defined( __linux__ )
+  std::ifstream io( "/proc/self/io" );
+  std::string key;
+  unsigned long long value = 0;
+  while( io >> key >> value )
+  {
+    if( key == "rchar:" ) bytesRead = value;
+    else if( key == "wchar:" ) bytesWritten = value;
+  }
+#endif
+} // end GetIOCounters()
+
+
+/** The peak resident set size of this process in bytes. */
+unsigned long long GetPeakMemory( void )
+{
+#if defined( __linux__ )
+  std::ifstream status( "/proc/self/status" );
+  std::string line;
+  while( std::getline( status, line ) )
+  {
+    if( line.compare( 0, 6, "VmHWM:" ) == 0 )
+    {
+      std::istringstream iss( line.substr( 6 ) );
+      unsigned long long kiloBytes = 0;
+      iss >> kiloBytes;
+      return kiloBytes * 1024;
+    }
+  }
+  return 0;
+#elif defined( _WIN32 )
+  PROCESS_MEMORY_COUNTERS counters;
+  if( GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) )
+  {
+    return static_cast<unsigned long long>( counters.PeakWorkingSetSize );
+  }
+  return 0;
+#else
+  struct rusage usage;
+  getrusage( RUSAGE_SELF, &usage );
+#if defined( __APPLE__ )
+  return static_cast<unsigned long long>( usage.ru_maxrss );
+#else
+  return static_cast<unsigned long long>( usage.ru_maxrss ) * 1024;
+#endif
+#endif
+} // end GetPeakMemory()
+
+
+/** Reset the peak resident set size, so that VmHWM is the peak of a stage.
+ * Only possible on Linux (>= 4.0).
+ */
+void ResetPeakMemory( void )
+{
+#if defined( __linux__ )
+  std::ofstream clearRefs( "/proc/self/clear_refs" );
+  if( clearRefs.is_open() ) clearRefs << "5";
+#endif
+} // end ResetPeakMemory()
+
+
+/** Escape a string for use in JSON. */
+std::string JSONEscape( const std::string & arg )
+{
+  std::string escaped;
+  for( std::string::size_type i = 0; i < arg.size(); ++i )
+  {
+    const char c = arg[ i ];
+    if( c == '"' || c == '\\' ) escaped += '\\';
+    if( c == '\n' ) { escaped += "\\n"; continue; }
+    escaped += c;
+  }
+  return escaped;
+
+} // end JSONEscape()
+
+
+/** Write the report when the program exits. */
+void WriteReportAtExit( void )
+{
+  Profiler * profiler = Profiler::GetInstance();
+  const std::string & fileName = profiler->GetReportFileName();
+  if( fileName.empty() )
+  {
+    profiler->WriteReport( std::cerr );
+    return;
+  }
+
+  std::ofstream report( fileName.c_str() );
+  if( !report.is_open() )
+  {
+    std::cerr << "ERROR: could not write the profile to " << fileName << std::endl;
+    return;
+  }
+  profiler->WriteReport( report );
+
+} // end WriteReportAtExit()
+
+
+/** \class ProfilerCommand
+ * Forwards the events of one process object to the profiler.
+ */
+
+class ProfilerCommand : public itk::Command
+{
+public:
+  typedef ProfilerCommand               Self;
+  typedef itk::Command                  Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  itkNewMacro( Self );
+
+  std::size_t m_Stage;
+
+  void Execute( itk::Object * caller, const itk::EventObject & event )
+  {
+    this->Execute( static_cast<const itk::Object *>( caller ), event );
+  }
+
+  void Execute( const itk::Object * caller, const itk::EventObject & event )
+  {
+    Profiler * profiler = Profiler::GetInstance();
+    if( itk::StartEvent().CheckEvent( &event ) )
+    {
+      profiler->StartStage( this->m_Stage,
+        dynamic_cast<const itk::ProcessObject *>( caller ) );
+    }
+    else if( itk::EndEvent().CheckEvent( &event ) )
+    {
+      profiler->EndStage( this->m_Stage );
+    }
+    else if( itk::ProgressEvent().CheckEvent( &event ) )
+    {
+      profiler->ProgressStage( this->m_Stage );
+    }
+    else if( itk::DeleteEvent().CheckEvent( &event ) )
+    {
+      profiler->ForgetObject( caller );
+    }
+  }
+
+protected:
+  ProfilerCommand() : m_Stage( 0 ) {};
+
+}; // end class ProfilerCommand
+
+} // end namespace
+
+
+/**
+ * ******************* GetInstance *******************
+ */
+
+Profiler *
+Profiler::GetInstance( void )
+{
+  static Profiler profiler;
+  return &profiler;
+
+} // end GetInstance()
+
+
+/**
+ * ******************* Constructor *******************
+ */
+
+Profiler::Profiler()
+{
+  this->m_Enabled = false;
+  this->m_StartTime = 0.0;
+  this->m_StartBytesRead = 0;
+  this->m_StartBytesWritten = 0;
+  this->m_PeakMemory = 0;
+
+} // end Constructor
+
+
+/**
+ * ******************* Enable *******************
+ */
+
+void
+Profiler::Enable( const std::string & programName, const std::string & reportFileName )
+{
+  if( this->m_Enabled ) return;
+
+  this->m_Enabled = true;
+  this->m_ProgramName = programName;
+  this->m_ReportFileName = reportFileName;
+  this->m_StartTime = GetWallTime();
+  GetIOCounters( this->m_StartBytesRead, this->m_StartBytesWritten );
+  std::atexit( WriteReportAtExit );
+
+} // end Enable()
+
+
+/**
+ * ******************* Observe *******************
+ */
+
+void
+Profiler::Observe( itk::ProcessObject * object )
+{
+  if( !this->m_Enabled || object == 0 ) return;
+  if( this->m_ObservedObjects.count( object ) != 0 ) return;
+
+  /** Name the stage after the class, numbered in order of registration. */
+  const std::string className = object->GetNameOfClass();
+  std::ostringstream name;
+  name << className << "#" << ++this->m_NumberOfStagesPerClass[ className ];
+
+  Stage stage;
+  stage.m_Name = name.str();
+  stage.m_NumberOfThreads = object->GetNumberOfThreads();
+  stage.m_NumberOfExecutions = 0;
+  stage.m_NumberOfProgressEvents = 0;
+  stage.m_WallTime = 0.0;
+  stage.m_BytesRead = 0;
+  stage.m_BytesWritten = 0;
+  stage.m_PeakMemory = 0;
+  stage.m_StartTime = 0.0;
+  stage.m_StartBytesRead = 0;
+  stage.m_StartBytesWritten = 0;
+  stage.m_InnerWallTime = 0.0;
+  stage.m_InnerBytesRead = 0;
+  stage.m_InnerBytesWritten = 0;
+  this->m_Stages.push_back( stage );
+  this->m_ObservedObjects[ object ] = this->m_Stages.size() - 1;
+
+  ProfilerCommand::Pointer command = ProfilerCommand::New();
+  command->m_Stage = this->m_Stages.size() - 1;
+  object->AddObserver( itk::StartEvent(), command );
+  object->AddObserver( itk::EndEvent(), command );
+  object->AddObserver( itk::ProgressEvent(), command );
+  object->AddObserver( itk::DeleteEvent(), command );
+
+} // end Observe()
+
+
+/**
+ * ******************* ObservePipeline *******************
+ */
+
+void
+Profiler::ObservePipeline( itk::ProcessObject * object )
+{
+  if( !this->m_Enabled ) return;
+
+  /** Walk upstream, visiting every process object once. */
+  std::set<itk::ProcessObject *> visited;
+  std::vector<itk::ProcessObject *> order;
+  std::vector<itk::ProcessObject *> toVisit( 1, object );
+  while( !toVisit.empty() )
+  {
+    itk::ProcessObject * current = toVisit.back();
+    toVisit.pop_back();
+    if( current == 0 || !visited.insert( current ).second ) continue;
+    order.push_back( current );
+
+    itk::ProcessObject::DataObjectPointerArray inputs = current->GetInputs();
+    for( std::size_t i = 0; i < inputs.size(); ++i )
+    {
+      if( inputs[ i ].IsNotNull() )
+      {
+        itk::ProcessObject * source = inputs[ i ]->GetSource();
+        toVisit.push_back( source );
+      }
+    }
+  }
+
+  /** Register the sources before their consumers. */
+  for( std::size_t i = order.size(); i > 0; --i )
+  {
+    this->Observe( order[ i - 1 ] );
+  }
+
+} // end ObservePipeline()
+
+
+/**
+ * ******************* StartStage *******************
+ */
+
+void
+Profiler::StartStage( std::size_t stageIndex, const itk::ProcessObject * object )
+{
+  Stage & stage = this->m_Stages[ stageIndex ];
+  if( object ) stage.m_NumberOfThreads = object->GetNumberOfThreads();
+  stage.m_StartTime = GetWallTime();
+  GetIOCounters( stage.m_StartBytesRead, stage.m_StartBytesWritten );
+  stage.m_InnerWallTime = 0.0;
+  stage.m_InnerBytesRead = 0;
+  stage.m_InnerBytesWritten = 0;
+
+  /** Keep the peak so far, before the peak is reset for this stage. */
+  const unsigned long long peak = GetPeakMemory();
+  this->m_PeakMemory = std::max( this->m_PeakMemory, peak );
+  for( std::size_t i = 0; i < this->m_ActiveStages.size(); ++i )
+  {
+    Stage & outer = this->m_Stages[ this->m_ActiveStages[ i ] ];
+    outer.m_PeakMemory = std::max( outer.m_PeakMemory, peak );
+  }
+  ResetPeakMemory();
+
+  this->m_ActiveStages.push_back( stageIndex );
+
+} // end StartStage()
+
+
+/**
+ * ******************* EndStage *******************
+ */
+
+void
+Profiler::EndStage( std::size_t stageIndex )
+{
+  /** Ignore an end without a start, e.g. after an exception. */
+  std::vector<std::size_t>::iterator active = std::find(
+    this->m_ActiveStages.begin(), this->m_ActiveStages.end(), stageIndex );
+  if( active == this->m_ActiveStages.end() ) return;
+  this->m_ActiveStages.erase( active, this->m_ActiveStages.end() );
+
+  Stage & stage = this->m_Stages[ stageIndex ];
+  unsigned long long bytesRead, bytesWritten;
+  GetIOCounters( bytesRead, bytesWritten );
+  const double wallTime = GetWallTime() - stage.m_StartTime;
+  const unsigned long long read = bytesRead - stage.m_StartBytesRead;
+  const unsigned long long written = bytesWritten - stage.m_StartBytesWritten;
+  const unsigned long long peak = GetPeakMemory();
+
+  stage.m_NumberOfExecutions++;
+  stage.m_WallTime += std::max( 0.0, wallTime - stage.m_InnerWallTime );
+  stage.m_BytesRead += read - std::min( read, stage.m_InnerBytesRead );
+  stage.m_BytesWritten += written - std::min( written, stage.m_InnerBytesWritten );
+  stage.m_PeakMemory = std::max( stage.m_PeakMemory, peak );
+  this->m_PeakMemory = std::max( this->m_PeakMemory, peak );
+
+  /** Do not count this stage for the one that updated it. */
+  if( !this->m_ActiveStages.empty() )
+  {
+    Stage & outer = this->m_Stages[ this->m_ActiveStages.back() ];
+    outer.m_InnerWallTime += wallTime;
+    outer.m_InnerBytesRead += read;
+    outer.m_InnerBytesWritten += written;
+    outer.m_PeakMemory = std::max( outer.m_PeakMemory, peak );
+  }
+
+} // end EndStage()
+
+
+/**
+ * ******************* ProgressStage *******************
+ */
+
+void
+Profiler::ProgressStage( std::size_t stageIndex )
+{
+  this->m_Stages[ stageIndex ].m_NumberOfProgressEvents++;
+
+} // end ProgressStage()
+
+
+/**
+ * ******************* ForgetObject *******************
+ */
+
+void
+Profiler::ForgetObject( const itk::Object * object )
+{
+  /** A new object at the same address is a new stage. */
+  this->m_ObservedObjects.erase( object );
+
+} // end ForgetObject()
+
+
+/**
+ * ******************* WriteReport *******************
+ */
+
+void
+Profiler::WriteReport( std::ostream & os ) const
+{
+  unsigned long long bytesRead, bytesWritten;
+  GetIOCounters( bytesRead, bytesWritten );
+  const unsigned long long peak = std::max( this->m_PeakMemory, GetPeakMemory() );
+
+  os << std::setprecision( 6 ) << std::fixed;
+  os << "{\n"
+    << "  \"program\": \"" << JSONEscape( this->m_ProgramName ) << "\",\n"
+    << "  \"wallTime\": " << GetWallTime() - this->m_StartTime << ",\n"
+    << "  \"cpuTime\": " << GetCPUTime() << ",\n"
+    << "  \"peakMemory\": " << peak << ",\n"
+    << "  \"bytesRead\": " << bytesRead - this->m_StartBytesRead << ",\n"
+    << "  \"bytesWritten\": " << bytesWritten - this->m_StartBytesWritten << ",\n"
+    << "  \"defaultNumberOfThreads\": "
+    << itk::MultiThreader::GetGlobalDefaultNumberOfThreads() << ",\n"
+    << "  \"stages\": [";
+
+  for( std::size_t i = 0; i < this->m_Stages.size(); ++i )
+  {
+    const Stage & stage = this->m_Stages[ i ];
+    os << ( i == 0 ? "\n" : ",\n" )
+      << "    { \"name\": \"" << JSONEscape( stage.m_Name ) << "\""
+      << ", \"executions\": " << stage.m_NumberOfExecutions
+      << ", \"wallTime\": " << stage.m_WallTime
+      << ", \"bytesRead\": " << stage.m_BytesRead
+      << ", \"bytesWritten\": " << stage.m_BytesWritten
+      << ", \"peakMemory\": " << stage.m_PeakMemory
+      << ", \"threads\": " << stage.m_NumberOfThreads
+      << ", \"progressEvents\": " << stage.m_NumberOfProgressEvents
+      << " }";
+  }
+  os << ( this->m_Stages.empty() ? "]\n" : "\n  ]\n" ) << "}" << std::endl;
+
+} // end WriteReport()
+
+} // end namespace itktools
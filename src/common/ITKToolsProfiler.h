@@ -0,0 +1,124 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __ITKToolsProfiler_h_
+#define __ITKToolsProfiler_h_
+
+#include "itkProcessObject.h"
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace itktools
+{
+
+/** \class Profiler
+ * \brief Collects where the time of a tool goes, for the -profile option.
+ *
+ * The itk::CommandLineArgumentParser enables the profiler when the -profile
+ * argument is given, optionally with a file name. At exit a JSON report is
+ * then written to that file, or to std::cerr: the total wall time, CPU time,
+ * peak memory, bytes read and written and the default number of threads,
+ * followed by the same per stage.
+ *
+ * A stage is a process object (reader, filter or writer) that a tool hands
+ * to Observe() or ObservePipeline(). Start, End and Progress observers time
+ * every execution of the object. The times are exclusive: when a stage
+ * updates another one while it executes, like a streaming writer does with
+ * its input, the time of the inner stage is not counted for the outer one.
+ * The same holds for the bytes read and written, which are the I/O of the
+ * whole process during the stage and only measured on Linux. The peak
+ * memory of a stage is the peak of the process during the stage; it is only
+ * per stage on Linux, elsewhere it is the peak since the start of the process.
+ *
+ * When the profiler is not enabled, Observe() and ObservePipeline() do
+ * nothing, so tools can call them unconditionally.
+ */
+
+class Profiler
+{
+public:
+  /** The profiler of this process. */
+  static Profiler * GetInstance( void );
+
+  /** Enable the profiler; the report is written at exit. */
+  void Enable( const std::string & programName, const std::string & reportFileName );
+  bool IsEnabled( void ) const { return this->m_Enabled; }
+  const std::string & GetReportFileName( void ) const { return this->m_ReportFileName; }
+
+  /** Time the executions of a process object. */
+  void Observe( itk::ProcessObject * object );
+
+  /** Observe a process object and all objects upstream of it. */
+  void ObservePipeline( itk::ProcessObject * object );
+
+  /** Write the JSON report. */
+  void WriteReport( std::ostream & os ) const;
+
+  /** The measurements of one stage. */
+  struct Stage
+  {
+    std::string         m_Name;
+    unsigned int        m_NumberOfThreads;
+    unsigned long       m_NumberOfExecutions;
+    unsigned long       m_NumberOfProgressEvents;
+    double              m_WallTime;
+    unsigned long long  m_BytesRead;
+    unsigned long long  m_BytesWritten;
+    unsigned long long  m_PeakMemory;
+
+    /** The values at the StartEvent of the current execution, and the
+     * amounts spent in the stages it updated since.
+     */
+    double              m_StartTime;
+    unsigned long long  m_StartBytesRead;
+    unsigned long long  m_StartBytesWritten;
+    double              m_InnerWallTime;
+    unsigned long long  m_InnerBytesRead;
+    unsigned long long  m_InnerBytesWritten;
+  };
+
+  /** Called by the observers. */
+  void StartStage( std::size_t stage, const itk::ProcessObject * object );
+  void EndStage( std::size_t stage );
+  void ProgressStage( std::size_t stage );
+  void ForgetObject( const itk::Object * object );
+
+private:
+  Profiler();
+
+  bool                                      m_Enabled;
+  std::string                               m_ProgramName;
+  std::string                               m_ReportFileName;
+  double                                    m_StartTime;
+  unsigned long long                        m_StartBytesRead;
+  unsigned long long                        m_StartBytesWritten;
+  unsigned long long                        m_PeakMemory;
+  std::vector<Stage>                        m_Stages;
+  std::vector<std::size_t>                  m_ActiveStages;
+  std::map<const itk::Object *, std::size_t>  m_ObservedObjects;
+  std::map<std::string, unsigned int>       m_NumberOfStagesPerClass;
+
+}; // end class Profiler
+
+} // end namespace itktools
+
+#endif // end #ifndef __ITKToolsProfiler_h_
@@ -19,6 +19,7 @@
 #define __itkCommandLineArgumentParser_cxx_
 
 #include "itkCommandLineArgumentParser.h"
+#include "ITKToolsProfiler.h"
 
 #include <limits>
 
@@ -309,6 +310,15 @@ CommandLineArgumentParser
 
   if( !allRequiredArgumentsSpecified ) return FAILED;
 
+  /** Profile the run if asked for; without a file the report goes to std::cerr. */
+  if( this->ArgumentExists( "-profile" ) )
+  {
+    std::vector<std::string> reportFileName;
+    this->GetCommandLineArgument( "-profile", reportFileName );
+    itktools::Profiler::GetInstance()->Enable( this->m_Argv[ 0 ],
+      reportFileName.empty() ? std::string( "" ) : reportFileName[ 0 ] );
+  }
+
   return PASSED;
 
 } // end CheckForRequiredArguments()
@@ -74,6 +74,10 @@ namespace itk
  * We make use of the casting functionality of string streams to
  * automatically cast the stored string to the requested type.
  *
+ * The argument "-profile [file]" is understood by all programs: if
+ * CheckForRequiredArguments() passes, it enables the itktools::Profiler,
+ * which writes a JSON report of the run at exit.
+ *
  */
 
 class CommandLineArgumentParser :
@@ -0,0 +1,127 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkComponentInterleaveImageFilter_h_
+#define __itkComponentInterleaveImageFilter_h_
+
+#include "itkImageToImageFilter.h"
+
+#include <utility>
+#include <vector>
+
+
+namespace itk
+{
+
+/** \class ComponentInterleaveImageFilter
+ * \brief Composes a vector image from selected components of one or more
+ * vector images, directly on the image buffers.
+ *
+ * Every output component is a (input number, component number) pair. If no
+ * components are selected, all components of all inputs are taken, in
+ * order. This replaces a chain of itk::VectorIndexSelectionCastImageFilter's
+ * followed by an itk::ComposeImageFilter: the components are copied with
+ * strides from the input buffers into the interleaved output buffer, in one
+ * threaded pass and without temporary scalar images.
+ *
+ * The inputs only need to provide the output requested region, so in a
+ * streaming pipeline the memory is bounded by one slab of every input and
+ * of the output.
+ *
+ * \ingroup IntensityImageFilters Multithreaded Streamed
+ */
+template <class TInputImage, class TOutputImage = TInputImage>
+class ComponentInterleaveImageFilter:
+    public ImageToImageFilter<TInputImage,TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ComponentInterleaveImageFilter                Self;
+  typedef ImageToImageFilter<TInputImage,TOutputImage>  Superclass;
+  typedef SmartPointer<Self>                            Pointer;
+  typedef SmartPointer<const Self>                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( ComponentInterleaveImageFilter, ImageToImageFilter );
+
+  /** Typedef to describe the input/output image types. */
+  typedef TInputImage                                   InputImageType;
+  typedef TOutputImage                                  OutputImageType;
+  typedef typename InputImageType::InternalPixelType    InputComponentType;
+  typedef typename OutputImageType::InternalPixelType   OutputComponentType;
+  typedef typename OutputImageType::RegionType          OutputImageRegionType;
+
+  /** A component: the input number and the component number. */
+  typedef std::pair<unsigned int, unsigned int>         ComponentType;
+  typedef std::vector<ComponentType>                    ComponentsType;
+
+  /** Append a component of input inputNumber to the output components. */
+  void AddComponent( unsigned int inputNumber, unsigned int component )
+  {
+    this->m_Components.push_back( ComponentType( inputNumber, component ) );
+    this->Modified();
+  }
+
+  /** Set/Get the selected components. Empty means all. */
+  void SetComponents( const ComponentsType & components )
+  {
+    this->m_Components = components;
+    this->Modified();
+  }
+  const ComponentsType & GetComponents( void ) const { return this->m_Components; }
+
+protected:
+  ComponentInterleaveImageFilter();
+  ~ComponentInterleaveImageFilter() {};
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** Set the number of output components and check the selection. */
+  virtual void GenerateOutputInformation( void );
+
+  /** Fill in the selection, if it is empty. */
+  virtual void BeforeThreadedGenerateData( void );
+
+  /** Copy the components of the region of this thread. */
+  virtual void ThreadedGenerateData(
+    const OutputImageRegionType & outputRegionForThread,
+    ThreadIdType threadId );
+
+  /** The selection, or all components if the selection is empty. */
+  ComponentsType GetSelectedComponents( void ) const;
+
+private:
+  ComponentInterleaveImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  ComponentsType  m_Components;
+
+  /** The components that are copied by the threads. */
+  ComponentsType  m_SelectedComponents;
+
+}; // end class ComponentInterleaveImageFilter
+
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkComponentInterleaveImageFilter.hxx"
+#endif
+
+#endif // end #ifndef __itkComponentInterleaveImageFilter_h_
@@ -0,0 +1,193 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef _itkComponentInterleaveImageFilter_hxx_
+#define _itkComponentInterleaveImageFilter_hxx_
+
+#include "itkComponentInterleaveImageFilter.h"
+
+#include "itkProgressReporter.h"
+
+
+namespace itk {
+
+template<class TInputImage, class TOutputImage>
+ComponentInterleaveImageFilter<TInputImage,TOutputImage>
+::ComponentInterleaveImageFilter()
+{
+  this->SetNumberOfRequiredInputs( 1 );
+}
+
+
+template<class TInputImage, class TOutputImage>
+typename ComponentInterleaveImageFilter<TInputImage,TOutputImage>::ComponentsType
+ComponentInterleaveImageFilter<TInputImage,TOutputImage>
+::GetSelectedComponents( void ) const
+{
+  if( !this->m_Components.empty() ) return this->m_Components;
+
+  ComponentsType components;
+  for( unsigned int i = 0; i < this->GetNumberOfInputs(); ++i )
+  {
+    const InputImageType * input = this->GetInput( i );
+    if( !input ) continue;
+    for( unsigned int c = 0; c < input->GetNumberOfComponentsPerPixel(); ++c )
+    {
+      components.push_back( ComponentType( i, c ) );
+    }
+  }
+  return components;
+
+} // end GetSelectedComponents()
+
+
+template<class TInputImage, class TOutputImage>
+void
+ComponentInterleaveImageFilter<TInputImage,TOutputImage>
+::GenerateOutputInformation( void )
+{
+  Superclass::GenerateOutputInformation();
+
+  const ComponentsType components = this->GetSelectedComponents();
+  if( components.empty() )
+  {
+    itkExceptionMacro( << "No components are selected." );
+  }
+
+  for( std::size_t i = 0; i < components.size(); ++i )
+  {
+    const InputImageType * input = this->GetInput( components[ i ].first );
+    if( !input )
+    {
+      itkExceptionMacro( << "Input " << components[ i ].first << " is not set." );
+    }
+    if( components[ i ].second >= input->GetNumberOfComponentsPerPixel() )
+    {
+      itkExceptionMacro( << "Component " << components[ i ].second
+        << " is selected, but input " << components[ i ].first
+        << " only has " << input->GetNumberOfComponentsPerPixel()
+        << " components." );
+    }
+  }
+
+  this->GetOutput()->SetNumberOfComponentsPerPixel( components.size() );
+
+} // end GenerateOutputInformation()
+
+
+template<class TInputImage, class TOutputImage>
+void
+ComponentInterleaveImageFilter<TInputImage,TOutputImage>
+::BeforeThreadedGenerateData( void )
+{
+  this->m_SelectedComponents = this->GetSelectedComponents();
+
+} // end BeforeThreadedGenerateData()
+
+
+template<class TInputImage, class TOutputImage>
+void
+ComponentInterleaveImageFilter<TInputImage,TOutputImage>
+::ThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread,
+  ThreadIdType threadId )
+{
+  typedef typename OutputImageType::IndexType   IndexType;
+  typedef typename OutputImageType::SizeType    SizeType;
+  const unsigned int dimension = OutputImageType::ImageDimension;
+
+  const std::size_t numberOfPixels = outputRegionForThread.GetNumberOfPixels();
+  if( numberOfPixels == 0 ) return;
+
+  OutputImageType * output = this->GetOutput();
+  const ComponentsType & components = this->m_SelectedComponents;
+  const std::size_t numberOfOutputComponents = components.size();
+
+  /** The inputs and their vector lengths, per output component. */
+  std::vector<const InputImageType *> inputs( numberOfOutputComponents );
+  std::vector<std::size_t> strides( numberOfOutputComponents );
+  for( std::size_t j = 0; j < numberOfOutputComponents; ++j )
+  {
+    inputs[ j ] = this->GetInput( components[ j ].first );
+    strides[ j ] = inputs[ j ]->GetNumberOfComponentsPerPixel();
+  }
+  std::vector<const InputComponentType *> in( numberOfOutputComponents );
+
+  /** Walk the region row by row. The inputs may have larger buffers than the
+   * output, so the start of a row is computed per input.
+   */
+  const SizeType size = outputRegionForThread.GetSize();
+  const std::size_t rowLength = size[ 0 ];
+  const std::size_t numberOfRows = numberOfPixels / rowLength;
+
+  ProgressReporter progress( this, threadId, numberOfRows );
+
+  const IndexType regionIndex = outputRegionForThread.GetIndex();
+  IndexType index = regionIndex;
+  for( std::size_t row = 0; row < numberOfRows; ++row )
+  {
+    for( std::size_t j = 0; j < numberOfOutputComponents; ++j )
+    {
+      in[ j ] = inputs[ j ]->GetBufferPointer()
+        + inputs[ j ]->ComputeOffset( index ) * strides[ j ]
+        + components[ j ].second;
+    }
+    OutputComponentType * out = output->GetBufferPointer()
+      + output->ComputeOffset( index ) * numberOfOutputComponents;
+
+    /** Write the output interleaved, reading the inputs with strides. */
+    for( std::size_t x = 0; x < rowLength; ++x )
+    {
+      for( std::size_t j = 0; j < numberOfOutputComponents; ++j )
+      {
+        *out++ = static_cast<OutputComponentType>( in[ j ][ x * strides[ j ] ] );
+      }
+    }
+    progress.CompletedPixel();
+
+    /** The start of the next row. */
+    for( unsigned int d = 1; d < dimension; ++d )
+    {
+      if( ++index[ d ] < regionIndex[ d ] + static_cast<IndexValueType>( size[ d ] ) ) break;
+      index[ d ] = regionIndex[ d ];
+    }
+  } // end for rows
+
+} // end ThreadedGenerateData()
+
+
+template<class TInputImage, class TOutputImage>
+void
+ComponentInterleaveImageFilter<TInputImage,TOutputImage>
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "Components:";
+  for( std::size_t i = 0; i < this->m_Components.size(); ++i )
+  {
+    os << " (" << this->m_Components[ i ].first
+      << ", " << this->m_Components[ i ].second << ")";
+  }
+  os << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef _itkComponentInterleaveImageFilter_hxx_
@@ -0,0 +1,118 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkStageMultiThreader_h
+#define __itkStageMultiThreader_h
+
+#include "itkMultiThreader.h"
+#include "itkIntTypes.h"
+
+namespace itk
+{
+
+/** \class StageMultiThreader
+ * \brief Runs one stage of a multi-threaded computation on all threads.
+ *
+ * Filters that need several parallel passes over their data, e.g. a
+ * minimum and maximum pass before a histogram pass, implement each pass
+ * as a member function
+ *
+ *   void Stage( ThreadIdType threadId, ThreadIdType numberOfThreads );
+ *
+ * and run it with Execute(), instead of each writing its own static
+ * threader callback and stage switch. A stage obtains its part of the
+ * work with SplitRange() or SplitRegion().
+ *
+ * \ingroup Multithreaded
+ */
+template <class TOwner>
+class StageMultiThreader
+{
+public:
+  /** A stage is a member function of the owner. */
+  typedef void ( TOwner::*StageMethodType )( ThreadIdType, ThreadIdType );
+
+  /** Run stage on numberOfThreads threads and wait until all finish. */
+  static void Execute( MultiThreader * threader, ThreadIdType numberOfThreads,
+    TOwner * owner, StageMethodType stage )
+  {
+    StageJob job;
+    job.Owner = owner;
+    job.Stage = stage;
+
+    threader->SetNumberOfThreads( numberOfThreads );
+    threader->SetSingleMethod( ThreaderCallback, &job );
+    threader->SingleMethodExecute();
+  }
+
+  /** The part [first, last) of the range [0, size) of a thread. */
+  static void SplitRange( SizeValueType size,
+    ThreadIdType threadId, ThreadIdType numberOfThreads,
+    SizeValueType & first, SizeValueType & last )
+  {
+    first = ( size * threadId ) / numberOfThreads;
+    last = ( size * ( threadId + 1 ) ) / numberOfThreads;
+  }
+
+  /** The part of region of a thread, split along its outermost dimension
+   * of size > 1. Returns false if the part is empty. */
+  template <class TRegion>
+  static bool SplitRegion( const TRegion & region,
+    ThreadIdType threadId, ThreadIdType numberOfThreads,
+    TRegion & threadRegion )
+  {
+    threadRegion = region;
+    unsigned int splitAxis = TRegion::ImageDimension - 1;
+    while( splitAxis > 0 && region.GetSize( splitAxis ) == 1 )
+    {
+      --splitAxis;
+    }
+
+    SizeValueType first = 0;
+    SizeValueType last = 0;
+    SplitRange( region.GetSize( splitAxis ), threadId, numberOfThreads, first, last );
+    threadRegion.SetIndex( splitAxis, region.GetIndex( splitAxis ) + first );
+    threadRegion.SetSize( splitAxis, last - first );
+
+    return last > first;
+  }
+
+private:
+  /** What the threads run. */
+  struct StageJob
+  {
+    TOwner *        Owner;
+    StageMethodType Stage;
+  };
+
+  /** Static function used as a "callback" by the MultiThreader. */
+  static ITK_THREAD_RETURN_TYPE ThreaderCallback( void * arg )
+  {
+    typedef MultiThreader::ThreadInfoStruct ThreadInfoType;
+    ThreadInfoType * info = static_cast<ThreadInfoType *>( arg );
+    StageJob * job = static_cast<StageJob *>( info->UserData );
+
+    ( job->Owner->*( job->Stage ) )( info->ThreadID, info->NumberOfThreads );
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+}; // end class StageMultiThreader
+
+} // end namespace itk
+
+#endif
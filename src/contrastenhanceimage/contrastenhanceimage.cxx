@@ -52,7 +52,15 @@ std::string GetHelpString( void )
     << "-r0    \tInteger radius of window, dimension 0\n"
     << "-r1    \tInteger radius of window, dimension 1\n"
     << "[-r2]  \tInteger radius of window, dimension 2\n"
-    << "[-LUT] \tUse Lookup-table <true, false>;\n"
+    << "[-m]   \tMethod, choose one of {ITK, sliding}; default = ITK.\n"
+    << "sliding: a multithreaded implementation that updates the local\n"
+    << "histogram incrementally while the window slides over the image.\n"
+    << "ITK: the original AdaptiveHistogramEqualizationImageFilter.\n"
+    << "[-bins]\tMaximum number of histogram bins, sliding method only;\n"
+    << "default = 1024, at most 4096. Integer images get one bin per\n"
+    << "intensity value up to this maximum, in which case both methods give\n"
+    << "the same result.\n"
+    << "[-LUT] \tUse Lookup-table <true, false>, ITK method only;\n"
     << "default = true; Faster, but requires more memory.";
 
   return ss.str();
@@ -105,6 +113,24 @@ int main( int argc, char** argv )
   std::vector<unsigned int> radius;
   parser->GetCommandLineArgument( "-r", radius );
 
+  std::string method = "ITK";
+  parser->GetCommandLineArgument( "-m", method );
+
+  unsigned int numberOfBins = 1024;
+  parser->GetCommandLineArgument( "-bins", numberOfBins );
+
+  /** Check method. */
+  if( method != "sliding" && method != "ITK" )
+  {
+    std::cerr << "ERROR: method should be one of {sliding, ITK}." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( numberOfBins == 0 || numberOfBins > 4096 )
+  {
+    std::cerr << "ERROR: the number of bins should be between 1 and 4096." << std::endl;
+    return EXIT_FAILURE;
+  }
+
   /** Determine image properties. */
   itk::ImageIOBase::IOPixelType pixelType = itk::ImageIOBase::UNKNOWNPIXELTYPE;
   itk::ImageIOBase::IOComponentType componentType = itk::ImageIOBase::UNKNOWNCOMPONENTTYPE;
@@ -140,6 +166,8 @@ int main( int argc, char** argv )
     filter->m_Beta = beta;
     filter->m_LookUpTable = lookUpTable;
     filter->m_Radius = radius;
+    filter->m_Method = method;
+    filter->m_NumberOfBins = numberOfBins;
 
     filter->Run();
 
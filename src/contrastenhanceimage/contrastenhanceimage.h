@@ -28,6 +28,7 @@
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
 #include "itkAdaptiveHistogramEqualizationImageFilter.h"
+#include "itkSlidingHistogramEqualizationImageFilter.h"
 
 
 /** \class ITKToolsContrastEnhanceImageBase
@@ -47,6 +48,8 @@ public:
     this->m_InputFileName = "";
     this->m_OutputFileName = "";
     this->m_LookUpTable = false;
+    this->m_Method = "ITK";
+    this->m_NumberOfBins = 1024;
   };
   /** Destructor. */
   ~ITKToolsContrastEnhanceImageBase(){};
@@ -58,6 +61,8 @@ public:
   float m_Beta;
   bool m_LookUpTable;
   std::vector<unsigned int> m_Radius;
+  std::string m_Method;
+  unsigned int m_NumberOfBins;
 
 }; // end class ITKToolsContrastEnhanceImageBase
 
@@ -86,8 +91,9 @@ public:
     typedef itk::ImageFileReader<ImageType>       ReaderType;
     typedef itk::AdaptiveHistogramEqualizationImageFilter<
       ImageType >                                 EnhancerType;
+    typedef itk::SlidingHistogramEqualizationImageFilter<
+      ImageType >                                 SlidingEnhancerType;
     typedef itk::ImageFileWriter<ImageType>       WriterType;
-    typedef typename EnhancerType::ImageSizeType  RadiusType;
 
     /** vars */
     itk::Size<VDimension> radiusSize;
@@ -102,17 +108,33 @@ public:
     reader->Update();
 
     /** Setup pipeline and configure its components */
-    typename EnhancerType::Pointer enhancer = EnhancerType::New();
-    enhancer->SetUseLookupTable( this->m_LookUpTable );
-    enhancer->SetAlpha( this->m_Alpha );
-    enhancer->SetBeta( this->m_Beta );
-    enhancer->SetRadius( radiusSize );
-    enhancer->SetInput( reader->GetOutput() );
-
     typename WriterType::Pointer writer = WriterType::New();
-    writer->SetInput( enhancer->GetOutput() );
     writer->SetFileName( this->m_OutputFileName.c_str() );
-    writer->Update();
+
+    if( this->m_Method == "sliding" )
+    {
+      typename SlidingEnhancerType::Pointer enhancer = SlidingEnhancerType::New();
+      enhancer->SetAlpha( this->m_Alpha );
+      enhancer->SetBeta( this->m_Beta );
+      enhancer->SetRadius( radiusSize );
+      enhancer->SetMaximumNumberOfBins( this->m_NumberOfBins );
+      enhancer->SetInput( reader->GetOutput() );
+
+      writer->SetInput( enhancer->GetOutput() );
+      writer->Update();
+    }
+    else
+    {
+      typename EnhancerType::Pointer enhancer = EnhancerType::New();
+      enhancer->SetUseLookupTable( this->m_LookUpTable );
+      enhancer->SetAlpha( this->m_Alpha );
+      enhancer->SetBeta( this->m_Beta );
+      enhancer->SetRadius( radiusSize );
+      enhancer->SetInput( reader->GetOutput() );
+
+      writer->SetInput( enhancer->GetOutput() );
+      writer->Update();
+    }
 
   } // end Run()
 
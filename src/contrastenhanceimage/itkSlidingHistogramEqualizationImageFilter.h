@@ -0,0 +1,158 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkSlidingHistogramEqualizationImageFilter_h_
+#define __itkSlidingHistogramEqualizationImageFilter_h_
+
+#include "itkImageToImageFilter.h"
+#include <vector>
+
+
+namespace itk
+{
+
+/** \class SlidingHistogramEqualizationImageFilter
+ * \brief Adaptive histogram equalization using a sliding window histogram.
+ *
+ * This filter computes the same power law adaptive histogram equalization
+ * as the AdaptiveHistogramEqualizationImageFilter, controlled by the same
+ * Alpha and Beta parameters: the output at a pixel is the mean over the
+ * window of the cumulative function
+ *
+ *   c(u,v) = 0.5 s(u-v) |2(u-v)|^Alpha - 0.5 Beta s(u-v) |2(u-v)| + Beta u
+ *
+ * with u the pixel and v its neighbours, both scaled to [-0.5,0.5].
+ *
+ * Instead of visiting every neighbour of every pixel, the histogram of the
+ * window is updated incrementally as the window moves along a row: per step
+ * only the slab that leaves and the slab that enters the window are visited.
+ * The output is then a dot product of the window histogram with a
+ * precomputed row of c(u,.). Rows are distributed over the threads.
+ *
+ * The intensities are binned; by default there is one bin per intensity
+ * value, up to 1024 bins. With one bin per intensity value the result equals
+ * that of the AdaptiveHistogramEqualizationImageFilter, up to floating point
+ * rounding. As in that filter the image border is handled by replicating the
+ * border pixels.
+ *
+ * \ingroup IntensityImageFilters Multithreaded
+ */
+template <class TImage>
+class SlidingHistogramEqualizationImageFilter:
+    public ImageToImageFilter<TImage,TImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef SlidingHistogramEqualizationImageFilter Self;
+  typedef ImageToImageFilter<TImage,TImage>       Superclass;
+  typedef SmartPointer<Self>                      Pointer;
+  typedef SmartPointer<const Self>                ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( SlidingHistogramEqualizationImageFilter, ImageToImageFilter );
+
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TImage::ImageDimension );
+
+  /** Typedef to describe the input/output image types. */
+  typedef TImage                                  InputImageType;
+  typedef TImage                                  OutputImageType;
+  typedef typename InputImageType::PixelType      InputImagePixelType;
+  typedef typename OutputImageType::PixelType     OutputImagePixelType;
+  typedef typename OutputImageType::RegionType    OutputImageRegionType;
+  typedef typename InputImageType::SizeType       ImageSizeType;
+
+  /** Set/Get the power law parameters, see the class documentation. */
+  itkSetMacro( Alpha, float );
+  itkGetConstMacro( Alpha, float );
+  itkSetMacro( Beta, float );
+  itkGetConstMacro( Beta, float );
+
+  /** Set/Get the radius of the window. */
+  itkSetMacro( Radius, ImageSizeType );
+  itkGetConstReferenceMacro( Radius, ImageSizeType );
+
+  /** The largest allowed maximum number of histogram bins. The cumulative
+   * function is tabulated for all pairs of bins, which for 4096 bins takes
+   * 64 MB. */
+  itkStaticConstMacro( LargestNumberOfBins, unsigned int, 4096 );
+
+  /** Set/Get the maximum number of histogram bins. Default 1024, clamped
+   * to [1, LargestNumberOfBins]. */
+  itkSetClampMacro( MaximumNumberOfBins, unsigned int, 1, LargestNumberOfBins );
+  itkGetConstMacro( MaximumNumberOfBins, unsigned int );
+
+protected:
+  SlidingHistogramEqualizationImageFilter();
+  ~SlidingHistogramEqualizationImageFilter() {};
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** The whole input is needed to determine the intensity range. */
+  virtual void GenerateInputRequestedRegion( void );
+
+  /** Determine the intensity range, the bins and the table of the
+   * cumulative function. */
+  virtual void BeforeThreadedGenerateData( void );
+
+  /** Slide the window along the rows of the region of this thread. */
+  virtual void ThreadedGenerateData(
+    const OutputImageRegionType & outputRegionForThread,
+    ThreadIdType threadId );
+
+  /** The cumulative function, for u and v scaled to [-0.5,0.5]. */
+  double CumulativeFunction( double u, double v ) const;
+
+  /** The bin of an intensity value. */
+  inline unsigned int GetBinIndex( const InputImagePixelType & value ) const
+  {
+    const double bin = ( static_cast<double>( value ) - this->m_Minimum ) * this->m_BinScale;
+    const double maxBin = this->m_NumberOfBins - 1;
+    return static_cast<unsigned int>( bin < 0.0 ? 0.0 : ( bin > maxBin ? maxBin : bin ) );
+  }
+
+private:
+  SlidingHistogramEqualizationImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  float         m_Alpha;
+  float         m_Beta;
+  ImageSizeType m_Radius;
+  unsigned int  m_MaximumNumberOfBins;
+
+  /** Computed in BeforeThreadedGenerateData. */
+  double        m_Minimum;
+  double        m_IntensityScale;
+  double        m_BinScale;
+  unsigned int  m_NumberOfBins;
+
+  /** m_CumulativeTable[ i * m_NumberOfBins + j ] = c( bin i, bin j ). */
+  std::vector<float> m_CumulativeTable;
+
+}; // end class SlidingHistogramEqualizationImageFilter
+
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSlidingHistogramEqualizationImageFilter.hxx"
+#endif
+
+#endif // end #ifndef __itkSlidingHistogramEqualizationImageFilter_h_
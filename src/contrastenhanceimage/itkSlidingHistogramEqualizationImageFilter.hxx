@@ -0,0 +1,307 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef _itkSlidingHistogramEqualizationImageFilter_hxx_
+#define _itkSlidingHistogramEqualizationImageFilter_hxx_
+
+#include "itkSlidingHistogramEqualizationImageFilter.h"
+
+#include "itkImageLinearIteratorWithIndex.h"
+#include "itkMinimumMaximumImageCalculator.h"
+#include "itkNumericTraits.h"
+#include "itkProgressReporter.h"
+#include "vnl/vnl_math.h"
+
+
+namespace itk {
+
+template<class TImage>
+SlidingHistogramEqualizationImageFilter<TImage>
+::SlidingHistogramEqualizationImageFilter()
+{
+  this->m_Alpha = 0.3f;
+  this->m_Beta = 0.3f;
+  this->m_Radius.Fill( 5 );
+  this->m_MaximumNumberOfBins = 1024;
+
+  this->m_Minimum = 0.0;
+  this->m_IntensityScale = 0.0;
+  this->m_BinScale = 1.0;
+  this->m_NumberOfBins = 1;
+}
+
+
+template<class TImage>
+void
+SlidingHistogramEqualizationImageFilter<TImage>
+::GenerateInputRequestedRegion( void )
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType * input = const_cast<InputImageType *>( this->GetInput() );
+  if( input )
+  {
+    input->SetRequestedRegionToLargestPossibleRegion();
+  }
+
+} // end GenerateInputRequestedRegion()
+
+
+template<class TImage>
+double
+SlidingHistogramEqualizationImageFilter<TImage>
+::CumulativeFunction( double u, double v ) const
+{
+  const double s = vnl_math_sgn( u - v );
+  const double ad = vnl_math_abs( 2.0 * ( u - v ) );
+
+  return 0.5 * s * vcl_pow( ad, static_cast<double>( this->m_Alpha ) )
+    - this->m_Beta * 0.5 * s * ad + this->m_Beta * u;
+
+} // end CumulativeFunction()
+
+
+template<class TImage>
+void
+SlidingHistogramEqualizationImageFilter<TImage>
+::BeforeThreadedGenerateData( void )
+{
+  /** Determine the intensity range. */
+  typedef MinimumMaximumImageCalculator<InputImageType> MinMaxCalculatorType;
+  typename MinMaxCalculatorType::Pointer calculator = MinMaxCalculatorType::New();
+  calculator->SetImage( this->GetInput() );
+  calculator->Compute();
+
+  this->m_Minimum = static_cast<double>( calculator->GetMinimum() );
+  this->m_IntensityScale = static_cast<double>( calculator->GetMaximum() )
+    - this->m_Minimum;
+  const double scale = this->m_IntensityScale > 0.0
+    ? 1.0 / this->m_IntensityScale : 0.0;
+
+  /** Integer types get one bin per value, if the maximum allows it. */
+  const bool isInteger = NumericTraits<InputImagePixelType>::is_integer;
+  const double maximumNumberOfBins = vnl_math_max( 1u,
+    vnl_math_min( this->m_MaximumNumberOfBins, static_cast<unsigned int>( LargestNumberOfBins ) ) );
+  double range = this->m_IntensityScale;
+  if( isInteger ) range += 1.0;
+  this->m_NumberOfBins = static_cast<unsigned int>(
+    isInteger ? vnl_math_min( range, maximumNumberOfBins ) : maximumNumberOfBins );
+  this->m_BinScale = range > 0.0 ? this->m_NumberOfBins / range : 0.0;
+
+  /** The intensity that represents each bin, scaled to [-0.5,0.5]. */
+  std::vector<double> binCenters( this->m_NumberOfBins, -0.5 );
+  if( this->m_BinScale > 0.0 )
+  {
+    const double shift = isInteger ? 0.5 : 0.0;
+    for( unsigned int i = 0; i < this->m_NumberOfBins; ++i )
+    {
+      const double value = ( i + 0.5 ) / this->m_BinScale - shift;
+      binCenters[ i ] = value * scale - 0.5;
+    }
+  }
+
+  /** Tabulate the cumulative function for all pairs of bins. */
+  const std::size_t nbins = this->m_NumberOfBins;
+  this->m_CumulativeTable.resize( nbins * nbins );
+  for( std::size_t i = 0; i < nbins; ++i )
+  {
+    for( std::size_t j = 0; j < nbins; ++j )
+    {
+      this->m_CumulativeTable[ i * nbins + j ] = static_cast<float>(
+        this->CumulativeFunction( binCenters[ i ], binCenters[ j ] ) );
+    }
+  }
+
+} // end BeforeThreadedGenerateData()
+
+
+template<class TImage>
+void
+SlidingHistogramEqualizationImageFilter<TImage>
+::ThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread,
+  ThreadIdType threadId )
+{
+  typedef typename InputImageType::IndexType      IndexType;
+  typedef typename InputImageType::RegionType     RegionType;
+  typedef ImageLinearIteratorWithIndex<OutputImageType> IteratorType;
+
+  const InputImageType * input = this->GetInput();
+  OutputImageType * output = this->GetOutput();
+
+  /** Raw access to the input; the border is replicated by clamping. */
+  const RegionType bufferedRegion = input->GetBufferedRegion();
+  const IndexType bufferIndex = bufferedRegion.GetIndex();
+  const ImageSizeType bufferSize = bufferedRegion.GetSize();
+  const OffsetValueType * offsetTable = input->GetOffsetTable();
+  const InputImagePixelType * inputBuffer = input->GetBufferPointer();
+
+  /** The window is split in a row part along dimension 0 and a cross
+   * section over the other dimensions.
+   */
+  const long radius0 = static_cast<long>( this->m_Radius[ 0 ] );
+  const long xFirst = bufferIndex[ 0 ];
+  const long xLast = bufferIndex[ 0 ] + static_cast<long>( bufferSize[ 0 ] ) - 1;
+  std::size_t crossSize = 1;
+  for( unsigned int d = 1; d < ImageDimension; ++d )
+  {
+    crossSize *= 2 * this->m_Radius[ d ] + 1;
+  }
+  const std::size_t kernelSize = crossSize * ( 2 * radius0 + 1 );
+  std::vector<OffsetValueType> crossOffsets( crossSize );
+
+  /** For small windows it is cheaper to visit the window than the
+   * histogram; both use the tabulated cumulative function.
+   */
+  const unsigned int nbins = this->m_NumberOfBins;
+  const bool useHistogram = kernelSize > nbins;
+  std::vector<unsigned int> histogram( nbins, 0 );
+  const float * table = &( this->m_CumulativeTable[ 0 ] );
+  const double normalization = 1.0 / static_cast<double>( kernelSize );
+  const double minimum = this->m_Minimum;
+  const double intensityScale = this->m_IntensityScale;
+
+  ProgressReporter progress( this, threadId,
+    outputRegionForThread.GetNumberOfPixels() / outputRegionForThread.GetSize( 0 ) );
+
+  IteratorType it( output, outputRegionForThread );
+  it.SetDirection( 0 );
+  it.GoToBegin();
+  while( !it.IsAtEnd() )
+  {
+    const IndexType lineIndex = it.GetIndex();
+
+    /** Offsets of the clamped cross section and of the line itself. */
+    OffsetValueType lineOffset = 0;
+    for( unsigned int d = 1; d < ImageDimension; ++d )
+    {
+      lineOffset += ( lineIndex[ d ] - bufferIndex[ d ] ) * offsetTable[ d ];
+    }
+    Offset<ImageDimension> k;
+    for( unsigned int d = 1; d < ImageDimension; ++d )
+    {
+      k[ d ] = -static_cast<long>( this->m_Radius[ d ] );
+    }
+    for( std::size_t c = 0; c < crossSize; ++c )
+    {
+      OffsetValueType offset = 0;
+      for( unsigned int d = 1; d < ImageDimension; ++d )
+      {
+        const long first = bufferIndex[ d ];
+        const long last = first + static_cast<long>( bufferSize[ d ] ) - 1;
+        const long index = vnl_math_min( vnl_math_max(
+          static_cast<long>( lineIndex[ d ] + k[ d ] ), first ), last );
+        offset += ( index - first ) * offsetTable[ d ];
+      }
+      crossOffsets[ c ] = offset;
+
+      /** Next position in the cross section. */
+      for( unsigned int d = 1; d < ImageDimension; ++d )
+      {
+        if( ++k[ d ] <= static_cast<long>( this->m_Radius[ d ] ) ) break;
+        k[ d ] = -static_cast<long>( this->m_Radius[ d ] );
+      }
+    }
+
+    /** Histogram of the window around the first pixel of the line. */
+    long x = lineIndex[ 0 ];
+    if( useHistogram )
+    {
+      std::fill( histogram.begin(), histogram.end(), 0 );
+      for( long dx = -radius0; dx <= radius0; ++dx )
+      {
+        const long xi = vnl_math_min( vnl_math_max( x + dx, xFirst ), xLast ) - xFirst;
+        for( std::size_t c = 0; c < crossSize; ++c )
+        {
+          ++histogram[ this->GetBinIndex( inputBuffer[ crossOffsets[ c ] + xi ] ) ];
+        }
+      }
+    }
+
+    while( !it.IsAtEndOfLine() )
+    {
+      const unsigned int centerBin = this->GetBinIndex(
+        inputBuffer[ lineOffset + x - xFirst ] );
+      const float * row = table + static_cast<std::size_t>( centerBin ) * nbins;
+
+      double sum = 0.0;
+      if( useHistogram )
+      {
+        for( unsigned int b = 0; b < nbins; ++b )
+        {
+          sum += histogram[ b ] * row[ b ];
+        }
+      }
+      else
+      {
+        for( long dx = -radius0; dx <= radius0; ++dx )
+        {
+          const long xi = vnl_math_min( vnl_math_max( x + dx, xFirst ), xLast ) - xFirst;
+          for( std::size_t c = 0; c < crossSize; ++c )
+          {
+            sum += row[ this->GetBinIndex( inputBuffer[ crossOffsets[ c ] + xi ] ) ];
+          }
+        }
+      }
+
+      it.Set( static_cast<OutputImagePixelType>(
+        intensityScale * ( sum * normalization + 0.5 ) + minimum ) );
+      ++it;
+      ++x;
+
+      /** Slide the window: remove the slab that leaves, add the one that enters. */
+      if( useHistogram && !it.IsAtEndOfLine() )
+      {
+        const long xOut = vnl_math_max( x - radius0 - 1, xFirst ) - xFirst;
+        const long xIn = vnl_math_min( x + radius0, xLast ) - xFirst;
+        if( xOut != xIn )
+        {
+          for( std::size_t c = 0; c < crossSize; ++c )
+          {
+            --histogram[ this->GetBinIndex( inputBuffer[ crossOffsets[ c ] + xOut ] ) ];
+            ++histogram[ this->GetBinIndex( inputBuffer[ crossOffsets[ c ] + xIn ] ) ];
+          }
+        }
+      }
+    } // end while line
+
+    it.NextLine();
+    progress.CompletedPixel();
+  } // end while lines
+
+} // end ThreadedGenerateData()
+
+
+template<class TImage>
+void
+SlidingHistogramEqualizationImageFilter<TImage>
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "Alpha: " << this->m_Alpha << std::endl;
+  os << indent << "Beta: " << this->m_Beta << std::endl;
+  os << indent << "Radius: " << this->m_Radius << std::endl;
+  os << indent << "MaximumNumberOfBins: " << this->m_MaximumNumberOfBins << std::endl;
+  os << indent << "NumberOfBins: " << this->m_NumberOfBins << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef _itkSlidingHistogramEqualizationImageFilter_hxx_
@@ -299,6 +299,7 @@ public:
       << std::endl;
 
     vectorWriter = VectorWriterType::New();
+    vectorWriter->SetFileName( this->m_OutputFileName.c_str() );
     vectorWriter->SetInput(imageToVectorImageFilter->GetOutput());
     vectorWriter->Update();
 
@@ -101,9 +101,10 @@ public:
     typename ReaderType::Pointer reader = ReaderType::New();
     typename WriterType::Pointer writer = WriterType::New();
 
-    /** Read the image. */
+    /** Set up the reader. The crop filter requests only the crop region, so
+     * that streaming image IOs read only its bytes.
+     */
     reader->SetFileName( this->m_InputFileName.c_str() );
-    reader->Update();
 
     /** Convert the lower and upper boundary to SizeType. */
     SizeType downSize, upSize;
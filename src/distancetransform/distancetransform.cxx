@@ -45,6 +45,9 @@ std::string GetHelpString( void )
     << "  -out     outputFilename: the output of distance transform\n"
     << "  [-s]     flag: if set, output squared distances instead of distances\n"
     << "  [-m]     method, one of {Maurer, Danielsson, Morphological, MorphologicalSigned}, default Maurer\n"
+    << "  [-maxdist] maximum distance of interest: distances are only computed\n"
+    << "           in a band around the object, and clamped to this value elsewhere.\n"
+    << "           Default 0, which means no limit.\n"
     << "Note: voxel spacing is taken into account. Voxels inside the\n"
     << "object (=1) receive a negative distance.\n"
     << "Supported: 2D/3D. input: unsigned char, output: float";
@@ -99,6 +102,9 @@ int main( int argc, char **argv )
   unsigned int K = 5;
   parser->GetCommandLineArgument( "-k", K );
 
+  double maximumDistance = 0.0;
+  parser->GetCommandLineArgument( "-maxdist", maximumDistance );
+
   /** Checks. */
   if( method != "Maurer" && method != "Danielsson"
     && method != "Morphological" && method != "MorphologicalSigned" )
@@ -108,6 +114,13 @@ int main( int argc, char **argv )
     return EXIT_FAILURE;
   }
 
+  if( maximumDistance < 0.0 )
+  {
+    std::cerr << "ERROR: the maximum distance should be non-negative!"
+      << std::endl;
+    return EXIT_FAILURE;
+  }
+
   if( method == "OrderK" && outputFileNames.size() != 3 )
   {
     std::cerr << "ERROR: the method OrderK requires three output file names!\n";
@@ -161,7 +174,7 @@ int main( int argc, char **argv )
         inputFileName,
         outputFileNames,
         outputSquaredDistance,
-        method, K );
+        method, K, maximumDistance );
     }
     if( Dimension == 3 )
     {
@@ -169,7 +182,7 @@ int main( int argc, char **argv )
         inputFileName,
         outputFileNames,
         outputSquaredDistance,
-        method, K );
+        method, K, maximumDistance );
     }
 
   }
@@ -24,6 +24,11 @@
 #include "itkExceptionObject.h"
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
+#include "itkRegionOfInterestImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "vnl/vnl_math.h"
 
 #include "itkSignedMaurerDistanceMapImageFilter.h"
 #include "itkSignedDanielssonDistanceMapImageFilter.h"
@@ -32,6 +37,222 @@
 //#include "itkOrderKDistanceTransformImageFilter.h"
 
 
+/*
+ * ******************* ComputeDistanceTransformBand ****************
+ *
+ * Determine the region of the input image in which distances up to
+ * maximumDistance are needed: the bounding box of the object, padded by
+ * the maximum distance (in voxels) plus one voxel, so that also the
+ * background voxels just outside the object are included.
+ * Returns false if the image contains no object voxels.
+ */
+
+template <class TInputImage>
+bool ComputeDistanceTransformBand(
+  const TInputImage * image,
+  const double & maximumDistance,
+  typename TInputImage::RegionType & band )
+{
+  typedef typename TInputImage::RegionType          RegionType;
+  typedef typename TInputImage::IndexType           IndexType;
+  typedef typename TInputImage::SizeType            SizeType;
+  typedef typename TInputImage::PixelType           PixelType;
+  typedef itk::ImageRegionConstIteratorWithIndex<
+    TInputImage >                                   IteratorType;
+  const unsigned int Dimension = TInputImage::ImageDimension;
+
+  const RegionType largest = image->GetLargestPossibleRegion();
+  const PixelType zero = itk::NumericTraits<PixelType>::Zero;
+
+  /** Compute the bounding box of the object. */
+  IndexType minIndex, maxIndex;
+  bool foundObject = false;
+  IteratorType it( image, largest );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+  {
+    if( it.Get() == zero ) continue;
+
+    const IndexType & index = it.GetIndex();
+    if( !foundObject )
+    {
+      minIndex = index; maxIndex = index;
+      foundObject = true;
+    }
+    for( unsigned int i = 0; i < Dimension; ++i )
+    {
+      minIndex[ i ] = vnl_math_min( index[ i ], minIndex[ i ] );
+      maxIndex[ i ] = vnl_math_max( index[ i ], maxIndex[ i ] );
+    }
+  }
+  if( !foundObject ) return false;
+
+  /** Pad with the maximum distance, and crop to the image. */
+  IndexType bandIndex;
+  SizeType bandSize;
+  const IndexType largestIndex = largest.GetIndex();
+  const SizeType largestSize = largest.GetSize();
+  for( unsigned int i = 0; i < Dimension; ++i )
+  {
+    const long pad = static_cast<long>( vcl_ceil(
+      maximumDistance / image->GetSpacing()[ i ] ) ) + 1;
+    const long lower = vnl_math_max(
+      static_cast<long>( minIndex[ i ] ) - pad,
+      static_cast<long>( largestIndex[ i ] ) );
+    const long upper = vnl_math_min(
+      static_cast<long>( maxIndex[ i ] ) + pad,
+      static_cast<long>( largestIndex[ i ] + largestSize[ i ] ) - 1 );
+    bandIndex[ i ] = lower;
+    bandSize[ i ] = upper - lower + 1;
+  }
+  band.SetIndex( bandIndex );
+  band.SetSize( bandSize );
+
+  return true;
+
+} // end ComputeDistanceTransformBand()
+
+
+/*
+ * ******************* ComputeDistanceMap ****************
+ *
+ * Compute the signed distance map of a binary image in memory, with one
+ * of the methods { Maurer, Danielsson, Morphological, MorphologicalSigned }.
+ * If maximumDistance > 0, distances are only computed in a band around
+ * the object, and clamped to [-maximumDistance, maximumDistance]
+ * (squared if outputSquaredDistance is set) everywhere.
+ */
+
+template <class TInputImage, class TOutputImage>
+typename TOutputImage::Pointer ComputeDistanceMap(
+  const TInputImage * inputImage,
+  bool outputSquaredDistance,
+  const std::string & method,
+  const double & maximumDistance )
+{
+  typedef TInputImage                               InputImageType;
+  typedef TOutputImage                              OutputImageType;
+  typedef typename OutputImageType::PixelType       OutputPixelType;
+  typedef typename OutputImageType::Pointer         OutputImagePointer;
+  typedef typename InputImageType::RegionType       RegionType;
+
+  typedef itk::SignedMaurerDistanceMapImageFilter<
+    InputImageType, OutputImageType >               MaurerDistanceType;
+  typedef itk::SignedDanielssonDistanceMapImageFilter<
+    InputImageType, OutputImageType >               DanielssonDistanceType;
+  typedef itk::MorphologicalSignedDistanceTransformImageFilter<
+    InputImageType, OutputImageType >               MorphologicalSignedDistanceType;
+  typedef itk::MorphologicalDistanceTransformImageFilter<
+    InputImageType, OutputImageType >               MorphologicalDistanceType;
+  typedef itk::RegionOfInterestImageFilter<
+    InputImageType, InputImageType >                ROIFilterType;
+
+  /** In the bounded-distance mode, restrict the computation to a band
+   * around the object. Outside the band all distances are clamped anyway.
+   */
+  const bool useBand = maximumDistance > 0.0;
+  const double clampValue = outputSquaredDistance
+    ? maximumDistance * maximumDistance : maximumDistance;
+  RegionType band;
+  typename ROIFilterType::Pointer roi = ROIFilterType::New();
+  const InputImageType * distanceInput = inputImage;
+  if( useBand )
+  {
+    if( !ComputeDistanceTransformBand<InputImageType>(
+      inputImage, maximumDistance, band ) )
+    {
+      /** No object: all voxels are beyond the maximum distance. */
+      OutputImagePointer output = OutputImageType::New();
+      output->CopyInformation( inputImage );
+      output->SetRegions( inputImage->GetLargestPossibleRegion() );
+      output->Allocate();
+      output->FillBuffer( static_cast<OutputPixelType>( clampValue ) );
+      return output;
+    }
+
+    roi->SetInput( inputImage );
+    roi->SetRegionOfInterest( band );
+    roi->Update();
+    distanceInput = roi->GetOutput();
+  }
+
+  /** Setup and run the requested distance transform filter. */
+  OutputImagePointer distanceImage;
+  if( method == "Maurer" )
+  {
+    typename MaurerDistanceType::Pointer distance_Maurer
+      = MaurerDistanceType::New();
+    distance_Maurer->SetInput( distanceInput );
+    distance_Maurer->SetUseImageSpacing( true );
+    distance_Maurer->SetInsideIsPositive( false );
+    distance_Maurer->SetSquaredDistance( outputSquaredDistance );
+    distance_Maurer->SetBackgroundValue( 0 );
+    distance_Maurer->Update();
+    distanceImage = distance_Maurer->GetOutput();
+  }
+  else if( method == "Danielsson" )
+  {
+    typename DanielssonDistanceType::Pointer distance_Danielsson
+      = DanielssonDistanceType::New();
+    distance_Danielsson->SetInput( distanceInput );
+    distance_Danielsson->SetUseImageSpacing( true );
+    distance_Danielsson->SetInsideIsPositive( false );
+    distance_Danielsson->SetSquaredDistance( outputSquaredDistance );
+    distance_Danielsson->Update();
+    distanceImage = distance_Danielsson->GetOutput();
+  }
+  else if( method == "Morphological" )
+  {
+    typename MorphologicalDistanceType::Pointer distance_Morphological
+      = MorphologicalDistanceType::New();
+    distance_Morphological->SetInput( distanceInput );
+    distance_Morphological->SetUseImageSpacing( true );
+    distance_Morphological->SetOutsideValue( 1 );
+    distance_Morphological->SetSqrDist( outputSquaredDistance );
+    distance_Morphological->SetMaximumDistance( maximumDistance );
+    distance_Morphological->Update();
+    distanceImage = distance_Morphological->GetOutput();
+  }
+  else if( method == "MorphologicalSigned" )
+  {
+    typename MorphologicalSignedDistanceType::Pointer distance_MorphologicalSigned
+      = MorphologicalSignedDistanceType::New();
+    distance_MorphologicalSigned->SetInput( distanceInput );
+    distance_MorphologicalSigned->SetUseImageSpacing( true );
+    distance_MorphologicalSigned->SetInsideIsPositive( false );
+    distance_MorphologicalSigned->SetOutsideValue( 0 );
+    distance_MorphologicalSigned->SetMaximumDistance( maximumDistance );
+    distance_MorphologicalSigned->Update();
+    distanceImage = distance_MorphologicalSigned->GetOutput();
+  }
+  else
+  {
+    itkGenericExceptionMacro( << "Unknown distance transform method: " << method );
+  }
+
+  if( !useBand ) return distanceImage;
+
+  /** Paste the band into a full size output, clamping all distances. */
+  OutputImagePointer output = OutputImageType::New();
+  output->CopyInformation( inputImage );
+  output->SetRegions( inputImage->GetLargestPossibleRegion() );
+  output->Allocate();
+  output->FillBuffer( static_cast<OutputPixelType>( clampValue ) );
+
+  const OutputPixelType upper = static_cast<OutputPixelType>( clampValue );
+  const OutputPixelType lower = static_cast<OutputPixelType>( -clampValue );
+  itk::ImageRegionConstIterator<OutputImageType> itIn(
+    distanceImage, distanceImage->GetLargestPossibleRegion() );
+  itk::ImageRegionIterator<OutputImageType> itOut( output, band );
+  for( itIn.GoToBegin(), itOut.GoToBegin(); !itIn.IsAtEnd(); ++itIn, ++itOut )
+  {
+    itOut.Set( vnl_math_max( lower, vnl_math_min( upper, itIn.Get() ) ) );
+  }
+
+  return output;
+
+} // end ComputeDistanceMap()
+
+
 /*
  * ******************* DistanceTransform ****************
  *
@@ -43,7 +264,8 @@ void DistanceTransform(
   const std::vector<std::string> & outputFileNames,
   bool outputSquaredDistance,
   const std::string & method,
-  const unsigned int & K )
+  const unsigned int & K,
+  const double & maximumDistance )
 {
   const unsigned int              Dimension = NDimensions;
   typedef unsigned char           InputComponentType;
@@ -56,14 +278,6 @@ void DistanceTransform(
   typedef itk::Image< float, Dimension >            FloatImageType;
   typedef itk::Image< unsigned long, Dimension >    ULImageType;
 
-  typedef itk::SignedMaurerDistanceMapImageFilter<
-    InputImageType, OutputImageType >               MaurerDistanceType;
-  typedef itk::SignedDanielssonDistanceMapImageFilter<
-    InputImageType, OutputImageType >               DanielssonDistanceType;
-  typedef itk::MorphologicalSignedDistanceTransformImageFilter<
-    InputImageType, OutputImageType >               MorphologicalSignedDistanceType;
-  typedef itk::MorphologicalDistanceTransformImageFilter<
-    InputImageType, OutputImageType >               MorphologicalDistanceType;
 //   typedef itk::OrderKDistanceTransformImageFilter<
 //     FloatImageType, ULImageType >                   OrderKDistanceType;
 //
@@ -71,7 +285,6 @@ void DistanceTransform(
 //   typedef typename OrderKDistanceType::KDistanceImageType KDistanceImageType;
 //   typedef typename OrderKDistanceType::KIDImageType       KIDImageType;
 
-  typedef typename InputImageType::Pointer          InputImagePointer;
   typedef typename OutputImageType::Pointer         OutputImagePointer;
 
   typedef itk::ImageFileReader< InputImageType >    ReaderType;
@@ -84,43 +297,11 @@ void DistanceTransform(
   /** Read the input images */
   typename ReaderType::Pointer reader = ReaderType::New();
   reader->SetFileName( inputFileName.c_str() );
+  reader->Update();
 
   typename FloatReaderType::Pointer freader = FloatReaderType::New();
   freader->SetFileName( inputFileName.c_str() );
 
-  /** Setup the Maurer distance transform filter. */
-  typename MaurerDistanceType::Pointer distance_Maurer
-    = MaurerDistanceType::New();
-  distance_Maurer->SetInput( reader->GetOutput() );
-  distance_Maurer->SetUseImageSpacing( true );
-  distance_Maurer->SetInsideIsPositive( false );
-  distance_Maurer->SetSquaredDistance( outputSquaredDistance );
-  distance_Maurer->SetBackgroundValue( 0 );
-
-  /** Setup the Danielsson distance transform filter. */
-  typename DanielssonDistanceType::Pointer distance_Danielsson
-    = DanielssonDistanceType::New();
-  distance_Danielsson->SetInput( reader->GetOutput() );
-  distance_Danielsson->SetUseImageSpacing( true );
-  distance_Danielsson->SetInsideIsPositive( false );
-  distance_Danielsson->SetSquaredDistance( outputSquaredDistance );
-
-  /** Setup the Morphological distance transform filter. */
-  typename MorphologicalDistanceType::Pointer distance_Morphological
-    = MorphologicalDistanceType::New();
-  distance_Morphological->SetInput( reader->GetOutput() );
-  distance_Morphological->SetUseImageSpacing( true );
-  distance_Morphological->SetOutsideValue( 1 );
-  distance_Morphological->SetSqrDist( outputSquaredDistance );
-
-  /** Setup the Morphological signed distance transform filter. */
-  typename MorphologicalSignedDistanceType::Pointer distance_MorphologicalSigned
-    = MorphologicalSignedDistanceType::New();
-  distance_MorphologicalSigned->SetInput( reader->GetOutput() );
-  distance_MorphologicalSigned->SetUseImageSpacing( true );
-  distance_MorphologicalSigned->SetInsideIsPositive( false );
-  distance_MorphologicalSigned->SetOutsideValue( 0 );
-
   /** Setup the OrderK distance transform filter. */
 //   typename OrderKDistanceType::Pointer distance_OrderK
 //     = OrderKDistanceType::New();
@@ -130,9 +311,16 @@ void DistanceTransform(
 //   distance_OrderK->SetSquaredDistance( outputSquaredDistance );
 //   distance_OrderK->SetK( K );
 
+  /** Run! */
+  OutputImagePointer distanceImage
+    = ComputeDistanceMap<InputImageType, OutputImageType>(
+    reader->GetOutput(), outputSquaredDistance, method, maximumDistance );
+
   /** Setup writer. */
   typename WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( outputFileNames[ 0 ].c_str() );
+  writer->SetInput( distanceImage );
+  writer->Update();
 
 //   typename VoronoiWriterType::Pointer voronoiWriter = VoronoiWriterType::New();
 //   typename KDistanceWriterType::Pointer kDistanceWriter = KDistanceWriterType::New();
@@ -140,40 +328,11 @@ void DistanceTransform(
 //   voronoiWriter->SetFileName( outputFileNames[ 0 ].c_str() );
 //   kDistanceWriter->SetFileName( outputFileNames[ 1 ].c_str() );
 //   kIDWriter->SetFileName( outputFileNames[ 2 ].c_str() );
-
-  /** Run! */
-  if( method == "Maurer" )
-  {
-    distance_Maurer->Update();
-    writer->SetInput( distance_Maurer->GetOutput() );
-    writer->Update();
-  }
-  else if( method == "Danielsson" )
-  {
-    distance_Danielsson->Update();
-    writer->SetInput( distance_Danielsson->GetOutput() );
-    writer->Update();
-  }
-  else if( method == "Morphological" )
-  {
-    distance_Morphological->Update();
-    writer->SetInput( distance_Morphological->GetOutput() );
-    writer->Update();
-  }
-  else if( method == "MorphologicalSigned" )
-  {
-    distance_MorphologicalSigned->Update();
-    writer->SetInput( distance_MorphologicalSigned->GetOutput() );
-    writer->Update();
-  }
-
-//   else if( method == "OrderK" )
+//
+//   if( method == "OrderK" )
 //   {
-//     std::cerr << "to here";
 //     freader->Update();
-//     std::cerr << "to here";
 //     distance_OrderK->Update();
-//     std::cerr << "to here";
 //     voronoiWriter->SetInput( distance_OrderK->GetVoronoiMap() );
 //     kDistanceWriter->SetInput( distance_OrderK->GetKDistanceMap() );
 //     kIDWriter->SetInput( distance_OrderK->GetKclosestIDMap() );
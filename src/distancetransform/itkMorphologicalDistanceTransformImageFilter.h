@@ -94,6 +94,14 @@ public:
     return this->m_Erode->GetUseImageSpacing();
   }
 
+  /** Set/Get the maximum distance of interest. Background voxels start at
+   * the square of this value instead of the squared image diagonal, so
+   * distances beyond it saturate at MaximumDistance (or its square when
+   * SqrDist is set). The parabolic erosion itself is not bounded: it still
+   * runs over the whole image. Default 0, meaning no limit. */
+  itkSetMacro(MaximumDistance, double);
+  itkGetConstMacro(MaximumDistance, double);
+
   itkSetMacro(SqrDist, bool);
   itkGetConstReferenceMacro(SqrDist, bool);
   itkBooleanMacro(SqrDist);
@@ -134,6 +142,7 @@ private:
   typename ThreshType::Pointer m_Thresh;
   typename SqrtType::Pointer m_Sqrt;
   bool m_SqrDist;
+  double m_MaximumDistance;
 };
 
 } // namespace itk
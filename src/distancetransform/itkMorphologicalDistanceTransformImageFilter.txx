@@ -3,6 +3,7 @@
 
 #include "itkMorphologicalDistanceTransformImageFilter.h"
 #include "itkProgressAccumulator.h"
+#include "vnl/vnl_math.h"
 
 namespace itk
 {
@@ -20,6 +21,7 @@ MorphologicalDistanceTransformImageFilter<TInputImage, TOutputImage>
   this->m_Erode->SetScale(0.5);
   this->SetUseImageSpacing(true);
   this->m_SqrDist = false;
+  this->m_MaximumDistance = 0.0;
 }
 
 template <typename TInputImage, typename TOutputImage>
@@ -70,6 +72,13 @@ MorphologicalDistanceTransformImageFilter<TInputImage, TOutputImage>
       }
     }
 
+  // saturate distances beyond the maximum distance of interest
+  if( this->m_MaximumDistance > 0.0 )
+    {
+    MaxDist = vnl_math_min( MaxDist,
+      this->m_MaximumDistance * this->m_MaximumDistance );
+    }
+
 //   double Wt = 0.0;
 //   if(this->GetUseImageSpacing())
 //     {
@@ -119,6 +128,7 @@ MorphologicalDistanceTransformImageFilter<TInputImage, TOutputImage>
   Superclass::PrintSelf(os,indent);
   os << "Outside Value = " << (OutputPixelType)m_OutsideValue << std::endl;
   os << "ImageScale = " << this->m_Erode->GetUseImageSpacing() << std::endl;
+  os << "MaximumDistance = " << this->m_MaximumDistance << std::endl;
 
 }
 
@@ -107,6 +107,15 @@ public:
      * map. By convention ON pixels are treated as inside pixels. Default is
      * true.                             */
   itkBooleanMacro( InsideIsPositive );
+
+  /** Set/Get the maximum distance of interest. Inside and outside voxels
+   * start at plus or minus the square of this value instead of the squared
+   * image diagonal, so distances beyond it saturate at MaximumDistance.
+   * The parabolic erosion and dilation themselves are not bounded: they
+   * still run over the whole image. Default 0, which means no limit. */
+  itkSetMacro( MaximumDistance, double );
+  itkGetConstMacro( MaximumDistance, double );
+
   /** Is the transform in world or voxel units - default is world */
   void SetUseImageSpacing(bool uis)
   {
@@ -156,6 +165,7 @@ private:
 
   InputPixelType m_OutsideValue;
   bool m_InsideIsPositive;
+  double m_MaximumDistance;
   typename ErodeType::Pointer m_Erode;
   typename DilateType::Pointer m_Dilate;
   typename ThreshType::Pointer m_Thresh;
@@ -3,6 +3,7 @@
 
 #include "itkMorphologicalSignedDistanceTransformImageFilter.h"
 #include "itkProgressAccumulator.h"
+#include "vnl/vnl_math.h"
 
 namespace itk
 {
@@ -22,6 +23,7 @@ MorphologicalSignedDistanceTransformImageFilter<TInputImage, TOutputImage>
   this->SetUseImageSpacing(true);
   this->SetInsideIsPositive(false);
   this->m_OutsideValue = 0;
+  this->m_MaximumDistance = 0.0;
 
 }
 template <typename TInputImage, typename TOutputImage>
@@ -75,6 +77,13 @@ MorphologicalSignedDistanceTransformImageFilter<TInputImage, TOutputImage>
       }
     }
 
+  // saturate distances beyond the maximum distance of interest
+  if( this->m_MaximumDistance > 0.0 )
+    {
+    MaxDist = vnl_math_min( MaxDist,
+      this->m_MaximumDistance * this->m_MaximumDistance );
+    }
+
   this->m_Thresh->SetLowerThreshold( this->m_OutsideValue);
   this->m_Thresh->SetUpperThreshold( this->m_OutsideValue);
   if(this->GetInsideIsPositive())
@@ -114,6 +123,7 @@ MorphologicalSignedDistanceTransformImageFilter<TInputImage, TOutputImage>
   Superclass::PrintSelf(os,indent);
   os << "Outside Value = " << (OutputPixelType)m_OutsideValue << std::endl;
   os << "ImageScale = " << this->m_Erode->GetUseImageSpacing() << std::endl;
+  os << "MaximumDistance = " << this->m_MaximumDistance << std::endl;
 
 }
 
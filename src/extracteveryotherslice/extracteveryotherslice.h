@@ -20,8 +20,8 @@
 
 #include "ITKToolsBase.h"
 
-#include "itkImageSliceConstIteratorWithIndex.h"
-#include "itkImageSliceIteratorWithIndex.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
 
@@ -79,23 +79,24 @@ public:
   {
     /** Typedefs. */
     typedef itk::Image< TComponentType, VDimension >    InputImageType;
-    typedef itk::ImageSliceConstIteratorWithIndex<
-      InputImageType >                                  SliceConstIteratorType;
-    typedef itk::ImageSliceIteratorWithIndex<
-      InputImageType >                                  SliceIteratorType;
+    typedef itk::ImageRegionConstIterator<
+      InputImageType >                                  ConstIteratorType;
+    typedef itk::ImageRegionIterator<
+      InputImageType >                                  IteratorType;
     typedef itk::ImageFileReader< InputImageType >      ReaderType;
     typedef itk::ImageFileWriter< InputImageType >      WriterType;
     typedef typename InputImageType::RegionType         RegionType;
-    typedef typename RegionType::IndexType              IndexType;
     typedef typename InputImageType::SizeType           SizeType;
 
-    /** Read in the inputImage. */
+    /** Read only the header of the inputImage. */
     typename ReaderType::Pointer reader = ReaderType::New();
     reader->SetFileName( this->m_InputFileName.c_str() );
-    reader->Update();
+    reader->UpdateOutputInformation();
+    typename InputImageType::Pointer inputImage = reader->GetOutput();
+    const RegionType inputRegion = inputImage->GetLargestPossibleRegion();
 
     /** Define size of output image. */
-    SizeType sizeIn = reader->GetOutput()->GetLargestPossibleRegion().GetSize();
+    SizeType sizeIn = inputRegion.GetSize();
     SizeType sizeOut = sizeIn;
     float newSize = vcl_ceil(
       ( static_cast<float>( sizeOut[ this->m_Direction ] - this->m_Offset ) )
@@ -104,75 +105,41 @@ public:
 
     /** Define region of output image. */
     RegionType region;
-    region.SetIndex( reader->GetOutput()->GetLargestPossibleRegion().GetIndex() );
+    region.SetIndex( inputRegion.GetIndex() );
     region.SetSize( sizeOut );
 
     /** Create output image. */
     typename InputImageType::Pointer outputImage = InputImageType::New();
-    outputImage->SetSpacing( reader->GetOutput()->GetSpacing() );
-    outputImage->SetOrigin( reader->GetOutput()->GetOrigin() );
+    outputImage->SetSpacing( inputImage->GetSpacing() );
+    outputImage->SetOrigin( inputImage->GetOrigin() );
     outputImage->SetRegions( region );
     outputImage->Allocate();
 
-    /** Create iterators. */
-    SliceConstIteratorType itIn( reader->GetOutput(), reader->GetOutput()->GetLargestPossibleRegion() );
-    SliceIteratorType itOut( outputImage, outputImage->GetLargestPossibleRegion() );
-
-    /** Set direction, default slice = z. */
-    if( this->m_Direction == 0 )
-    {
-      itIn.SetFirstDirection(1);
-      itIn.SetSecondDirection(2);
-      itOut.SetFirstDirection(1);
-      itOut.SetSecondDirection(2);
-    }
-    else if( this->m_Direction == 1 )
-    {
-      itIn.SetFirstDirection(0);
-      itIn.SetSecondDirection(2);
-      itOut.SetFirstDirection(0);
-      itOut.SetSecondDirection(2);
-    }
-    else if( this->m_Direction == 2 )
-    {
-      itIn.SetFirstDirection(0);
-      itIn.SetSecondDirection(1);
-      itOut.SetFirstDirection(0);
-      itOut.SetSecondDirection(1);
-    }
-
-    /** Initialize iterators. */
-    itIn.GoToBegin();
-    itOut.GoToBegin();
-    IndexType index= itIn.GetIndex();
-    index[ this->m_Direction ] += this->m_Offset;
-    itIn.SetIndex( index );
-
-    /** Loop over images. */
-    while( !itOut.IsAtEnd() )
+    /** Request the slices one by one from the reader. Streaming image IOs
+     * read only the bytes of the slice; other IOs read the whole image the
+     * first time, which then contains all following slices.
+     */
+    RegionType inputSlice = inputRegion;
+    RegionType outputSlice = region;
+    inputSlice.SetSize( this->m_Direction, 1 );
+    outputSlice.SetSize( this->m_Direction, 1 );
+    for( unsigned int k = 0; k < sizeOut[ this->m_Direction ]; ++k )
     {
-      while( !itOut.IsAtEndOfSlice() )
-      {
-        while( !itOut.IsAtEndOfLine() )
-        {
-          itOut.Set( itIn.Get() );
-          ++itIn;
-          ++itOut;
-        }
-        itIn.NextLine();
-        itOut.NextLine();
-      }
-      itIn.NextSlice();
-      itOut.NextSlice();
+      inputSlice.SetIndex( this->m_Direction, inputRegion.GetIndex( this->m_Direction )
+        + this->m_Offset + k * this->m_EveryOther );
+      outputSlice.SetIndex( this->m_Direction, region.GetIndex( this->m_Direction ) + k );
+
+      inputImage->SetRequestedRegion( inputSlice );
+      inputImage->Update();
 
-      /** Skip some slices in inputImage. */
-      index = itIn.GetIndex();
-      for( unsigned int i = 1; i < this->m_EveryOther; i++ )
+      /** Both slices are traversed in the same order. */
+      ConstIteratorType itIn( inputImage, inputSlice );
+      IteratorType itOut( outputImage, outputSlice );
+      for( ; !itOut.IsAtEnd(); ++itIn, ++itOut )
       {
-        index[ this->m_Direction ]++;
+        itOut.Set( itIn.Get() );
       }
-      itIn.SetIndex( index );
-    } // end while
+    } // end for slices
 
     /** Write the output image. */
     typename WriterType::Pointer writer = WriterType::New();
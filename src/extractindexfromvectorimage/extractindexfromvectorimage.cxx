@@ -43,6 +43,7 @@ std::string GetHelpString( void )
     << "  -in      inputFilename\n"
     << "  [-out]   outputFilename, default in + INDEXEXTRACTED.mhd\n"
     << "  -ind     one or more valid indices\n"
+    << "  [-s]     number of streams, default 1.\n"
     << "Supported: 2D, 3D, (unsigned) char, (unsigned) short, (unsigned) int,\n"
     << "long, float, double.";
   return ss.str();
@@ -83,6 +84,9 @@ int main( int argc, char ** argv )
   std::vector<unsigned int> indices;
   parser->GetCommandLineArgument( "-ind", indices );
 
+  unsigned int numberOfStreams = 1;
+  parser->GetCommandLineArgument( "-s", numberOfStreams );
+
   /** Determine image properties. */
   itk::ImageIOBase::IOPixelType pixelType = itk::ImageIOBase::UNKNOWNPIXELTYPE;
   itk::ImageIOBase::IOComponentType componentType = itk::ImageIOBase::UNKNOWNCOMPONENTTYPE;
@@ -150,6 +154,7 @@ int main( int argc, char ** argv )
     filter->m_InputFileName = inputFileName;
     filter->m_OutputFileName = outputFileName;
     filter->m_Indices = indices;
+    filter->m_NumberOfStreams = numberOfStreams;
 
     filter->Run();
 
@@ -21,13 +21,10 @@
 #include "ITKToolsBase.h"
 
 #include "itkImageFileReader.h"
-#include "itkComposeImageFilter.h"
+#include "itkComponentInterleaveImageFilter.h"
 #include "itkImageFileWriter.h"
-#include "itkVectorIndexSelectionCastImageFilter.h"
 
-#include "itkImage.h"
 #include "itkVectorImage.h"
-#include "itkVector.h"
 
 
 /** \class ITKToolsExtractIndexBase
@@ -44,6 +41,7 @@ public:
   {
     this->m_InputFileName = "";
     this->m_OutputFileName = "";
+    this->m_NumberOfStreams = 1;
   };
   /** Destructor. */
   ~ITKToolsExtractIndexBase(){};
@@ -52,6 +50,7 @@ public:
   std::string m_InputFileName;
   std::string m_OutputFileName;
   std::vector<unsigned int> m_Indices;
+  unsigned int m_NumberOfStreams;
 
 }; // end class ITKToolsExtractIndexBase
 
@@ -78,40 +77,28 @@ public:
   {
     /** Use vector image type that dynamically determines vector length: */
     typedef itk::VectorImage< TComponentType, VDimension >  VectorImageType;
-    typedef itk::Image< TComponentType, VDimension >        ScalarImageType;
     typedef itk::ImageFileReader< VectorImageType >         ImageReaderType;
-    typedef itk::VectorIndexSelectionCastImageFilter<
-      VectorImageType, ScalarImageType >                    IndexExtractorType;
+    typedef itk::ComponentInterleaveImageFilter<
+      VectorImageType >                                     IndexExtractorType;
     typedef itk::ImageFileWriter< VectorImageType >         ImageWriterType;
 
-    /** Read input image. */
+    /** Create the reader. The image is read by the writer, slab by slab. */
     typename ImageReaderType::Pointer reader = ImageReaderType::New();
     reader->SetFileName( this->m_InputFileName );
-    reader->Update();
-
-    /** Extract indices. */
-
-    // Create the assembler
-    typedef itk::ComposeImageFilter<ScalarImageType> ImageToVectorImageFilterType;
-    typename ImageToVectorImageFilterType::Pointer imageToVectorImageFilter = ImageToVectorImageFilterType::New();
 
+    /** Extract the indices, directly into the interleaved output. */
+    typename IndexExtractorType::Pointer extractor = IndexExtractorType::New();
+    extractor->SetInput( reader->GetOutput() );
     for( unsigned int i = 0; i < this->m_Indices.size(); ++i )
     {
-      typename IndexExtractorType::Pointer extractor = IndexExtractorType::New();
-      extractor->SetInput( reader->GetOutput() );
-      extractor->SetIndex( this->m_Indices[ i ] );
-      extractor->Update();
-      //extractor->DisconnectPipeline();
-
-      imageToVectorImageFilter->SetInput( i, extractor->GetOutput() );
+      extractor->AddComponent( 0, this->m_Indices[ i ] );
     }
 
-    imageToVectorImageFilter->Update();
-
     /** Write output image. */
     typename ImageWriterType::Pointer writer = ImageWriterType::New();
     writer->SetFileName( this->m_OutputFileName );
-    writer->SetInput( imageToVectorImageFilter->GetOutput() );
+    writer->SetInput( extractor->GetOutput() );
+    writer->SetNumberOfStreamDivisions( this->m_NumberOfStreams );
     writer->Update();
 
   } // end Run()
@@ -91,10 +91,12 @@ public:
     typedef typename Image3DType::SizeType    SizeType;
     typedef typename Image3DType::IndexType   IndexType;
 
-    /** Create reader. */
+    /** Create reader. Only the header is read here; the extractor requests
+     * the slice, so that streaming image IOs read only its bytes.
+     */
     typename ImageReaderType::Pointer reader = ImageReaderType::New();
     reader->SetFileName( this->m_InputFileName.c_str() );
-    reader->Update();
+    reader->UpdateOutputInformation();
 
     /** Create extractor. */
     typename ExtractFilterType::Pointer extractor = ExtractFilterType::New();
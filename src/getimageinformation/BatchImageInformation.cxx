@@ -0,0 +1,353 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#include "BatchImageInformation.h"
+
+#include "itkImageIOBase.h"
+#include "itkImageIOFactory.h"
+#include "itkMultiThreader.h"
+#include "itkSimpleFastMutexLock.h"
+
+#include <itksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+
+namespace itktools
+{
+
+namespace
+{
+
+/** The header information of one image. */
+struct ImageInformationRow
+{
+  std::string                 m_Error;
+  unsigned int                m_Dimension;
+  std::string                 m_PixelType;
+  std::string                 m_ComponentType;
+  unsigned int                m_NumberOfComponents;
+  std::vector<std::size_t>    m_Size;
+  std::vector<double>         m_Spacing;
+  std::vector<double>         m_Origin;
+  unsigned long long          m_ByteSize;
+};
+
+
+/**
+ * ***************** ImageIOCache ************************
+ *
+ * Remembers per file extension the ImageIO that could read a file.
+ */
+
+class ImageIOCache
+{
+public:
+  itk::ImageIOBase::Pointer CreateImageIO( const std::string & fileName )
+  {
+    const std::string extension = itksys::SystemTools::LowerCase(
+      itksys::SystemTools::GetFilenameExtension( fileName ) );
+
+    /** Ask only the ImageIO that read the previous file with this extension. */
+    this->m_Mutex.Lock();
+    std::map<std::string, itk::ImageIOBase::Pointer>::const_iterator it
+      = this->m_ImageIOs.find( extension );
+    itk::ImageIOBase::Pointer prototype;
+    if( it != this->m_ImageIOs.end() ) prototype = it->second;
+    this->m_Mutex.Unlock();
+
+    if( prototype.IsNotNull() )
+    {
+      itk::LightObject::Pointer another = prototype->CreateAnother();
+      itk::ImageIOBase::Pointer imageIO
+        = dynamic_cast<itk::ImageIOBase *>( another.GetPointer() );
+      if( imageIO.IsNotNull() && imageIO->CanReadFile( fileName.c_str() ) )
+      {
+        return imageIO;
+      }
+    }
+
+    /** Otherwise probe all ImageIOs. The factory is not guaranteed to be
+     * thread safe, but this only happens for the first files.
+     */
+    this->m_Mutex.Lock();
+    itk::ImageIOBase::Pointer imageIO = itk::ImageIOFactory::CreateImageIO(
+      fileName.c_str(), itk::ImageIOFactory::ReadMode );
+    if( imageIO.IsNotNull() ) this->m_ImageIOs[ extension ] = imageIO;
+    this->m_Mutex.Unlock();
+
+    return imageIO;
+
+  } // end CreateImageIO()
+
+private:
+  std::map<std::string, itk::ImageIOBase::Pointer>  m_ImageIOs;
+  itk::SimpleFastMutexLock                          m_Mutex;
+
+}; // end class ImageIOCache
+
+
+/**
+ * ***************** ReadImageInformationRow ************************
+ */
+
+void ReadImageInformationRow( const std::string & fileName,
+  ImageIOCache & cache, ImageInformationRow & row )
+{
+  try
+  {
+    itk::ImageIOBase::Pointer imageIO = cache.CreateImageIO( fileName );
+    if( imageIO.IsNull() )
+    {
+      row.m_Error = "no ImageIO can read this file";
+      return;
+    }
+    imageIO->SetFileName( fileName.c_str() );
+    imageIO->ReadImageInformation();
+
+    row.m_Dimension = imageIO->GetNumberOfDimensions();
+    row.m_Size.reserve( row.m_Dimension );
+    row.m_PixelType = imageIO->GetPixelTypeAsString( imageIO->GetPixelType() );
+    row.m_ComponentType = imageIO->GetComponentTypeAsString( imageIO->GetComponentType() );
+    row.m_NumberOfComponents = imageIO->GetNumberOfComponents();
+    for( unsigned int i = 0; i < row.m_Dimension; ++i )
+    {
+      row.m_Size.push_back( imageIO->GetDimensions( i ) );
+      row.m_Spacing.push_back( imageIO->GetSpacing( i ) );
+      row.m_Origin.push_back( imageIO->GetOrigin( i ) );
+    }
+    row.m_ByteSize = imageIO->GetImageSizeInBytes();
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    row.m_Error = excp.GetDescription();
+    if( row.m_Error.empty() ) row.m_Error = "the header could not be read";
+  }
+  catch( std::exception & excp )
+  {
+    row.m_Error = excp.what();
+    if( row.m_Error.empty() ) row.m_Error = "the header could not be read";
+  }
+
+} // end ReadImageInformationRow()
+
+
+/** The files of one block, shared by the threads. */
+struct BatchBlock
+{
+  const std::vector<std::string> *    m_FileNames;
+  std::size_t                         m_Begin;
+  std::size_t                         m_Next;
+  std::size_t                         m_End;
+  std::vector<ImageInformationRow> *  m_Rows;
+  ImageIOCache *                      m_Cache;
+  itk::SimpleFastMutexLock            m_Mutex;
+};
+
+
+/**
+ * ***************** ReadBlockThreaderCallback ************************
+ *
+ * The threads take the next file of the block until all are done, so that
+ * slow files do not hold up the other threads.
+ */
+
+ITK_THREAD_RETURN_TYPE ReadBlockThreaderCallback( void * arg )
+{
+  itk::MultiThreader::ThreadInfoStruct * info
+    = static_cast<itk::MultiThreader::ThreadInfoStruct *>( arg );
+  BatchBlock * block = static_cast<BatchBlock *>( info->UserData );
+
+  while( true )
+  {
+    block->m_Mutex.Lock();
+    const std::size_t i = block->m_Next++;
+    block->m_Mutex.Unlock();
+    if( i >= block->m_End ) break;
+
+    ReadImageInformationRow( ( *block->m_FileNames )[ i ], *block->m_Cache,
+      ( *block->m_Rows )[ i - block->m_Begin ] );
+  }
+
+  return ITK_THREAD_RETURN_VALUE;
+
+} // end ReadBlockThreaderCallback()
+
+
+/** Quote a CSV field, if needed. */
+std::string CSVField( const std::string & value )
+{
+  if( value.find_first_of( ",\"\n\r" ) == std::string::npos ) return value;
+
+  std::string quoted = "\"";
+  for( std::size_t i = 0; i < value.size(); ++i )
+  {
+    if( value[ i ] == '"' ) quoted += '"';
+    quoted += value[ i ];
+  }
+  return quoted + "\"";
+
+} // end CSVField()
+
+
+/** Quote and escape a JSON string. */
+std::string JSONString( const std::string & value )
+{
+  std::ostringstream stream;
+  stream << '"';
+  for( std::size_t i = 0; i < value.size(); ++i )
+  {
+    const unsigned char c = static_cast<unsigned char>( value[ i ] );
+    if( c == '"' || c == '\\' ) stream << '\\' << value[ i ];
+    else if( c == '\n' ) stream << "\\n";
+    else if( c == '\r' ) stream << "\\r";
+    else if( c == '\t' ) stream << "\\t";
+    else if( c < 0x20 )
+    {
+      stream << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' )
+        << static_cast<unsigned int>( c ) << std::dec << std::setfill( ' ' );
+    }
+    else stream << value[ i ];
+  }
+  stream << '"';
+  return stream.str();
+
+} // end JSONString()
+
+
+/** Join values with a separator, with enough digits for spacings and origins. */
+template <class T>
+std::string JoinValues( const std::vector<T> & values, const std::string & separator )
+{
+  std::ostringstream stream;
+  stream << std::setprecision( 16 );
+  for( std::size_t i = 0; i < values.size(); ++i )
+  {
+    stream << ( i == 0 ? "" : separator ) << values[ i ];
+  }
+  return stream.str();
+
+} // end JoinValues()
+
+
+/**
+ * ***************** PrintImageInformationRow ************************
+ */
+
+void PrintImageInformationRow( const std::string & fileName,
+  const ImageInformationRow & row, bool json, std::ostream & os )
+{
+  if( json )
+  {
+    os << "{\"file\": " << JSONString( fileName );
+    if( !row.m_Error.empty() )
+    {
+      os << ", \"error\": " << JSONString( row.m_Error ) << "}\n";
+      return;
+    }
+    os << ", \"dimension\": " << row.m_Dimension
+      << ", \"pixelType\": " << JSONString( row.m_PixelType )
+      << ", \"componentType\": " << JSONString( row.m_ComponentType )
+      << ", \"numberOfComponents\": " << row.m_NumberOfComponents
+      << ", \"size\": [" << JoinValues( row.m_Size, ", " ) << "]"
+      << ", \"spacing\": [" << JoinValues( row.m_Spacing, ", " ) << "]"
+      << ", \"origin\": [" << JoinValues( row.m_Origin, ", " ) << "]"
+      << ", \"byteSize\": " << row.m_ByteSize << "}\n";
+    return;
+  }
+
+  /** The vectors are space separated within their field. */
+  os << CSVField( fileName ) << ",";
+  if( !row.m_Error.empty() )
+  {
+    os << ",,,,,,,," << CSVField( row.m_Error ) << "\n";
+    return;
+  }
+  os << row.m_Dimension << ","
+    << row.m_PixelType << ","
+    << row.m_ComponentType << ","
+    << row.m_NumberOfComponents << ","
+    << JoinValues( row.m_Size, " " ) << ","
+    << JoinValues( row.m_Spacing, " " ) << ","
+    << JoinValues( row.m_Origin, " " ) << ","
+    << row.m_ByteSize << ",\n";
+
+} // end PrintImageInformationRow()
+
+
+} // end namespace anonymous
+
+
+/**
+ * ***************** PrintImageInformationBatch ************************
+ */
+
+std::size_t PrintImageInformationBatch(
+  const std::vector<std::string> & fileNames,
+  const std::string & format,
+  unsigned int numberOfThreads,
+  std::ostream & os )
+{
+  const bool json = ( format == "json" );
+  if( !json )
+  {
+    os << "file,dimension,pixelType,componentType,numberOfComponents,"
+      << "size,spacing,origin,byteSize,error\n";
+  }
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  if( numberOfThreads > 0 ) threader->SetNumberOfThreads( numberOfThreads );
+  numberOfThreads = threader->GetNumberOfThreads();
+
+  /** The files are read in blocks, so that the rows are printed in order
+   * while the memory stays bounded for long lists.
+   */
+  const std::size_t blockSize = 256 * numberOfThreads;
+  ImageIOCache cache;
+  std::size_t numberOfFailures = 0;
+  for( std::size_t begin = 0; begin < fileNames.size(); begin += blockSize )
+  {
+    const std::size_t end = std::min( begin + blockSize, fileNames.size() );
+    std::vector<ImageInformationRow> rows( end - begin );
+
+    BatchBlock block;
+    block.m_FileNames = &fileNames;
+    block.m_Begin = begin;
+    block.m_Next = begin;
+    block.m_End = end;
+    block.m_Rows = &rows;
+    block.m_Cache = &cache;
+
+    threader->SetSingleMethod( ReadBlockThreaderCallback, &block );
+    threader->SingleMethodExecute();
+
+    for( std::size_t i = 0; i < rows.size(); ++i )
+    {
+      PrintImageInformationRow( fileNames[ begin + i ], rows[ i ], json, os );
+      if( !rows[ i ].m_Error.empty() ) ++numberOfFailures;
+    }
+    os.flush();
+  }
+
+  return numberOfFailures;
+
+} // end PrintImageInformationBatch()
+
+} // end namespace itktools
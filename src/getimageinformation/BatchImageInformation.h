@@ -0,0 +1,50 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __BatchImageInformation_h_
+#define __BatchImageInformation_h_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace itktools
+{
+
+/** Print the header information of many images, one row per image, in the
+ * order of fileNames. The format is "csv" (with a header line) or "json"
+ * (one object per line). Every row has the dimension, pixel type, component
+ * type, number of components, size, spacing, origin and size of the pixel
+ * data in bytes; rows of files that could not be read have an error instead.
+ *
+ * The headers are read concurrently by numberOfThreads threads (0 means the
+ * ITK default). The ImageIO that matched a file extension is remembered, so
+ * for the following files with that extension only that ImageIO is asked
+ * whether it can read the file, instead of all registered ImageIOs.
+ *
+ * Returns the number of files that could not be read.
+ */
+std::size_t PrintImageInformationBatch(
+  const std::vector<std::string> & fileNames,
+  const std::string & format,
+  unsigned int numberOfThreads,
+  std::ostream & os );
+
+} // end namespace itktools
+
+#endif // end #ifndef __BatchImageInformation_h_
@@ -26,6 +26,7 @@
 
 #include "itkCommandLineArgumentParser.h"
 #include "ITKToolsHelpers.h"
+#include "BatchImageInformation.h"
 #include "itkImage.h"
 #include "itkImageIOBase.h"
 #include "itkImageFileReader.h"
@@ -56,7 +57,16 @@ std::string GetHelpString( void )
     << "Image information about the inputFileName is printed to screen.\n"
     << "Only one option should be given, e.g. -sp, then the spacing is printed.\n"
     << "  [-i]     index, if this option is given only e.g.\n"
-    << "spacing[index] is printed.";
+    << "spacing[index] is printed.\n"
+    << "Batch mode, for many files:\n"
+    << "pxgetimageinformation\n"
+    << "  -in      inputFileNames or patterns, e.g. \"dir/*.mhd\"\n"
+    << "  -list    text file with one inputFileName per line\n"
+    << "  [-format] output format, choose one of {csv, json}, default csv\n"
+    << "  [-threads] maximum number of threads\n"
+    << "Batch mode is used if more than one file is given, or -list or -format.\n"
+    << "One row is printed per file, with the dimension, pixel type, component\n"
+    << "type, #components, size, spacing, origin and data size in bytes.";
 
   return ss.str();
 
@@ -74,7 +84,12 @@ int main( int argc, char **argv )
   parser->SetCommandLineArguments( argc, argv );
   parser->SetProgramHelpText( GetHelpString() );
 
-  parser->MarkArgumentAsRequired( "-in", "The input filename." );
+  std::vector<std::string> exactlyOneArguments;
+  exactlyOneArguments.push_back( "-in" );
+  exactlyOneArguments.push_back( "-list" );
+
+  parser->MarkExactlyOneOfArgumentsAsRequired( exactlyOneArguments,
+    "The input filename(s) or a file with a list of input filenames." );
 
   itk::CommandLineArgumentParser::ReturnValue validateArguments = parser->CheckForRequiredArguments();
 
@@ -88,8 +103,47 @@ int main( int argc, char **argv )
   }
 
   /** Get arguments. */
-  std::string inputFileName = "";
-  parser->GetCommandLineArgument( "-in", inputFileName );
+  std::vector<std::string> inputFileNames;
+  parser->GetCommandLineArgument( "-in", inputFileNames );
+
+  std::string listFileName = "";
+  parser->GetCommandLineArgument( "-list", listFileName );
+
+  std::string format = "csv";
+  bool retformat = parser->GetCommandLineArgument( "-format", format );
+
+  unsigned int numberOfThreads = 0;
+  parser->GetCommandLineArgument( "-threads", numberOfThreads );
+
+  /** Batch mode: one row per file, read concurrently. */
+  const bool isPattern = inputFileNames.size() == 1
+    && inputFileNames[ 0 ].find_first_of( "*?[" ) != std::string::npos;
+  if( inputFileNames.size() > 1 || isPattern || !listFileName.empty() || retformat )
+  {
+    if( format != "csv" && format != "json" )
+    {
+      std::cerr << "ERROR: -format should be one of {csv, json}." << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> fileNames;
+    if( !itktools::ExpandImageFileNames( inputFileNames, listFileName, fileNames ) )
+    {
+      std::cerr << "ERROR: could not read " << listFileName << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    const std::size_t numberOfFailures = itktools::PrintImageInformationBatch(
+      fileNames, format, numberOfThreads, std::cout );
+    return numberOfFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  if( inputFileNames.empty() )
+  {
+    std::cerr << "ERROR: no input filename was given." << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string inputFileName = inputFileNames[ 0 ];
 
   int index = -1;
   bool reti = parser->GetCommandLineArgument( "-i", index );
@@ -45,7 +45,10 @@ std::string GetHelpString( void )
     << "  -in      inputFileName\n"
     << "  -out     outputFileName\n"
     << "  -[mask]  maskFileName\n"
-    << "Supported: 2D, 3D, (unsigned) char, (unsigned) short, (unsigned) int";
+    << "  [-bins]  the number of histogram bins, default 0:\n"
+    << "           one bin per intensity value for integer images, 4096 for float images;\n"
+    << "           at most 2^20\n"
+    << "Supported: 2D, 3D, (unsigned) char, (unsigned) short, (unsigned) int, float, double";
 
   return ss.str();
 
@@ -86,6 +89,9 @@ int main( int argc, char** argv )
   std::string maskFileName = "";
   parser->GetCommandLineArgument( "-mask", maskFileName );
 
+  unsigned int numberOfBins = 0;
+  parser->GetCommandLineArgument( "-bins", numberOfBins );
+
   /** Determine image properties. */
   itk::ImageIOBase::IOPixelType pixelType = itk::ImageIOBase::UNKNOWNPIXELTYPE;
   itk::ImageIOBase::IOComponentType componentType = itk::ImageIOBase::UNKNOWNCOMPONENTTYPE;
@@ -110,6 +116,8 @@ int main( int argc, char** argv )
     if( !filter ) filter = ITKToolsHistogramEqualizeImage< 2, unsigned short >::New( dim, componentType );
     if( !filter ) filter = ITKToolsHistogramEqualizeImage< 2, int >::New( dim, componentType );
     if( !filter ) filter = ITKToolsHistogramEqualizeImage< 2, unsigned int >::New( dim, componentType );
+    if( !filter ) filter = ITKToolsHistogramEqualizeImage< 2, float >::New( dim, componentType );
+    if( !filter ) filter = ITKToolsHistogramEqualizeImage< 2, double >::New( dim, componentType );
 
 #ifdef ITKTOOLS_3D_SUPPORT
     if( !filter ) filter = ITKToolsHistogramEqualizeImage< 3, char >::New( dim, componentType );
@@ -118,6 +126,8 @@ int main( int argc, char** argv )
     if( !filter ) filter = ITKToolsHistogramEqualizeImage< 3, unsigned short >::New( dim, componentType );
     if( !filter ) filter = ITKToolsHistogramEqualizeImage< 3, int >::New( dim, componentType );
     if( !filter ) filter = ITKToolsHistogramEqualizeImage< 3, unsigned int >::New( dim, componentType );
+    if( !filter ) filter = ITKToolsHistogramEqualizeImage< 3, float >::New( dim, componentType );
+    if( !filter ) filter = ITKToolsHistogramEqualizeImage< 3, double >::New( dim, componentType );
 #endif
     /** Check if filter was instantiated. */
     bool supported = itktools::IsFilterSupportedCheck( filter, dim, componentType );
@@ -127,6 +137,7 @@ int main( int argc, char** argv )
     filter->m_InputFileName = inputFileName;
     filter->m_OutputFileName = outputFileName;
     filter->m_MaskFileName = maskFileName;
+    filter->m_NumberOfBins = numberOfBins;
 
     filter->Run();
 
@@ -40,6 +40,7 @@ public:
     this->m_InputFileName = "";
     this->m_OutputFileName = "";
     this->m_MaskFileName = "";
+    this->m_NumberOfBins = 0;
   };
   /** Destructor. */
   ~ITKToolsHistogramEqualizeImageBase(){};
@@ -48,6 +49,7 @@ public:
   std::string m_InputFileName;
   std::string m_OutputFileName;
   std::string m_MaskFileName;
+  unsigned int m_NumberOfBins;
 
 }; // end class ITKToolsHistogramEqualizeImageBase
 
@@ -107,6 +109,7 @@ public:
 
     /** Setup pipeline and configure its components */
     enhancer->SetInput( reader->GetOutput() );
+    enhancer->SetNumberOfBins( this->m_NumberOfBins );
     if( this->m_MaskFileName != "" )
     {
       enhancer->SetMask( maskReader->GetOutput() );
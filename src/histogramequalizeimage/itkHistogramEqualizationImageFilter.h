@@ -20,6 +20,8 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkArray.h"
+#include "itkStageMultiThreader.h"
+#include <vector>
 
 
 namespace itk
@@ -32,6 +34,14 @@ namespace itk
  * In contrast to the AdaptiveHistogramEqualizationImageFilter it is not adaptive
  * and therefore faster.
  *
+ * The histogram is accumulated in parallel, in per-thread histograms that
+ * are merged afterwards. For (unsigned) char and short images a single pass
+ * over the image suffices, for other types the minimum and maximum are
+ * determined first. By default integer images get one bin per intensity
+ * value, and floating point images 4096 bins, but never more than
+ * MaximumNumberOfBins. Use SetNumberOfBins() to limit the number of bins
+ * further, e.g. for int images with a wide range.
+ *
  * \ingroup IntensityImageFilters
  *
  */
@@ -89,8 +99,16 @@ public:
   itkSetObjectMacro( Mask, MaskImageType );
   itkGetObjectMacro( Mask, MaskImageType );
 
-  //itkSetMacro( NumberOfBins, unsigned int );
-  //itkGetConstReferenceMacro( NumberOfBins, unsigned int );
+  /** Set/Get the number of histogram bins. Default 0, meaning one bin per
+   * intensity value for integer images, and 4096 bins for floating point
+   * images. For integer images it is never more than one bin per value,
+   * and it is never more than MaximumNumberOfBins. */
+  itkSetMacro( NumberOfBins, unsigned int );
+  itkGetConstReferenceMacro( NumberOfBins, unsigned int );
+
+  /** The maximum number of histogram bins, 2^20. Integer images with a
+   * wider range get several values per bin. */
+  itkStaticConstMacro( MaximumNumberOfBins, unsigned int, 1u << 20 );
 
 protected:
   HistogramEqualizationImageFilter();
@@ -98,16 +116,46 @@ protected:
   void PrintSelf(std::ostream& os, Indent indent) const;
 
   typedef itk::Array<OutputImagePixelType> LUTType;
+  typedef itk::Array<SizeValueType>        HistogramType;
   LUTType m_LUT;
 
   unsigned int        m_NumberOfBins;
+  unsigned int        m_NumberOfHistogramBins;
   InputImagePixelType m_Min;
   InputImagePixelType m_Max;
   double              m_MeanFrequency;
+  double              m_BinScale;
   MaskImagePointer    m_Mask;
 
-  /** Initialize some accumulators before the threads run.
-   * Create a LUT */
+  /** Per-thread accumulators, merged after each stage. */
+  std::vector<InputImagePixelType> m_ThreadMin;
+  std::vector<InputImagePixelType> m_ThreadMax;
+  std::vector<SizeValueType>       m_ThreadNumberOfValidPixels;
+  std::vector<HistogramType>       m_ThreadHistograms;
+
+  /** The bin of an intensity value, clamped to the valid range. */
+  inline unsigned int GetBinIndex( const InputImagePixelType & value ) const
+  {
+    const double bin = ( static_cast<double>( value )
+      - static_cast<double>( this->m_Min ) ) * this->m_BinScale;
+    const double maxBin = this->m_NumberOfHistogramBins - 1;
+    return static_cast<unsigned int>( bin < 0.0 ? 0.0 : ( bin > maxBin ? maxBin : bin ) );
+  }
+
+  /** The minimum, maximum and histogram are computed in multithreaded
+   * stages before the LUT is applied, with StageThreaderType::Execute(). */
+  typedef StageMultiThreader<Self> StageThreaderType;
+
+  /** Run a stage on all threads. */
+  void ExecuteStage( typename StageThreaderType::StageMethodType stage )
+  {
+    StageThreaderType::Execute( this->GetMultiThreader(), this->GetNumberOfThreads(), this, stage );
+  }
+
+  /** Determine the number of bins and the bin scale from m_Min and m_Max. */
+  virtual void ComputeBinning( void );
+
+  /** Accumulate the histogram in parallel and create the LUT. */
   virtual void BeforeThreadedGenerateData( void );
 
   /** Tally accumulated in threads. */
@@ -118,6 +166,19 @@ protected:
     const OutputImageRegionType & outputRegionForThread,
     ThreadIdType threadId );
 
+  /** The stages that precede it, on the part of the output requested
+   * region of a thread. */
+  void ThreadedComputeMinimumMaximum(
+    ThreadIdType threadId, ThreadIdType numberOfThreads );
+  void ThreadedComputeHistogram(
+    ThreadIdType threadId, ThreadIdType numberOfThreads );
+  void ThreadedComputeFullRangeHistogram(
+    ThreadIdType threadId, ThreadIdType numberOfThreads );
+
+  /** Accumulate the histogram of a region in the histogram of a thread. */
+  void ComputeHistogram( const OutputImageRegionType & region,
+    ThreadIdType threadId, bool fullRange );
+
 private:
   HistogramEqualizationImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
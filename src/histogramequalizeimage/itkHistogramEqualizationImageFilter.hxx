@@ -24,6 +24,7 @@
 #include "itkImageRegionConstIterator.h"
 #include "itkNumericTraits.h"
 #include "itkProgressReporter.h"
+#include "vnl/vnl_math.h"
 
 
 namespace itk {
@@ -35,7 +36,9 @@ HistogramEqualizationImageFilter<TImage>
   this->m_Min = itk::NumericTraits<InputImagePixelType>::max();
   this->m_Max = itk::NumericTraits<InputImagePixelType>::NonpositiveMin();
   this->m_MeanFrequency = 1.0;
-  this->m_NumberOfBins = 1;
+  this->m_NumberOfBins = 0;
+  this->m_NumberOfHistogramBins = 1;
+  this->m_BinScale = 1.0;
 }
 
 template<class TImage>
@@ -44,35 +47,235 @@ HistogramEqualizationImageFilter<TImage>
 {
 }
 
+
+template<class TImage>
+void
+HistogramEqualizationImageFilter<TImage>
+::ComputeBinning( void )
+{
+  const double range = static_cast<double>( this->m_Max )
+    - static_cast<double>( this->m_Min );
+
+  /** No valid pixels. */
+  if( range < 0.0 )
+  {
+    this->m_NumberOfHistogramBins = 1;
+    this->m_BinScale = 0.0;
+    return;
+  }
+
+  /** The per-thread histograms must fit in memory, and the number of bins
+   * of e.g. a full range int image would not even fit in an unsigned int. */
+  const double maximumNumberOfBins = static_cast<double>( MaximumNumberOfBins );
+
+  if( itk::NumericTraits<InputImagePixelType>::is_integer )
+  {
+    /** One bin per intensity value, unless the user asks for less. */
+    const double numberOfValues = range + 1.0;
+    double numberOfBins = vnl_math_min( numberOfValues, maximumNumberOfBins );
+    if( this->m_NumberOfBins > 0 )
+    {
+      numberOfBins = vnl_math_min( numberOfBins,
+        static_cast<double>( this->m_NumberOfBins ) );
+    }
+    this->m_NumberOfHistogramBins = static_cast<unsigned int>( numberOfBins );
+    this->m_BinScale = numberOfBins / numberOfValues;
+  }
+  else
+  {
+    this->m_NumberOfHistogramBins = this->m_NumberOfBins > 0
+      ? static_cast<unsigned int>( vnl_math_min(
+        static_cast<double>( this->m_NumberOfBins ), maximumNumberOfBins ) )
+      : 4096;
+    this->m_BinScale = range > 0.0 ? this->m_NumberOfHistogramBins / range : 0.0;
+  }
+
+} // end ComputeBinning()
+
+
 template<class TImage>
 void
 HistogramEqualizationImageFilter<TImage>
 ::BeforeThreadedGenerateData( void )
+{
+  const unsigned int numberOfThreads = this->GetNumberOfThreads();
+
+  /** Initialize the per-thread accumulators. */
+  this->m_ThreadMin.assign( numberOfThreads,
+    itk::NumericTraits<InputImagePixelType>::max() );
+  this->m_ThreadMax.assign( numberOfThreads,
+    itk::NumericTraits<InputImagePixelType>::NonpositiveMin() );
+  this->m_ThreadNumberOfValidPixels.assign( numberOfThreads, 0 );
+  this->m_ThreadHistograms.resize( numberOfThreads );
+
+  /** For small integer types a histogram over the full range of the type is
+   * cheap, so the minimum, maximum and histogram are obtained in one pass.
+   * Otherwise the minimum and maximum are needed first, to define the bins.
+   */
+  const bool fullRange = itk::NumericTraits<InputImagePixelType>::is_integer
+    && sizeof( InputImagePixelType ) <= 2;
+
+  HistogramType hist;
+  SizeValueType numberOfValidPixels = 0;
+  if( fullRange )
+  {
+    const unsigned int numberOfValues = 1u << ( 8 * sizeof( InputImagePixelType ) );
+    for( unsigned int t = 0; t < numberOfThreads; ++t )
+    {
+      this->m_ThreadHistograms[ t ].SetSize( numberOfValues );
+      this->m_ThreadHistograms[ t ].Fill( 0 );
+    }
+    this->ExecuteStage( &Self::ThreadedComputeFullRangeHistogram );
+
+    /** Merge the thread histograms. */
+    HistogramType fullHist( numberOfValues );
+    fullHist.Fill( 0 );
+    for( unsigned int t = 0; t < numberOfThreads; ++t )
+    {
+      fullHist += this->m_ThreadHistograms[ t ];
+      this->m_ThreadHistograms[ t ].SetSize( 0 );
+    }
+
+    /** Derive the minimum and maximum from the histogram. */
+    const InputImagePixelType typeMin
+      = itk::NumericTraits<InputImagePixelType>::NonpositiveMin();
+    unsigned int first = 0;
+    unsigned int last = 0;
+    bool found = false;
+    for( unsigned int i = 0; i < numberOfValues; ++i )
+    {
+      if( fullHist[ i ] == 0 ) continue;
+      if( !found ) first = i;
+      last = i;
+      found = true;
+      numberOfValidPixels += fullHist[ i ];
+    }
+    this->m_Min = static_cast<InputImagePixelType>( typeMin + static_cast<int>( first ) );
+    this->m_Max = static_cast<InputImagePixelType>( typeMin + static_cast<int>( last ) );
+    if( !found )
+    {
+      this->m_Min = itk::NumericTraits<InputImagePixelType>::max();
+      this->m_Max = itk::NumericTraits<InputImagePixelType>::NonpositiveMin();
+    }
+    this->ComputeBinning();
+
+    /** Rebin the values between the minimum and maximum. */
+    hist.SetSize( this->m_NumberOfHistogramBins );
+    hist.Fill( 0 );
+    for( unsigned int i = first; found && i <= last; ++i )
+    {
+      const InputImagePixelType value
+        = static_cast<InputImagePixelType>( typeMin + static_cast<int>( i ) );
+      hist[ this->GetBinIndex( value ) ] += fullHist[ i ];
+    }
+  }
+  else
+  {
+    /** Compute minimum and maximum of the input image. */
+    this->ExecuteStage( &Self::ThreadedComputeMinimumMaximum );
+
+    InputImagePixelType tempmin = itk::NumericTraits<InputImagePixelType>::max();
+    InputImagePixelType tempmax =
+      itk::NumericTraits<InputImagePixelType>::NonpositiveMin();
+    for( unsigned int t = 0; t < numberOfThreads; ++t )
+    {
+      tempmin = vnl_math_min( tempmin, this->m_ThreadMin[ t ] );
+      tempmax = vnl_math_max( tempmax, this->m_ThreadMax[ t ] );
+      numberOfValidPixels += this->m_ThreadNumberOfValidPixels[ t ];
+    }
+    this->m_Min = tempmin;
+    this->m_Max = tempmax;
+    this->ComputeBinning();
+
+    /** Compute the histogram of the input image. */
+    for( unsigned int t = 0; t < numberOfThreads; ++t )
+    {
+      this->m_ThreadHistograms[ t ].SetSize( this->m_NumberOfHistogramBins );
+      this->m_ThreadHistograms[ t ].Fill( 0 );
+    }
+    this->ExecuteStage( &Self::ThreadedComputeHistogram );
+
+    hist.SetSize( this->m_NumberOfHistogramBins );
+    hist.Fill( 0 );
+    for( unsigned int t = 0; t < numberOfThreads; ++t )
+    {
+      hist += this->m_ThreadHistograms[ t ];
+      this->m_ThreadHistograms[ t ].SetSize( 0 );
+    }
+  }
+
+  /** Compute the ideal number of times a bin should occur in the image. */
+  this->m_MeanFrequency =
+    static_cast<double>( numberOfValidPixels ) /
+    static_cast<double>( this->m_NumberOfHistogramBins );
+
+  /** convert it to a cumulative histogram */
+  for( unsigned int i = 1; i < this->m_NumberOfHistogramBins; i++ )
+  {
+    hist[ i ] += hist[i-1];
+  }
+
+  /** Compute LUT. Equalized bins are spread over [min, max], which for one
+   * bin per intensity value gives steps of 1. */
+  const double tempmin = static_cast<double>( this->m_Min );
+  const double binWidth = this->m_NumberOfHistogramBins > 1
+    ? ( static_cast<double>( this->m_Max ) - tempmin )
+      / static_cast<double>( this->m_NumberOfHistogramBins - 1 )
+    : 1.0;
+  this->m_LUT.SetSize(this->m_NumberOfHistogramBins);
+  for( unsigned int i = 0; i < this->m_NumberOfHistogramBins; i++ )
+  {
+    this->m_LUT[ i ] = static_cast<OutputImagePixelType>(
+      vnl_math_max(
+      tempmin,
+      tempmin + binWidth * ( -1.0 + vcl_floor( static_cast<double>( hist[ i ] ) / this->m_MeanFrequency + 0.5 ) ) ) );
+  }
+
+} // end BeforeThreadedGenerateData()
+
+
+template<class TImage>
+void
+HistogramEqualizationImageFilter<TImage>
+::AfterThreadedGenerateData( void )
+{
+  //nothing
+} // end AfterThreadedGenerateData()
+
+
+template<class TImage>
+void
+HistogramEqualizationImageFilter<TImage>
+::ThreadedComputeMinimumMaximum(
+  ThreadIdType threadId, ThreadIdType numberOfThreads )
 {
   typedef ImageRegionConstIterator<InputImageType>   ImageIteratorType;
   typedef ImageRegionConstIterator<MaskImageType>    MaskIteratorType;
 
-  /** Use a mask or not */
-  bool useMask = false;
-  if( this->GetMask() )
+  this->m_ThreadNumberOfValidPixels[ threadId ] = 0;
+  OutputImageRegionType outputRegionForThread;
+  if( !StageThreaderType::SplitRegion( this->GetOutput()->GetRequestedRegion(),
+    threadId, numberOfThreads, outputRegionForThread ) )
   {
-    useMask = true;
+    return;
   }
 
-  /** Compute minimum and maximum of the input image */
-  ImageIteratorType it( this->GetInput(), this->GetOutput()->GetRequestedRegion() );
+  /** Use a mask or not */
+  const bool useMask = this->GetMask() != 0;
+
+  ImageIteratorType it( this->GetInput(), outputRegionForThread );
   MaskIteratorType maskIt;
   if( useMask )
   {
-    maskIt = MaskIteratorType( this->GetMask(), this->GetOutput()->GetRequestedRegion() );
+    maskIt = MaskIteratorType( this->GetMask(), outputRegionForThread );
     maskIt.GoToBegin();
   }
 
   InputImagePixelType tempmin = itk::NumericTraits<InputImagePixelType>::max();
   InputImagePixelType tempmax =
     itk::NumericTraits<InputImagePixelType>::NonpositiveMin();
+  SizeValueType numberOfValidPixels = 0;
 
-  unsigned long numberOfValidPixels = 0;
   it.GoToBegin();
   while ( !it.IsAtEnd() )
   {
@@ -98,25 +301,69 @@ HistogramEqualizationImageFilter<TImage>
     ++it;
   }
 
-  this->m_Min = tempmin;
-  this->m_Max = tempmax;
+  this->m_ThreadMin[ threadId ] = tempmin;
+  this->m_ThreadMax[ threadId ] = tempmax;
+  this->m_ThreadNumberOfValidPixels[ threadId ] = numberOfValidPixels;
 
-  /** Compute the number of bins and the ideal number of times a intensity value
-   * should occur in the image */
-  this->m_NumberOfBins = tempmax - tempmin + 1;
-  this->m_MeanFrequency =
-    static_cast<double>( numberOfValidPixels ) /
-    static_cast<double>( this->m_NumberOfBins );
+} // end ThreadedComputeMinimumMaximum()
 
-  /** Compute the histogram of the input image */
-  typedef itk::Array<unsigned long> HistogramType;
-  HistogramType hist( this->m_NumberOfBins );
-  hist.Fill( 0 );
-  it.GoToBegin();
+
+template<class TImage>
+void
+HistogramEqualizationImageFilter<TImage>
+::ThreadedComputeHistogram(
+  ThreadIdType threadId, ThreadIdType numberOfThreads )
+{
+  OutputImageRegionType region;
+  if( StageThreaderType::SplitRegion( this->GetOutput()->GetRequestedRegion(),
+    threadId, numberOfThreads, region ) )
+  {
+    this->ComputeHistogram( region, threadId, false );
+  }
+} // end ThreadedComputeHistogram()
+
+
+template<class TImage>
+void
+HistogramEqualizationImageFilter<TImage>
+::ThreadedComputeFullRangeHistogram(
+  ThreadIdType threadId, ThreadIdType numberOfThreads )
+{
+  OutputImageRegionType region;
+  if( StageThreaderType::SplitRegion( this->GetOutput()->GetRequestedRegion(),
+    threadId, numberOfThreads, region ) )
+  {
+    this->ComputeHistogram( region, threadId, true );
+  }
+} // end ThreadedComputeFullRangeHistogram()
+
+
+template<class TImage>
+void
+HistogramEqualizationImageFilter<TImage>
+::ComputeHistogram(
+  const OutputImageRegionType & outputRegionForThread,
+  ThreadIdType threadId, bool fullRange )
+{
+  typedef ImageRegionConstIterator<InputImageType>   ImageIteratorType;
+  typedef ImageRegionConstIterator<MaskImageType>    MaskIteratorType;
+
+  /** Use a mask or not */
+  const bool useMask = this->GetMask() != 0;
+
+  ImageIteratorType it( this->GetInput(), outputRegionForThread );
+  MaskIteratorType maskIt;
   if( useMask )
   {
+    maskIt = MaskIteratorType( this->GetMask(), outputRegionForThread );
     maskIt.GoToBegin();
   }
+
+  HistogramType & hist = this->m_ThreadHistograms[ threadId ];
+  const int typeMin = static_cast<int>(
+    itk::NumericTraits<InputImagePixelType>::NonpositiveMin() );
+
+  it.GoToBegin();
   while ( !it.IsAtEnd() )
   {
     bool validPixel = true;
@@ -127,38 +374,19 @@ HistogramEqualizationImageFilter<TImage>
     }
     if( validPixel )
     {
-      // assuming integer pixel type of binsize 1
-      hist[ static_cast<unsigned int>( it.Value() - tempmin ) ]++;
+      if( fullRange )
+      {
+        hist[ static_cast<unsigned int>( static_cast<int>( it.Value() ) - typeMin ) ]++;
+      }
+      else
+      {
+        hist[ this->GetBinIndex( it.Value() ) ]++;
+      }
     }
     ++it;
   }
 
-  /** convert it to a cumulative histogram */
-  for( unsigned int i = 1; i < this->m_NumberOfBins; i++ )
-  {
-    hist[ i ] += hist[i-1];
-  }
-
-  /** Compute LUT */
-  this->m_LUT.SetSize(this->m_NumberOfBins);
-  for( unsigned int i = 0; i < this->m_NumberOfBins; i++ )
-  {
-    this->m_LUT[ i ] = static_cast<OutputImagePixelType>(
-      vnl_math_max(
-      static_cast<double>( tempmin ),
-      -1.0 + tempmin + vcl_floor( static_cast<double>( hist[ i ] ) / this->m_MeanFrequency + 0.5 ) ) );
-  }
-
-} // end BeforeThreadedGenerateData()
-
-
-template<class TImage>
-void
-HistogramEqualizationImageFilter<TImage>
-::AfterThreadedGenerateData( void )
-{
-  //nothing
-} // end AfterThreadedGenerateData()
+} // end ComputeHistogram()
 
 
 template<class TImage>
@@ -173,43 +401,41 @@ HistogramEqualizationImageFilter<TImage>
   typedef ImageRegionConstIterator<MaskImageType>    MaskIteratorType;
 
   /** Use a mask or not */
-  bool useMask = false;
-  if( this->GetMask() ) useMask = true;
+  const bool useMask = this->GetMask() != 0;
 
   InputImageIteratorType  it( this->GetInput(), outputRegionForThread );
   OutputImageIteratorType ot( this->GetOutput(), outputRegionForThread );
-  MaskIteratorType maskIt;
-  if( useMask )
-  {
-    maskIt = MaskIteratorType( this->GetMask(), outputRegionForThread );
-    maskIt.GoToBegin();
-  }
 
   // support progress methods/callbacks
   ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
 
-  LUTType & lut = this->m_LUT;
-  InputImagePixelType & tempmin = this->m_Min;
+  const OutputImagePixelType * lut = this->m_LUT.data_block();
 
-  // shift and scale the input pixels
-  while( !it.IsAtEnd() )
+  // map the input pixels through the LUT; the bin index is clamped
+  // instead of tested, so the loop body is a plain gather
+  if( !useMask )
   {
-    bool validPixel = true;
-    if( useMask )
+    while( !it.IsAtEnd() )
     {
-      validPixel = static_cast<bool>( maskIt.Value() );
-      ++maskIt;
-    }
-    if( validPixel )
-    {
-      ot.Set( lut[ static_cast<unsigned int>( it.Value() - tempmin ) ] );
-    }
-    else
-    {
-      ot.Set( it.Value() ); // original?
+      ot.Set( lut[ this->GetBinIndex( it.Value() ) ] );
+      ++it;
+      ++ot;
+      progress.CompletedPixel();
     }
+    return;
+  }
+
+  MaskIteratorType maskIt( this->GetMask(), outputRegionForThread );
+  maskIt.GoToBegin();
+  while( !it.IsAtEnd() )
+  {
+    /** Pixels outside the mask keep their original value. */
+    const InputImagePixelType value = it.Value();
+    const OutputImagePixelType mapped = lut[ this->GetBinIndex( value ) ];
+    ot.Set( maskIt.Value() ? mapped : static_cast<OutputImagePixelType>( value ) );
     ++it;
     ++ot;
+    ++maskIt;
     progress.CompletedPixel();
   }
 } // end ThreadedGenerateData()
@@ -223,6 +449,7 @@ HistogramEqualizationImageFilter<TImage>
   Superclass::PrintSelf(os,indent);
 
   os << indent << "NumberOfBins: "  << this->m_NumberOfBins << std::endl;
+  os << indent << "NumberOfHistogramBins: "  << this->m_NumberOfHistogramBins << std::endl;
   os << indent << "Minimum intensity: "  << this->m_Min << std::endl;
   os << indent << "Maximum intensity: "  << this->m_Max << std::endl;
 
@@ -0,0 +1,625 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#include "ImageExpression.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include "vnl/vnl_math.h"
+#include "vnl/vnl_erf.h"
+#include "vcl_cmath.h"
+
+
+namespace itktools
+{
+
+/**
+ * ******************* Parser *******************
+ *
+ * A recursive descent parser that emits the postfix program directly.
+ */
+
+class ImageExpression::Parser
+{
+public:
+  Parser( ImageExpression * expression, const std::string & text,
+    const std::vector<std::string> & names )
+    : m_Expression( expression ), m_Text( text ), m_Names( names ), m_Position( 0 )
+  {}
+
+  bool ParseAll( std::string & errorMessage )
+  {
+    bool ok = this->ParseTernary();
+    this->SkipSpace();
+    if( ok && this->m_Position != this->m_Text.size() )
+    {
+      ok = this->Error( "unexpected character" );
+    }
+    if( !ok )
+    {
+      std::ostringstream oss;
+      oss << this->m_Error << " at position " << this->m_Position
+        << " in \"" << this->m_Text << "\"";
+      errorMessage = oss.str();
+    }
+    return ok;
+  }
+
+private:
+  ImageExpression *                 m_Expression;
+  const std::string &               m_Text;
+  const std::vector<std::string> &  m_Names;
+  std::string::size_type            m_Position;
+  std::string                       m_Error;
+
+  bool Error( const std::string & message )
+  {
+    if( this->m_Error.empty() ) this->m_Error = message;
+    return false;
+  }
+
+  void SkipSpace( void )
+  {
+    while( this->m_Position < this->m_Text.size()
+      && std::isspace( static_cast<unsigned char>( this->m_Text[ this->m_Position ] ) ) )
+    {
+      ++this->m_Position;
+    }
+  }
+
+  /** Consume token if it is next; "<" does not match the start of "<=". */
+  bool Accept( const char * token )
+  {
+    this->SkipSpace();
+    const std::size_t length = std::strlen( token );
+    if( this->m_Text.compare( this->m_Position, length, token ) != 0 ) return false;
+    const std::string::size_type next = this->m_Position + length;
+    if( length == 1 && next < this->m_Text.size() && this->m_Text[ next ] == '='
+      && std::strchr( "<>=!", token[ 0 ] ) )
+    {
+      return false;
+    }
+    if( length == 1 && next < this->m_Text.size() && this->m_Text[ next ] == token[ 0 ]
+      && std::strchr( "&|", token[ 0 ] ) )
+    {
+      return false;
+    }
+    this->m_Position = next;
+    return true;
+  }
+
+  bool Expect( const char * token )
+  {
+    if( this->Accept( token ) ) return true;
+    return this->Error( std::string( "expected \"" ) + token + "\"" );
+  }
+
+  bool ParseTernary( void )
+  {
+    if( !this->ParseOr() ) return false;
+    if( !this->Accept( "?" ) ) return true;
+    if( !this->ParseTernary() || !this->Expect( ":" ) || !this->ParseTernary() )
+    {
+      return false;
+    }
+    this->m_Expression->Emit( SELECT );
+    return true;
+  }
+
+  bool ParseOr( void )
+  {
+    if( !this->ParseAnd() ) return false;
+    while( this->Accept( "||" ) )
+    {
+      if( !this->ParseAnd() ) return false;
+      this->m_Expression->Emit( OR );
+    }
+    return true;
+  }
+
+  bool ParseAnd( void )
+  {
+    if( !this->ParseEquality() ) return false;
+    while( this->Accept( "&&" ) )
+    {
+      if( !this->ParseEquality() ) return false;
+      this->m_Expression->Emit( AND );
+    }
+    return true;
+  }
+
+  bool ParseEquality( void )
+  {
+    if( !this->ParseRelational() ) return false;
+    while( true )
+    {
+      OpCode code;
+      if( this->Accept( "==" ) ) code = EQUAL;
+      else if( this->Accept( "!=" ) ) code = NOTEQUAL;
+      else return true;
+      if( !this->ParseRelational() ) return false;
+      this->m_Expression->Emit( code );
+    }
+  }
+
+  bool ParseRelational( void )
+  {
+    if( !this->ParseAdditive() ) return false;
+    while( true )
+    {
+      OpCode code;
+      if( this->Accept( "<=" ) ) code = LESSEQUAL;
+      else if( this->Accept( ">=" ) ) code = GREATEREQUAL;
+      else if( this->Accept( "<" ) ) code = LESS;
+      else if( this->Accept( ">" ) ) code = GREATER;
+      else return true;
+      if( !this->ParseAdditive() ) return false;
+      this->m_Expression->Emit( code );
+    }
+  }
+
+  bool ParseAdditive( void )
+  {
+    if( !this->ParseMultiplicative() ) return false;
+    while( true )
+    {
+      OpCode code;
+      if( this->Accept( "+" ) ) code = ADD;
+      else if( this->Accept( "-" ) ) code = SUBTRACT;
+      else return true;
+      if( !this->ParseMultiplicative() ) return false;
+      this->m_Expression->Emit( code );
+    }
+  }
+
+  bool ParseMultiplicative( void )
+  {
+    if( !this->ParseUnary() ) return false;
+    while( true )
+    {
+      OpCode code;
+      if( this->Accept( "*" ) ) code = MULTIPLY;
+      else if( this->Accept( "/" ) ) code = DIVIDE;
+      else if( this->Accept( "%" ) ) code = MODULO;
+      else return true;
+      if( !this->ParseUnary() ) return false;
+      this->m_Expression->Emit( code );
+    }
+  }
+
+  bool ParseUnary( void )
+  {
+    if( this->Accept( "-" ) )
+    {
+      if( !this->ParseUnary() ) return false;
+      this->m_Expression->Emit( NEGATE );
+      return true;
+    }
+    if( this->Accept( "!" ) )
+    {
+      if( !this->ParseUnary() ) return false;
+      this->m_Expression->Emit( NOT );
+      return true;
+    }
+    if( this->Accept( "+" ) ) return this->ParseUnary();
+    return this->ParsePower();
+  }
+
+  bool ParsePower( void )
+  {
+    if( !this->ParsePrimary() ) return false;
+    if( !this->Accept( "^" ) ) return true;
+    if( !this->ParseUnary() ) return false;
+    this->m_Expression->Emit( POWER );
+    return true;
+  }
+
+  bool ParsePrimary( void )
+  {
+    this->SkipSpace();
+    if( this->m_Position >= this->m_Text.size() )
+    {
+      return this->Error( "unexpected end of expression" );
+    }
+
+    if( this->Accept( "(" ) )
+    {
+      return this->ParseTernary() && this->Expect( ")" );
+    }
+
+    /** A number. */
+    const char * begin = this->m_Text.c_str() + this->m_Position;
+    if( std::isdigit( static_cast<unsigned char>( *begin ) ) || *begin == '.' )
+    {
+      char * end = 0;
+      const double value = std::strtod( begin, &end );
+      if( end == begin ) return this->Error( "invalid number" );
+      this->m_Position += end - begin;
+      this->m_Expression->Emit( LOADCONSTANT, 0, value );
+      return true;
+    }
+
+    /** A name or a function call. */
+    if( !std::isalpha( static_cast<unsigned char>( *begin ) ) && *begin != '_' )
+    {
+      return this->Error( "unexpected character" );
+    }
+    const std::string::size_type start = this->m_Position;
+    while( this->m_Position < this->m_Text.size()
+      && ( std::isalnum( static_cast<unsigned char>( this->m_Text[ this->m_Position ] ) )
+      || this->m_Text[ this->m_Position ] == '_' ) )
+    {
+      ++this->m_Position;
+    }
+    const std::string name = this->m_Text.substr( start, this->m_Position - start );
+
+    for( unsigned int i = 0; i < this->m_Names.size(); ++i )
+    {
+      if( name == this->m_Names[ i ] )
+      {
+        this->m_Expression->Emit( LOADINPUT, i );
+        return true;
+      }
+    }
+    if( name == "pi" )
+    {
+      this->m_Expression->Emit( LOADCONSTANT, 0, vnl_math::pi );
+      return true;
+    }
+
+    return this->ParseFunction( name, start );
+  }
+
+  bool ParseFunction( const std::string & name, const std::string::size_type & start )
+  {
+    /** The functions and their number of arguments; 0 means two or more. */
+    static const struct { const char * Name; OpCode Code; unsigned int Arity; } functions[] = {
+      { "abs", ABS, 1 }, { "sqrt", SQRT, 1 }, { "sqr", SQR, 1 }, { "exp", EXP, 1 },
+      { "ln", LN, 1 }, { "log10", LOG10, 1 }, { "sin", SIN, 1 }, { "cos", COS, 1 },
+      { "tan", TAN, 1 }, { "asin", ASIN, 1 }, { "acos", ACOS, 1 }, { "atan", ATAN, 1 },
+      { "erf", ERF, 1 }, { "round", ROUND, 1 }, { "floor", FLOOR, 1 },
+      { "ceil", CEIL, 1 }, { "sign", SIGN, 1 }, { "atan2", ATAN2, 2 },
+      { "pow", POWER, 2 }, { "mod", MODULO, 2 }, { "min", MINIMUM, 0 },
+      { "max", MAXIMUM, 0 } };
+    const unsigned int numberOfFunctions = sizeof( functions ) / sizeof( functions[ 0 ] );
+
+    unsigned int f = 0;
+    while( f < numberOfFunctions && name != functions[ f ].Name ) ++f;
+    if( f == numberOfFunctions )
+    {
+      this->m_Position = start;
+      return this->Error( "unknown image or function \"" + name + "\"" );
+    }
+    if( !this->Expect( "(" ) ) return false;
+
+    unsigned int numberOfArguments = 0;
+    do
+    {
+      if( !this->ParseTernary() ) return false;
+      ++numberOfArguments;
+
+      /** min and max are folded pairwise. */
+      if( functions[ f ].Arity == 0 && numberOfArguments > 1 )
+      {
+        this->m_Expression->Emit( functions[ f ].Code );
+      }
+    } while( this->Accept( "," ) );
+    if( !this->Expect( ")" ) ) return false;
+
+    const unsigned int arity = functions[ f ].Arity;
+    if( ( arity == 0 && numberOfArguments < 2 )
+      || ( arity > 0 && numberOfArguments != arity ) )
+    {
+      this->m_Position = start;
+      return this->Error( "wrong number of arguments to \"" + name + "\"" );
+    }
+    if( arity > 0 ) this->m_Expression->Emit( functions[ f ].Code );
+
+    return true;
+  }
+
+}; // end class Parser
+
+
+/**
+ * ******************* Constructor *******************
+ */
+
+ImageExpression::ImageExpression()
+{
+  this->m_StackDepth = 0;
+  this->m_NumberOfInputs = 0;
+  this->m_IntegerModulo = false;
+  this->m_DivisionByZeroValue = 0.0;
+} // end Constructor
+
+
+/**
+ * ******************* Parse *******************
+ */
+
+bool
+ImageExpression::Parse( const std::string & expression,
+  const std::vector<std::string> & names,
+  std::string & errorMessage )
+{
+  this->m_Program.clear();
+  this->m_NumberOfInputs = names.size();
+
+  Parser parser( this, expression, names );
+  if( !parser.ParseAll( errorMessage ) )
+  {
+    this->m_Program.clear();
+    this->m_StackDepth = 0;
+    return false;
+  }
+
+  /** The stack depth of the (folded) program. */
+  unsigned int depth = 0;
+  this->m_StackDepth = 0;
+  for( std::size_t i = 0; i < this->m_Program.size(); ++i )
+  {
+    const OpCode code = this->m_Program[ i ].Code;
+    if( code == LOADINPUT || code == LOADCONSTANT ) ++depth;
+    else depth -= GetArity( code ) - 1;
+    if( depth > this->m_StackDepth ) this->m_StackDepth = depth;
+  }
+
+  return true;
+
+} // end Parse()
+
+
+/**
+ * ******************* GetArity *******************
+ */
+
+unsigned int
+ImageExpression::GetArity( const OpCode & code )
+{
+  if( code == LOADINPUT || code == LOADCONSTANT ) return 0;
+  if( code == SELECT ) return 3;
+  if( code >= ADD ) return 2;
+  return 1;
+
+} // end GetArity()
+
+
+/**
+ * ******************* Emit *******************
+ */
+
+void
+ImageExpression::Emit( const OpCode & code, const unsigned int & operand,
+  const double & constant )
+{
+  Instruction instruction;
+  instruction.Code = code;
+  instruction.Operand = operand;
+  instruction.Constant = constant;
+  this->m_Program.push_back( instruction );
+
+  /** In postfix order the operands are the arity instructions just before,
+   * if they are all constants. Then evaluate them once, for one pixel.
+   */
+  const unsigned int arity = GetArity( code );
+  const std::size_t size = this->m_Program.size();
+  if( arity == 0 || size < arity + 1 ) return;
+  for( std::size_t i = size - 1 - arity; i < size - 1; ++i )
+  {
+    if( this->m_Program[ i ].Code != LOADCONSTANT ) return;
+  }
+
+  double stack[ 3 ];
+  this->Run( size - 1 - arity, size, 0, 1, stack );
+  this->m_Program.resize( size - arity );
+  this->m_Program.back().Code = LOADCONSTANT;
+  this->m_Program.back().Operand = 0;
+  this->m_Program.back().Constant = stack[ 0 ];
+
+} // end Emit()
+
+
+/**
+ * ******************* UsesInput *******************
+ */
+
+bool
+ImageExpression::UsesInput( const unsigned int & input ) const
+{
+  for( std::size_t i = 0; i < this->m_Program.size(); ++i )
+  {
+    if( this->m_Program[ i ].Code == LOADINPUT
+      && this->m_Program[ i ].Operand == input )
+    {
+      return true;
+    }
+  }
+  return false;
+
+} // end UsesInput()
+
+
+/**
+ * ******************* Evaluate *******************
+ */
+
+void
+ImageExpression::Evaluate( const double * const * inputs, double * output,
+  const std::size_t & n, double * stack ) const
+{
+  this->Run( 0, this->m_Program.size(), inputs, n, stack );
+  std::memcpy( output, stack, n * sizeof( double ) );
+
+} // end Evaluate()
+
+
+/**
+ * ******************* Run *******************
+ *
+ * Every instruction loops over the whole batch. The stack holds batches of
+ * n values; unary operators work in place on the top, binary operators
+ * combine the top two into the lower one.
+ */
+
+void
+ImageExpression::Run( std::size_t first, std::size_t last,
+  const double * const * inputs, const std::size_t & n, double * stack ) const
+{
+  const double divisionByZeroValue = this->m_DivisionByZeroValue;
+  double * top = stack - n;
+
+  for( std::size_t pc = first; pc < last; ++pc )
+  {
+    const Instruction & instruction = this->m_Program[ pc ];
+    double * a = top;
+    const double * b = 0;
+    std::size_t i;
+
+    switch( instruction.Code )
+    {
+      case LOADINPUT:
+        top += n;
+        std::memcpy( top, inputs[ instruction.Operand ], n * sizeof( double ) );
+        continue;
+      case LOADCONSTANT:
+        top += n;
+        for( i = 0; i < n; ++i ) top[ i ] = instruction.Constant;
+        continue;
+
+      /** Unary operators. */
+      case NEGATE: for( i = 0; i < n; ++i ) a[ i ] = -a[ i ]; continue;
+      case NOT:    for( i = 0; i < n; ++i ) a[ i ] = a[ i ] == 0.0 ? 1.0 : 0.0; continue;
+      case ABS:    for( i = 0; i < n; ++i ) a[ i ] = vcl_fabs( a[ i ] ); continue;
+      case SQRT:   for( i = 0; i < n; ++i ) a[ i ] = vcl_sqrt( a[ i ] ); continue;
+      case SQR:    for( i = 0; i < n; ++i ) a[ i ] = a[ i ] * a[ i ]; continue;
+      case EXP:    for( i = 0; i < n; ++i ) a[ i ] = vcl_exp( a[ i ] ); continue;
+      case LN:     for( i = 0; i < n; ++i ) a[ i ] = vcl_log( a[ i ] ); continue;
+      case LOG10:  for( i = 0; i < n; ++i ) a[ i ] = vcl_log10( a[ i ] ); continue;
+      case SIN:    for( i = 0; i < n; ++i ) a[ i ] = vcl_sin( a[ i ] ); continue;
+      case COS:    for( i = 0; i < n; ++i ) a[ i ] = vcl_cos( a[ i ] ); continue;
+      case TAN:    for( i = 0; i < n; ++i ) a[ i ] = vcl_tan( a[ i ] ); continue;
+      case ASIN:   for( i = 0; i < n; ++i ) a[ i ] = vcl_asin( a[ i ] ); continue;
+      case ACOS:   for( i = 0; i < n; ++i ) a[ i ] = vcl_acos( a[ i ] ); continue;
+      case ATAN:   for( i = 0; i < n; ++i ) a[ i ] = vcl_atan( a[ i ] ); continue;
+      case ERF:    for( i = 0; i < n; ++i ) a[ i ] = vnl_erf( a[ i ] ); continue;
+      case ROUND:  for( i = 0; i < n; ++i ) a[ i ] = vnl_math_rnd( a[ i ] ); continue;
+      case FLOOR:  for( i = 0; i < n; ++i ) a[ i ] = vcl_floor( a[ i ] ); continue;
+      case CEIL:   for( i = 0; i < n; ++i ) a[ i ] = vcl_ceil( a[ i ] ); continue;
+      case SIGN:   for( i = 0; i < n; ++i ) a[ i ] = vnl_math_sgn( a[ i ] ); continue;
+      default: break;
+    }
+
+    /** Binary operators. */
+    b = top;
+    top -= n;
+    a = top;
+    switch( instruction.Code )
+    {
+      case ADD:      for( i = 0; i < n; ++i ) a[ i ] += b[ i ]; break;
+      case SUBTRACT: for( i = 0; i < n; ++i ) a[ i ] -= b[ i ]; break;
+      case MULTIPLY: for( i = 0; i < n; ++i ) a[ i ] *= b[ i ]; break;
+      case DIVIDE:
+        for( i = 0; i < n; ++i )
+        {
+          a[ i ] = b[ i ] != 0.0 ? a[ i ] / b[ i ] : divisionByZeroValue;
+        }
+        break;
+      case MODULO:
+        if( this->m_IntegerModulo )
+        {
+          /** The operands are truncated towards zero, like a cast to an
+           * integer, but fmod of the truncated values gives the result of
+           * the integer % for any range, without overflow. */
+          for( i = 0; i < n; ++i )
+          {
+            const double ia = a[ i ] < 0.0 ? vcl_ceil( a[ i ] ) : vcl_floor( a[ i ] );
+            const double ib = b[ i ] < 0.0 ? vcl_ceil( b[ i ] ) : vcl_floor( b[ i ] );
+            a[ i ] = ib != 0.0 ? vcl_fmod( ia, ib ) : divisionByZeroValue;
+          }
+        }
+        else
+        {
+          for( i = 0; i < n; ++i ) a[ i ] = vcl_fmod( a[ i ], b[ i ] );
+        }
+        break;
+      case POWER:    for( i = 0; i < n; ++i ) a[ i ] = vcl_pow( a[ i ], b[ i ] ); break;
+      case ATAN2:    for( i = 0; i < n; ++i ) a[ i ] = vcl_atan2( a[ i ], b[ i ] ); break;
+      case MINIMUM:  for( i = 0; i < n; ++i ) a[ i ] = b[ i ] < a[ i ] ? b[ i ] : a[ i ]; break;
+      case MAXIMUM:  for( i = 0; i < n; ++i ) a[ i ] = b[ i ] > a[ i ] ? b[ i ] : a[ i ]; break;
+      case LESS:         for( i = 0; i < n; ++i ) a[ i ] = a[ i ] < b[ i ] ? 1.0 : 0.0; break;
+      case LESSEQUAL:    for( i = 0; i < n; ++i ) a[ i ] = a[ i ] <= b[ i ] ? 1.0 : 0.0; break;
+      case GREATER:      for( i = 0; i < n; ++i ) a[ i ] = a[ i ] > b[ i ] ? 1.0 : 0.0; break;
+      case GREATEREQUAL: for( i = 0; i < n; ++i ) a[ i ] = a[ i ] >= b[ i ] ? 1.0 : 0.0; break;
+      case EQUAL:        for( i = 0; i < n; ++i ) a[ i ] = a[ i ] == b[ i ] ? 1.0 : 0.0; break;
+      case NOTEQUAL:     for( i = 0; i < n; ++i ) a[ i ] = a[ i ] != b[ i ] ? 1.0 : 0.0; break;
+      case AND:
+        for( i = 0; i < n; ++i ) a[ i ] = a[ i ] != 0.0 && b[ i ] != 0.0 ? 1.0 : 0.0;
+        break;
+      case OR:
+        for( i = 0; i < n; ++i ) a[ i ] = a[ i ] != 0.0 || b[ i ] != 0.0 ? 1.0 : 0.0;
+        break;
+      case SELECT:
+      {
+        /** The condition is below the two alternatives. */
+        top -= n;
+        double * c = top;
+        const double * t = c + n;
+        const double * e = c + 2 * n;
+        for( i = 0; i < n; ++i ) c[ i ] = c[ i ] != 0.0 ? t[ i ] : e[ i ];
+        break;
+      }
+      default: break;
+    }
+  } // end for instructions
+
+} // end Run()
+
+
+/**
+ * ******************* ToString *******************
+ */
+
+std::string
+ImageExpression::ToString( void ) const
+{
+  static const char * names[] = {
+    "LOADINPUT", "LOADCONSTANT",
+    "NEGATE", "NOT", "ABS", "SQRT", "SQR", "EXP", "LN", "LOG10",
+    "SIN", "COS", "TAN", "ASIN", "ACOS", "ATAN", "ERF", "ROUND", "FLOOR", "CEIL", "SIGN",
+    "ADD", "SUBTRACT", "MULTIPLY", "DIVIDE", "MODULO", "POWER", "ATAN2", "MINIMUM", "MAXIMUM",
+    "LESS", "LESSEQUAL", "GREATER", "GREATEREQUAL", "EQUAL", "NOTEQUAL", "AND", "OR",
+    "SELECT" };
+
+  std::ostringstream oss;
+  for( std::size_t i = 0; i < this->m_Program.size(); ++i )
+  {
+    const Instruction & instruction = this->m_Program[ i ];
+    oss << "  " << names[ instruction.Code ];
+    if( instruction.Code == LOADINPUT ) oss << " " << instruction.Operand;
+    if( instruction.Code == LOADCONSTANT ) oss << " " << instruction.Constant;
+    oss << "\n";
+  }
+  oss << "  stack depth: " << this->m_StackDepth << "\n";
+  return oss.str();
+
+} // end ToString()
+
+} // end namespace itktools
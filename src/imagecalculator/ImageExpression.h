@@ -0,0 +1,147 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __ImageExpression_h_
+#define __ImageExpression_h_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+namespace itktools
+{
+
+/** \class ImageExpression
+ * \brief A compiled pixel-wise expression over a number of named images.
+ *
+ * The expression is parsed once into a postfix program of a small stack
+ * machine. Every instruction operates on a batch of pixels at a time, so
+ * the dispatch cost is shared by the whole batch and the inner loops are
+ * simple enough for the compiler to vectorise. Subexpressions that do not
+ * depend on an image are folded into a constant when compiling.
+ *
+ * The grammar, from low to high precedence:
+ *
+ *   c ? a : b
+ *   a || b
+ *   a && b
+ *   a == b, a != b
+ *   a < b, a <= b, a > b, a >= b
+ *   a + b, a - b
+ *   a * b, a / b, a % b
+ *   -a, +a, !a
+ *   a ^ b                         (right associative)
+ *   number, pi, name, function( a, ... ), ( a )
+ *
+ * The functions are abs, sqrt, sqr, exp, ln, log10, sin, cos, tan, asin,
+ * acos, atan, erf, round, floor, ceil, sign, atan2( a, b ), pow( a, b ),
+ * mod( a, b ) and min( a, b, ... ), max( a, b, ... ).
+ *
+ * Everything is computed in double. Comparisons and logical operators
+ * return 1 or 0, and any nonzero value is true. The semantics follow the
+ * functors of the unary and binary image operators: a / 0 gives the
+ * division by zero value (the maximum of the output type), a % b is
+ * (int)a % (int)b for integer images (RMODINT) and fmod( a, b ) otherwise
+ * (RMODDOUBLE), round is vnl_math_rnd and sign is vnl_math_sgn.
+ */
+
+class ImageExpression
+{
+public:
+  /** The instructions of the stack machine. */
+  enum OpCode {
+    LOADINPUT, LOADCONSTANT,
+    NEGATE, NOT, ABS, SQRT, SQR, EXP, LN, LOG10,
+    SIN, COS, TAN, ASIN, ACOS, ATAN, ERF, ROUND, FLOOR, CEIL, SIGN,
+    ADD, SUBTRACT, MULTIPLY, DIVIDE, MODULO, POWER, ATAN2, MINIMUM, MAXIMUM,
+    LESS, LESSEQUAL, GREATER, GREATEREQUAL, EQUAL, NOTEQUAL, AND, OR,
+    SELECT
+  };
+
+  /** An instruction; Operand is the input index of LOADINPUT and Constant
+   * the value of LOADCONSTANT.
+   */
+  struct Instruction
+  {
+    OpCode        Code;
+    unsigned int  Operand;
+    double        Constant;
+  };
+
+  ImageExpression();
+  ~ImageExpression(){};
+
+  /** Settings that change the semantics; set them before Parse(), since
+   * they are used for constant folding.
+   */
+  void SetIntegerModulo( const bool & arg ) { this->m_IntegerModulo = arg; }
+  bool GetIntegerModulo( void ) const { return this->m_IntegerModulo; }
+  void SetDivisionByZeroValue( const double & arg ) { this->m_DivisionByZeroValue = arg; }
+  double GetDivisionByZeroValue( void ) const { return this->m_DivisionByZeroValue; }
+
+  /** Compile an expression over the images called names[ 0 ], names[ 1 ], ...
+   * Returns false and fills errorMessage if the expression is invalid.
+   */
+  bool Parse( const std::string & expression,
+    const std::vector<std::string> & names,
+    std::string & errorMessage );
+
+  /** The compiled program. */
+  const std::vector<Instruction> & GetProgram( void ) const { return this->m_Program; }
+
+  /** The number of batches of scratch space that Evaluate() needs. */
+  unsigned int GetStackDepth( void ) const { return this->m_StackDepth; }
+
+  /** Whether the program reads input i; unused inputs need not be loaded. */
+  bool UsesInput( const unsigned int & i ) const;
+
+  /** Evaluate the program for n pixels. inputs[ i ] points to the n values
+   * of input i and stack to GetStackDepth() * n values of scratch space.
+   */
+  void Evaluate( const double * const * inputs, double * output,
+    const std::size_t & n, double * stack ) const;
+
+  /** Write a readable listing of the program. */
+  std::string ToString( void ) const;
+
+private:
+  class Parser;
+  friend class Parser;
+
+  /** Append an instruction, folding it into a constant if possible. */
+  void Emit( const OpCode & code, const unsigned int & operand = 0,
+    const double & constant = 0.0 );
+
+  /** The number of operands taken from the stack. */
+  static unsigned int GetArity( const OpCode & code );
+
+  /** Run instructions [first,last) of the program on n pixels. */
+  void Run( std::size_t first, std::size_t last,
+    const double * const * inputs, const std::size_t & n, double * stack ) const;
+
+  std::vector<Instruction> m_Program;
+  unsigned int  m_StackDepth;
+  unsigned int  m_NumberOfInputs;
+  bool          m_IntegerModulo;
+  double        m_DivisionByZeroValue;
+
+}; // end class ImageExpression
+
+} // end namespace itktools
+
+#endif // end #ifndef __ImageExpression_h_
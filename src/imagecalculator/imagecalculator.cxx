@@ -0,0 +1,277 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+/** \file
+ \brief Evaluate a pixel-wise expression over multiple images.
+
+ \verbinclude imagecalculator.help
+ */
+
+/** Setup Mevislab DicomTiff IO support */
+#include "itkUseMevisDicomTiff.h"
+
+#include "itkCommandLineArgumentParser.h"
+#include "ITKToolsHelpers.h"
+#include "ITKToolsImageProperties.h"
+#include "imagecalculator.h"
+
+
+/**
+ * ******************* GetHelpString *******************
+ */
+
+std::string GetHelpString( void )
+{
+  std::stringstream ss;
+  ss << "ITKTools v" << itktools::GetITKToolsVersion() << "\n"
+    << "Evaluates a pixel-wise expression over one or more images in a single pass.\n"
+    << "Usage:\npximagecalculator\n"
+    << "  -in      inputFilenames\n"
+    << "  -out     outputFilename\n"
+    << "  -e       expression, e.g. \"(A * 0.5 + B) / max(C, 1)\"\n"
+    << "  [-names] names of the inputs in the expression, default A, B, C, ...\n"
+    << "             names start with a letter or _, followed by letters, digits or _\n"
+    << "  [-z]     compression flag; if provided, the output image is compressed\n"
+    << "  [-s]     number of streams, default 1.\n"
+    << "  [-threads] maximum number of threads, default all\n"
+    << "  [-opct]  output component type, by default the largest of the input images\n"
+    << "             choose one of: {[unsigned_]{char,short,int,long},float,double}\n"
+    << "The expression supports, from low to high precedence:\n"
+    << "  c ? a : b,  ||,  &&,  == !=,  < <= > >=,  + -,  * / %,  unary - + !,  ^\n"
+    << "and the functions abs, sqrt, sqr, exp, ln, log10, sin, cos, tan, asin, acos,\n"
+    << "atan, erf, round, floor, ceil, sign, atan2(a,b), pow(a,b), mod(a,b),\n"
+    << "min(a,b,...) and max(a,b,...), and the constant pi.\n"
+    << "Everything is computed in double; the result is clamped to the output type.\n"
+    << "Comparisons and logical operators give 1 or 0. As in pxbinaryimageoperator\n"
+    << "a division by zero gives the maximum of the output type, and as in\n"
+    << "pxunaryimageoperator % is an integer modulo for integer output types.\n"
+    << "NaN results become 0 for integer output types.\n"
+    << "Supported: 2D, 3D, (unsigned) char, (unsigned) short, (unsigned) int, (unsigned) long, float, double.";
+
+  return ss.str();
+
+} // end GetHelpString()
+
+
+/**
+ * ******************* DetermineImageProperties *******************
+ */
+
+int DetermineImageProperties(
+  const std::vector<std::string> & inputFileNames,
+  itk::ImageIOBase::IOComponentType & componentTypeOut,
+  unsigned int & dimension )
+{
+  std::vector<unsigned int> imageSize0;
+  for( unsigned int i = 0; i < inputFileNames.size(); ++i )
+  {
+    itk::ImageIOBase::IOPixelType pixelType;
+    itk::ImageIOBase::IOComponentType componentType;
+    unsigned int dimension_i = 2;
+    unsigned int numberOfComponents = 1;
+    std::vector<unsigned int> imageSize;
+    int retgip = itktools::GetImageProperties(
+      inputFileNames[ i ],
+      pixelType,
+      componentType,
+      dimension_i,
+      numberOfComponents,
+      imageSize );
+    if( retgip ) return retgip;
+
+    if( !itktools::NumberOfComponentsCheck( numberOfComponents ) )
+    {
+      return EXIT_FAILURE;
+    }
+
+    if( i == 0 )
+    {
+      dimension = dimension_i;
+      imageSize0 = imageSize;
+      componentTypeOut = componentType;
+    }
+    else if( dimension_i != dimension || imageSize != imageSize0 )
+    {
+      std::cerr << "ERROR: the input images have different sizes." << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    /** The output type is the largest of the input types. */
+    componentTypeOut = itktools::GetLargestComponentType( componentTypeOut, componentType );
+  }
+
+  return 0;
+
+} // end DetermineImageProperties()
+
+//-------------------------------------------------------------------------------------
+
+int main( int argc, char **argv )
+{
+  RegisterMevisDicomTiff();
+
+  /** Create a command line argument parser. */
+  itk::CommandLineArgumentParser::Pointer parser = itk::CommandLineArgumentParser::New();
+  parser->SetCommandLineArguments( argc, argv );
+  parser->SetProgramHelpText( GetHelpString() );
+
+  parser->MarkArgumentAsRequired( "-in", "The input filename." );
+  parser->MarkArgumentAsRequired( "-out", "The output filename." );
+  parser->MarkArgumentAsRequired( "-e", "The expression." );
+
+  itk::CommandLineArgumentParser::ReturnValue validateArguments = parser->CheckForRequiredArguments();
+
+  if( validateArguments == itk::CommandLineArgumentParser::FAILED )
+  {
+    return EXIT_FAILURE;
+  }
+  else if( validateArguments == itk::CommandLineArgumentParser::HELPREQUESTED )
+  {
+    return EXIT_SUCCESS;
+  }
+
+  /** Get arguments. */
+  std::vector<std::string> inputFileNames;
+  parser->GetCommandLineArgument( "-in", inputFileNames );
+
+  std::string outputFileName = "";
+  parser->GetCommandLineArgument( "-out", outputFileName );
+
+  std::string expression = "";
+  parser->GetCommandLineArgument( "-e", expression );
+
+  std::vector<std::string> names;
+  bool retnames = parser->GetCommandLineArgument( "-names", names );
+
+  std::string opct = "";
+  bool retopct = parser->GetCommandLineArgument( "-opct", opct );
+
+  const bool useCompression = parser->ArgumentExists( "-z" );
+
+  unsigned int numberOfStreams = 1;
+  parser->GetCommandLineArgument( "-s", numberOfStreams );
+
+  unsigned int numberOfThreads = 0;
+  parser->GetCommandLineArgument( "-threads", numberOfThreads );
+
+  /** The default names are A, B, ..., Z, A1, B1, ... */
+  if( !retnames )
+  {
+    for( unsigned int i = 0; i < inputFileNames.size(); ++i )
+    {
+      std::ostringstream name;
+      name << static_cast<char>( 'A' + i % 26 );
+      if( i >= 26 ) name << i / 26;
+      names.push_back( name.str() );
+    }
+  }
+  else if( names.size() != inputFileNames.size() )
+  {
+    std::cerr << "ERROR: the number of names should equal the number of inputs." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** Check the expression before reading any image. */
+  itktools::ImageExpression imageExpression;
+  std::string errorMessage;
+  if( !imageExpression.Parse( expression, names, errorMessage ) )
+  {
+    std::cerr << "ERROR: invalid expression: " << errorMessage << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** Determine image properties. */
+  itk::ImageIOBase::IOComponentType componentTypeOut = itk::ImageIOBase::LONG;
+  unsigned int dim = 2;
+  int retdip = DetermineImageProperties( inputFileNames, componentTypeOut, dim );
+  if( retdip ) return EXIT_FAILURE;
+
+  /** Let the user override the output component type. */
+  if( retopct )
+  {
+    componentTypeOut = itk::ImageIOBase::GetComponentTypeFromString( opct );
+    if( !itktools::ComponentTypeIsValid( componentTypeOut ) )
+    {
+      std::cerr << "ERROR: the you specified an invalid opct." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  /** The inputs are read as long or double, depending on the output type. */
+  itk::ImageIOBase::IOComponentType componentTypeIn = itk::ImageIOBase::DOUBLE;
+  if( itktools::ComponentTypeIsInteger( componentTypeOut ) )
+  {
+    componentTypeIn = itk::ImageIOBase::LONG;
+  }
+
+  /** Class that does the work. */
+  ITKToolsImageCalculatorBase * filter = NULL;
+
+  try
+  {
+    // now call all possible template combinations.
+    if( !filter ) filter = ITKToolsImageCalculator< 2, long, char >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 2, long, unsigned char >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 2, long, short >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 2, long, unsigned short >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 2, long, int >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 2, long, unsigned int >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 2, long, long >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 2, long, unsigned long >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 2, double, float >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 2, double, double >::New( dim, componentTypeIn, componentTypeOut );
+
+#ifdef ITKTOOLS_3D_SUPPORT
+    if( !filter ) filter = ITKToolsImageCalculator< 3, long, char >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 3, long, unsigned char >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 3, long, short >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 3, long, unsigned short >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 3, long, int >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 3, long, unsigned int >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 3, long, long >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 3, long, unsigned long >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 3, double, float >::New( dim, componentTypeIn, componentTypeOut );
+    if( !filter ) filter = ITKToolsImageCalculator< 3, double, double >::New( dim, componentTypeIn, componentTypeOut );
+#endif
+    /** Check if filter was instantiated. */
+    bool supported = itktools::IsFilterSupportedCheck( filter, dim, componentTypeIn, componentTypeOut );
+    if( !supported ) return EXIT_FAILURE;
+
+    /** Set the filter arguments. */
+    filter->m_InputFileNames = inputFileNames;
+    filter->m_VariableNames = names;
+    filter->m_OutputFileName = outputFileName;
+    filter->m_Expression = expression;
+    filter->m_UseCompression = useCompression;
+    filter->m_NumberOfStreams = numberOfStreams;
+    filter->m_NumberOfThreads = numberOfThreads;
+
+    filter->Run();
+
+    delete filter;
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    std::cerr << "ERROR: Caught ITK exception: " << excp << std::endl;
+    delete filter;
+    return EXIT_FAILURE;
+  }
+
+  /** End program. */
+  return EXIT_SUCCESS;
+
+} // end main
@@ -0,0 +1,124 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __imagecalculator_h_
+#define __imagecalculator_h_
+
+#include "ITKToolsBase.h"
+
+#include "itkImage.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkExpressionImageFilter.h"
+
+#include <vector>
+
+
+/** \class ITKToolsImageCalculatorBase
+ *
+ * Untemplated pure virtual base class that holds
+ * the Run() function and all required parameters.
+ */
+
+class ITKToolsImageCalculatorBase : public itktools::ITKToolsBase
+{
+public:
+  /** Constructor. */
+  ITKToolsImageCalculatorBase()
+  {
+    this->m_OutputFileName = "";
+    this->m_Expression = "";
+    this->m_UseCompression = false;
+    this->m_NumberOfStreams = 1;
+    this->m_NumberOfThreads = 0;
+  };
+  /** Destructor. */
+  ~ITKToolsImageCalculatorBase(){};
+
+  /** Input member parameters. */
+  std::vector<std::string> m_InputFileNames;
+  std::vector<std::string> m_VariableNames;
+  std::string       m_OutputFileName;
+  std::string       m_Expression;
+  bool              m_UseCompression;
+  unsigned int      m_NumberOfStreams;
+  unsigned int      m_NumberOfThreads;
+
+}; // end class ITKToolsImageCalculatorBase
+
+
+/** \class ITKToolsImageCalculator
+ *
+ * Templated class that implements the Run() function
+ * and the New() function for its creation.
+ */
+
+template< unsigned int VDimension, class TInputComponentType, class TOutputComponentType >
+class ITKToolsImageCalculator : public ITKToolsImageCalculatorBase
+{
+public:
+  /** Standard ITKTools stuff. */
+  typedef ITKToolsImageCalculator Self;
+  itktoolsTwoTypeNewMacro( Self );
+
+  ITKToolsImageCalculator(){};
+  ~ITKToolsImageCalculator(){};
+
+  /** Run function. */
+  void Run( void )
+  {
+    /** Typedefs. */
+    typedef itk::Image< TInputComponentType, VDimension >   InputImageType;
+    typedef itk::Image< TOutputComponentType, VDimension >  OutputImageType;
+    typedef itk::ImageFileReader< InputImageType >          ReaderType;
+    typedef itk::ExpressionImageFilter<
+      InputImageType, OutputImageType >                     ExpressionFilterType;
+    typedef itk::ImageFileWriter< OutputImageType >         WriterType;
+
+    /** Set up the expression filter; all inputs are read lazily, one stream
+     * at a time, and combined in one pass.
+     */
+    typename ExpressionFilterType::Pointer expressionFilter = ExpressionFilterType::New();
+    expressionFilter->SetExpression( this->m_Expression );
+    expressionFilter->SetVariableNames( this->m_VariableNames );
+    if( this->m_NumberOfThreads > 0 )
+    {
+      expressionFilter->SetNumberOfThreads( this->m_NumberOfThreads );
+    }
+
+    std::vector<typename ReaderType::Pointer> readers( this->m_InputFileNames.size() );
+    for( unsigned int i = 0; i < this->m_InputFileNames.size(); ++i )
+    {
+      readers[ i ] = ReaderType::New();
+      readers[ i ]->SetFileName( this->m_InputFileNames[ i ] );
+      expressionFilter->SetInput( i, readers[ i ]->GetOutput() );
+    }
+
+    /** Write the image to disk. */
+    typename WriterType::Pointer writer = WriterType::New();
+    writer->SetFileName( this->m_OutputFileName.c_str() );
+    writer->SetInput( expressionFilter->GetOutput() );
+    writer->SetUseCompression( this->m_UseCompression );
+    writer->SetNumberOfStreamDivisions( this->m_NumberOfStreams );
+    writer->Update();
+
+  } // end Run()
+
+}; // end class ITKToolsImageCalculator
+
+
+#endif // end #ifndef __imagecalculator_h_
@@ -0,0 +1,122 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkExpressionImageFilter_h_
+#define __itkExpressionImageFilter_h_
+
+#include "itkImageToImageFilter.h"
+#include "ImageExpression.h"
+#include <string>
+#include <vector>
+
+
+namespace itk
+{
+
+/** \class ExpressionImageFilter
+ * \brief Evaluates a pixel-wise expression over N input images.
+ *
+ * The expression, see itktools::ImageExpression for the syntax, refers to
+ * the inputs by the names given with SetVariableNames(). It is compiled once
+ * in BeforeThreadedGenerateData() and evaluated in a single pass: every
+ * thread converts a batch of pixels of each used input to double, runs the
+ * program on the batch, and writes the result clamped to the range of the
+ * output pixel type. No intermediate images are created.
+ *
+ * As in the unary and binary image operators, a division by zero gives the
+ * maximum of the output pixel type and a % b is an integer modulo for
+ * integer input pixel types. NaN results become 0 for integer output pixel
+ * types.
+ *
+ * The filter supports streaming; the inputs need the same region as the
+ * output.
+ *
+ * \ingroup IntensityImageFilters Multithreaded
+ */
+template <class TInputImage, class TOutputImage>
+class ExpressionImageFilter:
+    public ImageToImageFilter<TInputImage,TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ExpressionImageFilter                         Self;
+  typedef ImageToImageFilter<TInputImage,TOutputImage>  Superclass;
+  typedef SmartPointer<Self>                            Pointer;
+  typedef SmartPointer<const Self>                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( ExpressionImageFilter, ImageToImageFilter );
+
+  /** Typedef to describe the input/output image types. */
+  typedef TInputImage                                   InputImageType;
+  typedef TOutputImage                                  OutputImageType;
+  typedef typename InputImageType::PixelType            InputImagePixelType;
+  typedef typename OutputImageType::PixelType           OutputImagePixelType;
+  typedef typename OutputImageType::RegionType          OutputImageRegionType;
+
+  /** Set/Get the expression. */
+  itkSetStringMacro( Expression );
+  itkGetStringMacro( Expression );
+
+  /** Set/Get the names of the inputs, in input order. */
+  void SetVariableNames( const std::vector<std::string> & names );
+  const std::vector<std::string> & GetVariableNames( void ) const
+  { return this->m_VariableNames; }
+
+  /** Set/Get the number of pixels evaluated at a time. Default 256. */
+  itkSetClampMacro( BatchSize, unsigned int, 1, NumericTraits<unsigned int>::max() );
+  itkGetConstMacro( BatchSize, unsigned int );
+
+  /** The compiled expression, valid after BeforeThreadedGenerateData(). */
+  const itktools::ImageExpression & GetCompiledExpression( void ) const
+  { return this->m_CompiledExpression; }
+
+protected:
+  ExpressionImageFilter();
+  ~ExpressionImageFilter() {};
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** Compile the expression. */
+  virtual void BeforeThreadedGenerateData( void );
+
+  /** Evaluate the expression on the region of this thread, line by line. */
+  virtual void ThreadedGenerateData(
+    const OutputImageRegionType & outputRegionForThread,
+    ThreadIdType threadId );
+
+private:
+  ExpressionImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  std::string                 m_Expression;
+  std::vector<std::string>    m_VariableNames;
+  unsigned int                m_BatchSize;
+  itktools::ImageExpression   m_CompiledExpression;
+
+}; // end class ExpressionImageFilter
+
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkExpressionImageFilter.hxx"
+#endif
+
+#endif // end #ifndef __itkExpressionImageFilter_h_
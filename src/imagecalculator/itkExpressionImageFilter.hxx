@@ -0,0 +1,198 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef _itkExpressionImageFilter_hxx_
+#define _itkExpressionImageFilter_hxx_
+
+#include "itkExpressionImageFilter.h"
+
+#include "itkImageLinearIteratorWithIndex.h"
+#include "itkNumericTraits.h"
+#include "itkProgressReporter.h"
+
+
+namespace itk {
+
+template<class TInputImage, class TOutputImage>
+ExpressionImageFilter<TInputImage,TOutputImage>
+::ExpressionImageFilter()
+{
+  this->m_Expression = "";
+  this->m_BatchSize = 256;
+}
+
+
+template<class TInputImage, class TOutputImage>
+void
+ExpressionImageFilter<TInputImage,TOutputImage>
+::SetVariableNames( const std::vector<std::string> & names )
+{
+  if( this->m_VariableNames != names )
+  {
+    this->m_VariableNames = names;
+    this->Modified();
+  }
+
+} // end SetVariableNames()
+
+
+template<class TInputImage, class TOutputImage>
+void
+ExpressionImageFilter<TInputImage,TOutputImage>
+::BeforeThreadedGenerateData( void )
+{
+  const unsigned int numberOfInputs = this->GetNumberOfInputs();
+  if( this->m_VariableNames.size() != numberOfInputs )
+  {
+    itkExceptionMacro( << "The number of variable names ("
+      << this->m_VariableNames.size() << ") does not match the number of inputs ("
+      << numberOfInputs << ")." );
+  }
+
+  /** The semantics of the functors, used also for constant folding. */
+  this->m_CompiledExpression.SetIntegerModulo(
+    NumericTraits<InputImagePixelType>::is_integer );
+  this->m_CompiledExpression.SetDivisionByZeroValue(
+    static_cast<double>( NumericTraits<OutputImagePixelType>::max() ) );
+
+  std::string errorMessage;
+  if( !this->m_CompiledExpression.Parse(
+    this->m_Expression, this->m_VariableNames, errorMessage ) )
+  {
+    itkExceptionMacro( << "Invalid expression: " << errorMessage );
+  }
+
+} // end BeforeThreadedGenerateData()
+
+
+template<class TInputImage, class TOutputImage>
+void
+ExpressionImageFilter<TInputImage,TOutputImage>
+::ThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread,
+  ThreadIdType threadId )
+{
+  typedef typename OutputImageType::IndexType           IndexType;
+  typedef ImageLinearIteratorWithIndex<OutputImageType> IteratorType;
+
+  const itktools::ImageExpression & expression = this->m_CompiledExpression;
+  const unsigned int numberOfInputs = this->GetNumberOfInputs();
+  const std::size_t batchSize = this->m_BatchSize;
+  OutputImageType * output = this->GetOutput();
+
+  /** Only the inputs that the (folded) expression reads are loaded. */
+  std::vector<const InputImageType *> inputs;
+  std::vector<unsigned int> usedInputs;
+  for( unsigned int i = 0; i < numberOfInputs; ++i )
+  {
+    inputs.push_back( this->GetInput( i ) );
+    if( expression.UsesInput( i ) ) usedInputs.push_back( i );
+  }
+
+  /** Per thread scratch space for one batch. */
+  std::vector<double> inputBuffer( numberOfInputs * batchSize + 1 );
+  std::vector<double> stack( expression.GetStackDepth() * batchSize + 1 );
+  std::vector<double> result( batchSize );
+  std::vector<const double *> inputPointers( numberOfInputs + 1 );
+  for( unsigned int i = 0; i < numberOfInputs; ++i )
+  {
+    inputPointers[ i ] = &inputBuffer[ i * batchSize ];
+  }
+
+  /** The output range. For 64-bit integers the maximum rounds up to 2^63
+   * or 2^64 in double, which does not fit in the output type, so values at
+   * or beyond the range are mapped to its ends without a cast. */
+  const OutputImagePixelType outputMaximum = NumericTraits<OutputImagePixelType>::max();
+  const OutputImagePixelType outputMinimum = NumericTraits<OutputImagePixelType>::NonpositiveMin();
+  const double maximum = static_cast<double>( outputMaximum );
+  const double minimum = static_cast<double>( outputMinimum );
+  const bool isInteger = NumericTraits<OutputImagePixelType>::is_integer;
+  const std::size_t lineLength = outputRegionForThread.GetSize( 0 );
+
+  ProgressReporter progress( this, threadId,
+    outputRegionForThread.GetNumberOfPixels() / lineLength );
+
+  /** Pixels along dimension 0 are contiguous in all buffers. */
+  IteratorType it( output, outputRegionForThread );
+  it.SetDirection( 0 );
+  it.GoToBegin();
+  while( !it.IsAtEnd() )
+  {
+    const IndexType index = it.GetIndex();
+    OutputImagePixelType * out
+      = output->GetBufferPointer() + output->ComputeOffset( index );
+
+    for( std::size_t start = 0; start < lineLength; start += batchSize )
+    {
+      const std::size_t n = lineLength - start < batchSize
+        ? lineLength - start : batchSize;
+
+      for( std::size_t k = 0; k < usedInputs.size(); ++k )
+      {
+        const unsigned int i = usedInputs[ k ];
+        const InputImagePixelType * in = inputs[ i ]->GetBufferPointer()
+          + inputs[ i ]->ComputeOffset( index ) + start;
+        double * buffer = &inputBuffer[ i * batchSize ];
+        for( std::size_t j = 0; j < n; ++j )
+        {
+          buffer[ j ] = static_cast<double>( in[ j ] );
+        }
+      }
+
+      expression.Evaluate( &inputPointers[ 0 ], &result[ 0 ], n, &stack[ 0 ] );
+
+      /** Clamp to the output range, as the binary functors do. NaN has no
+       * integer value, it becomes 0 for integer output types. */
+      for( std::size_t j = 0; j < n; ++j )
+      {
+        const double value = result[ j ];
+        if( value >= maximum ) out[ start + j ] = outputMaximum;
+        else if( value <= minimum ) out[ start + j ] = outputMinimum;
+        else if( value != value && isInteger ) out[ start + j ] = NumericTraits<OutputImagePixelType>::Zero;
+        else out[ start + j ] = static_cast<OutputImagePixelType>( value );
+      }
+    }
+
+    it.NextLine();
+    progress.CompletedPixel();
+  } // end while lines
+
+} // end ThreadedGenerateData()
+
+
+template<class TInputImage, class TOutputImage>
+void
+ExpressionImageFilter<TInputImage,TOutputImage>
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "Expression: " << this->m_Expression << std::endl;
+  os << indent << "VariableNames:";
+  for( std::size_t i = 0; i < this->m_VariableNames.size(); ++i )
+  {
+    os << " " << this->m_VariableNames[ i ];
+  }
+  os << std::endl;
+  os << indent << "BatchSize: " << this->m_BatchSize << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef _itkExpressionImageFilter_hxx_
@@ -26,6 +26,7 @@
 
 #include "itkCommandLineArgumentParser.h"
 #include "ITKToolsHelpers.h"
+#include "ITKToolsImageDigest.h"
 
 #include "itkNumericTraits.h"
 #include "itkImage.h"
@@ -37,6 +38,7 @@
 
 #include "itkImageSource.h" // This should not be necessary after ITK patch is merged
 #include "itkTestingComparisonImageFilter.h"
+#include "StreamedImageComparison.h"
 
 
 /**
@@ -50,7 +52,21 @@ std::string GetHelpString( void )
     << "Usage:\n"
     << "pximagecompare\n"
     << "  -test      image filename to test against baseline\n"
-    << "  -base      baseline image filename";
+    << "  -base      baseline image filename\n"
+    << "  [-t]       intensity difference threshold, default 0\n"
+    << "  [-r]       tolerance radius, default 0\n"
+    << "  [-n]       allowed number of different pixels, default 0\n"
+    << "  [-nodiff]  do not write a difference image\n"
+    << "  [-threads] maximum number of threads\n"
+    << "  [-digest]  only compare the content digests of the images\n"
+    << "A pixel differs if it differs by more than the threshold from all test\n"
+    << "pixels within the radius. The images are compared slab by slab, and the\n"
+    << "comparison stops as soon as more than the allowed number of pixels\n"
+    << "differ. Unless -nodiff is given, the difference image is then computed\n"
+    << "over the whole image, and written to test_DIFF.\n"
+    << "With -digest both images are read once, streamed, and the images are\n"
+    << "equal if the pixel data, component type, number of components and\n"
+    << "geometry are equal, see pximagedigest; no difference image is written.";
   return ss.str();
 
 } // end GetHelpString()
@@ -89,16 +105,57 @@ int main( int argc, char **argv )
   std::string baselineImageFileName;
   parser->GetCommandLineArgument( "-base", baselineImageFileName );
 
+  double differenceThreshold = 0.0;
+  parser->GetCommandLineArgument( "-t", differenceThreshold );
+
+  unsigned int toleranceRadius = 0;
+  parser->GetCommandLineArgument( "-r", toleranceRadius );
+
+  itk::SizeValueType allowedNumberOfDifferentPixels = 0;
+  parser->GetCommandLineArgument( "-n", allowedNumberOfDifferentPixels );
+
+  const bool writeDifferenceImage = !parser->ArgumentExists( "-nodiff" );
+
+  unsigned int numberOfThreads = 0;
+  parser->GetCommandLineArgument( "-threads", numberOfThreads );
+
+  /** Compare the digests only. */
+  if( parser->ArgumentExists( "-digest" ) )
+  {
+    std::string baselineDigest, testDigest, error;
+    if( !itktools::ComputeImageDigest( baselineImageFileName, 0, baselineDigest, error ) )
+    {
+      std::cerr << "Error during reading baseline image: " << error << std::endl;
+      return EXIT_FAILURE;
+    }
+    if( !itktools::ComputeImageDigest( testImageFileName, 0, testDigest, error ) )
+    {
+      std::cerr << "Error during reading test image: " << error << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    if( baselineDigest != testDigest )
+    {
+      std::cerr << "The digests of the Baseline image and Test image do not match!" << std::endl;
+      std::cerr << "Baseline image: " << baselineImageFileName
+        << " has digest " << baselineDigest << std::endl;
+      std::cerr << "Test image:     " << testImageFileName
+        << " has digest " << testDigest << std::endl;
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  }
+
   // Read images
   typedef itk::Image<double,ITK_TEST_DIMENSION_MAX>           ImageType;
   typedef itk::ImageFileReader<ImageType>                     ReaderType;
 
-  // Read the baseline file
+  // Read the header of the baseline file
   ReaderType::Pointer baselineReader = ReaderType::New();
   baselineReader->SetFileName( baselineImageFileName );
   try
   {
-    baselineReader->Update();
+    baselineReader->UpdateOutputInformation();
   }
   catch( itk::ExceptionObject & excp )
   {
@@ -106,12 +163,12 @@ int main( int argc, char **argv )
     return EXIT_FAILURE;
   }
 
-  // Read the file to test
+  // Read the header of the file to test
   ReaderType::Pointer testReader = ReaderType::New();
   testReader->SetFileName( testImageFileName );
   try
   {
-    testReader->Update();
+    testReader->UpdateOutputInformation();
   }
   catch( itk::ExceptionObject & excp )
   {
@@ -135,14 +192,14 @@ int main( int argc, char **argv )
     return EXIT_FAILURE;
   }
 
-  // Now compare the two images
-  typedef itk::Testing::ComparisonImageFilter< ImageType, ImageType > ComparisonFilterType;
-  ComparisonFilterType::Pointer comparisonFilter = ComparisonFilterType::New();
-  comparisonFilter->SetTestInput(testReader->GetOutput());
-  comparisonFilter->SetValidInput(baselineReader->GetOutput());
+  // Now compare the two images, slab by slab, until too many pixels differ
+  itk::SizeValueType numberOfDifferentPixels = 0;
   try
   {
-    comparisonFilter->Update();
+    numberOfDifferentPixels = itktools::CountDifferentPixels<ImageType>(
+      baselineReader.GetPointer(), testReader.GetPointer(),
+      differenceThreshold, toleranceRadius,
+      allowedNumberOfDifferentPixels, numberOfThreads );
   }
   catch( itk::ExceptionObject & excp )
   {
@@ -150,11 +207,29 @@ int main( int argc, char **argv )
     return EXIT_FAILURE;
   }
 
-  itk::SizeValueType numberOfDifferentPixels = comparisonFilter->GetNumberOfPixelsWithDifferences();
-
-  if(numberOfDifferentPixels > 0)
+  if( numberOfDifferentPixels > allowedNumberOfDifferentPixels )
   {
-    std::cerr << "There are " << numberOfDifferentPixels << " different pixels!" << std::endl;
+    std::cerr << "There are at least " << numberOfDifferentPixels << " different pixels!" << std::endl;
+    if( !writeDifferenceImage ) return EXIT_FAILURE;
+
+    // Compute the difference image over the whole image
+    typedef itk::Testing::ComparisonImageFilter< ImageType, ImageType > ComparisonFilterType;
+    ComparisonFilterType::Pointer comparisonFilter = ComparisonFilterType::New();
+    comparisonFilter->SetTestInput( testReader->GetOutput() );
+    comparisonFilter->SetValidInput( baselineReader->GetOutput() );
+    comparisonFilter->SetDifferenceThreshold( differenceThreshold );
+    comparisonFilter->SetToleranceRadius( toleranceRadius );
+    try
+    {
+      comparisonFilter->Update();
+    }
+    catch( itk::ExceptionObject & excp )
+    {
+      std::cerr << "Error during comparing image: " << excp << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cerr << "There are " << comparisonFilter->GetNumberOfPixelsWithDifferences()
+      << " different pixels!" << std::endl;
 
     // Create name for diff image
     std::string diffImageFileName =
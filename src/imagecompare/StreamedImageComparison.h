@@ -0,0 +1,251 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __StreamedImageComparison_h_
+#define __StreamedImageComparison_h_
+
+#include "itkImageSource.h"
+#include "itkMultiThreader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace itktools
+{
+
+/** The state of one slab of a streamed comparison, shared by the threads. */
+template <class TImage>
+struct SlabComparison
+{
+  typedef typename TImage::RegionType       RegionType;
+  typedef typename TImage::OffsetType       OffsetType;
+
+  const TImage *                m_Baseline;
+  const TImage *                m_Test;
+  RegionType                    m_Slab;
+  RegionType                    m_LargestRegion;
+  double                        m_DifferenceThreshold;
+  std::vector<OffsetType>       m_Neighbours;
+  itk::SizeValueType            m_MaximumNumberOfDifferentPixels;
+  std::vector<itk::SizeValueType> m_NumberOfDifferentPixels;
+};
+
+
+/**
+ * ***************** CompareSlabThreaderCallback ************************
+ *
+ * Every thread compares a contiguous part of the slab. A pixel is equal if
+ * it is equal within the threshold, or else if a test pixel within the
+ * tolerance radius is; only then the neighbourhood is searched. A thread
+ * stops when it alone has found more than the allowed number of pixels.
+ */
+
+template <class TImage>
+ITK_THREAD_RETURN_TYPE CompareSlabThreaderCallback( void * arg )
+{
+  typedef SlabComparison<TImage>            ComparisonType;
+  typedef typename TImage::IndexType        IndexType;
+  typedef typename TImage::SizeType         SizeType;
+  const unsigned int dimension = TImage::ImageDimension;
+
+  itk::MultiThreader::ThreadInfoStruct * info
+    = static_cast<itk::MultiThreader::ThreadInfoStruct *>( arg );
+  ComparisonType * comparison = static_cast<ComparisonType *>( info->UserData );
+
+  const TImage * baseline = comparison->m_Baseline;
+  const TImage * test = comparison->m_Test;
+  const double threshold = comparison->m_DifferenceThreshold;
+  const IndexType largestIndex = comparison->m_LargestRegion.GetIndex();
+  const SizeType largestSize = comparison->m_LargestRegion.GetSize();
+
+  /** The part of this thread. */
+  const std::size_t numberOfPixels = comparison->m_Slab.GetNumberOfPixels();
+  const std::size_t begin = numberOfPixels * info->ThreadID / info->NumberOfThreads;
+  const std::size_t end = numberOfPixels * ( info->ThreadID + 1 ) / info->NumberOfThreads;
+  if( begin == end ) return ITK_THREAD_RETURN_VALUE;
+
+  const IndexType slabIndex = comparison->m_Slab.GetIndex();
+  const SizeType slabSize = comparison->m_Slab.GetSize();
+  IndexType index;
+  std::size_t rest = begin;
+  for( unsigned int d = 0; d < dimension; ++d )
+  {
+    index[ d ] = slabIndex[ d ] + static_cast<itk::IndexValueType>( rest % slabSize[ d ] );
+    rest /= slabSize[ d ];
+  }
+
+  itk::SizeValueType & count = comparison->m_NumberOfDifferentPixels[ info->ThreadID ];
+  for( std::size_t i = begin; i < end; ++i )
+  {
+    const double valid = baseline->GetPixel( index );
+    if( std::abs( valid - test->GetPixel( index ) ) > threshold )
+    {
+      /** Search the tolerance neighbourhood, clamped to the image. */
+      bool found = false;
+      for( std::size_t n = 0; n < comparison->m_Neighbours.size() && !found; ++n )
+      {
+        IndexType neighbour = index + comparison->m_Neighbours[ n ];
+        for( unsigned int d = 0; d < dimension; ++d )
+        {
+          const itk::IndexValueType last
+            = largestIndex[ d ] + static_cast<itk::IndexValueType>( largestSize[ d ] ) - 1;
+          neighbour[ d ] = std::min( std::max( neighbour[ d ], largestIndex[ d ] ), last );
+        }
+        found = std::abs( valid - test->GetPixel( neighbour ) ) <= threshold;
+      }
+      if( !found && ++count > comparison->m_MaximumNumberOfDifferentPixels ) break;
+    }
+
+    /** The next index. */
+    for( unsigned int d = 0; d < dimension; ++d )
+    {
+      if( ++index[ d ] < slabIndex[ d ] + static_cast<itk::IndexValueType>( slabSize[ d ] ) ) break;
+      index[ d ] = slabIndex[ d ];
+    }
+  }
+
+  return ITK_THREAD_RETURN_VALUE;
+
+} // end CompareSlabThreaderCallback()
+
+
+/** Count the pixels of the baseline that differ from the test image, in the
+ * way of itk::Testing::ComparisonImageFilter: a pixel differs if its
+ * absolute difference with every test pixel within the tolerance radius
+ * is larger than the difference threshold.
+ *
+ * The images are requested from the sources slab by slab, along the last
+ * axis that has more than one pixel; the test slab is extended by the
+ * radius. A slab is compared by numberOfThreads threads (0 means the ITK
+ * default). Equal pixels take the fast path without a neighbourhood search.
+ * The comparison stops after the slab in which more than
+ * maximumNumberOfDifferentPixels pixels were found, so the returned count
+ * is then a lower bound.
+ *
+ * The sources need to have generated their output information, and their
+ * outputs need to have the same size.
+ */
+template <class TImage>
+itk::SizeValueType CountDifferentPixels(
+  itk::ImageSource<TImage> * baselineSource,
+  itk::ImageSource<TImage> * testSource,
+  double differenceThreshold,
+  unsigned int toleranceRadius,
+  itk::SizeValueType maximumNumberOfDifferentPixels,
+  unsigned int numberOfThreads )
+{
+  typedef SlabComparison<TImage>            ComparisonType;
+  typedef typename TImage::RegionType       RegionType;
+  typedef typename TImage::SizeType         SizeType;
+  typedef typename TImage::OffsetType       OffsetType;
+  const unsigned int dimension = TImage::ImageDimension;
+
+  TImage * baseline = baselineSource->GetOutput();
+  TImage * test = testSource->GetOutput();
+  const RegionType largestRegion = baseline->GetLargestPossibleRegion();
+  const SizeType largestSize = largestRegion.GetSize();
+
+  ComparisonType comparison;
+  comparison.m_Baseline = baseline;
+  comparison.m_Test = test;
+  comparison.m_LargestRegion = largestRegion;
+  comparison.m_DifferenceThreshold = differenceThreshold;
+  comparison.m_MaximumNumberOfDifferentPixels = maximumNumberOfDifferentPixels;
+
+  /** The neighbours within the tolerance radius, along the axes that have
+   * more than one pixel.
+   */
+  if( toleranceRadius > 0 )
+  {
+    OffsetType offset;
+    offset.Fill( 0 );
+    for( unsigned int d = 0; d < dimension; ++d )
+    {
+      if( largestSize[ d ] > 1 ) offset[ d ] = -static_cast<itk::OffsetValueType>( toleranceRadius );
+    }
+    const OffsetType first = offset;
+    while( true )
+    {
+      bool isCentre = true;
+      for( unsigned int d = 0; d < dimension; ++d ) isCentre &= ( offset[ d ] == 0 );
+      if( !isCentre ) comparison.m_Neighbours.push_back( offset );
+
+      unsigned int d = 0;
+      for( ; d < dimension; ++d )
+      {
+        if( largestSize[ d ] <= 1 ) continue;
+        if( ++offset[ d ] <= static_cast<itk::OffsetValueType>( toleranceRadius ) ) break;
+        offset[ d ] = first[ d ];
+      }
+      if( d == dimension ) break;
+    }
+  }
+
+  /** Slabs along the last axis with more than one pixel, of about 2^22 pixels. */
+  unsigned int slabAxis = 0;
+  for( unsigned int d = 0; d < dimension; ++d )
+  {
+    if( largestSize[ d ] > 1 ) slabAxis = d;
+  }
+  const itk::SizeValueType slicePixels
+    = largestRegion.GetNumberOfPixels() / std::max<itk::SizeValueType>( 1, largestSize[ slabAxis ] );
+  const itk::SizeValueType slabThickness = std::max<itk::SizeValueType>(
+    1, ( 1 << 22 ) / std::max<itk::SizeValueType>( 1, slicePixels ) );
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  if( numberOfThreads > 0 ) threader->SetNumberOfThreads( numberOfThreads );
+
+  itk::SizeValueType numberOfDifferentPixels = 0;
+  const itk::IndexValueType firstSlice = largestRegion.GetIndex( slabAxis );
+  const itk::IndexValueType endSlice = firstSlice + largestSize[ slabAxis ];
+  for( itk::IndexValueType slice = firstSlice; slice < endSlice; slice += slabThickness )
+  {
+    RegionType slab = largestRegion;
+    slab.SetIndex( slabAxis, slice );
+    slab.SetSize( slabAxis, std::min<itk::SizeValueType>( slabThickness, endSlice - slice ) );
+
+    /** The test image is also needed within the radius of the slab. */
+    RegionType testSlab = slab;
+    testSlab.PadByRadius( toleranceRadius );
+    testSlab.Crop( largestRegion );
+
+    baseline->SetRequestedRegion( slab );
+    baseline->Update();
+    test->SetRequestedRegion( testSlab );
+    test->Update();
+
+    comparison.m_Slab = slab;
+    comparison.m_NumberOfDifferentPixels.assign( threader->GetNumberOfThreads(), 0 );
+    threader->SetSingleMethod( CompareSlabThreaderCallback<TImage>, &comparison );
+    threader->SingleMethodExecute();
+
+    for( std::size_t i = 0; i < comparison.m_NumberOfDifferentPixels.size(); ++i )
+    {
+      numberOfDifferentPixels += comparison.m_NumberOfDifferentPixels[ i ];
+    }
+    if( numberOfDifferentPixels > maximumNumberOfDifferentPixels ) break;
+  }
+
+  return numberOfDifferentPixels;
+
+} // end CountDifferentPixels()
+
+} // end namespace itktools
+
+#endif // end #ifndef __StreamedImageComparison_h_
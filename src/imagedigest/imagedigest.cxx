@@ -0,0 +1,143 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+/** \file
+ \brief Compute content digests of images, and find identical images.
+
+ \verbinclude imagedigest.help
+ */
+
+/** Setup Mevislab DicomTiff IO support */
+#include "itkUseMevisDicomTiff.h"
+
+#include "itkCommandLineArgumentParser.h"
+#include "ITKToolsHelpers.h"
+#include "ITKToolsImageDigest.h"
+
+#include <map>
+
+
+/**
+ * ******************* GetHelpString *******************
+ */
+
+std::string GetHelpString( void )
+{
+  std::stringstream ss;
+  ss << "ITKTools v" << itktools::GetITKToolsVersion() << "\n"
+    << "Usage:\n"
+    << "pximagedigest\n"
+    << "  -in      inputFileNames or patterns, e.g. \"dir/*.mhd\"\n"
+    << "  -list    text file with one inputFileName per line\n"
+    << "  [-dedup] only print the groups of identical images\n"
+    << "  [-threads] maximum number of threads\n"
+    << "For every image a line \"digest  inputFileName\" is printed. The digest\n"
+    << "covers the pixel data, the component type, the number of components\n"
+    << "and the geometry, but not the file format, compression or pixel type\n"
+    << "label (e.g. RGB or VECTOR), so images are identical if their digests are.\n"
+    << "With -dedup the lines are grouped by digest, with an empty line between\n"
+    << "the groups, and images without a duplicate are not printed.";
+
+  return ss.str();
+
+} // end GetHelpString()
+
+//-------------------------------------------------------------------------------------
+
+int main( int argc, char ** argv )
+{
+  RegisterMevisDicomTiff();
+
+  /** Create a command line argument parser. */
+  itk::CommandLineArgumentParser::Pointer parser = itk::CommandLineArgumentParser::New();
+  parser->SetCommandLineArguments( argc, argv );
+  parser->SetProgramHelpText( GetHelpString() );
+
+  std::vector<std::string> exactlyOneArguments;
+  exactlyOneArguments.push_back( "-in" );
+  exactlyOneArguments.push_back( "-list" );
+
+  parser->MarkExactlyOneOfArgumentsAsRequired( exactlyOneArguments,
+    "The input filename(s) or a file with a list of input filenames." );
+
+  itk::CommandLineArgumentParser::ReturnValue validateArguments = parser->CheckForRequiredArguments();
+
+  if( validateArguments == itk::CommandLineArgumentParser::FAILED )
+  {
+    return EXIT_FAILURE;
+  }
+  else if( validateArguments == itk::CommandLineArgumentParser::HELPREQUESTED )
+  {
+    return EXIT_SUCCESS;
+  }
+
+  /** Get arguments. */
+  std::vector<std::string> inputFileNames;
+  parser->GetCommandLineArgument( "-in", inputFileNames );
+
+  std::string listFileName = "";
+  parser->GetCommandLineArgument( "-list", listFileName );
+
+  const bool dedup = parser->ArgumentExists( "-dedup" );
+
+  unsigned int numberOfThreads = 0;
+  parser->GetCommandLineArgument( "-threads", numberOfThreads );
+
+  std::vector<std::string> fileNames;
+  if( !itktools::ExpandImageFileNames( inputFileNames, listFileName, fileNames ) )
+  {
+    std::cerr << "ERROR: could not read " << listFileName << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** Compute the digests; the files that fail are reported and skipped. */
+  typedef std::map< std::string, std::vector<std::string> > GroupsType;
+  GroupsType groups;
+  bool allRead = true;
+  for( std::size_t i = 0; i < fileNames.size(); ++i )
+  {
+    std::string digest, error;
+    if( !itktools::ComputeImageDigest( fileNames[ i ], numberOfThreads, digest, error ) )
+    {
+      std::cerr << "ERROR: " << fileNames[ i ] << ": " << error << std::endl;
+      allRead = false;
+      continue;
+    }
+
+    if( dedup ) groups[ digest ].push_back( fileNames[ i ] );
+    else std::cout << digest << "  " << fileNames[ i ] << std::endl;
+  }
+
+  /** Print the groups of identical images. */
+  bool firstGroup = true;
+  for( GroupsType::const_iterator it = groups.begin(); it != groups.end(); ++it )
+  {
+    if( it->second.size() < 2 ) continue;
+
+    if( !firstGroup ) std::cout << "\n";
+    firstGroup = false;
+    for( std::size_t i = 0; i < it->second.size(); ++i )
+    {
+      std::cout << it->first << "  " << it->second[ i ] << "\n";
+    }
+  }
+  std::cout << std::flush;
+
+  /** End program. */
+  return allRead ? EXIT_SUCCESS : EXIT_FAILURE;
+
+} // end main
@@ -21,9 +21,9 @@
 #include "ITKToolsBase.h"
 
 #include "itkImageFileReader.h"
-#include "itkComposeImageFilter.h"
+#include "itkComponentInterleaveImageFilter.h"
 #include "itkImageFileWriter.h"
-#include "itkVectorIndexSelectionCastImageFilter.h"
+#include "itkVectorImage.h"
 
 
 /** \class ITKToolsImagesToVectorImageBase
@@ -76,56 +76,38 @@ public:
     typedef itk::VectorImage< TComponentType, VDimension >    VectorImageType;
     typedef VectorImageType                                   OutputImageType;
     typedef itk::ImageFileReader< VectorImageType >           ReaderType;
-    typedef itk::Image< TComponentType, VDimension >          ScalarImageType;
-    typedef itk::ImageFileWriter< VectorImageType >           WriterType;
+    typedef itk::ComponentInterleaveImageFilter<
+      VectorImageType, OutputImageType >                      ComposerType;
+    typedef itk::ImageFileWriter< OutputImageType >           WriterType;
 
-    /** Read in the input images. */
+    /** Create the composer, which takes all components of all inputs. */
+    typename ComposerType::Pointer composer = ComposerType::New();
+
+    /** Set up the readers. Only the headers are read here; the pixels are
+     * read by the writer, slab by slab.
+     */
+    std::cout << "There are " << this->m_InputFileNames.size() << " input images." << std::endl;
     std::vector<typename ReaderType::Pointer> readers( this->m_InputFileNames.size() );
     for( unsigned int i = 0; i < this->m_InputFileNames.size(); ++i )
     {
       readers[ i ] = ReaderType::New();
       readers[ i ]->SetFileName( this->m_InputFileNames[ i ] );
-      readers[ i ]->Update();
-    }
-
-    /** Create assembler. */
-    typedef itk::ComposeImageFilter< ScalarImageType > ImageToVectorImageFilterType;
-    typename ImageToVectorImageFilterType::Pointer imageToVectorImageFilter
-      = ImageToVectorImageFilterType::New();
+      readers[ i ]->UpdateOutputInformation();
+      composer->SetInput( i, readers[ i ]->GetOutput() );
 
-    // For each input image
-    std::cout << "There are " << this->m_InputFileNames.size() << " input images." << std::endl;
-    unsigned int currentOutputIndex = 0;
-    for( unsigned int inputImageIndex = 0; inputImageIndex < this->m_InputFileNames.size(); ++inputImageIndex )
-    {
-      typedef itk::VectorIndexSelectionCastImageFilter<VectorImageType, ScalarImageType> ComponentExtractionType;
-
-      // For each component of the current image
-      std::cout << "There are " << readers[inputImageIndex]->GetOutput()->GetNumberOfComponentsPerPixel()
-        << " components in image " << inputImageIndex << std::endl;
-      for( unsigned int component = 0;
-        component < readers[inputImageIndex]->GetOutput()->GetNumberOfComponentsPerPixel(); ++component )
-      {
-        typename ComponentExtractionType::Pointer componentExtractionFilter = ComponentExtractionType::New();
-        componentExtractionFilter->SetIndex( component );
-        componentExtractionFilter->SetInput( readers[inputImageIndex]->GetOutput() );
-        componentExtractionFilter->Update();
-
-        imageToVectorImageFilter->SetInput( currentOutputIndex, componentExtractionFilter->GetOutput());
-        currentOutputIndex++;
-      }
+      std::cout << "There are " << readers[ i ]->GetOutput()->GetNumberOfComponentsPerPixel()
+        << " components in image " << i << std::endl;
     }
 
-    imageToVectorImageFilter->Update();
-
+    composer->UpdateOutputInformation();
     std::cout << "Output image has "
-      << imageToVectorImageFilter->GetOutput()->GetNumberOfComponentsPerPixel()
+      << composer->GetOutput()->GetNumberOfComponentsPerPixel()
       << " components." << std::endl;
 
     /** Write vector image. */
     typename WriterType::Pointer writer = WriterType::New();
     writer->SetFileName( this->m_OutputFileName );
-    writer->SetInput( imageToVectorImageFilter->GetOutput() );
+    writer->SetInput( composer->GetOutput() );
     writer->SetNumberOfStreamDivisions( this->m_NumberOfStreams );
     writer->Update();
 
@@ -0,0 +1,139 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkIntensityReplaceImageFilter_h_
+#define __itkIntensityReplaceImageFilter_h_
+
+#include "itkInPlaceImageFilter.h"
+#include "itkIntTypes.h"
+
+#include <map>
+#include <vector>
+
+
+namespace itk
+{
+
+/** \class IntensityReplaceImageFilter
+ * \brief Replaces a set of intensities by other intensities.
+ *
+ * This filter computes the same as the itk::ChangeLabelImageFilter: a pixel
+ * with a value that is in the change map gets the corresponding new value,
+ * all other pixels keep their value. Instead of a map search per pixel, the
+ * change map is converted once, before the threads start, into one of:
+ *
+ * - FullTable: for integer input types of at most 16 bits a table with an
+ *   entry for every possible input value, so that every pixel is a plain
+ *   table lookup;
+ * - RangeTable: for other integer types, if the changed values span at most
+ *   MaximumTableSize values, a table over that span; pixels outside of it
+ *   keep their value, which is a compare and a select;
+ * - SortedSearch: otherwise, e.g. for floating point types or widely spread
+ *   values, a binary search in a sorted array of the changed values.
+ *
+ * Each thread processes its region line by line on the raw buffers. If the
+ * input and output types are equal the filter runs in place by default.
+ *
+ * \ingroup IntensityImageFilters Multithreaded
+ */
+template <class TInputImage, class TOutputImage = TInputImage>
+class IntensityReplaceImageFilter:
+    public InPlaceImageFilter<TInputImage,TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef IntensityReplaceImageFilter                   Self;
+  typedef InPlaceImageFilter<TInputImage,TOutputImage>  Superclass;
+  typedef SmartPointer<Self>                            Pointer;
+  typedef SmartPointer<const Self>                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( IntensityReplaceImageFilter, InPlaceImageFilter );
+
+  /** Typedef to describe the input/output image types. */
+  typedef TInputImage                                   InputImageType;
+  typedef typename InputImageType::PixelType            InputPixelType;
+  typedef TOutputImage                                  OutputImageType;
+  typedef typename OutputImageType::PixelType           OutputPixelType;
+  typedef typename OutputImageType::RegionType          OutputImageRegionType;
+  typedef std::map<InputPixelType, OutputPixelType>     ChangeMapType;
+
+  /** The ways of looking up the new values. */
+  typedef enum { FullTable, RangeTable, SortedSearch } LookupMethodType;
+
+  /** Replace original by result. */
+  void SetChange( const InputPixelType & original, const OutputPixelType & result );
+
+  /** Set/Get the complete change map. */
+  void SetChangeMap( const ChangeMapType & changeMap );
+  const ChangeMapType & GetChangeMap( void ) const { return this->m_ChangeMap; }
+
+  /** Set/Get the maximum number of entries of a RangeTable. Default 2^20. */
+  itkSetMacro( MaximumTableSize, SizeValueType );
+  itkGetConstMacro( MaximumTableSize, SizeValueType );
+
+  /** The method that was used by the last update. */
+  itkGetConstMacro( LookupMethod, LookupMethodType );
+
+protected:
+  IntensityReplaceImageFilter();
+  ~IntensityReplaceImageFilter() {};
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** Build the table or the sorted arrays. */
+  virtual void BeforeThreadedGenerateData( void );
+
+  /** Dispatch on the lookup method. */
+  virtual void ThreadedGenerateData(
+    const OutputImageRegionType & outputRegionForThread,
+    ThreadIdType threadId );
+
+  /** Replace the values of all lines of the region. */
+  template <class TLookup>
+  void ThreadedGenerateDataForLookup(
+    const OutputImageRegionType & outputRegionForThread,
+    ThreadIdType threadId, const TLookup & lookup );
+
+private:
+  IntensityReplaceImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  ChangeMapType     m_ChangeMap;
+  SizeValueType     m_MaximumTableSize;
+  LookupMethodType  m_LookupMethod;
+
+  /** The table and its first value, for FullTable and RangeTable. */
+  std::vector<OutputPixelType>  m_Table;
+  InputPixelType                m_TableOrigin;
+
+  /** The sorted changed values and their new values, for SortedSearch. */
+  std::vector<InputPixelType>   m_SortedOriginals;
+  std::vector<OutputPixelType>  m_SortedResults;
+
+}; // end class IntensityReplaceImageFilter
+
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkIntensityReplaceImageFilter.hxx"
+#endif
+
+#endif // end #ifndef __itkIntensityReplaceImageFilter_h_
@@ -0,0 +1,287 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef _itkIntensityReplaceImageFilter_hxx_
+#define _itkIntensityReplaceImageFilter_hxx_
+
+#include "itkIntensityReplaceImageFilter.h"
+
+#include "itkImageLinearIteratorWithIndex.h"
+#include "itkNumericTraits.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
+
+
+namespace itk
+{
+namespace Functor
+{
+
+/** The lookups of the IntensityReplaceImageFilter. The integer values are
+ * converted to uint64_t, so that value - origin is the table index for
+ * signed and unsigned types alike, and a value below the origin gives a
+ * huge index.
+ */
+
+template <class TInput, class TOutput>
+struct IntensityReplaceFullTable
+{
+  const TOutput * Table;
+  uint64_t        Origin;
+  inline TOutput operator()( const TInput & value ) const
+  {
+    return this->Table[ static_cast<uint64_t>( value ) - this->Origin ];
+  }
+};
+
+template <class TInput, class TOutput>
+struct IntensityReplaceRangeTable
+{
+  const TOutput * Table;
+  uint64_t        Origin;
+  uint64_t        Size;
+  inline TOutput operator()( const TInput & value ) const
+  {
+    const uint64_t offset = static_cast<uint64_t>( value ) - this->Origin;
+    const bool inside = offset < this->Size;
+    const TOutput replaced = this->Table[ inside ? offset : 0 ];
+    return inside ? replaced : static_cast<TOutput>( value );
+  }
+};
+
+template <class TInput, class TOutput>
+struct IntensityReplaceSortedSearch
+{
+  const TInput *  Originals;
+  const TOutput * Results;
+  std::size_t     Size;
+  inline TOutput operator()( const TInput & value ) const
+  {
+    const TInput * found = std::lower_bound( this->Originals, this->Originals + this->Size, value );
+    if( found != this->Originals + this->Size && *found == value )
+    {
+      return this->Results[ found - this->Originals ];
+    }
+    return static_cast<TOutput>( value );
+  }
+};
+
+} // end namespace Functor
+
+
+template<class TInputImage, class TOutputImage>
+IntensityReplaceImageFilter<TInputImage,TOutputImage>
+::IntensityReplaceImageFilter()
+{
+  this->SetNumberOfRequiredInputs( 1 );
+  this->InPlaceOn();
+  this->m_MaximumTableSize = 1 << 20;
+  this->m_LookupMethod = SortedSearch;
+  this->m_TableOrigin = NumericTraits<InputPixelType>::Zero;
+}
+
+
+template<class TInputImage, class TOutputImage>
+void
+IntensityReplaceImageFilter<TInputImage,TOutputImage>
+::SetChange( const InputPixelType & original, const OutputPixelType & result )
+{
+  typename ChangeMapType::iterator it = this->m_ChangeMap.find( original );
+  if( it == this->m_ChangeMap.end() || it->second != result )
+  {
+    this->m_ChangeMap[ original ] = result;
+    this->Modified();
+  }
+
+} // end SetChange()
+
+
+template<class TInputImage, class TOutputImage>
+void
+IntensityReplaceImageFilter<TInputImage,TOutputImage>
+::SetChangeMap( const ChangeMapType & changeMap )
+{
+  if( this->m_ChangeMap != changeMap )
+  {
+    this->m_ChangeMap = changeMap;
+    this->Modified();
+  }
+
+} // end SetChangeMap()
+
+
+template<class TInputImage, class TOutputImage>
+void
+IntensityReplaceImageFilter<TInputImage,TOutputImage>
+::BeforeThreadedGenerateData( void )
+{
+  typedef typename ChangeMapType::const_iterator  ChangeIteratorType;
+
+  this->m_Table.clear();
+  this->m_SortedOriginals.clear();
+  this->m_SortedResults.clear();
+
+  /** Choose the lookup method. The span of the map keys is computed in
+   * double, which is precise enough to compare with the table size.
+   */
+  const bool isInteger = NumericTraits<InputPixelType>::is_integer;
+  uint64_t tableSize = 0;
+  if( isInteger && sizeof( InputPixelType ) <= 2 )
+  {
+    this->m_LookupMethod = FullTable;
+    this->m_TableOrigin = NumericTraits<InputPixelType>::NonpositiveMin();
+    tableSize = static_cast<uint64_t>( NumericTraits<InputPixelType>::max() )
+      - static_cast<uint64_t>( this->m_TableOrigin ) + 1;
+  }
+  else if( isInteger && !this->m_ChangeMap.empty()
+    && static_cast<double>( this->m_ChangeMap.rbegin()->first )
+    - static_cast<double>( this->m_ChangeMap.begin()->first )
+    < static_cast<double>( this->m_MaximumTableSize ) )
+  {
+    this->m_LookupMethod = RangeTable;
+    this->m_TableOrigin = this->m_ChangeMap.begin()->first;
+    tableSize = static_cast<uint64_t>( this->m_ChangeMap.rbegin()->first )
+      - static_cast<uint64_t>( this->m_TableOrigin ) + 1;
+  }
+  else
+  {
+    this->m_LookupMethod = SortedSearch;
+  }
+
+  if( this->m_LookupMethod == SortedSearch )
+  {
+    /** The map is sorted already. */
+    for( ChangeIteratorType it = this->m_ChangeMap.begin(); it != this->m_ChangeMap.end(); ++it )
+    {
+      this->m_SortedOriginals.push_back( it->first );
+      this->m_SortedResults.push_back( it->second );
+    }
+    return;
+  }
+
+  /** Fill the table with the unchanged values, then apply the changes. */
+  const uint64_t origin = static_cast<uint64_t>( this->m_TableOrigin );
+  this->m_Table.resize( tableSize );
+  for( uint64_t i = 0; i < tableSize; ++i )
+  {
+    this->m_Table[ i ] = static_cast<OutputPixelType>(
+      static_cast<InputPixelType>( origin + i ) );
+  }
+  for( ChangeIteratorType it = this->m_ChangeMap.begin(); it != this->m_ChangeMap.end(); ++it )
+  {
+    this->m_Table[ static_cast<uint64_t>( it->first ) - origin ] = it->second;
+  }
+
+} // end BeforeThreadedGenerateData()
+
+
+template<class TInputImage, class TOutputImage>
+void
+IntensityReplaceImageFilter<TInputImage,TOutputImage>
+::ThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread,
+  ThreadIdType threadId )
+{
+  if( this->m_LookupMethod == FullTable )
+  {
+    Functor::IntensityReplaceFullTable<InputPixelType, OutputPixelType> lookup;
+    lookup.Table = &this->m_Table[ 0 ];
+    lookup.Origin = static_cast<uint64_t>( this->m_TableOrigin );
+    this->ThreadedGenerateDataForLookup( outputRegionForThread, threadId, lookup );
+  }
+  else if( this->m_LookupMethod == RangeTable )
+  {
+    Functor::IntensityReplaceRangeTable<InputPixelType, OutputPixelType> lookup;
+    lookup.Table = &this->m_Table[ 0 ];
+    lookup.Origin = static_cast<uint64_t>( this->m_TableOrigin );
+    lookup.Size = this->m_Table.size();
+    this->ThreadedGenerateDataForLookup( outputRegionForThread, threadId, lookup );
+  }
+  else
+  {
+    Functor::IntensityReplaceSortedSearch<InputPixelType, OutputPixelType> lookup;
+    lookup.Size = this->m_SortedOriginals.size();
+    lookup.Originals = lookup.Size > 0 ? &this->m_SortedOriginals[ 0 ] : 0;
+    lookup.Results = lookup.Size > 0 ? &this->m_SortedResults[ 0 ] : 0;
+    this->ThreadedGenerateDataForLookup( outputRegionForThread, threadId, lookup );
+  }
+
+} // end ThreadedGenerateData()
+
+
+template<class TInputImage, class TOutputImage>
+template<class TLookup>
+void
+IntensityReplaceImageFilter<TInputImage,TOutputImage>
+::ThreadedGenerateDataForLookup(
+  const OutputImageRegionType & outputRegionForThread,
+  ThreadIdType threadId, const TLookup & lookup )
+{
+  typedef typename OutputImageType::IndexType             IndexType;
+  typedef ImageLinearIteratorWithIndex<OutputImageType>   IteratorType;
+
+  const InputImageType * input = this->GetInput();
+  OutputImageType * output = this->GetOutput();
+
+  const std::size_t lineLength = outputRegionForThread.GetSize( 0 );
+  if( lineLength == 0 ) return;
+
+  ProgressReporter progress( this, threadId,
+    outputRegionForThread.GetNumberOfPixels() / lineLength );
+
+  /** Pixels along dimension 0 are contiguous in both buffers. When running
+   * in place, in and out are the same buffer.
+   */
+  IteratorType it( output, outputRegionForThread );
+  it.SetDirection( 0 );
+  it.GoToBegin();
+  while( !it.IsAtEnd() )
+  {
+    const IndexType index = it.GetIndex();
+    const InputPixelType * in = input->GetBufferPointer() + input->ComputeOffset( index );
+    OutputPixelType * out = output->GetBufferPointer() + output->ComputeOffset( index );
+
+    for( std::size_t j = 0; j < lineLength; ++j )
+    {
+      out[ j ] = lookup( in[ j ] );
+    }
+
+    it.NextLine();
+    progress.CompletedPixel();
+  } // end while lines
+
+} // end ThreadedGenerateDataForLookup()
+
+
+template<class TInputImage, class TOutputImage>
+void
+IntensityReplaceImageFilter<TInputImage,TOutputImage>
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "Number of changes: " << this->m_ChangeMap.size() << std::endl;
+  os << indent << "MaximumTableSize: " << this->m_MaximumTableSize << std::endl;
+  os << indent << "LookupMethod: " << this->m_LookupMethod << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef _itkIntensityReplaceImageFilter_hxx_
@@ -0,0 +1,224 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __BitPackedMask_h_
+#define __BitPackedMask_h_
+
+#include "itkIntTypes.h"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace itktools
+{
+
+/** \class BitPackedMask
+ * \brief A mask with one bit per pixel, packed in 64-bit words.
+ *
+ * Pixel i is bit i % 64 of word i / 64, in the order of the image buffer.
+ * Compared to an unsigned char mask this takes an eighth of the memory,
+ * and the logical operators process 64 pixels per word operation, in
+ * plain loops over the words that the compiler vectorises. The bits after
+ * the last pixel are kept zero, so that Count() can simply add the
+ * population counts of all words.
+ *
+ * The Pack functions convert an image buffer to bits, Unpack converts the
+ * bits back to the values 0 and 1.
+ */
+
+class BitPackedMask
+{
+public:
+  typedef itk::uint64_t WordType;
+  static const unsigned int BitsPerWord = 64;
+
+  /** The word-wide operations; the first operand is this mask. */
+  typedef enum {
+    And, Or, Xor, AndNot, OrNot, NotXor, NotOr, NotAnd, True
+  } OperationType;
+
+  BitPackedMask() : m_NumberOfPixels( 0 ) {};
+  ~BitPackedMask() {};
+
+  /** Set the number of pixels; all bits are cleared. */
+  void SetNumberOfPixels( const std::size_t & numberOfPixels )
+  {
+    this->m_NumberOfPixels = numberOfPixels;
+    this->m_Words.assign( ( numberOfPixels + BitsPerWord - 1 ) / BitsPerWord, 0 );
+  }
+  std::size_t GetNumberOfPixels( void ) const { return this->m_NumberOfPixels; }
+  std::size_t GetNumberOfWords( void ) const { return this->m_Words.size(); }
+
+  /** Pack buffer[ i ] != 0. */
+  template< class T >
+  void PackNonZero( const T * buffer )
+  {
+    for( std::size_t w = 0; w < this->m_Words.size(); ++w )
+    {
+      const std::size_t begin = w * BitsPerWord;
+      const std::size_t end = this->WordEnd( w );
+      WordType word = 0;
+      for( std::size_t i = begin; i < end; ++i )
+      {
+        word |= static_cast<WordType>( buffer[ i ] != 0 ) << ( i - begin );
+      }
+      this->m_Words[ w ] = word;
+    }
+  }
+
+  /** Pack buffer[ i ] == 1, checking that all values are 0 or 1, i.e. that
+   * bitwise operators on the values equal those on the bits. Stops at the
+   * first word with another value and returns false; the mask is then
+   * incomplete.
+   */
+  template< class T >
+  bool PackBinary( const T * buffer )
+  {
+    for( std::size_t w = 0; w < this->m_Words.size(); ++w )
+    {
+      const std::size_t begin = w * BitsPerWord;
+      const std::size_t end = this->WordEnd( w );
+      WordType word = 0;
+      bool binary = true;
+      for( std::size_t i = begin; i < end; ++i )
+      {
+        word |= static_cast<WordType>( buffer[ i ] == 1 ) << ( i - begin );
+        binary &= ( buffer[ i ] == 0 || buffer[ i ] == 1 );
+      }
+      if( !binary ) return false;
+      this->m_Words[ w ] = word;
+    }
+    return true;
+  }
+
+  /** Pack buffer[ i ] == value. */
+  template< class T >
+  void PackEqual( const T * buffer, const T & value )
+  {
+    for( std::size_t w = 0; w < this->m_Words.size(); ++w )
+    {
+      const std::size_t begin = w * BitsPerWord;
+      const std::size_t end = this->WordEnd( w );
+      WordType word = 0;
+      for( std::size_t i = begin; i < end; ++i )
+      {
+        word |= static_cast<WordType>( buffer[ i ] == value ) << ( i - begin );
+      }
+      this->m_Words[ w ] = word;
+    }
+  }
+
+  /** Write the bits as 0 and 1 to the buffer. */
+  template< class T >
+  void Unpack( T * buffer ) const
+  {
+    for( std::size_t w = 0; w < this->m_Words.size(); ++w )
+    {
+      const std::size_t begin = w * BitsPerWord;
+      const std::size_t end = this->WordEnd( w );
+      const WordType word = this->m_Words[ w ];
+      for( std::size_t i = begin; i < end; ++i )
+      {
+        buffer[ i ] = static_cast<T>( ( word >> ( i - begin ) ) & 1 );
+      }
+    }
+  }
+
+  /** this = this op other. The masks must have the same size. */
+  void Apply( const OperationType & operation, const BitPackedMask & other )
+  {
+    if( this->m_Words.empty() ) return;
+    WordType * a = &this->m_Words[ 0 ];
+    const WordType * b = &other.m_Words[ 0 ];
+    const std::size_t n = this->m_Words.size();
+    switch( operation )
+    {
+      case And:    for( std::size_t w = 0; w < n; ++w ) a[ w ] = a[ w ] & b[ w ]; break;
+      case Or:     for( std::size_t w = 0; w < n; ++w ) a[ w ] = a[ w ] | b[ w ]; break;
+      case Xor:    for( std::size_t w = 0; w < n; ++w ) a[ w ] = a[ w ] ^ b[ w ]; break;
+      case AndNot: for( std::size_t w = 0; w < n; ++w ) a[ w ] = a[ w ] & ~b[ w ]; break;
+      case OrNot:  for( std::size_t w = 0; w < n; ++w ) a[ w ] = a[ w ] | ~b[ w ]; break;
+      case NotXor: for( std::size_t w = 0; w < n; ++w ) a[ w ] = ~( a[ w ] ^ b[ w ] ); break;
+      case NotOr:  for( std::size_t w = 0; w < n; ++w ) a[ w ] = ~( a[ w ] | b[ w ] ); break;
+      case NotAnd: for( std::size_t w = 0; w < n; ++w ) a[ w ] = ~( a[ w ] & b[ w ] ); break;
+      case True:   for( std::size_t w = 0; w < n; ++w ) a[ w ] = ~WordType( 0 ); break;
+    }
+    this->ClearTail();
+  }
+
+  /** this = !this. */
+  void Not( void )
+  {
+    if( this->m_Words.empty() ) return;
+    WordType * a = &this->m_Words[ 0 ];
+    const std::size_t n = this->m_Words.size();
+    for( std::size_t w = 0; w < n; ++w ) a[ w ] = ~a[ w ];
+    this->ClearTail();
+  }
+
+  /** The number of set bits. */
+  std::size_t Count( void ) const
+  {
+    std::size_t count = 0;
+    for( std::size_t w = 0; w < this->m_Words.size(); ++w )
+    {
+      count += PopCount( this->m_Words[ w ] );
+    }
+    return count;
+  }
+
+  /** The number of set bits of a word. */
+  static inline unsigned int PopCount( WordType word )
+  {
+#if defined( __GNUC__ )
+    return __builtin_popcountll( word );
+#else
+    word = word - ( ( word >> 1 ) & 0x5555555555555555ULL );
+    word = ( word & 0x3333333333333333ULL ) + ( ( word >> 2 ) & 0x3333333333333333ULL );
+    word = ( word + ( word >> 4 ) ) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<unsigned int>( ( word * 0x0101010101010101ULL ) >> 56 );
+#endif
+  }
+
+private:
+
+  /** One past the last pixel of word w. */
+  std::size_t WordEnd( const std::size_t & w ) const
+  {
+    const std::size_t end = ( w + 1 ) * BitsPerWord;
+    return end < this->m_NumberOfPixels ? end : this->m_NumberOfPixels;
+  }
+
+  /** Zero the bits after the last pixel. */
+  void ClearTail( void )
+  {
+    const std::size_t used = this->m_NumberOfPixels % BitsPerWord;
+    if( used != 0 )
+    {
+      this->m_Words.back() &= ( WordType( 1 ) << used ) - 1;
+    }
+  }
+
+  std::size_t             m_NumberOfPixels;
+  std::vector<WordType>   m_Words;
+
+}; // end class BitPackedMask
+
+} // end namespace itktools
+
+#endif // end #ifndef __BitPackedMask_h_
@@ -42,6 +42,7 @@ std::string GetHelpString( void )
     << "An appropriate scaling must be performed either manually (with pxrescaleintensityimagefilter)\n"
     << "or with the application used to view the image.\n"
     << "In the case of a vector image, this is a componentwise logical operator.\n"
+    << "Scalar masks (images with only the values 0 and 1) are processed with one bit per pixel.\n"
     << "Usage:" << std::endl << "pxlogicalimageoperator\n"
     << "  -in      inputFilename1 [inputFilename2]\n"
     << "  [-out]   outputFilename, default in1 + <ops> + in2 + .mhd\n"
@@ -198,6 +199,7 @@ int main( int argc, char **argv )
     filter->m_UseCompression = useCompression;
     filter->m_Argument = argument;
     filter->m_Unary = unary;
+    filter->m_NumberOfComponents = numberOfComponents;
 
     filter->Run();
 
@@ -30,6 +30,8 @@
 #include "itkComposeImageFilter.h"
 #include "itkImageFileWriter.h"
 
+#include "BitPackedMask.h"
+
 #include <map>
 #include <utility>
 #include <vector>
@@ -55,6 +57,7 @@ public:
     this->m_UseCompression = false;
     this->m_Argument = 0.0f;
     this->m_Unary = false;
+    this->m_NumberOfComponents = 1;
   };
   /** Destructor. */
   ~ITKToolsLogicalImageOperatorBase(){};
@@ -67,6 +70,7 @@ public:
   bool m_UseCompression;
   double m_Argument;
   bool m_Unary; // is the operator to be performed unary? (else it is binary)
+  unsigned int m_NumberOfComponents;
 
 }; // end class ITKToolsLogicalImageOperatorBase
 
@@ -91,11 +95,282 @@ public:
   /** Run function. */
   void Run( void )
   {
+    /** Masks are processed bit-packed; see RunBitPacked(). */
+    if( this->m_NumberOfComponents == 1 && this->RunBitPacked() ) return;
+
     if( this->m_Unary ) this->RunUnary();
     else this->RunBinary();
 
   } // end Run()
 
+  /** A pair indicating which functor should be used for an operator,
+   * and whether the arguments should be swapped.
+   */
+  typedef std::pair< BinaryFunctorEnum, bool >        BinaryOperatorType;
+  typedef std::map<std::string, BinaryOperatorType>   BinaryOperatorMapType;
+
+  /** Fill the map of the binary operators. */
+  void GetBinaryOperatorMap( BinaryOperatorMapType & binaryOperatorMap ) const
+  {
+    /** Available SimpleOperatorTypes are defined in itkLogicalFunctors.h:
+     * AND, OR, XOR, NOT_AND, NOT_OR, NOT_XOR, ANDNOT, ORNOT
+     *
+     * The Simplification map (simpmap) defines for every possible logical
+     * operation of the form
+     *   [not]( ([not] A) [{&,|,^} ([not] B])] )
+     * a simplified version.
+     *
+     * example1: A ^ (!B) = XORNOT(A,B) = NOT_XOR(A,B) = ! (A ^ B)
+     * example2: (!A) & B = NOTAND(A,B) = ANDNOT(B,A) = B & (!A)
+     */
+
+    binaryOperatorMap["AND"]        = BinaryOperatorType(AND, false);
+    binaryOperatorMap["OR"]         = BinaryOperatorType(OR, false);
+    binaryOperatorMap["XOR"]        = BinaryOperatorType(XOR, false);
+    binaryOperatorMap["ANDNOT"]     = BinaryOperatorType(ANDNOT, false);
+    binaryOperatorMap["ORNOT"]      = BinaryOperatorType(ORNOT, false);
+    binaryOperatorMap["XORNOT"]     = BinaryOperatorType(NOT_XOR, false);
+
+    binaryOperatorMap["NOTAND"]     = BinaryOperatorType(ANDNOT, true);
+    binaryOperatorMap["NOTOR"]      = BinaryOperatorType(ORNOT, true);
+    binaryOperatorMap["NOTXOR"]     = BinaryOperatorType(NOT_XOR, false);
+
+    binaryOperatorMap["NOTANDNOT"]  = BinaryOperatorType(NOT_OR, false);
+    binaryOperatorMap["NOTORNOT"]   = BinaryOperatorType(NOT_AND, false);
+    binaryOperatorMap["NOTXORNOT"]  = BinaryOperatorType(XOR, false);
+
+    binaryOperatorMap["NOT_AND"]    = BinaryOperatorType(NOT_AND, false);
+    binaryOperatorMap["NOT_OR"]     = BinaryOperatorType(NOT_OR, false);
+    binaryOperatorMap["NOT_XOR"]    = BinaryOperatorType(NOT_XOR, false);
+    binaryOperatorMap["NOT_NOT"]    = BinaryOperatorType(DUMMY, false);
+
+    binaryOperatorMap["NOT_ANDNOT"] = BinaryOperatorType(ORNOT, true);
+    binaryOperatorMap["NOT_ORNOT"]  = BinaryOperatorType(ANDNOT, true);
+    binaryOperatorMap["NOT_XORNOT"] = BinaryOperatorType(XOR, false);
+
+    binaryOperatorMap["NOT_NOTAND"] = BinaryOperatorType(ORNOT, false);
+    binaryOperatorMap["NOT_NOTOR"]  = BinaryOperatorType(ANDNOT, false);
+    binaryOperatorMap["NOT_NOTXOR"] = BinaryOperatorType(XOR, false);
+
+    binaryOperatorMap["NOT_NOTANDNOT"] = BinaryOperatorType(OR, false);
+    binaryOperatorMap["NOT_NOTORNOT"]  = BinaryOperatorType(AND, false);
+    binaryOperatorMap["NOT_NOTXORNOT"] = BinaryOperatorType(NOT_XOR, false);
+
+  } // end GetBinaryOperatorMap()
+
+  /** Run the operation on bit-packed masks. The images are read one at a
+   * time and packed to one bit per pixel, so that at most one image of
+   * TComponentType is in memory. The result is unpacked into the output
+   * image. The operators are bitwise on the pixel values, which only equals
+   * the operation on the bits for the values 0 and 1, so the inputs of a
+   * binary operator are checked while they are packed. If one is not
+   * binary, the operator is applied to the images by RunBinaryOnImages();
+   * a binary first image is then unpacked again instead of read again.
+   * Returns false, without reading, for operators that are not supported.
+   */
+  bool RunBitPacked( void )
+  {
+    /** Typedefs. */
+    typedef itk::Image<TComponentType, VDimension>        ScalarImageType;
+    typedef itk::ImageFileReader< ScalarImageType >       ReaderType;
+    typedef itk::ImageFileWriter< ScalarImageType >       WriterType;
+    typedef itktools::BitPackedMask                       MaskType;
+
+    /** The word operation and whether the arguments should be swapped. */
+    MaskType::OperationType operation = MaskType::And;
+    bool swapArguments = false;
+    if( !this->m_Unary )
+    {
+      BinaryOperatorMapType binaryOperatorMap;
+      this->GetBinaryOperatorMap( binaryOperatorMap );
+      if( binaryOperatorMap.count( this->m_Ops ) == 0 ) return false;
+
+      const BinaryOperatorType logicalOperator = binaryOperatorMap[ this->m_Ops ];
+      swapArguments = logicalOperator.second;
+      switch( logicalOperator.first )
+      {
+        case AND:     operation = MaskType::And;    break;
+        case OR:      operation = MaskType::Or;     break;
+        case XOR:     operation = MaskType::Xor;    break;
+        case ANDNOT:  operation = MaskType::AndNot; break;
+        case ORNOT:   operation = MaskType::OrNot;  break;
+        case NOT_XOR: operation = MaskType::NotXor; break;
+        case NOT_OR:  operation = MaskType::NotOr;  break;
+        case NOT_AND: operation = MaskType::NotAnd; break;
+        case DUMMY:   operation = MaskType::True;   break;
+      }
+    }
+    else if( this->m_Ops != "EQUAL" && this->m_Ops != "NOT" )
+    {
+      return false;
+    }
+
+    /** Read and pack the first image. */
+    typename ReaderType::Pointer reader1 = ReaderType::New();
+    reader1->SetFileName( this->m_InputFileName1.c_str() );
+    std::cout << "Reading image1: " << this->m_InputFileName1 << std::endl;
+    reader1->Update();
+    std::cout << "Done reading image1." << std::endl;
+
+    typename ScalarImageType::Pointer image1 = reader1->GetOutput();
+    reader1 = 0;
+    MaskType mask1;
+    mask1.SetNumberOfPixels( image1->GetBufferedRegion().GetNumberOfPixels() );
+    bool binary1 = true;
+    if( this->m_Ops == "EQUAL" )
+    {
+      mask1.PackEqual( image1->GetBufferPointer(),
+        static_cast<TComponentType>( this->m_Argument ) );
+    }
+    else if( this->m_Unary )
+    {
+      mask1.PackNonZero( image1->GetBufferPointer() );
+    }
+    else
+    {
+      binary1 = mask1.PackBinary( image1->GetBufferPointer() );
+    }
+
+    /** The output gets the geometry of the first image, or of the second
+     * image for the operators with swapped arguments, as the filter in
+     * RunBinaryOnImages() does. A non-binary first image is kept for
+     * RunBinaryOnImages(). */
+    typename ScalarImageType::Pointer output = ScalarImageType::New();
+    output->CopyInformation( image1 );
+    output->SetRegions( image1->GetBufferedRegion() );
+    if( binary1 ) image1 = 0;
+
+    if( this->m_Unary )
+    {
+      std::cout
+        << "Performing logical operation, "
+        << this->m_Ops
+        << ", on bit-packed input image(s)..."
+        << std::endl;
+
+      if( this->m_Ops == "NOT" ) mask1.Not();
+    }
+    else
+    {
+      /** Read and pack the second image. */
+      typename ReaderType::Pointer reader2 = ReaderType::New();
+      reader2->SetFileName( this->m_InputFileName2.c_str() );
+      std::cout << "Reading image2: " << this->m_InputFileName2 << std::endl;
+      reader2->Update();
+      std::cout << "Done reading image2." << std::endl;
+
+      typename ScalarImageType::Pointer image2 = reader2->GetOutput();
+      reader2 = 0;
+      if( image2->GetBufferedRegion().GetSize() != output->GetBufferedRegion().GetSize() )
+      {
+        itkGenericExceptionMacro( << "The sizes of the input images differ." );
+      }
+      MaskType mask2;
+      mask2.SetNumberOfPixels( image2->GetBufferedRegion().GetNumberOfPixels() );
+      const bool binary2 = binary1 && mask2.PackBinary( image2->GetBufferPointer() );
+
+      if( !binary2 )
+      {
+        std::cout << "Image" << ( binary1 ? 2 : 1 )
+          << " is not binary, bit packing is not used." << std::endl;
+        if( binary1 )
+        {
+          /** The values of a binary image are its bits. */
+          output->Allocate();
+          mask1.Unpack( output->GetBufferPointer() );
+          image1 = output;
+        }
+        this->RunBinaryOnImages( image1, image2 );
+        return true;
+      }
+      if( swapArguments )
+      {
+        output->CopyInformation( image2 );
+        output->SetRegions( image2->GetBufferedRegion() );
+      }
+      image2 = 0;
+
+      std::cout
+        << "Performing logical operation, "
+        << this->m_Ops
+        << ", on bit-packed input image(s)..."
+        << std::endl;
+
+      if( swapArguments )
+      {
+        mask2.Apply( operation, mask1 );
+        std::swap( mask1, mask2 );
+      }
+      else
+      {
+        mask1.Apply( operation, mask2 );
+      }
+    }
+
+    std::cout << "The result has " << mask1.Count()
+      << " nonzero pixels out of " << mask1.GetNumberOfPixels() << "." << std::endl;
+
+    /** Unpack and write the image to disk. */
+    output->Allocate();
+    mask1.Unpack( output->GetBufferPointer() );
+
+    typename WriterType::Pointer writer = WriterType::New();
+    writer->SetFileName( this->m_OutputFileName.c_str() );
+    writer->SetInput( output );
+    writer->SetUseCompression( this->m_UseCompression );
+    writer->Update();
+
+    return true;
+
+  } // end RunBitPacked()
+
+  /** Apply the binary operator to scalar images that are already in
+   * memory, and write the result. Used by RunBitPacked() for inputs that
+   * are not binary.
+   */
+  void RunBinaryOnImages(
+    itk::Image<TComponentType, VDimension> * image1,
+    itk::Image<TComponentType, VDimension> * image2 )
+  {
+    /** Typedefs. */
+    typedef itk::Image<TComponentType, VDimension>        ScalarImageType;
+    typedef itk::ImageFileWriter< ScalarImageType >       WriterType;
+
+    BinaryOperatorMapType binaryOperatorMap;
+    this->GetBinaryOperatorMap( binaryOperatorMap );
+    const BinaryOperatorType logicalOperator = binaryOperatorMap[ this->m_Ops ];
+
+    BinaryLogicalFunctorFactory<ScalarImageType> binaryFactory;
+    typename itk::InPlaceImageFilter<ScalarImageType, ScalarImageType>::Pointer logicalFilter
+      = binaryFactory.GetFilter( logicalOperator.first );
+
+    std::cout
+      << "Performing logical operation, "
+      << this->m_Ops
+      << ", on input image(s)..."
+      << std::endl;
+
+    if( logicalOperator.second )
+    {
+      /** swap the input images */
+      logicalFilter->SetInput( 1, image1 );
+      logicalFilter->SetInput( 0, image2 );
+    }
+    else
+    {
+      logicalFilter->SetInput( 0, image1 );
+      logicalFilter->SetInput( 1, image2 );
+    }
+
+    /** Write the image to disk */
+    typename WriterType::Pointer writer = WriterType::New();
+    writer->SetFileName( this->m_OutputFileName.c_str() );
+    writer->SetInput( logicalFilter->GetOutput() );
+    writer->SetUseCompression( this->m_UseCompression );
+    writer->Update();
+
+  } // end RunBinaryOnImages()
+
   /** RunUnary function. */
   void RunUnary( void )
   {
@@ -116,11 +391,11 @@ public:
     std::cout << "Done reading image1." << std::endl;
 
     UnaryFunctorEnum unaryOperation;
-    if( this->m_Ops.compare( "EQUAL" ) )
+    if( this->m_Ops.compare( "EQUAL" ) == 0 )
     {
       unaryOperation = EQUAL;
     }
-    else if( this->m_Ops.compare( "NOT" ) )
+    else if( this->m_Ops.compare( "NOT" ) == 0 )
     {
       unaryOperation = NOT;
     }
@@ -176,61 +451,13 @@ public:
     typedef itk::ImageFileReader< VectorImageType >       ReaderType;
     typedef itk::ImageFileWriter< VectorImageType >       WriterType;
 
-    /** A pair indicating which functor should be used for an operator,
-     * and whether the arguments should be swapped.
-     */
-    typedef std::pair< BinaryFunctorEnum, bool >        BinaryOperatorType;
-    typedef std::map<std::string, BinaryOperatorType>   BinaryOperatorMapType;
-
     /** Declarations. */
     typename ReaderType::Pointer reader1 = ReaderType::New();
     typename ReaderType::Pointer reader2 = ReaderType::New();
     typename WriterType::Pointer writer = WriterType::New();
 
-    /** Available SimpleOperatorTypes are defined in itkLogicalFunctors.h:
-     * AND, OR, XOR, NOT_AND, NOT_OR, NOT_XOR, ANDNOT, ORNOT
-     *
-     * The Simplification map (simpmap) defines for every possible logical
-     * operation of the form
-     *   [not]( ([not] A) [{&,|,^} ([not] B])] )
-     * a simplified version.
-     *
-     * example1: A ^ (!B) = XORNOT(A,B) = NOT_XOR(A,B) = ! (A ^ B)
-     * example2: (!A) & B = NOTAND(A,B) = ANDNOT(B,A) = B & (!A)
-     */
-
     BinaryOperatorMapType binaryOperatorMap;
-    binaryOperatorMap["AND"]        = BinaryOperatorType(AND, false);
-    binaryOperatorMap["OR"]         = BinaryOperatorType(OR, false);
-    binaryOperatorMap["XOR"]        = BinaryOperatorType(XOR, false);
-    binaryOperatorMap["ANDNOT"]     = BinaryOperatorType(ANDNOT, false);
-    binaryOperatorMap["ORNOT"]      = BinaryOperatorType(ORNOT, false);
-    binaryOperatorMap["XORNOT"]     = BinaryOperatorType(NOT_XOR, false);
-
-    binaryOperatorMap["NOTAND"]     = BinaryOperatorType(ANDNOT, true);
-    binaryOperatorMap["NOTOR"]      = BinaryOperatorType(ORNOT, true);
-    binaryOperatorMap["NOTXOR"]     = BinaryOperatorType(NOT_XOR, false);
-
-    binaryOperatorMap["NOTANDNOT"]  = BinaryOperatorType(NOT_OR, false);
-    binaryOperatorMap["NOTORNOT"]   = BinaryOperatorType(NOT_AND, false);
-    binaryOperatorMap["NOTXORNOT"]  = BinaryOperatorType(XOR, false);
-
-    binaryOperatorMap["NOT_AND"]    = BinaryOperatorType(NOT_AND, false);
-    binaryOperatorMap["NOT_OR"]     = BinaryOperatorType(NOT_OR, false);
-    binaryOperatorMap["NOT_XOR"]    = BinaryOperatorType(NOT_XOR, false);
-    binaryOperatorMap["NOT_NOT"]    = BinaryOperatorType(DUMMY, false);
-
-    binaryOperatorMap["NOT_ANDNOT"] = BinaryOperatorType(ORNOT, true);
-    binaryOperatorMap["NOT_ORNOT"]  = BinaryOperatorType(ANDNOT, true);
-    binaryOperatorMap["NOT_XORNOT"] = BinaryOperatorType(XOR, false);
-
-    binaryOperatorMap["NOT_NOTAND"] = BinaryOperatorType(ORNOT, false);
-    binaryOperatorMap["NOT_NOTOR"]  = BinaryOperatorType(ANDNOT, false);
-    binaryOperatorMap["NOT_NOTXOR"] = BinaryOperatorType(XOR, false);
-
-    binaryOperatorMap["NOT_NOTANDNOT"] = BinaryOperatorType(OR, false);
-    binaryOperatorMap["NOT_NOTORNOT"]  = BinaryOperatorType(AND, false);
-    binaryOperatorMap["NOT_NOTXORNOT"] = BinaryOperatorType(NOT_XOR, false);
+    this->GetBinaryOperatorMap( binaryOperatorMap );
 
     /** Read the images. */
     reader1->SetFileName( this->m_InputFileName1.c_str() );
@@ -0,0 +1,130 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkNaryFoldImageFilter_h_
+#define __itkNaryFoldImageFilter_h_
+
+#include "itkInPlaceImageFilter.h"
+
+
+namespace itk
+{
+
+/** \class NaryFoldImageFilter
+ * \brief Folds one image into an accumulator image.
+ *
+ * The first input is the accumulator, the second input the image that is
+ * folded into it: acc = op( acc, input ), pixel by pixel, computed in the
+ * pixel type of the accumulator. The filter runs in place by default, so
+ * that folding N images one after the other only needs the memory of the
+ * accumulator and of the image that is folded in.
+ *
+ * The operations are the associative operators of pxnaryimageoperator.
+ * Started from GetIdentity() and folded in the order of the inputs, the
+ * accumulator equals the (unrounded) result of the corresponding functor
+ * in itkNaryFunctors.h. MEAN is an Addition divided by the number of
+ * inputs afterwards.
+ *
+ * Each thread processes its region line by line on the raw buffers, with
+ * the operation selected once per region.
+ *
+ * \ingroup IntensityImageFilters Multithreaded
+ */
+template <class TAccumulatorImage, class TInputImage>
+class NaryFoldImageFilter:
+    public InPlaceImageFilter<TAccumulatorImage,TAccumulatorImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef NaryFoldImageFilter                                       Self;
+  typedef InPlaceImageFilter<TAccumulatorImage,TAccumulatorImage>   Superclass;
+  typedef SmartPointer<Self>                                        Pointer;
+  typedef SmartPointer<const Self>                                  ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( NaryFoldImageFilter, InPlaceImageFilter );
+
+  /** Typedef to describe the input/output image types. */
+  typedef TAccumulatorImage                             AccumulatorImageType;
+  typedef typename AccumulatorImageType::PixelType      AccumulatorPixelType;
+  typedef TInputImage                                   InputImageType;
+  typedef typename InputImageType::PixelType            InputPixelType;
+  typedef typename AccumulatorImageType::RegionType     OutputImageRegionType;
+
+  /** The supported operations. */
+  typedef enum {
+    Addition, Times, Maximum, Minimum
+  } OperationType;
+
+  /** Set/Get the operation. Default Addition. */
+  itkSetMacro( Operation, OperationType );
+  itkGetConstMacro( Operation, OperationType );
+
+  /** The value to initialise the accumulator with, before the first image
+   * is folded in: 0, 1, and the lowest and highest value (-infinity and
+   * +infinity for floating point types), respectively.
+   */
+  static AccumulatorPixelType GetIdentity( const OperationType & operation );
+
+  /** Set the accumulator and the image to fold into it. */
+  void SetAccumulator( const AccumulatorImageType * accumulator )
+  {
+    this->SetNthInput( 0, const_cast<AccumulatorImageType *>( accumulator ) );
+  }
+  void SetFoldInput( const InputImageType * input )
+  {
+    this->SetNthInput( 1, const_cast<InputImageType *>( input ) );
+  }
+
+protected:
+  NaryFoldImageFilter();
+  ~NaryFoldImageFilter() {};
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** Check that the image to fold in covers the accumulator. */
+  virtual void BeforeThreadedGenerateData( void );
+
+  /** Dispatch on the operation. */
+  virtual void ThreadedGenerateData(
+    const OutputImageRegionType & outputRegionForThread,
+    ThreadIdType threadId );
+
+  /** Fold all lines of the region. */
+  template <class TKernel>
+  void ThreadedGenerateDataForKernel(
+    const OutputImageRegionType & outputRegionForThread,
+    ThreadIdType threadId );
+
+private:
+  NaryFoldImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  OperationType m_Operation;
+
+}; // end class NaryFoldImageFilter
+
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkNaryFoldImageFilter.hxx"
+#endif
+
+#endif // end #ifndef __itkNaryFoldImageFilter_h_
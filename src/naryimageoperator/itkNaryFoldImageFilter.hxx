@@ -0,0 +1,212 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef _itkNaryFoldImageFilter_hxx_
+#define _itkNaryFoldImageFilter_hxx_
+
+#include "itkNaryFoldImageFilter.h"
+
+#include "itkImageLinearIteratorWithIndex.h"
+#include "itkNumericTraits.h"
+#include "itkProgressReporter.h"
+
+#include <limits>
+
+
+namespace itk
+{
+namespace Functor
+{
+
+/** The kernels of the NaryFoldImageFilter. Apply() is one step of the loop
+ * of the corresponding functor in itkNaryFunctors.h.
+ */
+
+template <class T>
+struct NaryFoldADDITION
+{
+  static inline T Apply( const T & acc, const T & b ) { return acc + b; }
+};
+
+template <class T>
+struct NaryFoldTIMES
+{
+  static inline T Apply( const T & acc, const T & b ) { return acc * b; }
+};
+
+template <class T>
+struct NaryFoldMAXIMUM
+{
+  static inline T Apply( const T & acc, const T & b )
+  { return acc > b ? acc : b; } // as vnl_math_max
+};
+
+template <class T>
+struct NaryFoldMINIMUM
+{
+  static inline T Apply( const T & acc, const T & b )
+  { return acc < b ? acc : b; } // as vnl_math_min
+};
+
+} // end namespace Functor
+
+
+template<class TAccumulatorImage, class TInputImage>
+NaryFoldImageFilter<TAccumulatorImage,TInputImage>
+::NaryFoldImageFilter()
+{
+  this->SetNumberOfRequiredInputs( 2 );
+  this->InPlaceOn();
+  this->m_Operation = Addition;
+}
+
+
+template<class TAccumulatorImage, class TInputImage>
+typename NaryFoldImageFilter<TAccumulatorImage,TInputImage>::AccumulatorPixelType
+NaryFoldImageFilter<TAccumulatorImage,TInputImage>
+::GetIdentity( const OperationType & operation )
+{
+  switch( operation )
+  {
+    case Times:
+      return NumericTraits<AccumulatorPixelType>::One;
+    case Maximum:
+      return std::numeric_limits<AccumulatorPixelType>::has_infinity
+        ? -std::numeric_limits<AccumulatorPixelType>::infinity()
+        : NumericTraits<AccumulatorPixelType>::NonpositiveMin();
+    case Minimum:
+      return std::numeric_limits<AccumulatorPixelType>::has_infinity
+        ? std::numeric_limits<AccumulatorPixelType>::infinity()
+        : NumericTraits<AccumulatorPixelType>::max();
+    default:
+      return NumericTraits<AccumulatorPixelType>::Zero;
+  }
+
+} // end GetIdentity()
+
+
+template<class TAccumulatorImage, class TInputImage>
+void
+NaryFoldImageFilter<TAccumulatorImage,TInputImage>
+::BeforeThreadedGenerateData( void )
+{
+  const AccumulatorImageType * accumulator = this->GetInput( 0 );
+  const InputImageType * input
+    = dynamic_cast<const InputImageType *>( this->ProcessObject::GetInput( 1 ) );
+
+  if( !input || !input->GetBufferedRegion().IsInside( accumulator->GetBufferedRegion() ) )
+  {
+    itkExceptionMacro( << "The image to fold in does not cover the accumulator region "
+      << accumulator->GetBufferedRegion() );
+  }
+
+} // end BeforeThreadedGenerateData()
+
+
+template<class TAccumulatorImage, class TInputImage>
+void
+NaryFoldImageFilter<TAccumulatorImage,TInputImage>
+::ThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread,
+  ThreadIdType threadId )
+{
+  switch( this->m_Operation )
+  {
+    case Addition:
+      this->template ThreadedGenerateDataForKernel< Functor::NaryFoldADDITION<AccumulatorPixelType> >(
+        outputRegionForThread, threadId );
+      break;
+    case Times:
+      this->template ThreadedGenerateDataForKernel< Functor::NaryFoldTIMES<AccumulatorPixelType> >(
+        outputRegionForThread, threadId );
+      break;
+    case Maximum:
+      this->template ThreadedGenerateDataForKernel< Functor::NaryFoldMAXIMUM<AccumulatorPixelType> >(
+        outputRegionForThread, threadId );
+      break;
+    case Minimum:
+      this->template ThreadedGenerateDataForKernel< Functor::NaryFoldMINIMUM<AccumulatorPixelType> >(
+        outputRegionForThread, threadId );
+      break;
+  }
+
+} // end ThreadedGenerateData()
+
+
+template<class TAccumulatorImage, class TInputImage>
+template<class TKernel>
+void
+NaryFoldImageFilter<TAccumulatorImage,TInputImage>
+::ThreadedGenerateDataForKernel(
+  const OutputImageRegionType & outputRegionForThread,
+  ThreadIdType threadId )
+{
+  typedef typename AccumulatorImageType::IndexType              IndexType;
+  typedef ImageLinearIteratorWithIndex<AccumulatorImageType>    IteratorType;
+
+  const AccumulatorImageType * accumulator = this->GetInput( 0 );
+  const InputImageType * input
+    = static_cast<const InputImageType *>( this->ProcessObject::GetInput( 1 ) );
+  AccumulatorImageType * output = this->GetOutput();
+
+  const std::size_t lineLength = outputRegionForThread.GetSize( 0 );
+  if( lineLength == 0 ) return;
+
+  ProgressReporter progress( this, threadId,
+    outputRegionForThread.GetNumberOfPixels() / lineLength );
+
+  /** Pixels along dimension 0 are contiguous in all buffers. When running
+   * in place, acc and out are the same buffer.
+   */
+  IteratorType it( output, outputRegionForThread );
+  it.SetDirection( 0 );
+  it.GoToBegin();
+  while( !it.IsAtEnd() )
+  {
+    const IndexType index = it.GetIndex();
+    const AccumulatorPixelType * acc
+      = accumulator->GetBufferPointer() + accumulator->ComputeOffset( index );
+    const InputPixelType * in = input->GetBufferPointer() + input->ComputeOffset( index );
+    AccumulatorPixelType * out = output->GetBufferPointer() + output->ComputeOffset( index );
+
+    for( std::size_t j = 0; j < lineLength; ++j )
+    {
+      out[ j ] = TKernel::Apply( acc[ j ], static_cast<AccumulatorPixelType>( in[ j ] ) );
+    }
+
+    it.NextLine();
+    progress.CompletedPixel();
+  } // end while lines
+
+} // end ThreadedGenerateDataForKernel()
+
+
+template<class TAccumulatorImage, class TInputImage>
+void
+NaryFoldImageFilter<TAccumulatorImage,TInputImage>
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "Operation: " << this->m_Operation << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef _itkNaryFoldImageFilter_hxx_
@@ -219,6 +219,30 @@ public:
   }
 };
 
+
+/** Converts the accumulator of the fold mode to the output: the accumulated
+ * value divided by the denominator (the number of inputs for MEAN, 1 else).
+ */
+template< class TInput, class TOutput = TInput >
+class NaryFoldFinalize
+{
+public:
+  NaryFoldFinalize() { this->m_Denominator = NumericTraits< TInput >::One; };
+  ~NaryFoldFinalize() {};
+  bool operator!=( const NaryFoldFinalize & other ) const
+  {
+    return this->m_Denominator != other.m_Denominator;
+  }
+  bool operator==( const NaryFoldFinalize & other ) const{ return !(*this != other); }
+  void SetDenominator( const TInput & denominator ){ this->m_Denominator = denominator; }
+  inline TOutput operator()( const TInput & A ) const
+  {
+    return static_cast< TOutput >( A / this->m_Denominator );
+  }
+private:
+  TInput m_Denominator;
+};
+
 } // end namespace Functor
 
 
@@ -60,6 +60,10 @@ std::string GetHelpString( void )
 //             << "             MASK[NEG]: background value, e.g. 0.\n";
     << "  [-z]     compression flag; if provided, the output image is compressed\n"
     << "  [-s]     number of streams, default equals number of inputs.\n"
+    << "             Only used for MINUS, DIVIDE, ABSOLUTEDIFFERENCE and NARYMAGNITUDE;\n"
+    << "             ADDITION, MEAN, TIMES, MAXIMUM and MINIMUM fold the inputs\n"
+    << "             into the result one at a time, reading the next input while\n"
+    << "             folding, so that at most three images are in memory.\n"
     << "  [-opct]  output component type, by default the largest of the two input images\n"
     << "             choose one of: {[unsigned_]{char,short,int,long},float,double}\n"
     << "Supported: 2D, 3D, (unsigned) char, (unsigned) short, (unsigned) int, (unsigned) long, float, double.";
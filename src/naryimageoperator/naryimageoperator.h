@@ -21,6 +21,9 @@
 #include "itkImage.h"
 #include "itkNaryFunctors.h"
 #include "itkNaryFunctorImageFilter.h"
+#include "itkNaryFoldImageFilter.h"
+#include "itkUnaryFunctorImageFilter.h"
+#include "itkMultiThreader.h"
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
 
@@ -88,14 +91,7 @@ public:
     typedef itk::ImageFileReader< InputImageType >          ReaderType;
     typedef itk::ImageFileWriter< OutputImageType >         WriterType;
 
-    /** Read the input images. */
-    std::vector<typename ReaderType::Pointer> readers( this->m_InputFileNames.size() );
-    for ( unsigned int i = 0; i < this->m_InputFileNames.size(); ++i )
-    {
-      readers[ i ] = ReaderType::New();
-      readers[ i ]->SetFileName( this->m_InputFileNames[ i ] );
-    }
-
+    /** The associative operators are folded one input at a time. */
     std::map <std::string, NaryFilterEnum> naryOperatorMap;
 
     naryOperatorMap["ADDITION"] = ADDITION;
@@ -108,11 +104,34 @@ public:
     naryOperatorMap["ABSOLUTEDIFFERENCE"] = ABSOLUTEDIFFERENCE;
     naryOperatorMap["NARYMAGNITUDE"] = NARYMAGNITUDE;
 
+    /** They accumulate in the same type as the n-ary functors. */
+    typedef typename itk::NumericTraits< TInputComponentType >::ScalarRealType ScalarRealType;
+    typedef typename itk::NumericTraits< TInputComponentType >::AccumulateType AccumulateType;
+    const NaryFilterEnum naryOperator = naryOperatorMap[ this->m_NaryOperatorName ];
+    if( naryOperator == ADDITION || naryOperator == MEAN || naryOperator == TIMES )
+    {
+      this->template RunFold< ScalarRealType >( naryOperator );
+      return;
+    }
+    else if( naryOperator == MAXIMUM || naryOperator == MINIMUM )
+    {
+      this->template RunFold< AccumulateType >( naryOperator );
+      return;
+    }
+
+    /** Read the input images. */
+    std::vector<typename ReaderType::Pointer> readers( this->m_InputFileNames.size() );
+    for ( unsigned int i = 0; i < this->m_InputFileNames.size(); ++i )
+    {
+      readers[ i ] = ReaderType::New();
+      readers[ i ]->SetFileName( this->m_InputFileNames[ i ] );
+    }
+
     /** Set up the binaryFilter. */
     NaryFilterFactory< InputImageType, OutputImageType > naryFilterFactory;
     typedef itk::InPlaceImageFilter< InputImageType, OutputImageType > BaseFilterType;
     typename BaseFilterType::Pointer naryFilter
-      = naryFilterFactory.GetFilter( naryOperatorMap[ this->m_NaryOperatorName ] );
+      = naryFilterFactory.GetFilter( naryOperator );
 
     //InstantiateNaryFilterNoArg( POWER );
     //InstantiateNaryFilterNoArg( SQUAREDDIFFERENCE );
@@ -129,7 +148,7 @@ public:
       naryFilter->SetInput( i, readers[ i ]->GetOutput() );
     }
 
-    /** Write the image to disk */
+    /** Write the image to disk, streaming slabs through all inputs. */
     typename WriterType::Pointer writer = WriterType::New();
     writer->SetFileName( this->m_OutputFileName.c_str() );
     writer->SetInput( naryFilter->GetOutput() );
@@ -139,6 +158,141 @@ public:
 
   } // end Run()
 
+
+  /** Fold the inputs one by one into an accumulator image, in the order in
+   * which they are given, which gives the same result as the n-ary functor.
+   * While an input is folded in, the next one is read in the background, so
+   * at most the accumulator and two input images are in memory, whatever
+   * the number of inputs.
+   */
+  template< class TAccumulatorComponentType >
+  void RunFold( const NaryFilterEnum & naryOperator )
+  {
+    /** Typedefs. */
+    typedef itk::Image< TInputComponentType, VDimension >   InputImageType;
+    typedef itk::Image< TOutputComponentType, VDimension >  OutputImageType;
+    typedef TAccumulatorComponentType                       AccumulatorComponentType;
+    typedef itk::Image< AccumulatorComponentType, VDimension > AccumulatorImageType;
+    typedef itk::ImageFileReader< InputImageType >          ReaderType;
+    typedef itk::ImageFileWriter< OutputImageType >         WriterType;
+    typedef itk::NaryFoldImageFilter<
+      AccumulatorImageType, InputImageType >                FoldFilterType;
+    typedef itk::Functor::NaryFoldFinalize<
+      AccumulatorComponentType, TOutputComponentType >      FinalizeFunctorType;
+    typedef itk::UnaryFunctorImageFilter<
+      AccumulatorImageType, OutputImageType, FinalizeFunctorType > FinalizeFilterType;
+
+    typename FoldFilterType::OperationType operation = FoldFilterType::Addition;
+    if( naryOperator == TIMES ) operation = FoldFilterType::Times;
+    else if( naryOperator == MAXIMUM ) operation = FoldFilterType::Maximum;
+    else if( naryOperator == MINIMUM ) operation = FoldFilterType::Minimum;
+
+    const unsigned int numberOfInputs = this->m_InputFileNames.size();
+
+    /** Read the first input. */
+    ReadJob< ReaderType > job;
+    job.Reader = ReaderType::New();
+    job.Reader->SetFileName( this->m_InputFileNames[ 0 ] );
+    job.Reader->Update();
+    typename InputImageType::Pointer input = job.Reader->GetOutput();
+
+    /** Create the accumulator. */
+    typename AccumulatorImageType::Pointer accumulator = AccumulatorImageType::New();
+    accumulator->CopyInformation( input );
+    accumulator->SetRegions( input->GetLargestPossibleRegion() );
+    accumulator->Allocate();
+    accumulator->FillBuffer( FoldFilterType::GetIdentity( operation ) );
+
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    for( unsigned int i = 0; i < numberOfInputs; ++i )
+    {
+      /** Start reading the next input. */
+      const bool readNext = i + 1 < numberOfInputs;
+      itk::ThreadIdType readThreadId = 0;
+      if( readNext )
+      {
+        job.Reader = ReaderType::New();
+        job.Reader->SetFileName( this->m_InputFileNames[ i + 1 ] );
+        job.Failed = false;
+        readThreadId = threader->SpawnThread( ReadThreaderCallback< ReaderType >, &job );
+      }
+
+      /** Fold the current input into the accumulator, multi-threaded. */
+      typename FoldFilterType::Pointer foldFilter = FoldFilterType::New();
+      foldFilter->SetOperation( operation );
+      foldFilter->SetAccumulator( accumulator );
+      foldFilter->SetFoldInput( input );
+      try
+      {
+        foldFilter->Update();
+      }
+      catch( itk::ExceptionObject & )
+      {
+        if( readNext ) threader->TerminateThread( readThreadId );
+        throw;
+      }
+      accumulator = foldFilter->GetOutput();
+      accumulator->DisconnectPipeline();
+
+      /** Wait for the next input. */
+      if( readNext )
+      {
+        threader->TerminateThread( readThreadId );
+        if( job.Failed ) throw job.Exception;
+        input = job.Reader->GetOutput();
+      }
+    } // end for inputs
+
+    /** Convert the accumulator to the output. */
+    typename FinalizeFilterType::Pointer finalizeFilter = FinalizeFilterType::New();
+    finalizeFilter->SetInput( accumulator );
+    if( naryOperator == MEAN )
+    {
+      finalizeFilter->GetFunctor().SetDenominator( numberOfInputs );
+    }
+
+    /** Write the image to disk. */
+    typename WriterType::Pointer writer = WriterType::New();
+    writer->SetFileName( this->m_OutputFileName.c_str() );
+    writer->SetInput( finalizeFilter->GetOutput() );
+    writer->SetUseCompression( this->m_UseCompression );
+    writer->Update();
+
+  } // end RunFold()
+
+protected:
+
+  /** A reader that runs in the background, and its exception, if any. */
+  template< class TReader >
+  struct ReadJob
+  {
+    ReadJob() : Failed( false ) {};
+    typename TReader::Pointer Reader;
+    bool                      Failed;
+    itk::ExceptionObject      Exception;
+  };
+
+  /** Update the reader of a ReadJob; the thread function of RunFold(). */
+  template< class TReader >
+  static ITK_THREAD_RETURN_TYPE ReadThreaderCallback( void *arg )
+  {
+    typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+    ThreadInfoType * info = static_cast<ThreadInfoType *>( arg );
+    ReadJob< TReader > * job = static_cast<ReadJob< TReader > *>( info->UserData );
+
+    try
+    {
+      job->Reader->Update();
+    }
+    catch( itk::ExceptionObject & excp )
+    {
+      job->Exception = excp;
+      job->Failed = true;
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
 }; // end class ITKToolsNaryImageOperator
 
 
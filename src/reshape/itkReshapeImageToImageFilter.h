@@ -27,6 +27,13 @@ namespace itk
 /** \class ReshapeImageToImageFilter
  * \brief ReshapeImageToImageFilter
  *
+ * Gives the pixels of the input, in buffer order, a new size. Output pixels
+ * beyond the input are zero.
+ *
+ * A reshape to the same number of pixels does not change the pixel data,
+ * so the output then takes over the pixel container of the input, which
+ * costs no time or memory. Like an InPlaceImageFilter, this releases the
+ * input; with InPlace off the output gets a copy instead.
  *
  * \ingroup ??
  */
@@ -65,6 +72,11 @@ public:
   /***/
   itkSetMacro( OutputSize, SizeType );
 
+  /** Set/Get whether to take over the input buffer if possible. Default true. */
+  itkSetMacro( InPlace, bool );
+  itkGetConstMacro( InPlace, bool );
+  itkBooleanMacro( InPlace );
+
   /** FlipImageFilter produces an image with different origin and
    * direction than the input image. As such, FlipImageFilter needs to
    * provide an implementation for GenerateOutputInformation() in
@@ -97,7 +109,7 @@ protected:
    * must override the EnlargeOutputRequestedRegion method to enlarge the
    * output request region.
    */
-  //virtual void EnlargeOutputRequestedRegion( DataObject * );
+  virtual void EnlargeOutputRequestedRegion( DataObject * );
 
   /** Performs the image reshaping process. */
   virtual void GenerateData( void );
@@ -111,6 +123,7 @@ private:
 
   /** Private variables. */
   SizeType  m_OutputSize;
+  bool      m_InPlace;
 
 }; // end class ReshapeImageToImageFilter
 
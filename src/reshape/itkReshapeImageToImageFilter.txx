@@ -20,6 +20,9 @@
 
 #include "itkReshapeImageToImageFilter.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace itk
 {
 
@@ -33,6 +36,7 @@ ReshapeImageToImageFilter< TInputImage >
 {
   this->m_OutputSize.Fill( NumericTraits<
     typename SizeType::SizeValueType>::Zero );
+  this->m_InPlace = true;
 
 } // end Constructor()
 
@@ -92,9 +96,31 @@ void
 ReshapeImageToImageFilter< TInputImage>
 ::GenerateInputRequestedRegion( void )
 {
+  /** The pixels are taken in buffer order, so the whole input is needed. */
+  ImagePointer inputPtr = const_cast< TInputImage * >( this->GetInput() );
+  if( inputPtr )
+  {
+    inputPtr->SetRequestedRegionToLargestPossibleRegion();
+  }
+
 } // end GenerateInputRequestedRegion()
 
 
+/**
+ * ********************* EnlargeOutputRequestedRegion ****************************
+ */
+
+template< class TInputImage>
+void
+ReshapeImageToImageFilter< TInputImage>
+::EnlargeOutputRequestedRegion( DataObject * output )
+{
+  Superclass::EnlargeOutputRequestedRegion( output );
+  output->SetRequestedRegionToLargestPossibleRegion();
+
+} // end EnlargeOutputRequestedRegion()
+
+
 /**
  * ********************* GenerateData ****************************
  */
@@ -105,25 +131,36 @@ ReshapeImageToImageFilter< TInputImage >
 ::GenerateData( void )
 {
   /** Get handles to the input and output. */
-  ImageConstPointer input = this->GetInput();
+  ImagePointer input = const_cast< TInputImage * >( this->GetInput() );
   ImagePointer output = this->GetOutput();
 
-  /** Allocate memory. */
-  output->Allocate();
-  output->FillBuffer( NumericTraits<ImagePixelType>::Zero );
-
   /** Get the number of pixels. */
-  unsigned long numVoxelsInput = input->GetLargestPossibleRegion().GetNumberOfPixels();
-  unsigned long numVoxelsOutput = 1;
-  for( unsigned int i = 0; i < ImageDimension; i++ )
+  const SizeValueType numVoxelsInput = input->GetLargestPossibleRegion().GetNumberOfPixels();
+  const SizeValueType numVoxelsOutput = output->GetLargestPossibleRegion().GetNumberOfPixels();
+
+  /** Take over the pixel container. The input is initialized to an empty
+   * container, so the output is its only owner.
+   */
+  if( this->m_InPlace && numVoxelsInput == numVoxelsOutput )
   {
-    numVoxelsOutput *= this->m_OutputSize[ i ];
+    typename ImageType::PixelContainerPointer container = input->GetPixelContainer();
+    input->ReleaseData();
+    output->SetBufferedRegion( output->GetLargestPossibleRegion() );
+    output->SetPixelContainer( container );
+    return;
   }
-  unsigned long minVoxels = numVoxelsInput < numVoxelsOutput ? numVoxelsInput : numVoxelsOutput;
 
-  /** Copy pixels. */
+  /** Allocate memory. */
+  output->SetBufferedRegion( output->GetLargestPossibleRegion() );
+  output->Allocate();
+
+  /** Copy pixels, and zero the rest. */
+  const SizeValueType minVoxels = numVoxelsInput < numVoxelsOutput ? numVoxelsInput : numVoxelsOutput;
   memcpy( output->GetBufferPointer(), input->GetBufferPointer(),
     sizeof( ImagePixelType ) * minVoxels );
+  std::fill( output->GetBufferPointer() + minVoxels,
+    output->GetBufferPointer() + numVoxelsOutput,
+    NumericTraits<ImagePixelType>::Zero );
 
 } // end GenerateData()
 
@@ -142,6 +179,7 @@ ReshapeImageToImageFilter< TInputImage >
 
   /** Print the member variables. */
   os << indent << "OutputSize: " << this->m_OutputSize << std::endl;
+  os << indent << "InPlace: " << this->m_InPlace << std::endl;
 
 } // end PrintSelf()
 
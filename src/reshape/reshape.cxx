@@ -27,7 +27,9 @@
 #include "itkCommandLineArgumentParser.h"
 #include "ITKToolsHelpers.h"
 #include "reshape.h"
+#include "ITKToolsMetaImageHeader.h"
 #include <itksys/SystemTools.hxx>
+#include <sstream>
 
 
 /**
@@ -43,12 +45,134 @@ std::string GetHelpString( void )
     << "  -in      inputFilename\n"
     << "  [-out]   outputFileName, default inputFileName_reshaped\n"
     << "  -s       size of the output image\n"
+    << "  [-ho]    header only: if input and output are .mhd files, and the\n"
+    << "           number of pixels does not change, only write a header that\n"
+    << "           refers to the data file of the input. The dimension may\n"
+    << "           then change. Otherwise the image is read and written.\n"
     << "Supported: 2D, 3D, (unsigned) char, (unsigned) short, (unsigned) int, (unsigned) long, float, double.";
 
   return ss.str();
 
 } // end GetHelpString()
 
+
+/**
+ * ******************* ReshapeMetaImageHeader *******************
+ *
+ * Reshape a MetaImage by writing a header with the new size that refers
+ * to the data file of the input, which is not touched. The dimension may
+ * change; the geometry fields are then cut off or extended with unit values.
+ * Returns false if the files are not MetaImages with a single detached data
+ * file, or if the number of pixels changes.
+ */
+
+bool ReshapeMetaImageHeader(
+  const std::string & inputFileName,
+  const std::string & outputFileName,
+  const std::vector<unsigned long> & outputSize )
+{
+  if( !itktools::IsMetaImageHeaderFileName( inputFileName )
+    || !itktools::IsMetaImageHeaderFileName( outputFileName ) )
+  {
+    return false;
+  }
+
+  itktools::MetaImageHeaderType header;
+  if( !itktools::ReadMetaImageHeader( inputFileName, header ) ) return false;
+  const std::string dataFileName
+    = itktools::GetMetaImageDataFileName( inputFileName, header );
+  std::string dimSize;
+  if( dataFileName.empty()
+    || !itktools::GetMetaImageHeaderField( header, "DimSize", dimSize ) )
+  {
+    return false;
+  }
+
+  /** Compare the number of pixels. */
+  std::istringstream inputSizeStream( dimSize );
+  std::vector<unsigned long> inputSize;
+  unsigned long size = 0;
+  unsigned long numberOfInputPixels = 1;
+  while( inputSizeStream >> size )
+  {
+    inputSize.push_back( size );
+    numberOfInputPixels *= size;
+  }
+  unsigned long numberOfOutputPixels = 1;
+  for( unsigned int i = 0; i < outputSize.size(); ++i )
+  {
+    numberOfOutputPixels *= outputSize[ i ];
+  }
+  if( numberOfInputPixels != numberOfOutputPixels ) return false;
+
+  /** Adapt the fields that have a value per dimension. */
+  const unsigned int inputDimension = inputSize.size();
+  const unsigned int outputDimension = outputSize.size();
+  for( std::size_t f = 0; f < header.size(); ++f )
+  {
+    const std::string & key = header[ f ].first;
+    std::string defaultValue = "";
+    bool isMatrix = false;
+    if( key == "DimSize" || key == "NDims" ) continue;
+    else if( key == "ElementSpacing" || key == "ElementSize" ) defaultValue = "1";
+    else if( key == "Offset" || key == "Position" || key == "Origin"
+      || key == "CenterOfRotation" ) defaultValue = "0";
+    else if( key == "TransformMatrix" || key == "Rotation"
+      || key == "Orientation" ) isMatrix = true;
+    else continue;
+
+    std::istringstream valueStream( header[ f ].second );
+    std::vector<std::string> values;
+    std::string value;
+    while( valueStream >> value ) values.push_back( value );
+
+    std::ostringstream newValue;
+    for( unsigned int i = 0; i < outputDimension; ++i )
+    {
+      for( unsigned int j = 0; j < ( isMatrix ? outputDimension : 1 ); ++j )
+      {
+        const std::size_t k = isMatrix ? i * inputDimension + j : i;
+        const bool exists = ( isMatrix ? i < inputDimension && j < inputDimension
+          : i < inputDimension ) && k < values.size();
+        newValue << ( i + j == 0 ? "" : " " )
+          << ( exists ? values[ k ] : ( isMatrix ? ( i == j ? "1" : "0" ) : defaultValue ) );
+      }
+    }
+    header[ f ].second = newValue.str();
+  }
+  if( inputDimension != outputDimension )
+  {
+    for( std::size_t f = 0; f < header.size(); ++f )
+    {
+      if( header[ f ].first == "AnatomicalOrientation" )
+      {
+        header.erase( header.begin() + f );
+        break;
+      }
+    }
+  }
+
+  /** Refer to the data file relative to the new header, if possible. */
+  const std::string outputDirectory = itksys::SystemTools::GetFilenamePath(
+    itksys::SystemTools::CollapseFullPath( outputFileName ) );
+  std::string relativeDataFileName = itksys::SystemTools::RelativePath(
+    outputDirectory.c_str(), dataFileName.c_str() );
+  if( relativeDataFileName.empty() ) relativeDataFileName = dataFileName;
+
+  std::ostringstream newDimSize;
+  for( unsigned int i = 0; i < outputDimension; ++i )
+  {
+    newDimSize << ( i == 0 ? "" : " " ) << outputSize[ i ];
+  }
+  std::ostringstream newNDims;
+  newNDims << outputDimension;
+  itktools::SetMetaImageHeaderField( header, "NDims", newNDims.str() );
+  itktools::SetMetaImageHeaderField( header, "DimSize", newDimSize.str() );
+  itktools::SetMetaImageHeaderField( header, "ElementDataFile", relativeDataFileName );
+  return itktools::WriteMetaImageHeader( outputFileName, header );
+
+} // end ReshapeMetaImageHeader()
+
 //-------------------------------------------------------------------------------------
 
 int main( int argc, char **argv )
@@ -88,6 +212,14 @@ int main( int argc, char **argv )
   std::vector<unsigned long> outputSize;
   parser->GetCommandLineArgument( "-s", outputSize );
 
+  /** Reshape by a header only, if asked and possible. */
+  const bool headerOnly = parser->ArgumentExists( "-ho" );
+  if( headerOnly
+    && ReshapeMetaImageHeader( inputFileName, outputFileName, outputSize ) )
+  {
+    return EXIT_SUCCESS;
+  }
+
   /** Determine image properties. */
   itk::ImageIOBase::IOPixelType pixelType = itk::ImageIOBase::UNKNOWNPIXELTYPE;
   itk::ImageIOBase::IOComponentType componentType = itk::ImageIOBase::UNKNOWNCOMPONENTTYPE;
@@ -0,0 +1,214 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkSeparableResampleImageFilter_h_
+#define __itkSeparableResampleImageFilter_h_
+
+#include "itkImageToImageFilter.h"
+#include "itkMultiThreader.h"
+
+#include <vector>
+
+
+namespace itk
+{
+
+/** \class SeparableResampleImageFilter
+ * \brief Resizes an image by resampling it one axis at a time.
+ *
+ * The output has the origin, direction and start index of the input and the
+ * given size and spacing, so output index i along axis d lies at continuous
+ * input index i * OutputSpacing[d] / InputSpacing[d]. This is the resize that
+ * the itk::ResampleImageFilter computes for this geometry, but because the
+ * mapping is a scaling per axis, the interpolation weights factorise: for
+ * every axis a table with the input indices and weights of each output index
+ * is computed once, and the image is resampled with it axis by axis. A cubic
+ * resize of a 3D image takes 4 + 4 + 4 taps per voxel instead of 4^3.
+ *
+ * The InterpolationOrder selects the same interpolation as the resize tool
+ * did with the itk::ResampleImageFilter:
+ * - 0: nearest neighbour;
+ * - 1: linear, with the border values repeated outside the image;
+ * - 2 to 5: B-spline, with mirrored coefficients outside the image. The
+ *   B-spline prefilter is separable as well, so the coefficients along an
+ *   axis are computed just before that axis is resampled, with the recursive
+ *   filter of the itk::BSplineDecompositionImageFilter.
+ * Output points outside the input get the DefaultPixelValue.
+ *
+ * With AntiAlias on, an axis that is downsampled by an integer factor k is
+ * averaged over a box of k input pixels around each output point instead,
+ * which removes the aliasing of point sampling. Such an axis is averaged
+ * over the pixel values, it gets no B-spline prefilter.
+ *
+ * Only the output requested region is computed, from the part of the input
+ * that its taps touch, so the filter streams. Along a B-spline axis the
+ * prefilter needs whole lines, so there the whole input extent is requested.
+ * The output is computed in slabs along the last axis: the last axis is
+ * resampled first, from the input rows of the slab, and then the lower axes
+ * one by one. Every pass writes a RealType buffer of the slab only, so next
+ * to the input and output two slab buffers are held; only for a B-spline
+ * last axis the requested input is first converted to RealType coefficients
+ * along that axis, as the itk::ResampleImageFilter does for all axes.
+ *
+ * In the buffers the rows of the processed axis are contiguous blocks of
+ * all lower axes, so that a tap is a multiply-add over a contiguous block.
+ * The passes are split over the threads of the MultiThreader.
+ *
+ * \ingroup GeometricTransform Multithreaded
+ */
+template <class TInputImage, class TOutputImage = TInputImage>
+class SeparableResampleImageFilter:
+    public ImageToImageFilter<TInputImage,TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef SeparableResampleImageFilter                  Self;
+  typedef ImageToImageFilter<TInputImage,TOutputImage>  Superclass;
+  typedef SmartPointer<Self>                            Pointer;
+  typedef SmartPointer<const Self>                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( SeparableResampleImageFilter, ImageToImageFilter );
+
+  /** Typedef to describe the input/output image types. */
+  itkStaticConstMacro( ImageDimension, unsigned int, TOutputImage::ImageDimension );
+  typedef TInputImage                                   InputImageType;
+  typedef typename InputImageType::PixelType            InputPixelType;
+  typedef TOutputImage                                  OutputImageType;
+  typedef typename OutputImageType::PixelType           OutputPixelType;
+  typedef typename OutputImageType::SizeType            SizeType;
+  typedef typename OutputImageType::SpacingType         SpacingType;
+  typedef double                                        RealType;
+
+  /** Set/Get the output size. */
+  itkSetMacro( OutputSize, SizeType );
+  itkGetConstReferenceMacro( OutputSize, SizeType );
+
+  /** Set/Get the output spacing. */
+  itkSetMacro( OutputSpacing, SpacingType );
+  itkGetConstReferenceMacro( OutputSpacing, SpacingType );
+
+  /** Set/Get the interpolation order, 0 to 5. Default 1. */
+  itkSetClampMacro( InterpolationOrder, unsigned int, 0, 5 );
+  itkGetConstMacro( InterpolationOrder, unsigned int );
+
+  /** Set/Get whether to box average integer downsampling. Default false. */
+  itkSetMacro( AntiAlias, bool );
+  itkGetConstMacro( AntiAlias, bool );
+  itkBooleanMacro( AntiAlias );
+
+  /** Set/Get the value of output points outside the input. Default 0. */
+  itkSetMacro( DefaultPixelValue, OutputPixelType );
+  itkGetConstMacro( DefaultPixelValue, OutputPixelType );
+
+protected:
+  SeparableResampleImageFilter();
+  ~SeparableResampleImageFilter() {};
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** The output has the given size and spacing. */
+  virtual void GenerateOutputInformation( void );
+
+  /** Request the input that the taps of the output requested region touch. */
+  virtual void GenerateInputRequestedRegion( void );
+
+  /** Run the passes, slab by slab. */
+  virtual void GenerateData( void );
+
+  /** The taps of the output requested region along one axis. Output index
+   * j, counted from the start of the requested region, reads input row
+   * First + Indices[ j * NumberOfTaps + t ] with weight
+   * Weights[ j * NumberOfTaps + t ]. The rows are counted from the start of
+   * the input, and all taps lie in [First, First + Size). Output points
+   * outside the input have all weights zero; Inside tells which are inside.
+   * Prefilter tells whether the axis is a B-spline axis.
+   */
+  struct AxisTable
+  {
+    unsigned int                NumberOfTaps;
+    OffsetValueType             First;
+    SizeValueType               Size;
+    bool                        Prefilter;
+    std::vector<OffsetValueType> Indices;
+    std::vector<RealType>       Weights;
+    std::vector<bool>           Inside;
+  };
+
+  /** Compute the table of an axis. */
+  void ComputeAxisTable( unsigned int axis, AxisTable & table ) const;
+
+  /** The value of the centred B-spline of the given order at x. */
+  static RealType BSplineKernel( unsigned int order, RealType x );
+
+  /** Replace the values of a line by their B-spline coefficients, with
+   * mirrored boundaries, as the itk::BSplineDecompositionImageFilter does.
+   */
+  static void BSplinePrefilterLine( unsigned int order, RealType * line, SizeValueType length );
+
+  /** Run a pass over the threads. */
+  void ExecutePass( void );
+
+  /** Static function used as a "callback" by the MultiThreader. */
+  static ITK_THREAD_RETURN_TYPE ThreaderCallback( void * arg );
+
+  /** Resample the runs of the current pass that belong to a thread. */
+  template <class TSourcePixel>
+  void ThreadedResampleAxis( const TSourcePixel * source,
+    ThreadIdType threadId, ThreadIdType numberOfThreads );
+
+  /** Prefilter the lines of the current pass that belong to a thread. */
+  void ThreadedPrefilterAxis( ThreadIdType threadId, ThreadIdType numberOfThreads );
+
+private:
+  SeparableResampleImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  SizeType          m_OutputSize;
+  SpacingType       m_OutputSpacing;
+  unsigned int      m_InterpolationOrder;
+  bool              m_AntiAlias;
+  OutputPixelType   m_DefaultPixelValue;
+
+  /** The state of the current pass. A resample pass fills the contiguous
+   * buffer PassTarget of size PassSize from rows PassTableOffset on of the
+   * table; its source is either the input or a RealType buffer, with the
+   * given strides, and has the size of the target except along PassAxis. A
+   * prefilter pass replaces PassTarget by its coefficients along PassAxis.
+   */
+  bool                    m_PassIsPrefilter;
+  const InputPixelType *  m_PassInputSource;
+  const RealType *        m_PassRealSource;
+  OffsetValueType         m_PassSourceStrides[ ImageDimension ];
+  RealType *              m_PassTarget;
+  SizeType                m_PassSize;
+  unsigned int            m_PassAxis;
+  const AxisTable *       m_PassTable;
+  SizeValueType           m_PassTableOffset;
+
+}; // end class SeparableResampleImageFilter
+
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSeparableResampleImageFilter.hxx"
+#endif
+
+#endif // end #ifndef __itkSeparableResampleImageFilter_h_
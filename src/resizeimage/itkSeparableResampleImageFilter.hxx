@@ -0,0 +1,735 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef _itkSeparableResampleImageFilter_hxx_
+#define _itkSeparableResampleImageFilter_hxx_
+
+#include "itkSeparableResampleImageFilter.h"
+
+#include "itkNumericTraits.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace itk
+{
+
+template<class TInputImage, class TOutputImage>
+SeparableResampleImageFilter<TInputImage,TOutputImage>
+::SeparableResampleImageFilter()
+{
+  this->SetNumberOfRequiredInputs( 1 );
+  this->m_OutputSize.Fill( 0 );
+  this->m_OutputSpacing.Fill( 1.0 );
+  this->m_InterpolationOrder = 1;
+  this->m_AntiAlias = false;
+  this->m_DefaultPixelValue = NumericTraits<OutputPixelType>::Zero;
+
+  this->m_PassIsPrefilter = false;
+  this->m_PassInputSource = 0;
+  this->m_PassRealSource = 0;
+  std::fill( this->m_PassSourceStrides, this->m_PassSourceStrides + ImageDimension, 0 );
+  this->m_PassTarget = 0;
+  this->m_PassSize.Fill( 0 );
+  this->m_PassAxis = 0;
+  this->m_PassTable = 0;
+  this->m_PassTableOffset = 0;
+}
+
+
+template<class TInputImage, class TOutputImage>
+void
+SeparableResampleImageFilter<TInputImage,TOutputImage>
+::GenerateOutputInformation( void )
+{
+  Superclass::GenerateOutputInformation();
+
+  const InputImageType * input = this->GetInput();
+  OutputImageType * output = this->GetOutput();
+  if( !input || !output ) return;
+
+  typename OutputImageType::RegionType region;
+  region.SetIndex( input->GetLargestPossibleRegion().GetIndex() );
+  region.SetSize( this->m_OutputSize );
+
+  output->SetLargestPossibleRegion( region );
+  output->SetSpacing( this->m_OutputSpacing );
+  output->SetOrigin( input->GetOrigin() );
+  output->SetDirection( input->GetDirection() );
+
+} // end GenerateOutputInformation()
+
+
+template<class TInputImage, class TOutputImage>
+void
+SeparableResampleImageFilter<TInputImage,TOutputImage>
+::GenerateInputRequestedRegion( void )
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType * input = const_cast<InputImageType *>( this->GetInput() );
+  if( !input ) return;
+
+  /** The rows that the taps of the output requested region touch. */
+  typename InputImageType::RegionType region = input->GetLargestPossibleRegion();
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+  {
+    AxisTable table;
+    this->ComputeAxisTable( d, table );
+    region.SetIndex( d, region.GetIndex( d ) + table.First );
+    region.SetSize( d, table.Size );
+  }
+  input->SetRequestedRegion( region );
+
+} // end GenerateInputRequestedRegion()
+
+
+/**
+ * The centred B-spline of the given order:
+ * sum_k (-1)^k binomial(n+1,k) max(0, x + (n+1)/2 - k)^n / n!
+ */
+template<class TInputImage, class TOutputImage>
+typename SeparableResampleImageFilter<TInputImage,TOutputImage>::RealType
+SeparableResampleImageFilter<TInputImage,TOutputImage>
+::BSplineKernel( unsigned int order, RealType x )
+{
+  RealType value = 0.0;
+  RealType binomial = 1.0;
+  RealType factorial = 1.0;
+  for( unsigned int k = 2; k <= order; ++k ) factorial *= k;
+
+  for( unsigned int k = 0; k <= order + 1; ++k )
+  {
+    const RealType shifted = x + 0.5 * ( order + 1 ) - k;
+    if( shifted > 0.0 )
+    {
+      const RealType term = binomial * std::pow( shifted, static_cast<int>( order ) );
+      value += ( k % 2 == 0 ) ? term : -term;
+    }
+    binomial = binomial * ( order + 1 - k ) / ( k + 1 );
+  }
+  return value / factorial;
+
+} // end BSplineKernel()
+
+
+/**
+ * The recursive filter of Unser et al., with the poles, the initial
+ * coefficients and the tolerance of the itk::BSplineDecompositionImageFilter.
+ */
+template<class TInputImage, class TOutputImage>
+void
+SeparableResampleImageFilter<TInputImage,TOutputImage>
+::BSplinePrefilterLine( unsigned int order, RealType * line, SizeValueType length )
+{
+  if( length < 2 ) return;
+
+  RealType poles[ 2 ];
+  unsigned int numberOfPoles = 1;
+  switch( order )
+  {
+    case 2:
+      poles[ 0 ] = std::sqrt( 8.0 ) - 3.0;
+      break;
+    case 3:
+      poles[ 0 ] = std::sqrt( 3.0 ) - 2.0;
+      break;
+    case 4:
+      numberOfPoles = 2;
+      poles[ 0 ] = std::sqrt( 664.0 - std::sqrt( 438976.0 ) ) + std::sqrt( 304.0 ) - 19.0;
+      poles[ 1 ] = std::sqrt( 664.0 + std::sqrt( 438976.0 ) ) - std::sqrt( 304.0 ) - 19.0;
+      break;
+    case 5:
+      numberOfPoles = 2;
+      poles[ 0 ] = std::sqrt( 135.0 / 2.0 - std::sqrt( 17745.0 / 4.0 ) )
+        + std::sqrt( 105.0 / 4.0 ) - 13.0 / 2.0;
+      poles[ 1 ] = std::sqrt( 135.0 / 2.0 + std::sqrt( 17745.0 / 4.0 ) )
+        - std::sqrt( 105.0 / 4.0 ) - 13.0 / 2.0;
+      break;
+    default:
+      return;
+  }
+
+  /** The overall gain. */
+  RealType gain = 1.0;
+  for( unsigned int k = 0; k < numberOfPoles; ++k )
+  {
+    gain *= ( 1.0 - poles[ k ] ) * ( 1.0 - 1.0 / poles[ k ] );
+  }
+  for( SizeValueType n = 0; n < length; ++n ) line[ n ] *= gain;
+
+  const RealType tolerance = 1e-10;
+  for( unsigned int k = 0; k < numberOfPoles; ++k )
+  {
+    const RealType z = poles[ k ];
+
+    /** The initial causal coefficient, for mirrored boundaries. */
+    const SizeValueType horizon = static_cast<SizeValueType>(
+      std::ceil( std::log( tolerance ) / std::log( std::fabs( z ) ) ) );
+    RealType zn = z;
+    if( horizon < length )
+    {
+      RealType sum = line[ 0 ];
+      for( SizeValueType n = 1; n < horizon; ++n )
+      {
+        sum += zn * line[ n ];
+        zn *= z;
+      }
+      line[ 0 ] = sum;
+    }
+    else
+    {
+      const RealType iz = 1.0 / z;
+      RealType z2n = std::pow( z, static_cast<RealType>( length - 1 ) );
+      RealType sum = line[ 0 ] + z2n * line[ length - 1 ];
+      z2n *= z2n * iz;
+      for( SizeValueType n = 1; n + 1 < length; ++n )
+      {
+        sum += ( zn + z2n ) * line[ n ];
+        zn *= z;
+        z2n *= iz;
+      }
+      line[ 0 ] = sum / ( 1.0 - zn * zn );
+    }
+
+    /** Causal recursion. */
+    for( SizeValueType n = 1; n < length; ++n )
+    {
+      line[ n ] += z * line[ n - 1 ];
+    }
+
+    /** The initial anti-causal coefficient, and anti-causal recursion. */
+    line[ length - 1 ] = ( z / ( z * z - 1.0 ) )
+      * ( z * line[ length - 2 ] + line[ length - 1 ] );
+    for( SizeValueType n = length - 1; n > 0; --n )
+    {
+      line[ n - 1 ] = z * ( line[ n ] - line[ n - 1 ] );
+    }
+  }
+
+} // end BSplinePrefilterLine()
+
+
+/**
+ * The taps of the output requested region along an axis. Positions are
+ * continuous indices relative to the start of the input.
+ */
+template<class TInputImage, class TOutputImage>
+void
+SeparableResampleImageFilter<TInputImage,TOutputImage>
+::ComputeAxisTable( unsigned int axis, AxisTable & table ) const
+{
+  const InputImageType * input = this->GetInput();
+  const OffsetValueType inputStart = input->GetLargestPossibleRegion().GetIndex( axis );
+  const OffsetValueType inputSize = input->GetLargestPossibleRegion().GetSize( axis );
+  const OffsetValueType outputStart = this->GetOutput()->GetRequestedRegion().GetIndex( axis );
+  const SizeValueType outputSize = this->GetOutput()->GetRequestedRegion().GetSize( axis );
+  const RealType ratio = this->m_OutputSpacing[ axis ] / input->GetSpacing()[ axis ];
+  const unsigned int order = this->m_InterpolationOrder;
+
+  /** An integer downsampling factor gets a box of that many pixels; for an
+   * even factor the box has half pixels at both ends, to stay centred.
+   */
+  const OffsetValueType factor = static_cast<OffsetValueType>( ratio + 0.5 );
+  const bool useBox = this->m_AntiAlias && factor >= 2
+    && std::abs( ratio - factor ) < 1e-6 * factor;
+
+  if( useBox ) table.NumberOfTaps = factor % 2 == 1 ? factor : factor + 1;
+  else if( order == 0 ) table.NumberOfTaps = 1;
+  else table.NumberOfTaps = order + 1;
+  table.Prefilter = !useBox && order > 1;
+
+  const unsigned int taps = table.NumberOfTaps;
+  table.Indices.assign( outputSize * taps, 0 );
+  table.Weights.assign( outputSize * taps, 0.0 );
+  table.Inside.assign( outputSize, false );
+
+  OffsetValueType firstRow = inputSize;
+  OffsetValueType lastRow = -1;
+  for( SizeValueType j = 0; j < outputSize; ++j )
+  {
+    const RealType x = ( outputStart + static_cast<OffsetValueType>( j ) ) * ratio - inputStart;
+    if( x < -0.5 || x >= inputSize - 0.5 ) continue;
+    table.Inside[ j ] = true;
+
+    OffsetValueType * indices = &table.Indices[ j * taps ];
+    RealType * weights = &table.Weights[ j * taps ];
+
+    if( useBox )
+    {
+      const OffsetValueType first = static_cast<OffsetValueType>( std::floor( x + 0.5 ) )
+        - static_cast<OffsetValueType>( taps - 1 ) / 2;
+      for( unsigned int t = 0; t < taps; ++t )
+      {
+        indices[ t ] = std::min( std::max( first + static_cast<OffsetValueType>( t ),
+          OffsetValueType( 0 ) ), inputSize - 1 );
+        weights[ t ] = 1.0 / factor;
+      }
+      if( factor % 2 == 0 )
+      {
+        weights[ 0 ] *= 0.5;
+        weights[ taps - 1 ] *= 0.5;
+      }
+    }
+    else if( order == 0 )
+    {
+      indices[ 0 ] = std::min( static_cast<OffsetValueType>( std::floor( x + 0.5 ) ), inputSize - 1 );
+      weights[ 0 ] = 1.0;
+    }
+    else if( order == 1 )
+    {
+      /** Neighbours outside the image repeat the border. */
+      const RealType base = std::floor( x );
+      const OffsetValueType b = static_cast<OffsetValueType>( base );
+      indices[ 0 ] = std::min( std::max( b, OffsetValueType( 0 ) ), inputSize - 1 );
+      indices[ 1 ] = std::min( std::max( b + 1, OffsetValueType( 0 ) ), inputSize - 1 );
+      weights[ 0 ] = 1.0 - ( x - base );
+      weights[ 1 ] = x - base;
+    }
+    else
+    {
+      /** The support as in the itk::BSplineInterpolateImageFunction, with
+       * mirrored coefficients outside the image.
+       */
+      const OffsetValueType first = ( order % 2 == 1
+        ? static_cast<OffsetValueType>( std::floor( x ) )
+        : static_cast<OffsetValueType>( std::floor( x + 0.5 ) ) )
+        - static_cast<OffsetValueType>( order / 2 );
+      const OffsetValueType period = 2 * inputSize - 2;
+      for( unsigned int t = 0; t < taps; ++t )
+      {
+        const OffsetValueType position = first + static_cast<OffsetValueType>( t );
+        OffsetValueType mirrored = 0;
+        if( inputSize > 1 )
+        {
+          mirrored = position < 0 ? ( -position ) % period : position % period;
+          if( mirrored >= inputSize ) mirrored = period - mirrored;
+        }
+        indices[ t ] = mirrored;
+        weights[ t ] = BSplineKernel( order, x - position );
+      }
+    }
+
+    for( unsigned int t = 0; t < taps; ++t )
+    {
+      firstRow = std::min( firstRow, indices[ t ] );
+      lastRow = std::max( lastRow, indices[ t ] );
+    }
+  } // end for output indices
+
+  /** The prefilter needs whole lines. Without any tap one row is taken, so
+   * that the input requested region is valid.
+   */
+  if( table.Prefilter )
+  {
+    firstRow = 0;
+    lastRow = inputSize - 1;
+  }
+  else if( lastRow < firstRow )
+  {
+    firstRow = lastRow = 0;
+  }
+  table.First = firstRow;
+  table.Size = static_cast<SizeValueType>( lastRow - firstRow + 1 );
+
+  /** Count the taps from the first row; outside points read that row. */
+  for( SizeValueType j = 0; j < outputSize; ++j )
+  {
+    for( unsigned int t = 0; t < taps; ++t )
+    {
+      OffsetValueType & index = table.Indices[ j * taps + t ];
+      index = table.Inside[ j ] ? index - firstRow : 0;
+    }
+  }
+
+} // end ComputeAxisTable()
+
+
+template<class TInputImage, class TOutputImage>
+void
+SeparableResampleImageFilter<TInputImage,TOutputImage>
+::GenerateData( void )
+{
+  const InputImageType * input = this->GetInput();
+  OutputImageType * output = this->GetOutput();
+  output->SetBufferedRegion( output->GetRequestedRegion() );
+  output->Allocate();
+
+  const SizeType outputSize = output->GetBufferedRegion().GetSize();
+  if( output->GetBufferedRegion().GetNumberOfPixels() == 0 ) return;
+  const unsigned int lastAxis = ImageDimension - 1;
+
+  /** The tables of all axes, for the output requested region. */
+  std::vector<AxisTable> tables( ImageDimension );
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+  {
+    this->ComputeAxisTable( d, tables[ d ] );
+  }
+
+  /** The part of the input buffer that the taps touch, with its strides. */
+  const typename InputImageType::RegionType & buffered = input->GetBufferedRegion();
+  SizeType boxSize;
+  OffsetValueType inputStrides[ ImageDimension ];
+  const InputPixelType * box = input->GetBufferPointer();
+  OffsetValueType stride = 1;
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+  {
+    boxSize[ d ] = tables[ d ].Size;
+    inputStrides[ d ] = stride;
+    box += ( input->GetLargestPossibleRegion().GetIndex( d ) + tables[ d ].First
+      - buffered.GetIndex( d ) ) * stride;
+    stride *= buffered.GetSize( d );
+  }
+
+  /** A B-spline last axis needs whole lines along it, so its coefficients
+   * are computed for the whole box first: an identity pass copies the box
+   * to RealType, and a prefilter pass replaces it by the coefficients.
+   */
+  std::vector<RealType> coefficients;
+  if( tables[ lastAxis ].Prefilter )
+  {
+    AxisTable identity;
+    identity.NumberOfTaps = 1;
+    identity.Indices.resize( boxSize[ lastAxis ] );
+    identity.Weights.assign( boxSize[ lastAxis ], 1.0 );
+    for( SizeValueType j = 0; j < boxSize[ lastAxis ]; ++j ) identity.Indices[ j ] = j;
+
+    SizeValueType numberOfValues = 1;
+    for( unsigned int d = 0; d < ImageDimension; ++d ) numberOfValues *= boxSize[ d ];
+    coefficients.resize( numberOfValues );
+
+    this->m_PassIsPrefilter = false;
+    this->m_PassInputSource = box;
+    this->m_PassRealSource = 0;
+    std::copy( inputStrides, inputStrides + ImageDimension, this->m_PassSourceStrides );
+    this->m_PassTarget = &coefficients[ 0 ];
+    this->m_PassSize = boxSize;
+    this->m_PassAxis = lastAxis;
+    this->m_PassTable = &identity;
+    this->m_PassTableOffset = 0;
+    this->ExecutePass();
+
+    this->m_PassIsPrefilter = true;
+    this->ExecutePass();
+  }
+
+  /** The number of output slices per slab, such that a slab buffer holds
+   * about slabValues values.
+   */
+  const SizeValueType slabValues = 1 << 22;
+  SizeValueType valuesPerSlice = 1;
+  for( unsigned int d = 0; d < lastAxis; ++d ) valuesPerSlice *= boxSize[ d ];
+  SizeValueType maximumPerSlice = valuesPerSlice;
+  for( unsigned int d = 0; d < lastAxis; ++d )
+  {
+    valuesPerSlice = valuesPerSlice / boxSize[ d ] * outputSize[ d ];
+    maximumPerSlice = std::max( maximumPerSlice, valuesPerSlice );
+  }
+  const SizeValueType slabSlices = std::min<SizeValueType>( outputSize[ lastAxis ],
+    std::max<SizeValueType>( 1, slabValues / std::max<SizeValueType>( 1, maximumPerSlice ) ) );
+
+  /** Cast to the output type with clamping, as the itk::ResampleImageFilter
+   * does, and give points outside the input the default value.
+   */
+  const RealType minimum = static_cast<RealType>( NumericTraits<OutputPixelType>::NonpositiveMin() );
+  const RealType maximum = static_cast<RealType>( NumericTraits<OutputPixelType>::max() );
+  const SizeValueType pixelsPerSlice = valuesPerSlice;
+
+  std::vector<RealType> source;
+  std::vector<RealType> target;
+  for( SizeValueType slab = 0; slab < outputSize[ lastAxis ]; slab += slabSlices )
+  {
+    const SizeValueType slices = std::min( slabSlices, outputSize[ lastAxis ] - slab );
+
+    /** The last axis, from the input box or its coefficients. */
+    SizeType size = boxSize;
+    size[ lastAxis ] = slices;
+    SizeValueType numberOfValues = 1;
+    for( unsigned int d = 0; d < ImageDimension; ++d ) numberOfValues *= size[ d ];
+    target.resize( numberOfValues );
+
+    this->m_PassIsPrefilter = false;
+    this->m_PassInputSource = coefficients.empty() ? box : 0;
+    this->m_PassRealSource = coefficients.empty() ? 0 : &coefficients[ 0 ];
+    if( coefficients.empty() )
+    {
+      std::copy( inputStrides, inputStrides + ImageDimension, this->m_PassSourceStrides );
+    }
+    else
+    {
+      stride = 1;
+      for( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+        this->m_PassSourceStrides[ d ] = stride;
+        stride *= boxSize[ d ];
+      }
+    }
+    this->m_PassTarget = &target[ 0 ];
+    this->m_PassSize = size;
+    this->m_PassAxis = lastAxis;
+    this->m_PassTable = &tables[ lastAxis ];
+    this->m_PassTableOffset = slab;
+    this->ExecutePass();
+
+    /** The lower axes, each from the buffer of the previous pass. */
+    for( unsigned int d = 0; d < lastAxis; ++d )
+    {
+      source.swap( target );
+      if( tables[ d ].Prefilter )
+      {
+        this->m_PassIsPrefilter = true;
+        this->m_PassTarget = &source[ 0 ];
+        this->m_PassAxis = d;
+        this->ExecutePass();
+      }
+
+      stride = 1;
+      for( unsigned int e = 0; e < ImageDimension; ++e )
+      {
+        this->m_PassSourceStrides[ e ] = stride;
+        stride *= size[ e ];
+      }
+      numberOfValues = numberOfValues / size[ d ] * outputSize[ d ];
+      size[ d ] = outputSize[ d ];
+      target.resize( numberOfValues );
+
+      this->m_PassIsPrefilter = false;
+      this->m_PassInputSource = 0;
+      this->m_PassRealSource = &source[ 0 ];
+      this->m_PassTarget = &target[ 0 ];
+      this->m_PassSize = size;
+      this->m_PassAxis = d;
+      this->m_PassTable = &tables[ d ];
+      this->m_PassTableOffset = 0;
+      this->ExecutePass();
+    }
+
+    /** The slab is a contiguous part of the output buffer. */
+    OutputPixelType * out = output->GetBufferPointer() + slab * pixelsPerSlice;
+    SizeType position;
+    position.Fill( 0 );
+    for( SizeValueType i = 0; i < numberOfValues; ++i )
+    {
+      bool inside = tables[ lastAxis ].Inside[ slab + position[ lastAxis ] ];
+      for( unsigned int d = 0; d < lastAxis; ++d )
+      {
+        inside &= tables[ d ].Inside[ position[ d ] ];
+      }
+
+      const RealType value = target[ i ];
+      if( !inside ) out[ i ] = this->m_DefaultPixelValue;
+      else if( value < minimum ) out[ i ] = NumericTraits<OutputPixelType>::NonpositiveMin();
+      else if( value > maximum ) out[ i ] = NumericTraits<OutputPixelType>::max();
+      else out[ i ] = static_cast<OutputPixelType>( value );
+
+      /** Next position, the first axis running fastest. */
+      for( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+        if( ++position[ d ] < size[ d ] ) break;
+        position[ d ] = 0;
+      }
+    }
+
+    this->UpdateProgress( static_cast<float>( slab + slices ) / outputSize[ lastAxis ] );
+  } // end for slabs
+
+} // end GenerateData()
+
+
+template<class TInputImage, class TOutputImage>
+void
+SeparableResampleImageFilter<TInputImage,TOutputImage>
+::ExecutePass( void )
+{
+  MultiThreader * threader = this->GetMultiThreader();
+  threader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  threader->SetSingleMethod( this->ThreaderCallback, this );
+  threader->SingleMethodExecute();
+
+} // end ExecutePass()
+
+
+template<class TInputImage, class TOutputImage>
+ITK_THREAD_RETURN_TYPE
+SeparableResampleImageFilter<TInputImage,TOutputImage>
+::ThreaderCallback( void * arg )
+{
+  MultiThreader::ThreadInfoStruct * info = static_cast<MultiThreader::ThreadInfoStruct *>( arg );
+  Self * self = static_cast<Self *>( info->UserData );
+
+  if( self->m_PassIsPrefilter )
+  {
+    self->ThreadedPrefilterAxis( info->ThreadID, info->NumberOfThreads );
+  }
+  else if( self->m_PassRealSource )
+  {
+    self->ThreadedResampleAxis( self->m_PassRealSource, info->ThreadID, info->NumberOfThreads );
+  }
+  else
+  {
+    self->ThreadedResampleAxis( self->m_PassInputSource, info->ThreadID, info->NumberOfThreads );
+  }
+
+  return ITK_THREAD_RETURN_VALUE;
+
+} // end ThreaderCallback()
+
+
+/**
+ * The target is a sequence of runs along the first axis, one for every
+ * position of the other axes. For a higher axis a run is the weighted sum
+ * of the source runs of its taps; along the first axis every value gathers
+ * its taps from the source run at the same position. The threads get
+ * consecutive ranges of the runs.
+ */
+template<class TInputImage, class TOutputImage>
+template<class TSourcePixel>
+void
+SeparableResampleImageFilter<TInputImage,TOutputImage>
+::ThreadedResampleAxis( const TSourcePixel * source,
+  ThreadIdType threadId, ThreadIdType numberOfThreads )
+{
+  const unsigned int axis = this->m_PassAxis;
+  const AxisTable & table = *this->m_PassTable;
+  const unsigned int taps = table.NumberOfTaps;
+  const SizeType & size = this->m_PassSize;
+  const OffsetValueType * strides = this->m_PassSourceStrides;
+  const SizeValueType runLength = size[ 0 ];
+
+  SizeValueType numberOfRuns = 1;
+  for( unsigned int e = 1; e < ImageDimension; ++e ) numberOfRuns *= size[ e ];
+  const SizeValueType first = ( numberOfRuns * threadId ) / numberOfThreads;
+  const SizeValueType last = ( numberOfRuns * ( threadId + 1 ) ) / numberOfThreads;
+
+  for( SizeValueType run = first; run < last; ++run )
+  {
+    /** The source offset of the run, and its output row along the axis. */
+    SizeValueType rest = run;
+    OffsetValueType offset = 0;
+    SizeValueType j = 0;
+    for( unsigned int e = 1; e < ImageDimension; ++e )
+    {
+      const SizeValueType c = rest % size[ e ];
+      rest /= size[ e ];
+      if( e == axis ) j = c;
+      else offset += static_cast<OffsetValueType>( c ) * strides[ e ];
+    }
+    const TSourcePixel * in = source + offset;
+    RealType * out = this->m_PassTarget + run * runLength;
+
+    if( axis == 0 )
+    {
+      for( SizeValueType i = 0; i < runLength; ++i )
+      {
+        const SizeValueType row = ( this->m_PassTableOffset + i ) * taps;
+        RealType sum = 0.0;
+        for( unsigned int t = 0; t < taps; ++t )
+        {
+          const RealType weight = table.Weights[ row + t ];
+          if( weight == 0.0 ) continue;
+          sum += weight * static_cast<RealType>( in[ table.Indices[ row + t ] ] );
+        }
+        out[ i ] = sum;
+      }
+      continue;
+    }
+
+    const SizeValueType row = ( this->m_PassTableOffset + j ) * taps;
+    std::fill( out, out + runLength, 0.0 );
+    for( unsigned int t = 0; t < taps; ++t )
+    {
+      const RealType weight = table.Weights[ row + t ];
+      if( weight == 0.0 ) continue;
+      const TSourcePixel * inRun = in + table.Indices[ row + t ] * strides[ axis ];
+      for( SizeValueType b = 0; b < runLength; ++b )
+      {
+        out[ b ] += weight * static_cast<RealType>( inRun[ b ] );
+      }
+    }
+  }
+
+} // end ThreadedResampleAxis()
+
+
+/**
+ * The lines along the axis are gathered into a scratch line, filtered and
+ * scattered back. The threads get consecutive ranges of the lines.
+ */
+template<class TInputImage, class TOutputImage>
+void
+SeparableResampleImageFilter<TInputImage,TOutputImage>
+::ThreadedPrefilterAxis( ThreadIdType threadId, ThreadIdType numberOfThreads )
+{
+  const unsigned int axis = this->m_PassAxis;
+  const SizeType & size = this->m_PassSize;
+  const SizeValueType length = size[ axis ];
+
+  OffsetValueType strides[ ImageDimension ];
+  SizeValueType numberOfLines = 1;
+  OffsetValueType stride = 1;
+  for( unsigned int e = 0; e < ImageDimension; ++e )
+  {
+    strides[ e ] = stride;
+    stride *= size[ e ];
+    if( e != axis ) numberOfLines *= size[ e ];
+  }
+  const SizeValueType first = ( numberOfLines * threadId ) / numberOfThreads;
+  const SizeValueType last = ( numberOfLines * ( threadId + 1 ) ) / numberOfThreads;
+
+  std::vector<RealType> line( length );
+  for( SizeValueType l = first; l < last; ++l )
+  {
+    SizeValueType rest = l;
+    OffsetValueType offset = 0;
+    for( unsigned int e = 0; e < ImageDimension; ++e )
+    {
+      if( e == axis ) continue;
+      offset += static_cast<OffsetValueType>( rest % size[ e ] ) * strides[ e ];
+      rest /= size[ e ];
+    }
+
+    RealType * values = this->m_PassTarget + offset;
+    for( SizeValueType n = 0; n < length; ++n ) line[ n ] = values[ n * strides[ axis ] ];
+    BSplinePrefilterLine( this->m_InterpolationOrder, &line[ 0 ], length );
+    for( SizeValueType n = 0; n < length; ++n ) values[ n * strides[ axis ] ] = line[ n ];
+  }
+
+} // end ThreadedPrefilterAxis()
+
+
+template<class TInputImage, class TOutputImage>
+void
+SeparableResampleImageFilter<TInputImage,TOutputImage>
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "OutputSize: " << this->m_OutputSize << std::endl;
+  os << indent << "OutputSpacing: " << this->m_OutputSpacing << std::endl;
+  os << indent << "InterpolationOrder: " << this->m_InterpolationOrder << std::endl;
+  os << indent << "AntiAlias: " << this->m_AntiAlias << std::endl;
+  os << indent << "DefaultPixelValue: "
+    << static_cast<typename NumericTraits<OutputPixelType>::PrintType>(
+    this->m_DefaultPixelValue ) << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef _itkSeparableResampleImageFilter_hxx_
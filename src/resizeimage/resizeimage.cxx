@@ -45,6 +45,8 @@ std::string GetHelpString( void )
     << "  [-sp]    output spacing\n"
     << "  [-sz]    output size\n"
     << "  [-io]    interpolation order, default 1\n"
+    << "  [-aa]    antialias: average boxes of k pixels along axes that are\n"
+    << "           downsampled by an integer factor k, instead of interpolating\n"
     << "One of {-f, -sp, -sz} should be given.\n"
     << "Supported: 2D, 3D, (unsigned) char, (unsigned) short, (unsigned) int, (unsigned) long, float, double.";
 
@@ -103,6 +105,8 @@ int main( int argc, char **argv )
   unsigned int interpolationOrder = 1;
   parser->GetCommandLineArgument( "-io", interpolationOrder );
 
+  const bool antiAlias = parser->ArgumentExists( "-aa" );
+
   /** Determine image properties. */
   itk::ImageIOBase::IOPixelType pixelType = itk::ImageIOBase::UNKNOWNPIXELTYPE;
   itk::ImageIOBase::IOComponentType componentType = itk::ImageIOBase::UNKNOWNCOMPONENTTYPE;
@@ -198,6 +202,7 @@ int main( int argc, char **argv )
     filter->m_OutputSpacing = outputSpacing;
     filter->m_OutputSize = outputSize;
     filter->m_InterpolationOrder = interpolationOrder;
+    filter->m_AntiAlias = antiAlias;
 
     filter->Run();
 
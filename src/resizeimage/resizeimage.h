@@ -21,9 +21,7 @@
 #include "ITKToolsBase.h"
 
 #include "itkImage.h"
-#include "itkResampleImageFilter.h"
-#include "itkNearestNeighborInterpolateImageFunction.h"
-#include "itkBSplineInterpolateImageFunction.h"
+#include "itkSeparableResampleImageFilter.h"
 
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
@@ -45,6 +43,7 @@ public:
     this->m_OutputFileName = "";
     this->m_ResizingSpecifiedBy = "";
     this->m_InterpolationOrder = 0;
+    this->m_AntiAlias = false;
   };
   /** Destructor. */
   ~ITKToolsResizeImageBase(){};
@@ -57,6 +56,7 @@ public:
   std::vector<double> m_OutputSpacing;
   std::vector<unsigned int> m_OutputSize;
   unsigned int m_InterpolationOrder;
+  bool m_AntiAlias;
 
 }; // end class ITKToolsResizeImageBase
 
@@ -83,13 +83,10 @@ public:
   {
     /** Typedefs. */
     typedef itk::Image<TComponentType, VDimension>      InputImageType;
-    typedef itk::ResampleImageFilter< InputImageType, InputImageType >  ResamplerType;
+    typedef itk::SeparableResampleImageFilter<
+      InputImageType, InputImageType >                  ResamplerType;
     typedef itk::ImageFileReader< InputImageType >      ReaderType;
     typedef itk::ImageFileWriter< InputImageType >      WriterType;
-    typedef itk::NearestNeighborInterpolateImageFunction<
-      InputImageType, double >                          NNInterpolatorType;
-    typedef itk::BSplineInterpolateImageFunction<
-      InputImageType >                                  BSplineInterpolatorType;
 
     typedef typename InputImageType::SizeType         SizeType;
     typedef typename InputImageType::SpacingType      SpacingType;
@@ -101,15 +98,13 @@ public:
     typename ResamplerType::Pointer resampler = ResamplerType::New();
     typename ReaderType::Pointer reader = ReaderType::New();
     typename WriterType::Pointer writer = WriterType::New();
-    typename NNInterpolatorType::Pointer nnInterpolator
-      = NNInterpolatorType::New();
-    typename BSplineInterpolatorType::Pointer bsInterpolator
-      = BSplineInterpolatorType::New();
 
-    /** Read in the inputImage. */
+    /** Read the information of the inputImage; the resampler requests only
+     * the part of it that it needs.
+     */
     reader->SetFileName( this->m_InputFileName.c_str() );
     inputImage = reader->GetOutput();
-    inputImage->Update();
+    inputImage->UpdateOutputInformation();
 
     /** Prepare stuff. */
     SpacingType inputSpacing  = inputImage->GetSpacing();
@@ -142,27 +137,17 @@ public:
       }
     }
 
-    /** Setup the pipeline. */
+    /** Setup the pipeline. The resize is a scaling along the image axes,
+     * so the resampler interpolates one axis at a time. It keeps the origin,
+     * start index and direction of the input, and uses nearest neighbour
+     * interpolation for order 0, linear for order 1 and B-splines above.
+     */
     resampler->SetInput( inputImage );
-    resampler->SetSize( outputSize );
-    resampler->SetDefaultPixelValue( 0 );
-    resampler->SetOutputStartIndex( inputImage->GetLargestPossibleRegion().GetIndex() );
+    resampler->SetOutputSize( outputSize );
     resampler->SetOutputSpacing( outputSpacing );
-    resampler->SetOutputOrigin( inputImage->GetOrigin() );
-    resampler->SetOutputDirection( inputImage->GetDirection() );
-
-    /* The interpolator: the resampler has by default a
-     * LinearInterpolateImageFunction as interpolator.
-     */
-    if( this->m_InterpolationOrder == 0 )
-    {
-      resampler->SetInterpolator( nnInterpolator );
-    }
-    else if( this->m_InterpolationOrder > 1 )
-    {
-      bsInterpolator->SetSplineOrder( this->m_InterpolationOrder );
-      resampler->SetInterpolator( bsInterpolator );
-    }
+    resampler->SetDefaultPixelValue( 0 );
+    resampler->SetInterpolationOrder( this->m_InterpolationOrder );
+    resampler->SetAntiAlias( this->m_AntiAlias );
 
     /** Write the output image. */
     writer->SetFileName( this->m_OutputFileName.c_str() );
@@ -19,6 +19,7 @@
 #define __segmentationdistance_h_
 
 #include "ITKToolsBase.h"
+#include "ITKToolsProfiler.h"
 
 #include "itkImage.h"
 #include "itkExceptionObject.h"
@@ -174,6 +175,22 @@ public:
     typename WriterCartesianType::Pointer writerDistCartesian = WriterCartesianType::New();
     typename WriterCartesianType::Pointer writerEdgeCartesian = WriterCartesianType::New();
 
+    /** Time the stages if -profile is given. */
+    itktools::Profiler * profiler = itktools::Profiler::GetInstance();
+    profiler->Observe( reader1 );
+    profiler->Observe( reader2 );
+    profiler->Observe( padder1 );
+    profiler->Observe( padder2 );
+    profiler->Observe( subtracterDistCartesian );
+    profiler->Observe( adderEdgeCartesian );
+    profiler->Observe( writerDistCartesian );
+    profiler->Observe( writerEdgeCartesian );
+    profiler->Observe( subtracter );
+    profiler->Observe( adder );
+    profiler->Observe( divider );
+    profiler->Observe( extracter );
+    profiler->Observe( writer );
+
     /** Read in the inputImages. */
     reader1->SetFileName( this->m_InputFileName1.c_str() );
     reader2->SetFileName( this->m_InputFileName2.c_str() );
@@ -415,6 +432,19 @@ public:
     typename AccumulatorType::Pointer accumulator1 = AccumulatorType::New();
     typename AccumulatorType::Pointer accumulator2 = AccumulatorType::New();
 
+    /** Time the stages if -profile is given. */
+    itktools::Profiler * profiler = itktools::Profiler::GetInstance();
+    profiler->Observe( distanceMapFilter1 );
+    profiler->Observe( distanceMapFilter2 );
+    profiler->Observe( thresholder );
+    profiler->Observe( multiplier2 );
+    profiler->Observe( toMaskImageCaster );
+    profiler->Observe( cscFilter1 );
+    profiler->Observe( cscFilter2 );
+    profiler->Observe( multiplier );
+    profiler->Observe( accumulator1 );
+    profiler->Observe( accumulator2 );
+
     /** Compute the distance map of image 1 */
     distanceMapFilter1->SetInput( inputImage1 );
     distanceMapFilter1->SetUseImageSpacing( true );
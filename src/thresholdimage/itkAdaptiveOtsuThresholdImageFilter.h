@@ -50,7 +50,6 @@
 #endif
 
 #include "itkImageToImageFilter.h"
-#include "itkOtsuThresholdCalculator.h"
 #include "itkNumericTraits.h"
 
 #include "itkVector.h"
@@ -61,10 +60,33 @@
 #include "itkImageRandomNonRepeatingConstIteratorWithIndex.h"
 #include "itkBSplineScatteredDataPointSetToImageFilter.h"
 #include "itkVectorIndexSelectionCastImageFilter.h"
-#include "itkRegionOfInterestImageFilter.h"
+#include "itkMultiThreader.h"
+#include "itkStageMultiThreader.h"
+#include <vector>
 
 namespace itk {
 
+/** \class AdaptiveOtsuThresholdImageFilter
+ * \brief Threshold an image with a smoothly varying Otsu threshold.
+ *
+ * Otsu thresholds are computed in windows of size Radius at a set of
+ * (random) sample points, and a B-spline is fitted through them.
+ *
+ * The window thresholds are computed directly from the input buffer, with
+ * per-thread scratch histograms and the samples distributed over the threads.
+ * By default every window histogram is binned between the window minimum and
+ * maximum, as in the OtsuThresholdImageCalculator. With
+ * UseIntegralHistogram the histograms are instead binned between the global
+ * minimum and maximum and obtained from an integral histogram. It is built
+ * one bin at a time, with ImageDimension cumulative passes over the N image
+ * pixels per bin, so building it costs O(bins D N) and an N element buffer
+ * of unsigned ints; a window histogram then costs O(bins 2^D). The local
+ * computation costs two passes over the window pixels per sample, so the
+ * integral histogram is only cheaper when samples x window pixels exceeds
+ * about bins x D x N, i.e. when the windows cover the image many times
+ * over. For the default settings it is much slower.
+ */
+
 template < class TInputImage, class TOutputImage >
 class ITK_EXPORT AdaptiveOtsuThresholdImageFilter :
   public ImageToImageFilter< TInputImage, TOutputImage >
@@ -112,14 +134,6 @@ public:
   typedef ImageRandomNonRepeatingConstIteratorWithIndex< InputImageType >
     RandomIteratorType;
 
-  typedef RegionOfInterestImageFilter< InputImageType, InputImageType >
-    ROIFilterType;
-  typedef typename ROIFilterType::Pointer
-    ROIFilterPointer;
-
-  typedef OtsuThresholdCalculator< InputImageType >       OtsuThresholdType;
-  typedef typename OtsuThresholdType::Pointer             OtsuThresholdPointer;
-
   typedef Vector< InputCoordType, 1 >         VectorType;
   typedef Image< VectorType, ImageDimension > VectorImageType;
   typedef typename VectorImageType::PixelType VectorPixelType;
@@ -138,7 +152,7 @@ public:
   typedef Image< InputCoordType, ImageDimension > CoordImageType;
   typedef typename CoordImageType::Pointer        CoordImagePointer;
   typedef VectorIndexSelectionCastImageFilter< VectorImageType,
-    OutputImageType > IndexFilterType;
+    CoordImageType > IndexFilterType;
   typedef typename IndexFilterType::Pointer IndexFilterPointer;
 
   /** Set the radius of the neighborhood used to compute the median. */
@@ -168,7 +182,14 @@ public:
   itkSetMacro(InsideValue, OutputPixelType);
   itkGetConstReferenceMacro(InsideValue, OutputPixelType);
 
-  OutputImagePointer GetThresholdImage()
+  /** Obtain the window histograms from an integral histogram, binned
+   * between the global minimum and maximum. Default false.
+   */
+  itkSetMacro( UseIntegralHistogram, bool );
+  itkGetConstMacro( UseIntegralHistogram, bool );
+  itkBooleanMacro( UseIntegralHistogram );
+
+  CoordImagePointer GetThresholdImage()
     {
     return this->m_Threshold;
     }
@@ -183,9 +204,44 @@ protected:
   AdaptiveOtsuThresholdImageFilter();
   ~AdaptiveOtsuThresholdImageFilter() {}
 
+  /** The whole input is needed. */
+  void GenerateInputRequestedRegion();
+
   void ComputeRandomPointSet();
   void GenerateData();
 
+  /** The computation of the sample thresholds runs in multithreaded
+   * stages, with StageThreaderType::Execute(). */
+  typedef StageMultiThreader<Self> StageThreaderType;
+
+  /** Run a stage on all threads. */
+  void ExecuteStage( typename StageThreaderType::StageMethodType stage )
+    {
+    StageThreaderType::Execute( this->GetMultiThreader(), this->GetNumberOfThreads(), this, stage );
+    }
+
+  /** The window of a sample, cropped to the image. */
+  InputImageRegionType GetSampleRegion( unsigned long sample ) const;
+
+  /** Otsu thresholds of the samples of this thread, with the window
+   * histograms binned between the window minimum and maximum. */
+  void ThreadedComputeLocalThresholds( ThreadIdType threadId, ThreadIdType numberOfThreads );
+
+  /** Cumulative sum along m_IntegrationDimension of the lines of this
+   * thread. The first dimension starts from the indicator of m_CurrentBin. */
+  void ThreadedIntegrate( ThreadIdType threadId, ThreadIdType numberOfThreads );
+
+  /** Count of m_CurrentBin in the windows of the samples of this thread. */
+  void ThreadedQueryIntegralHistogram( ThreadIdType threadId, ThreadIdType numberOfThreads );
+
+  /** Compute the thresholds of all samples using the integral histogram. */
+  void ComputeIntegralHistogramThresholds();
+
+  /** Otsu's method on a histogram. Returns the bin that maximizes the
+   * between-class variance; the threshold is at its upper edge.
+   */
+  static unsigned int ComputeOtsuBin( std::vector<double> & histogram );
+
   InputSizeType m_Radius;
   unsigned int m_NumberOfHistogramBins;
   unsigned int m_NumberOfControlPoints;
@@ -194,9 +250,20 @@ protected:
   unsigned int m_SplineOrder;
   OutputPixelType m_OutsideValue;
   OutputPixelType m_InsideValue;
+  bool m_UseIntegralHistogram;
 
   PointSetPointer m_PointSet;
-  OutputImagePointer m_Threshold;
+  CoordImagePointer m_Threshold;
+
+  /** State of the multithreaded stages. */
+  std::vector<InputCoordType> m_SampleThresholds;
+  std::vector<InputImageRegionType> m_SampleRegions;
+  std::vector<unsigned long> m_SampleHistograms;
+  std::vector<unsigned int> m_IntegralHistogram;
+  unsigned int m_IntegrationDimension;
+  unsigned int m_CurrentBin;
+  double m_GlobalMinimum;
+  double m_GlobalBinMultiplier;
 
 private:
 
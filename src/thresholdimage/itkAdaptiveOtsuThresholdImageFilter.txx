@@ -43,6 +43,8 @@
 
 #include "itkAdaptiveOtsuThresholdImageFilter.h"
 
+#include "vnl/vnl_math.h"
+
 namespace itk
 {
 //  Software Guide : BeginCodeSnippet
@@ -58,8 +60,13 @@ AdaptiveOtsuThresholdImageFilter()
   this->m_NumberOfSamples = 5000;
   this->m_OutsideValue = 0;
   this->m_InsideValue = 1;
+  this->m_UseIntegralHistogram = false;
 
   this->m_PointSet = NULL;
+  this->m_IntegrationDimension = 0;
+  this->m_CurrentBin = 0;
+  this->m_GlobalMinimum = 0.0;
+  this->m_GlobalBinMultiplier = 1.0;
 
   this->Superclass::SetNumberOfRequiredInputs( 1 );
   this->Superclass::SetNumberOfRequiredOutputs( 1 );
@@ -117,6 +124,363 @@ AdaptiveOtsuThresholdImageFilter<TInputImage, TOutputImage>
     }
 }
 
+template< class TInputImage, class TOutputImage >
+void
+AdaptiveOtsuThresholdImageFilter<TInputImage, TOutputImage>
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType * input = const_cast< InputImageType * >( this->GetInput() );
+  if( input )
+    {
+    input->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+typename AdaptiveOtsuThresholdImageFilter<TInputImage, TOutputImage>::InputImageRegionType
+AdaptiveOtsuThresholdImageFilter<TInputImage, TOutputImage>
+::GetSampleRegion( unsigned long sample ) const
+{
+  InputIndexType startIndex;
+  this->GetInput()->TransformPhysicalPointToIndex(
+    this->m_PointSet->GetPoints()->GetElement( sample ), startIndex );
+
+  InputImageRegionType region( startIndex, this->m_Radius );
+  if( !region.Crop( this->GetInput()->GetLargestPossibleRegion() ) )
+    {
+    InputSizeType emptySize;
+    emptySize.Fill( 0 );
+    region.SetSize( emptySize );
+    }
+  return region;
+}
+
+template< class TInputImage, class TOutputImage >
+unsigned int
+AdaptiveOtsuThresholdImageFilter<TInputImage, TOutputImage>
+::ComputeOtsuBin( std::vector<double> & relativeFrequency )
+{
+  const unsigned int numberOfBins = relativeFrequency.size();
+  double totalPixels = 0.0;
+  for( unsigned int j = 0; j < numberOfBins; j++ )
+    {
+    totalPixels += relativeFrequency[j];
+    }
+  if( totalPixels == 0.0 )
+    {
+    return 0;
+    }
+
+  // normalize the frequencies
+  double totalMean = 0.0;
+  for( unsigned int j = 0; j < numberOfBins; j++ )
+    {
+    relativeFrequency[j] /= totalPixels;
+    totalMean += (j+1) * relativeFrequency[j];
+    }
+
+  // compute Otsu's threshold by maximizing the between-class
+  // variance
+  double freqLeft = relativeFrequency[0];
+  double meanLeft = 1.0;
+  double meanRight = freqLeft == 1.0 ? 0.0
+    : ( totalMean - freqLeft ) / ( 1.0 - freqLeft );
+
+  double maxVarBetween = freqLeft * ( 1.0 - freqLeft ) *
+    vnl_math_sqr( meanLeft - meanRight );
+  unsigned int maxBinNumber = 0;
+
+  double freqLeftOld = freqLeft;
+  double meanLeftOld = meanLeft;
+
+  for( unsigned int j = 1; j < numberOfBins; j++ )
+    {
+    freqLeft += relativeFrequency[j];
+    if( freqLeft == 0.0 )
+      {
+      // empty left class: the mean is undefined, the variance zero
+      continue;
+      }
+    meanLeft = ( meanLeftOld * freqLeftOld +
+                 (j+1) * relativeFrequency[j] ) / freqLeft;
+    if( freqLeft == 1.0 )
+      {
+      meanRight = 0.0;
+      }
+    else
+      {
+      meanRight = ( totalMean - meanLeft * freqLeft ) /
+        ( 1.0 - freqLeft );
+      }
+    double varBetween = freqLeft * ( 1.0 - freqLeft ) *
+      vnl_math_sqr( meanLeft - meanRight );
+
+    if( varBetween > maxVarBetween )
+      {
+      maxVarBetween = varBetween;
+      maxBinNumber = j;
+      }
+
+    // cache old values
+    freqLeftOld = freqLeft;
+    meanLeftOld = meanLeft;
+    }
+
+  return maxBinNumber;
+}
+
+template< class TInputImage, class TOutputImage >
+void
+AdaptiveOtsuThresholdImageFilter<TInputImage, TOutputImage>
+::ThreadedComputeLocalThresholds( ThreadIdType threadId, ThreadIdType numberOfThreads )
+{
+  const InputImageType * input = this->GetInput();
+  const unsigned long numberOfSamples = this->m_SampleThresholds.size();
+  SizeValueType first = 0;
+  SizeValueType last = 0;
+  StageThreaderType::SplitRange( numberOfSamples, threadId, numberOfThreads, first, last );
+
+  // scratch histogram, reused for all samples of this thread
+  std::vector<double> histogram( this->m_NumberOfHistogramBins );
+
+  for( unsigned long i = first; i < last; i++ )
+    {
+    const InputImageRegionType & region = this->m_SampleRegions[i];
+    if( region.GetNumberOfPixels() == 0 )
+      {
+      this->m_SampleThresholds[i] = NumericTraits< InputCoordType >::Zero;
+      continue;
+      }
+
+    // compute window max and min
+    InputIteratorType it( input, region );
+    InputPixelType windowMin = NumericTraits< InputPixelType >::max();
+    InputPixelType windowMax = NumericTraits< InputPixelType >::NonpositiveMin();
+    for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      const InputPixelType current = it.Get();
+      windowMin = windowMin > current ? current : windowMin;
+      windowMax = windowMax < current ? current : windowMax;
+      }
+
+    if( windowMin >= windowMax )
+      {
+      this->m_SampleThresholds[i] = static_cast< InputCoordType >( windowMin );
+      continue;
+      }
+
+    // fill the histogram
+    std::fill( histogram.begin(), histogram.end(), 0.0 );
+    const double binMultiplier = static_cast< double >( this->m_NumberOfHistogramBins ) /
+      ( static_cast< double >( windowMax ) - static_cast< double >( windowMin ) );
+    for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      const InputPixelType value = it.Get();
+      unsigned int binNumber = 0;
+      if( value != windowMin )
+        {
+        binNumber = static_cast< unsigned int >( vcl_ceil(
+          ( static_cast< double >( value ) - windowMin ) * binMultiplier ) ) - 1;
+        if( binNumber == this->m_NumberOfHistogramBins ) // in case of rounding errors
+          {
+          binNumber -= 1;
+          }
+        }
+      histogram[binNumber] += 1.0;
+      }
+
+    const unsigned int maxBinNumber = ComputeOtsuBin( histogram );
+    this->m_SampleThresholds[i] = static_cast< InputCoordType >(
+      static_cast< InputPixelType >( windowMin + ( maxBinNumber + 1 ) / binMultiplier ) );
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+AdaptiveOtsuThresholdImageFilter<TInputImage, TOutputImage>
+::ThreadedIntegrate( ThreadIdType threadId, ThreadIdType numberOfThreads )
+{
+  const InputImageType * input = this->GetInput();
+  const InputSizeType size = input->GetLargestPossibleRegion().GetSize();
+  const OffsetValueType * offsetTable = input->GetOffsetTable();
+  const unsigned int dim = this->m_IntegrationDimension;
+  const OffsetValueType stride = offsetTable[dim];
+  const unsigned long lineLength = size[dim];
+  const unsigned long numberOfLines = input->GetLargestPossibleRegion().GetNumberOfPixels() / lineLength;
+  SizeValueType first = 0;
+  SizeValueType last = 0;
+  StageThreaderType::SplitRange( numberOfLines, threadId, numberOfThreads, first, last );
+
+  const InputPixelType * inputBuffer = input->GetBufferPointer();
+  unsigned int * integral = &( this->m_IntegralHistogram[0] );
+  const double binMultiplier = this->m_GlobalBinMultiplier;
+  const double minimum = this->m_GlobalMinimum;
+  const unsigned int maxBin = this->m_NumberOfHistogramBins - 1;
+
+  for( unsigned long line = first; line < last; line++ )
+    {
+    // offset of the first pixel of the line
+    OffsetValueType offset = 0;
+    unsigned long remainder = line;
+    for( unsigned int k = 0; k < ImageDimension; k++ )
+      {
+      if( k == dim ) continue;
+      offset += static_cast< OffsetValueType >( remainder % size[k] ) * offsetTable[k];
+      remainder /= size[k];
+      }
+
+    if( dim == 0 )
+      {
+      // cumulative sum of the indicator of the current bin
+      unsigned int sum = 0;
+      for( unsigned long x = 0; x < lineLength; x++, offset += stride )
+        {
+        const double value = inputBuffer[offset];
+        unsigned int binNumber = 0;
+        if( value != minimum )
+          {
+          binNumber = vnl_math_min( static_cast< unsigned int >(
+            vcl_ceil( ( value - minimum ) * binMultiplier ) ) - 1, maxBin );
+          }
+        sum += ( binNumber == this->m_CurrentBin );
+        integral[offset] = sum;
+        }
+      }
+    else
+      {
+      unsigned int sum = 0;
+      for( unsigned long x = 0; x < lineLength; x++, offset += stride )
+        {
+        sum += integral[offset];
+        integral[offset] = sum;
+        }
+      }
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+AdaptiveOtsuThresholdImageFilter<TInputImage, TOutputImage>
+::ThreadedQueryIntegralHistogram( ThreadIdType threadId, ThreadIdType numberOfThreads )
+{
+  const InputImageType * input = this->GetInput();
+  const InputIndexType imageIndex = input->GetLargestPossibleRegion().GetIndex();
+  const OffsetValueType * offsetTable = input->GetOffsetTable();
+  const unsigned int * integral = &( this->m_IntegralHistogram[0] );
+  const unsigned long numberOfSamples = this->m_SampleThresholds.size();
+  SizeValueType first = 0;
+  SizeValueType last = 0;
+  StageThreaderType::SplitRange( numberOfSamples, threadId, numberOfThreads, first, last );
+  const unsigned int numberOfCorners = 1u << ImageDimension;
+
+  for( unsigned long i = first; i < last; i++ )
+    {
+    const InputImageRegionType & region = this->m_SampleRegions[i];
+    if( region.GetNumberOfPixels() == 0 ) continue;
+
+    // inclusion-exclusion over the corners of the window
+    long count = 0;
+    for( unsigned int corner = 0; corner < numberOfCorners; corner++ )
+      {
+      OffsetValueType offset = 0;
+      bool outside = false;
+      int sign = 1;
+      for( unsigned int k = 0; k < ImageDimension; k++ )
+        {
+        long index = region.GetIndex()[k] - imageIndex[k];
+        if( corner & ( 1u << k ) )
+          {
+          index += region.GetSize()[k] - 1;
+          }
+        else
+          {
+          index -= 1;
+          sign = -sign;
+          }
+        if( index < 0 )
+          {
+          outside = true;
+          break;
+          }
+        offset += index * offsetTable[k];
+        }
+      if( !outside )
+        {
+        count += sign * static_cast< long >( integral[offset] );
+        }
+      }
+
+    this->m_SampleHistograms[ i * this->m_NumberOfHistogramBins + this->m_CurrentBin ]
+      = static_cast< unsigned long >( count );
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+AdaptiveOtsuThresholdImageFilter<TInputImage, TOutputImage>
+::ComputeIntegralHistogramThresholds()
+{
+  const InputImageType * input = this->GetInput();
+  const unsigned long numberOfPixels = input->GetLargestPossibleRegion().GetNumberOfPixels();
+  const unsigned long numberOfSamples = this->m_SampleThresholds.size();
+  const unsigned int numberOfBins = this->m_NumberOfHistogramBins;
+
+  if( static_cast< double >( numberOfPixels ) > NumericTraits< unsigned int >::max() )
+    {
+    itkExceptionMacro( << "The image is too large for the integral histogram." );
+    }
+
+  // the global binning
+  InputPixelType imageMin = NumericTraits< InputPixelType >::max();
+  InputPixelType imageMax = NumericTraits< InputPixelType >::NonpositiveMin();
+  InputIteratorType it( input, input->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const InputPixelType current = it.Get();
+    imageMin = imageMin > current ? current : imageMin;
+    imageMax = imageMax < current ? current : imageMax;
+    }
+  if( imageMin >= imageMax )
+    {
+    std::fill( this->m_SampleThresholds.begin(), this->m_SampleThresholds.end(),
+      static_cast< InputCoordType >( imageMin ) );
+    return;
+    }
+  this->m_GlobalMinimum = static_cast< double >( imageMin );
+  this->m_GlobalBinMultiplier = static_cast< double >( numberOfBins ) /
+    ( static_cast< double >( imageMax ) - static_cast< double >( imageMin ) );
+
+  // the window histograms, one bin at a time
+  this->m_IntegralHistogram.resize( numberOfPixels );
+  this->m_SampleHistograms.assign( numberOfSamples * numberOfBins, 0 );
+  for( this->m_CurrentBin = 0; this->m_CurrentBin < numberOfBins; this->m_CurrentBin++ )
+    {
+    for( this->m_IntegrationDimension = 0;
+      this->m_IntegrationDimension < ImageDimension; this->m_IntegrationDimension++ )
+      {
+      this->ExecuteStage( &Self::ThreadedIntegrate );
+      }
+    this->ExecuteStage( &Self::ThreadedQueryIntegralHistogram );
+    }
+  std::vector<unsigned int>().swap( this->m_IntegralHistogram );
+
+  // Otsu's threshold per window
+  std::vector<double> histogram( numberOfBins );
+  for( unsigned long i = 0; i < numberOfSamples; i++ )
+    {
+    for( unsigned int j = 0; j < numberOfBins; j++ )
+      {
+      histogram[j] = static_cast< double >( this->m_SampleHistograms[ i * numberOfBins + j ] );
+      }
+    const unsigned int maxBinNumber = ComputeOtsuBin( histogram );
+    this->m_SampleThresholds[i] = static_cast< InputCoordType >(
+      static_cast< InputPixelType >( imageMin + ( maxBinNumber + 1 ) / this->m_GlobalBinMultiplier ) );
+    }
+  std::vector<unsigned long>().swap( this->m_SampleHistograms );
+}
+
 template< class TInputImage, class TOutputImage >
 void
 AdaptiveOtsuThresholdImageFilter<TInputImage, TOutputImage>
@@ -129,42 +493,41 @@ AdaptiveOtsuThresholdImageFilter<TInputImage, TOutputImage>
   OutputImagePointer output = this->GetOutput();
   InputConstImagePointer input  = this->GetInput();
   InputImageRegionType inputRegion = input->GetLargestPossibleRegion();
-  InputSizeType inputSize = inputRegion.GetSize();
-
-  InputIndexType startIndex;
-  InputImageRegionType region;
-  region.SetSize( this->m_Radius );
-
-  PointSetPointType point;
-  VectorPixelType V;
 
   if( !m_PointSet )
     {
     ComputeRandomPointSet();
     }
 
-  PointsContainerPointer
-    pointscontainer = this->m_PointSet->GetPoints();
-  PointDataContainerPointer pointdatacontainer =  this->m_PointSet->GetPointData();
-  for( unsigned long i = 0; i < this->m_NumberOfSamples; i++ )
-  {
-    point = pointscontainer->GetElement( i );
-    input->TransformPhysicalPointToIndex( point, startIndex );
-    region.SetIndex( startIndex );
-
-    ROIFilterPointer roi = ROIFilterType::New();
-    roi->SetInput( input );
-    roi->SetRegionOfInterest( region );
-    roi->Update();
-
-    OtsuThresholdPointer otsu = OtsuThresholdType::New();
-    otsu->SetImage( roi->GetOutput() );
-    otsu->SetNumberOfHistogramBins( this->m_NumberOfHistogramBins);
-    otsu->Compute();
-
-    V[0] = static_cast<InputCoordType>( otsu->GetThreshold() );
+  // the Otsu threshold in the window of every sample
+  const unsigned long numberOfSamples = this->m_PointSet->GetNumberOfPoints();
+  this->m_SampleThresholds.resize( numberOfSamples );
+  this->m_SampleRegions.resize( numberOfSamples );
+  for( unsigned long i = 0; i < numberOfSamples; i++ )
+    {
+    this->m_SampleRegions[i] = this->GetSampleRegion( i );
+    }
+
+  if( this->m_UseIntegralHistogram )
+    {
+    this->ComputeIntegralHistogramThresholds();
+    }
+  else
+    {
+    this->ExecuteStage( &Self::ThreadedComputeLocalThresholds );
+    }
+
+  PointDataContainerPointer pointdatacontainer = PointDataContainer::New();
+  pointdatacontainer->Reserve( numberOfSamples );
+  VectorPixelType V;
+  for( unsigned long i = 0; i < numberOfSamples; i++ )
+    {
+    V[0] = this->m_SampleThresholds[i];
     pointdatacontainer->SetElement( i, V );
-  }
+    }
+  this->m_PointSet->SetPointData( pointdatacontainer );
+  std::vector<InputCoordType>().swap( this->m_SampleThresholds );
+  std::vector<InputImageRegionType>().swap( this->m_SampleRegions );
 
   typename SDAFilterType::ArrayType ncps;
   ncps.Fill( this->m_NumberOfControlPoints );
@@ -187,7 +550,7 @@ AdaptiveOtsuThresholdImageFilter<TInputImage, TOutputImage>
   componentExtractor->Update();
   this->m_Threshold = componentExtractor->GetOutput();
 
-  OutputIteratorType Itt( this->m_Threshold, inputRegion );
+  ImageRegionConstIterator< CoordImageType > Itt( this->m_Threshold, inputRegion );
   Itt.GoToBegin();
 
   OutputIteratorType oIt( output, inputRegion );
@@ -196,7 +559,7 @@ AdaptiveOtsuThresholdImageFilter<TInputImage, TOutputImage>
   InputIteratorType iIt( input, inputRegion );
   iIt.GoToBegin();
 
-  OutputPixelType p;
+  InputCoordType p;
   while( !Itt.IsAtEnd() )
     {
     p = Itt.Get();
@@ -236,6 +599,8 @@ PrintSelf( std::ostream& os, Indent indent ) const
     std::endl;
   os << indent << "Outside value: " << GetOutsideValue() <<
     std::endl;
+  os << indent << "Use integral histogram: " << GetUseIntegralHistogram() <<
+    std::endl;
 }
 
 } /* end namespace itk */
@@ -20,6 +20,7 @@
 #include "itkObject.h"
 #include "itkObjectFactory.h"
 #include "itkNumericTraits.h"
+#include "itkThresholdHistogram.h"
 
 namespace itk
 {
@@ -73,6 +74,14 @@ public:
   /** Set the input image. */
   itkSetConstObjectMacro(Image,ImageType);
 
+  /** The histogram type. */
+  typedef ThresholdHistogram< TInputImage >         HistogramType;
+  typedef typename HistogramType::ConstPointer      HistogramConstPointer;
+
+  /** Set a precomputed histogram. The image, region and number of
+   * histogram bins are then ignored. */
+  itkSetConstObjectMacro( Histogram, HistogramType );
+
   /** Compute the MinError's threshold for the input image. */
   void Compute( void );
 
@@ -110,6 +119,7 @@ private:
   PixelType            m_Threshold;
   unsigned long        m_NumberOfHistogramBins;
   ImageConstPointer    m_Image;
+  HistogramConstPointer m_Histogram;
   RegionType           m_Region;
   bool                 m_RegionSetByUser;
   double         m_AlphaLeft;
@@ -18,8 +18,6 @@
 #define _itkMinErrorThresholdImageCalculator_txx
 
 #include "itkMinErrorThresholdImageCalculator.h"
-#include "itkImageRegionConstIteratorWithIndex.h"
-#include "itkMinimumMaximumImageCalculator.h"
 
 #include "vnl/vnl_math.h"
 #include <limits>
@@ -35,6 +33,7 @@ MinErrorThresholdImageCalculator<TInputImage>
 ::MinErrorThresholdImageCalculator()
 {
   this->m_Image = NULL;
+  this->m_Histogram = NULL;
   this->m_Threshold = NumericTraits<PixelType>::Zero;
   this->m_NumberOfHistogramBins = 128;
   this->m_RegionSetByUser = false;
@@ -80,72 +79,37 @@ MinErrorThresholdImageCalculator<TInputImage>
 
   unsigned int j, i;
 
-  if( !m_Image ) { return; }
-  if( !m_RegionSetByUser )
+  // compute image max and min, and the histogram
+  HistogramConstPointer histogram = this->m_Histogram;
+  if( histogram.IsNull() )
     {
-    this->m_Region = this->m_Image->GetRequestedRegion();
-    }
-
-  double totalPixels = (double) this->m_Region.GetNumberOfPixels();
-  if( totalPixels == 0 ) { return; }
-
+    if( !m_Image ) { return; }
 
-  // compute image max and min
-  typedef MinimumMaximumImageCalculator<TInputImage> RangeCalculator;
-  typename RangeCalculator::Pointer rangeCalculator = RangeCalculator::New();
-  rangeCalculator->SetImage( this->m_Image );
-  rangeCalculator->Compute();
-
-  PixelType imageMin = rangeCalculator->GetMinimum();
-  PixelType imageMax = rangeCalculator->GetMaximum();
+    typename HistogramType::Pointer newHistogram = HistogramType::New();
+    newHistogram->SetImage( this->m_Image );
+    if( this->m_RegionSetByUser )
+      {
+      newHistogram->SetRegion( this->m_Region );
+      }
+    newHistogram->SetNumberOfHistogramBins( this->m_NumberOfHistogramBins );
+    newHistogram->Compute();
+    histogram = newHistogram.GetPointer();
+    }
+  this->m_NumberOfHistogramBins = histogram->GetNumberOfHistogramBins();
 
-  if( imageMin >= imageMax )
+  PixelType imageMin = histogram->GetMinimum();
+  if( histogram->IsDegenerate() )
     {
     this->m_Threshold = imageMin;
     return;
     }
 
   // create the histogram and the error functions
-  std::vector<double> relativeFrequency;
-  std::vector<double> errorFunctionPois;
-  std::vector<double> errorFunctionGaus;
-
-  relativeFrequency.resize( this->m_NumberOfHistogramBins );
-  errorFunctionPois.resize( this->m_NumberOfHistogramBins );
-  errorFunctionGaus.resize( this->m_NumberOfHistogramBins );
-  for ( j = 0; j < this->m_NumberOfHistogramBins; j++ )
-    {
-    relativeFrequency[j] = errorFunctionPois[j] = errorFunctionGaus[j] = 0.0;
-    }
-
-  double binMultiplier = (double) this->m_NumberOfHistogramBins /
-    (double) ( imageMax - imageMin );
-
-  typedef ImageRegionConstIteratorWithIndex<TInputImage> Iterator;
-  Iterator iter( this->m_Image, this->m_Region );
-
-  while ( !iter.IsAtEnd() )
-    {
-    unsigned int binNumber;
-    PixelType value = iter.Get();
-
-    if( value == imageMin )
-      {
-      binNumber = 0;
-      }
-    else
-      {
-      binNumber = (unsigned int) vcl_ceil((value - imageMin) * binMultiplier ) - 1;
-      if( binNumber == this->m_NumberOfHistogramBins ) // in case of rounding errors
-        {
-        binNumber -= 1;
-        }
-      }
-
-    relativeFrequency[binNumber] += 1.0;
-    ++iter;
-
-    }
+  std::vector<double> relativeFrequency = histogram->GetFrequencies();
+  std::vector<double> errorFunctionPois( this->m_NumberOfHistogramBins, 0.0 );
+  std::vector<double> errorFunctionGaus( this->m_NumberOfHistogramBins, 0.0 );
+  const double totalPixels = histogram->GetTotalFrequency();
+  const double binMultiplier = histogram->GetBinMultiplier();
 
   // normalize the histogram
   double totalMean = 0.0;
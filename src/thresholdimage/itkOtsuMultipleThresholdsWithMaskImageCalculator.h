@@ -0,0 +1,160 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkOtsuMultipleThresholdsWithMaskImageCalculator_h
+#define __itkOtsuMultipleThresholdsWithMaskImageCalculator_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkNumericTraits.h"
+#include "itkThresholdHistogram.h"
+#include <vector>
+
+namespace itk
+{
+
+/** \class OtsuMultipleThresholdsWithMaskImageCalculator
+ * \brief Computes multiple Otsu thresholds for an image.
+ *
+ * The thresholds split the histogram in NumberOfThresholds + 1 classes
+ * such that the between-class variance is maximal. Instead of trying all
+ * combinations of thresholds, the optimum is found by dynamic programming
+ * over prefix sums of the histogram. Since maximizing the between-class
+ * variance is the same as minimizing the within-class sum of squares,
+ * the optimal split points are monotone, and every layer of the dynamic
+ * program is solved by divide and conquer. The cost is
+ * O( NumberOfThresholds * bins * log( bins ) ), so many thresholds on
+ * thousands of bins are cheap.
+ *
+ * The thresholds are the upper bounds of the last bin of each class. The
+ * histogram is computed with a ThresholdHistogram, unless one is provided
+ * with SetHistogram().
+ *
+ * \ingroup Operators
+ */
+template <class TInputImage>
+class ITK_EXPORT OtsuMultipleThresholdsWithMaskImageCalculator : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef OtsuMultipleThresholdsWithMaskImageCalculator Self;
+  typedef Object                                        Superclass;
+  typedef SmartPointer<Self>                            Pointer;
+  typedef SmartPointer<const Self>                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( OtsuMultipleThresholdsWithMaskImageCalculator, Object );
+
+  /** Image related typedefs. */
+  typedef TInputImage                               ImageType;
+  typedef typename ImageType::ConstPointer          ImageConstPointer;
+  typedef typename ImageType::PixelType             PixelType;
+  typedef typename ImageType::RegionType            RegionType;
+  typedef ThresholdHistogram< TInputImage >         HistogramType;
+  typedef typename HistogramType::ConstPointer      HistogramConstPointer;
+  typedef typename HistogramType::MaskImageType     MaskImageType;
+  typedef typename MaskImageType::ConstPointer      MaskImageConstPointer;
+  typedef std::vector<double>                       ThresholdVectorType;
+  typedef std::vector<unsigned long>                BinVectorType;
+
+  /** Set the input image. */
+  itkSetConstObjectMacro( Image, ImageType );
+
+  /** Set the mask image. */
+  itkSetConstObjectMacro( MaskImage, MaskImageType );
+
+  /** Set a precomputed histogram. The image, mask and number of
+   * histogram bins are then ignored. */
+  itkSetConstObjectMacro( Histogram, HistogramType );
+
+  /** Set/Get the number of histogram bins. Default is 128. */
+  itkSetClampMacro( NumberOfHistogramBins, unsigned long, 1,
+                    NumericTraits<unsigned long>::max() );
+  itkGetConstMacro( NumberOfHistogramBins, unsigned long );
+
+  /** Set/Get the number of thresholds. Default is 1. */
+  itkSetClampMacro( NumberOfThresholds, unsigned long, 1,
+                    NumericTraits<unsigned long>::max() );
+  itkGetConstMacro( NumberOfThresholds, unsigned long );
+
+  /** Compute the thresholds. */
+  void Compute( void );
+
+  /** Get the thresholds, in increasing order. */
+  const ThresholdVectorType & GetThresholds( void ) const
+  {
+    return this->m_Thresholds;
+  }
+
+  /** Get the last bin of every class but the last. */
+  const BinVectorType & GetThresholdBins( void ) const
+  {
+    return this->m_ThresholdBins;
+  }
+
+protected:
+  OtsuMultipleThresholdsWithMaskImageCalculator();
+  virtual ~OtsuMultipleThresholdsWithMaskImageCalculator() {};
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** The between-class variance term of a class of bins [first,last]. */
+  inline double ClassTerm( unsigned long first, unsigned long last ) const
+  {
+    const double weight = this->m_CumulativeFrequency[ last + 1 ]
+      - this->m_CumulativeFrequency[ first ];
+    const double sum = this->m_CumulativeMoment[ last + 1 ]
+      - this->m_CumulativeMoment[ first ];
+    return weight > 0.0 ? sum * sum / weight : 0.0;
+  }
+
+  /** Fill layer k of the dynamic program for the bins [first,last], knowing
+   * that the optimal start of the last class is in [firstStart,lastStart]. */
+  void ComputeLayer( unsigned long k,
+    unsigned long first, unsigned long last,
+    unsigned long firstStart, unsigned long lastStart );
+
+private:
+  OtsuMultipleThresholdsWithMaskImageCalculator( const Self& ); //purposely not implemented
+  void operator=( const Self& ); //purposely not implemented
+
+  ImageConstPointer       m_Image;
+  MaskImageConstPointer   m_MaskImage;
+  HistogramConstPointer   m_Histogram;
+  unsigned long           m_NumberOfHistogramBins;
+  unsigned long           m_NumberOfThresholds;
+
+  ThresholdVectorType     m_Thresholds;
+  BinVectorType           m_ThresholdBins;
+
+  /** Prefix sums of the histogram and the tables of the dynamic program. */
+  std::vector<double>                         m_CumulativeFrequency;
+  std::vector<double>                         m_CumulativeMoment;
+  std::vector< std::vector<double> >          m_Score;
+  std::vector< std::vector<unsigned long> >   m_ClassStart;
+
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkOtsuMultipleThresholdsWithMaskImageCalculator.txx"
+#endif
+
+#endif
@@ -0,0 +1,181 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkOtsuMultipleThresholdsWithMaskImageCalculator_txx
+#define __itkOtsuMultipleThresholdsWithMaskImageCalculator_txx
+
+#include "itkOtsuMultipleThresholdsWithMaskImageCalculator.h"
+#include <algorithm>
+
+namespace itk
+{
+
+/**
+ * Constructor
+ */
+template<class TInputImage>
+OtsuMultipleThresholdsWithMaskImageCalculator<TInputImage>
+::OtsuMultipleThresholdsWithMaskImageCalculator()
+{
+  this->m_Image = NULL;
+  this->m_MaskImage = NULL;
+  this->m_Histogram = NULL;
+  this->m_NumberOfHistogramBins = 128;
+  this->m_NumberOfThresholds = 1;
+}
+
+
+/**
+ * One layer of the dynamic program, by divide and conquer
+ */
+template<class TInputImage>
+void
+OtsuMultipleThresholdsWithMaskImageCalculator<TInputImage>
+::ComputeLayer( unsigned long k,
+  unsigned long first, unsigned long last,
+  unsigned long firstStart, unsigned long lastStart )
+{
+  if( first > last ) return;
+
+  const unsigned long mid = first + ( last - first ) / 2;
+  const std::vector<double> & previous = this->m_Score[ k - 1 ];
+
+  // the last class is [start,mid]; take the smallest optimal start
+  const unsigned long maxStart = std::min( mid, lastStart );
+  double bestScore = NumericTraits<double>::NonpositiveMin();
+  unsigned long bestStart = firstStart;
+  for( unsigned long start = firstStart; start <= maxStart; ++start )
+  {
+    const double score = previous[ start - 1 ] + this->ClassTerm( start, mid );
+    if( score > bestScore )
+    {
+      bestScore = score;
+      bestStart = start;
+    }
+  }
+  this->m_Score[ k ][ mid ] = bestScore;
+  this->m_ClassStart[ k ][ mid ] = bestStart;
+
+  if( mid > first )
+  {
+    this->ComputeLayer( k, first, mid - 1, firstStart, bestStart );
+  }
+  this->ComputeLayer( k, mid + 1, last, bestStart, lastStart );
+}
+
+
+/**
+ * Compute the thresholds
+ */
+template<class TInputImage>
+void
+OtsuMultipleThresholdsWithMaskImageCalculator<TInputImage>
+::Compute( void )
+{
+  // the histogram
+  HistogramConstPointer histogram = this->m_Histogram;
+  if( histogram.IsNull() )
+  {
+    if( !this->m_Image ) { return; }
+
+    typename HistogramType::Pointer newHistogram = HistogramType::New();
+    newHistogram->SetImage( this->m_Image );
+    newHistogram->SetMaskImage( this->m_MaskImage );
+    newHistogram->SetNumberOfHistogramBins( this->m_NumberOfHistogramBins );
+    newHistogram->Compute();
+    histogram = newHistogram.GetPointer();
+  }
+
+  const unsigned long numberOfThresholds = this->m_NumberOfThresholds;
+  this->m_Thresholds.assign( numberOfThresholds,
+    static_cast<double>( histogram->GetMinimum() ) );
+  this->m_ThresholdBins.assign( numberOfThresholds, 0 );
+  if( histogram->IsDegenerate() ) { return; }
+
+  const std::vector<double> & frequencies = histogram->GetFrequencies();
+  const unsigned long numberOfBins = frequencies.size();
+  if( numberOfBins <= numberOfThresholds )
+  {
+    itkExceptionMacro( << "The number of histogram bins (" << numberOfBins
+      << ") should be larger than the number of thresholds ("
+      << numberOfThresholds << ")." );
+  }
+
+  // prefix sums of the frequencies and first moments
+  this->m_CumulativeFrequency.assign( numberOfBins + 1, 0.0 );
+  this->m_CumulativeMoment.assign( numberOfBins + 1, 0.0 );
+  for( unsigned long j = 0; j < numberOfBins; ++j )
+  {
+    this->m_CumulativeFrequency[ j + 1 ] = this->m_CumulativeFrequency[ j ] + frequencies[ j ];
+    this->m_CumulativeMoment[ j + 1 ] = this->m_CumulativeMoment[ j ] + ( j + 1 ) * frequencies[ j ];
+  }
+
+  // m_Score[ k ][ b ]: the best score of bins [0,b] in k + 1 classes
+  this->m_Score.assign( numberOfThresholds + 1,
+    std::vector<double>( numberOfBins, NumericTraits<double>::NonpositiveMin() ) );
+  this->m_ClassStart.assign( numberOfThresholds + 1,
+    std::vector<unsigned long>( numberOfBins, 0 ) );
+  for( unsigned long b = 0; b < numberOfBins; ++b )
+  {
+    this->m_Score[ 0 ][ b ] = this->ClassTerm( 0, b );
+  }
+  for( unsigned long k = 1; k <= numberOfThresholds; ++k )
+  {
+    this->ComputeLayer( k, k, numberOfBins - 1, k, numberOfBins - 1 );
+  }
+
+  // trace back the class boundaries
+  unsigned long last = numberOfBins - 1;
+  for( unsigned long k = numberOfThresholds; k > 0; --k )
+  {
+    const unsigned long start = this->m_ClassStart[ k ][ last ];
+    this->m_ThresholdBins[ k - 1 ] = start - 1;
+    this->m_Thresholds[ k - 1 ] = histogram->GetBinUpperBound( start - 1 );
+    last = start - 1;
+  }
+
+  std::vector<double>().swap( this->m_CumulativeFrequency );
+  std::vector<double>().swap( this->m_CumulativeMoment );
+  std::vector< std::vector<double> >().swap( this->m_Score );
+  std::vector< std::vector<unsigned long> >().swap( this->m_ClassStart );
+}
+
+
+/**
+ * PrintSelf
+ */
+template<class TInputImage>
+void
+OtsuMultipleThresholdsWithMaskImageCalculator<TInputImage>
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "NumberOfHistogramBins: " << this->m_NumberOfHistogramBins << std::endl;
+  os << indent << "NumberOfThresholds: " << this->m_NumberOfThresholds << std::endl;
+  os << indent << "Thresholds:";
+  for( unsigned long i = 0; i < this->m_Thresholds.size(); ++i )
+  {
+    os << " " << this->m_Thresholds[ i ];
+  }
+  os << std::endl;
+  os << indent << "Image: " << this->m_Image.GetPointer() << std::endl;
+}
+
+} // end namespace itk
+
+#endif
@@ -20,6 +20,7 @@
 #include "itkObject.h"
 #include "itkObjectFactory.h"
 #include "itkNumericTraits.h"
+#include "itkThresholdHistogram.h"
 
 namespace itk
 {
@@ -32,6 +33,10 @@ namespace itk
  * histogram of image intensities. The basic idea is to maximize the
  * between-class variance.
  *
+ * The histogram is computed with a ThresholdHistogram, unless one is
+ * provided with SetHistogram(), in which case the image, mask, region
+ * and number of bins are ignored.
+ *
  * This class is templated over the input image type.
  *
  * \warning This method assumes that the input image consists of scalar pixel
@@ -84,6 +89,13 @@ public:
   /** Set the mask image */
   itkSetObjectMacro( MaskImage, MaskImageType );
 
+  /** The histogram type. */
+  typedef ThresholdHistogram< TInputImage >         HistogramType;
+  typedef typename HistogramType::ConstPointer      HistogramConstPointer;
+
+  /** Set a precomputed histogram. */
+  itkSetConstObjectMacro( Histogram, HistogramType );
+
   /** Compute the Otsu's threshold for the input image. */
   void Compute( void );
 
@@ -111,6 +123,7 @@ private:
   unsigned long         m_NumberOfHistogramBins;
   ImageConstPointer     m_Image;
   MaskImagePointer      m_MaskImage;
+  HistogramConstPointer m_Histogram;
   RegionType            m_Region;
   bool                  m_RegionSetByUser;
 
@@ -19,9 +19,6 @@
 
 #include "itkOtsuThresholdWithMaskImageCalculator.h"
 
-#include "itkImageRegionConstIteratorWithIndex.h"
-#include "itkImageRegionConstIterator.h"
-
 #include "vnl/vnl_math.h"
 
 namespace itk
@@ -36,6 +33,7 @@ OtsuThresholdWithMaskImageCalculator<TInputImage>
 {
   this->m_Image = NULL;
   this->m_MaskImage = NULL;
+  this->m_Histogram = NULL;
   this->m_Threshold = NumericTraits<PixelType>::Zero;
   this->m_NumberOfHistogramBins = 128;
   this->m_RegionSetByUser = false;
@@ -52,100 +50,36 @@ OtsuThresholdWithMaskImageCalculator<TInputImage>
 {
   unsigned int j;
 
-  if( !m_Image ) { return; }
-  if( !m_RegionSetByUser )
+  // compute image max and min, and the histogram
+  HistogramConstPointer histogram = this->m_Histogram;
+  if( histogram.IsNull() )
   {
-    this->m_Region = this->m_Image->GetRequestedRegion();
-  }
-
-  double totalPixels = (double) this->m_Region.GetNumberOfPixels();
-  if( totalPixels == 0 ) { return; }
-  totalPixels = 0.0;
-
-  typedef ImageRegionConstIteratorWithIndex<ImageType> IteratorType;
-  IteratorType iter( this->m_Image, this->m_Region );
-  iter.GoToBegin();
-
-  typedef ImageRegionConstIterator<MaskImageType> MaskIteratorType;
-  MaskIteratorType itMask;
-  if( this->m_MaskImage )
-  {
-    itMask = MaskIteratorType( this->m_MaskImage, this->m_Region );
-    itMask.GoToBegin();
-  }
+    if( !m_Image ) { return; }
 
-  // compute image max and min
-  PixelType imageMin = NumericTraits<PixelType>::max();
-  PixelType imageMax = NumericTraits<PixelType>::NonpositiveMin();
-  while ( !iter.IsAtEnd() )
-  {
-    if( this->m_MaskImage && itMask.Value() == 0 )
+    typename HistogramType::Pointer newHistogram = HistogramType::New();
+    newHistogram->SetImage( this->m_Image );
+    newHistogram->SetMaskImage( this->m_MaskImage );
+    if( this->m_RegionSetByUser )
     {
-      ++iter; ++itMask;
-      continue;
+      newHistogram->SetRegion( this->m_Region );
     }
-
-    PixelType current = iter.Value();
-    imageMin = imageMin > current ? current : imageMin;
-    imageMax = imageMax < current ? current : imageMax;
-
-    ++iter;
-    if( this->m_MaskImage ) ++itMask;
+    newHistogram->SetNumberOfHistogramBins( this->m_NumberOfHistogramBins );
+    newHistogram->Compute();
+    histogram = newHistogram.GetPointer();
   }
 
-  if( imageMin >= imageMax )
+  if( histogram->IsDegenerate() )
   {
-    this->m_Threshold = imageMin;
+    this->m_Threshold = histogram->GetMinimum();
     return;
   }
 
-  // create a histogram
-  std::vector<double> relativeFrequency;
-  relativeFrequency.resize( this->m_NumberOfHistogramBins );
-  for ( j = 0; j < this->m_NumberOfHistogramBins; j++ )
-    {
-    relativeFrequency[j] = 0.0;
-    }
-
-  double binMultiplier = (double) this->m_NumberOfHistogramBins /
-    (double) ( imageMax - imageMin );
-
-  iter.GoToBegin();
-  if( this->m_MaskImage ) itMask.GoToBegin();
-  while ( !iter.IsAtEnd() )
-  {
-    if( this->m_MaskImage && itMask.Value() == 0 )
-    {
-      ++iter; ++itMask;
-      continue;
-    }
-
-    unsigned int binNumber;
-    PixelType value = iter.Get();
-
-    if( value == imageMin )
-      {
-      binNumber = 0;
-      }
-    else
-      {
-      binNumber = (unsigned int) vcl_ceil((value - imageMin) * binMultiplier ) - 1;
-      if( binNumber == this->m_NumberOfHistogramBins ) // in case of rounding errors
-        {
-        binNumber -= 1;
-        }
-      }
-
-    relativeFrequency[binNumber] += 1.0;
-    totalPixels += 1.0;
-
-    ++iter;
-    if( this->m_MaskImage ) ++itMask;
-  }
-
   // normalize the frequencies
+  std::vector<double> relativeFrequency = histogram->GetFrequencies();
+  const unsigned long numberOfHistogramBins = relativeFrequency.size();
+  const double totalPixels = histogram->GetTotalFrequency();
   double totalMean = 0.0;
-  for ( j = 0; j < this->m_NumberOfHistogramBins; j++ )
+  for ( j = 0; j < numberOfHistogramBins; j++ )
     {
     relativeFrequency[j] /= totalPixels;
     totalMean += (j+1) * relativeFrequency[j];
@@ -165,7 +99,7 @@ OtsuThresholdWithMaskImageCalculator<TInputImage>
   double freqLeftOld = freqLeft;
   double meanLeftOld = meanLeft;
 
-  for ( j = 1; j < this->m_NumberOfHistogramBins; j++ )
+  for ( j = 1; j < numberOfHistogramBins; j++ )
     {
     freqLeft += relativeFrequency[j];
     meanLeft = ( meanLeftOld * freqLeftOld +
@@ -194,8 +128,8 @@ OtsuThresholdWithMaskImageCalculator<TInputImage>
 
     }
 
-  this->m_Threshold = static_cast<PixelType>( imageMin +
-                                        ( maxBinNumber + 1 ) / binMultiplier );
+  this->m_Threshold = static_cast<PixelType>(
+    histogram->GetBinUpperBound( maxBinNumber ) );
 }
 
 template<class TInputImage>
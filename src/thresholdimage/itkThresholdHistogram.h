@@ -0,0 +1,171 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkThresholdHistogram_h
+#define __itkThresholdHistogram_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkNumericTraits.h"
+#include "itkImage.h"
+#include "itkMultiThreader.h"
+#include "itkStageMultiThreader.h"
+#include <vector>
+
+namespace itk
+{
+
+/** \class ThresholdHistogram
+ * \brief The intensity histogram on which the histogram based threshold
+ * calculators operate.
+ *
+ * The histogram has NumberOfHistogramBins bins between the minimum and
+ * maximum intensity. The minimum falls in bin 0, and a value v > minimum
+ * falls in bin ceil( ( v - minimum ) * BinMultiplier ) - 1, so the upper
+ * bound of bin j is minimum + ( j + 1 ) / BinMultiplier. Only the pixels
+ * where the optional mask is nonzero are counted.
+ *
+ * The minimum, maximum and histogram are computed in parallel. Compute it
+ * once and pass it to several calculators to avoid recomputing it.
+ *
+ * \ingroup Operators Multithreaded
+ */
+template <class TInputImage>
+class ITK_EXPORT ThresholdHistogram : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ThresholdHistogram          Self;
+  typedef Object                      Superclass;
+  typedef SmartPointer<Self>          Pointer;
+  typedef SmartPointer<const Self>    ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( ThresholdHistogram, Object );
+
+  /** Image related typedefs. */
+  itkStaticConstMacro( ImageDimension, unsigned int,
+    TInputImage::ImageDimension );
+  typedef TInputImage                           ImageType;
+  typedef typename ImageType::ConstPointer      ImageConstPointer;
+  typedef typename ImageType::PixelType         PixelType;
+  typedef typename ImageType::RegionType        RegionType;
+  typedef Image< unsigned char,
+    itkGetStaticConstMacro( ImageDimension ) >  MaskImageType;
+  typedef typename MaskImageType::ConstPointer  MaskImageConstPointer;
+  typedef std::vector<double>                   FrequencyContainerType;
+
+  /** Set the input image. */
+  itkSetConstObjectMacro( Image, ImageType );
+
+  /** Set the mask image. */
+  itkSetConstObjectMacro( MaskImage, MaskImageType );
+
+  /** Set/Get the number of histogram bins. Default is 128. */
+  itkSetClampMacro( NumberOfHistogramBins, unsigned long, 1,
+                    NumericTraits<unsigned long>::max() );
+  itkGetConstMacro( NumberOfHistogramBins, unsigned long );
+
+  /** Set/Get the number of threads. Default the global default. */
+  itkSetClampMacro( NumberOfThreads, ThreadIdType, 1,
+                    NumericTraits<ThreadIdType>::max() );
+  itkGetConstMacro( NumberOfThreads, ThreadIdType );
+
+  /** Set the region over which the histogram is computed. */
+  void SetRegion( const RegionType & region );
+
+  /** Compute the minimum, maximum and histogram. */
+  void Compute( void );
+
+  /** The number of pixels in each bin. */
+  const FrequencyContainerType & GetFrequencies( void ) const
+  {
+    return this->m_Frequencies;
+  }
+
+  /** Get the results. */
+  itkGetConstMacro( Minimum, PixelType );
+  itkGetConstMacro( Maximum, PixelType );
+  itkGetConstMacro( BinMultiplier, double );
+  itkGetConstMacro( TotalFrequency, double );
+
+  /** True if there are no (masked) pixels, or if they are all equal.
+   * The histogram is then empty. */
+  bool IsDegenerate( void ) const
+  {
+    return !( this->m_Minimum < this->m_Maximum );
+  }
+
+  /** The upper bound of a bin, which is the threshold that puts this and
+   * all lower bins in the lower class. */
+  double GetBinUpperBound( unsigned long bin ) const
+  {
+    return static_cast<double>( this->m_Minimum ) + ( bin + 1 ) / this->m_BinMultiplier;
+  }
+
+  /** The center of a bin. */
+  double GetBinCenter( unsigned long bin ) const
+  {
+    return static_cast<double>( this->m_Minimum ) + ( bin + 0.5 ) / this->m_BinMultiplier;
+  }
+
+protected:
+  ThresholdHistogram();
+  virtual ~ThresholdHistogram() {};
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  typedef StageMultiThreader<Self> StageThreaderType;
+
+  /** The stages, run with StageThreaderType::Execute(). */
+  void ThreadedComputeMinimumMaximum( ThreadIdType threadId, ThreadIdType numberOfThreads );
+  void ThreadedComputeHistogram( ThreadIdType threadId, ThreadIdType numberOfThreads );
+
+private:
+  ThresholdHistogram( const Self& ); //purposely not implemented
+  void operator=( const Self& ); //purposely not implemented
+
+  ImageConstPointer       m_Image;
+  MaskImageConstPointer   m_MaskImage;
+  RegionType              m_Region;
+  bool                    m_RegionSetByUser;
+  unsigned long           m_NumberOfHistogramBins;
+  ThreadIdType            m_NumberOfThreads;
+  MultiThreader::Pointer  m_Threader;
+
+  PixelType               m_Minimum;
+  PixelType               m_Maximum;
+  double                  m_BinMultiplier;
+  double                  m_TotalFrequency;
+  FrequencyContainerType  m_Frequencies;
+
+  /** Per thread results. */
+  std::vector<PixelType>                    m_ThreadMinimum;
+  std::vector<PixelType>                    m_ThreadMaximum;
+  std::vector< std::vector<SizeValueType> > m_ThreadFrequencies;
+
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkThresholdHistogram.txx"
+#endif
+
+#endif
@@ -0,0 +1,240 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkThresholdHistogram_txx
+#define __itkThresholdHistogram_txx
+
+#include "itkThresholdHistogram.h"
+
+#include "itkImageRegionConstIterator.h"
+#include "vnl/vnl_math.h"
+
+namespace itk
+{
+
+/**
+ * Constructor
+ */
+template<class TInputImage>
+ThresholdHistogram<TInputImage>
+::ThresholdHistogram()
+{
+  this->m_Image = NULL;
+  this->m_MaskImage = NULL;
+  this->m_RegionSetByUser = false;
+  this->m_NumberOfHistogramBins = 128;
+  this->m_Threader = MultiThreader::New();
+  this->m_NumberOfThreads = this->m_Threader->GetNumberOfThreads();
+
+  this->m_Minimum = NumericTraits<PixelType>::max();
+  this->m_Maximum = NumericTraits<PixelType>::NonpositiveMin();
+  this->m_BinMultiplier = 1.0;
+  this->m_TotalFrequency = 0.0;
+}
+
+
+/**
+ * Set the region
+ */
+template<class TInputImage>
+void
+ThresholdHistogram<TInputImage>
+::SetRegion( const RegionType & region )
+{
+  this->m_Region = region;
+  this->m_RegionSetByUser = true;
+}
+
+
+/**
+ * Minimum and maximum of the part of a thread
+ */
+template<class TInputImage>
+void
+ThresholdHistogram<TInputImage>
+::ThreadedComputeMinimumMaximum( ThreadIdType threadId, ThreadIdType numberOfThreads )
+{
+  PixelType minimum = NumericTraits<PixelType>::max();
+  PixelType maximum = NumericTraits<PixelType>::NonpositiveMin();
+
+  RegionType region;
+  if( StageThreaderType::SplitRegion( this->m_Region, threadId, numberOfThreads, region ) )
+  {
+    ImageRegionConstIterator<ImageType> iter( this->m_Image, region );
+    if( this->m_MaskImage.IsNull() )
+    {
+      for( iter.GoToBegin(); !iter.IsAtEnd(); ++iter )
+      {
+        const PixelType current = iter.Value();
+        minimum = minimum > current ? current : minimum;
+        maximum = maximum < current ? current : maximum;
+      }
+    }
+    else
+    {
+      ImageRegionConstIterator<MaskImageType> itMask( this->m_MaskImage, region );
+      for( iter.GoToBegin(), itMask.GoToBegin(); !iter.IsAtEnd(); ++iter, ++itMask )
+      {
+        if( itMask.Value() == 0 ) continue;
+        const PixelType current = iter.Value();
+        minimum = minimum > current ? current : minimum;
+        maximum = maximum < current ? current : maximum;
+      }
+    }
+  }
+
+  this->m_ThreadMinimum[ threadId ] = minimum;
+  this->m_ThreadMaximum[ threadId ] = maximum;
+}
+
+
+/**
+ * Histogram of the part of a thread
+ */
+template<class TInputImage>
+void
+ThresholdHistogram<TInputImage>
+::ThreadedComputeHistogram( ThreadIdType threadId, ThreadIdType numberOfThreads )
+{
+  std::vector<SizeValueType> & frequencies = this->m_ThreadFrequencies[ threadId ];
+  frequencies.assign( this->m_NumberOfHistogramBins, 0 );
+
+  RegionType region;
+  if( !StageThreaderType::SplitRegion( this->m_Region, threadId, numberOfThreads, region ) ) return;
+
+  const PixelType imageMin = this->m_Minimum;
+  const double imageMinAsDouble = static_cast<double>( imageMin );
+  const double binMultiplier = this->m_BinMultiplier;
+  const unsigned long lastBin = this->m_NumberOfHistogramBins - 1;
+
+  ImageRegionConstIterator<ImageType> iter( this->m_Image, region );
+  ImageRegionConstIterator<MaskImageType> itMask;
+  if( this->m_MaskImage.IsNotNull() )
+  {
+    itMask = ImageRegionConstIterator<MaskImageType>( this->m_MaskImage, region );
+    itMask.GoToBegin();
+  }
+
+  for( iter.GoToBegin(); !iter.IsAtEnd(); ++iter )
+  {
+    if( this->m_MaskImage.IsNotNull() )
+    {
+      const bool inside = itMask.Value() != 0;
+      ++itMask;
+      if( !inside ) continue;
+    }
+
+    const PixelType value = iter.Value();
+    unsigned long binNumber = 0;
+    if( value != imageMin )
+    {
+      /** In double, since value - imageMin overflows the pixel type (or
+       * the int it is promoted to) for wide ranges of integer pixels. */
+      const double bin = vcl_ceil(
+        ( static_cast<double>( value ) - imageMinAsDouble ) * binMultiplier ) - 1.0;
+      if( bin >= static_cast<double>( lastBin ) ) // in case of rounding errors
+      {
+        binNumber = lastBin;
+      }
+      else if( bin > 0.0 )
+      {
+        binNumber = static_cast<unsigned long>( bin );
+      }
+    }
+    ++frequencies[ binNumber ];
+  }
+}
+
+
+/**
+ * Compute the histogram
+ */
+template<class TInputImage>
+void
+ThresholdHistogram<TInputImage>
+::Compute( void )
+{
+  if( !this->m_Image ) { return; }
+  if( !this->m_RegionSetByUser )
+  {
+    this->m_Region = this->m_Image->GetRequestedRegion();
+  }
+
+  this->m_Frequencies.assign( this->m_NumberOfHistogramBins, 0.0 );
+  this->m_TotalFrequency = 0.0;
+  this->m_Minimum = NumericTraits<PixelType>::max();
+  this->m_Maximum = NumericTraits<PixelType>::NonpositiveMin();
+  if( this->m_Region.GetNumberOfPixels() == 0 ) { return; }
+
+  /** The range. */
+  this->m_ThreadMinimum.resize( this->m_NumberOfThreads );
+  this->m_ThreadMaximum.resize( this->m_NumberOfThreads );
+  StageThreaderType::Execute( this->m_Threader, this->m_NumberOfThreads,
+    this, &Self::ThreadedComputeMinimumMaximum );
+  for( ThreadIdType i = 0; i < this->m_NumberOfThreads; ++i )
+  {
+    const PixelType & minimum = this->m_ThreadMinimum[ i ];
+    const PixelType & maximum = this->m_ThreadMaximum[ i ];
+    this->m_Minimum = this->m_Minimum > minimum ? minimum : this->m_Minimum;
+    this->m_Maximum = this->m_Maximum < maximum ? maximum : this->m_Maximum;
+  }
+  if( this->IsDegenerate() ) { return; }
+
+  /** The histogram. */
+  this->m_BinMultiplier = static_cast<double>( this->m_NumberOfHistogramBins ) /
+    ( static_cast<double>( this->m_Maximum ) - static_cast<double>( this->m_Minimum ) );
+  this->m_ThreadFrequencies.resize( this->m_NumberOfThreads );
+  StageThreaderType::Execute( this->m_Threader, this->m_NumberOfThreads,
+    this, &Self::ThreadedComputeHistogram );
+  for( ThreadIdType i = 0; i < this->m_NumberOfThreads; ++i )
+  {
+    const std::vector<SizeValueType> & frequencies = this->m_ThreadFrequencies[ i ];
+    for( unsigned long j = 0; j < frequencies.size(); ++j )
+    {
+      this->m_Frequencies[ j ] += frequencies[ j ];
+    }
+    std::vector<SizeValueType>().swap( this->m_ThreadFrequencies[ i ] );
+  }
+  for( unsigned long j = 0; j < this->m_NumberOfHistogramBins; ++j )
+  {
+    this->m_TotalFrequency += this->m_Frequencies[ j ];
+  }
+}
+
+
+/**
+ * PrintSelf
+ */
+template<class TInputImage>
+void
+ThresholdHistogram<TInputImage>
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "NumberOfHistogramBins: " << this->m_NumberOfHistogramBins << std::endl;
+  os << indent << "NumberOfThreads: " << this->m_NumberOfThreads << std::endl;
+  os << indent << "Minimum: " << this->m_Minimum << std::endl;
+  os << indent << "Maximum: " << this->m_Maximum << std::endl;
+  os << indent << "TotalFrequency: " << this->m_TotalFrequency << std::endl;
+  os << indent << "Image: " << this->m_Image.GetPointer() << std::endl;
+  os << indent << "MaskImage: " << this->m_MaskImage.GetPointer() << std::endl;
+}
+
+} // end namespace itk
+
+#endif
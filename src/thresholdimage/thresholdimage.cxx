@@ -42,24 +42,34 @@ std::string GetHelpString( void )
     << "pxthresholdimage\n"
     << "  -in        inputFilename\n"
     << "  [-out]     outputFilename; default in + THRESHOLDED.mhd\n"
-    << "  [-mask]    maskFilename, optional for \"OtsuThreshold\", required for \"KappaSigmaThreshold\"\n"
+    << "  [-mask]    maskFilename, optional for \"OtsuThreshold\", \"OtsuMultipleThreshold\"\n"
+    << "               and \"all\", required for \"KappaSigmaThreshold\"\n"
     << "  [-m]       method, choose one of \n"
     << "               {Threshold, OtsuThreshold, OtsuMultipleThreshold,\n"
     << "               AdaptiveOtsuThreshold, RobustAutomaticThreshold,\n"
-    << "               KappaSigmaThreshold, MinErrorThreshold }\n"
+    << "               KappaSigmaThreshold, MinErrorThreshold, all }\n"
     << "             default \"Threshold\"\n"
+    << "             \"all\" prints the thresholds of the histogram based methods\n"
+    << "             (Otsu, OtsuMultiple, MinError and KappaSigma on the bin centers),\n"
+    << "             computed from a single histogram, and writes no output image.\n"
     << "  [-t1]      lower threshold, for \"Threshold\", default -infinity\n"
     << "  [-t2]      upper threshold, for \"Threshold\", default 1.0\n"
     << "  [-inside]  inside value, default 0\n"
     << "  [-outside] outside value, default 1\n"
     << "  [-t]       number of thresholds, for \"OtsuMultipleThreshold\", default 1\n"
-    << "  [-b]       number of histogram bins, for \"OtsuThreshold\", \"MinErrorThreshold\"\n"
-    << "               and \"AdaptiveOtsuThreshold\", default 128\n"
+    << "  [-b]       number of histogram bins, for \"OtsuThreshold\", \"OtsuMultipleThreshold\",\n"
+    << "               \"MinErrorThreshold\", \"AdaptiveOtsuThreshold\" and \"all\", default 128\n"
     << "  [-r]       radius, for \"AdaptiveOtsuThreshold\", default 8\n"
     << "  [-cp]      number of control points, for \"AdaptiveOtsuThreshold\", default 50\n"
     << "  [-l]       number of levels, for \"AdaptiveOtsuThreshold\", default 3\n"
     << "  [-s]       number of samples, for \"AdaptiveOtsuThreshold\", default 5000\n"
     << "  [-o]       spline order, for \"AdaptiveOtsuThreshold\", default 3\n"
+    << "  [-ih]      use an integral histogram, for \"AdaptiveOtsuThreshold\";\n"
+    << "               the window histograms are then binned between the image\n"
+    << "               minimum and maximum instead of the window minimum and maximum.\n"
+    << "               Building it takes D passes over the image per bin, so it is\n"
+    << "               only faster when the windows cover the image many (> b x D)\n"
+    << "               times over.\n"
     << "  [-p]       power, for \"RobustAutomaticThreshold\", default 1\n"
     << "  [-sigma]   sigma factor, for \"KappaSigmaThreshold\", default 2\n"
     << "  [-iter]    number of iterations, for \"KappaSigmaThreshold\", default 2\n"
@@ -158,6 +168,8 @@ int main( int argc, char **argv )
   unsigned int mixtureType = 1;
   parser->GetCommandLineArgument( "-mt", mixtureType );
 
+  bool useIntegralHistogram = parser->ArgumentExists( "-ih" );
+
   bool useCompression = parser->ArgumentExists( "-z" );
 
   /** Checks. */
@@ -167,11 +179,12 @@ int main( int argc, char **argv )
     && method != "AdaptiveOtsuThreshold"
     && method != "RobustAutomaticThreshold"
     && method != "KappaSigmaThreshold"
-    && method != "MinErrorThreshold" )
+    && method != "MinErrorThreshold"
+    && method != "all" )
   {
     std::cerr << "ERROR: method \"-m\" should be one of { Threshold, "
       << "OtsuThreshold, OtsuMultipleThreshold, AdaptiveOtsuThreshold, "
-      << "RobustAutomaticThreshold, KappaSigmaThreshold, MinErrorThreshold }." << std::endl;
+      << "RobustAutomaticThreshold, KappaSigmaThreshold, MinErrorThreshold, all }." << std::endl;
     return EXIT_FAILURE;
   }
   if( method == "KappaSigmaThreshold" && maskFileName == "" )
@@ -179,6 +192,11 @@ int main( int argc, char **argv )
     std::cerr << "ERROR: the method \"KappaSigmaThreshold\" requires setting a mask using \"-mask\"." << std::endl;
     return EXIT_FAILURE;
   }
+  if( ( method == "OtsuMultipleThreshold" || method == "all" ) && bins <= numThresholds )
+  {
+    std::cerr << "ERROR: the number of bins \"-b\" should be larger than the number of thresholds \"-t\"." << std::endl;
+    return EXIT_FAILURE;
+  }
 
   /** Determine image properties. */
   itk::ImageIOBase::IOPixelType pixelType = itk::ImageIOBase::UNKNOWNPIXELTYPE;
@@ -230,9 +248,11 @@ int main( int argc, char **argv )
 
     /** Set the filter arguments. */
     filter->m_Bins = bins;
+    filter->m_ControlPoints = controlPoints;
     filter->m_InputFileName = inputFileName;
     filter->m_Inside = inside;
     filter->m_Iterations = iterations;
+    filter->m_Levels = levels;
     filter->m_MaskFileName = maskFileName;
     filter->m_MaskValue = maskValue;
     filter->m_Method = method;
@@ -241,10 +261,14 @@ int main( int argc, char **argv )
     filter->m_OutputFileName = outputFileName;
     filter->m_Outside = outside;
     filter->m_Pow = pow;
+    filter->m_Radius = radius;
+    filter->m_Samples = samples;
     filter->m_Sigma = sigma;
+    filter->m_SplineOrder = splineOrder;
     filter->m_Threshold1 = threshold1;
     filter->m_Threshold2 = threshold2;
     filter->m_UseCompression = useCompression;
+    filter->m_UseIntegralHistogram = useIntegralHistogram;
 
     filter->Run();
 
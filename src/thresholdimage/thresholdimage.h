@@ -36,9 +36,11 @@ public:
   ITKToolsThresholdImageBase()
   {
     this->m_Bins = 0;
+    this->m_ControlPoints = 0;
     this->m_InputFileName = "";
     this->m_Inside = 0.0f;
     this->m_Iterations = 0;
+    this->m_Levels = 0;
     this->m_MaskFileName = "";
     this->m_MaskValue = 0;
     this->m_Method = "";
@@ -47,11 +49,15 @@ public:
     this->m_OutputFileName = "";
     this->m_Outside = 0.0f;
     this->m_Pow = 0.0f;
+    this->m_Radius = 0;
+    this->m_Samples = 0;
     this->m_Sigma = 0.0f;
+    this->m_SplineOrder = 0;
     this->m_Supported = false;
     this->m_Threshold1 = 0.0f;
     this->m_Threshold2 = 0.0f;
     this->m_UseCompression = false;
+    this->m_UseIntegralHistogram = false;
   };
   /** Destructor. */
   ~ITKToolsThresholdImageBase(){};
@@ -73,11 +79,17 @@ public:
   unsigned int  m_Iterations;
   unsigned int  m_MaskValue;
   unsigned int  m_MixtureType;
+  unsigned int  m_Radius;
+  unsigned int  m_ControlPoints;
+  unsigned int  m_Levels;
+  unsigned int  m_Samples;
+  unsigned int  m_SplineOrder;
 
   double        m_Pow;
   double        m_Sigma;
   bool          m_Supported;
   bool          m_UseCompression;
+  bool          m_UseIntegralHistogram;
 
 }; // end class ITKToolsThresholdImageBase
 
@@ -125,10 +137,20 @@ public:
     {
       this->OtsuMultipleThresholdImage(
         this->m_InputFileName, this->m_OutputFileName, this->m_MaskFileName,
-        this->m_Inside, this->m_Outside,
         this->m_Bins, this->m_NumThresholds,
         this->m_UseCompression );
     }
+    else if( this->m_Method == "AdaptiveOtsuThreshold" )
+    {
+      this->AdaptiveOtsuThresholdImage(
+        this->m_InputFileName, this->m_OutputFileName,
+        this->m_Inside, this->m_Outside,
+        this->m_Radius, this->m_Bins,
+        this->m_ControlPoints, this->m_Levels,
+        this->m_Samples, this->m_SplineOrder,
+        this->m_UseIntegralHistogram,
+        this->m_UseCompression );
+    }
     else if( this->m_Method == "RobustAutomaticThreshold" )
     {
       this->RobustAutomaticThresholdImage(
@@ -153,6 +175,13 @@ public:
         this->m_Bins, this->m_MixtureType,
         this->m_UseCompression );
     }
+    else if( this->m_Method == "all" )
+    {
+      this->ReportThresholds(
+        this->m_InputFileName, this->m_MaskFileName,
+        this->m_Bins, this->m_NumThresholds,
+        this->m_Sigma, this->m_Iterations );
+    }
     else
     {
       std::cerr << "Not supported!" << std::endl;
@@ -178,17 +207,19 @@ public:
   /** Function to perform Otsu thresholding with multiple thresholds. */
   void OtsuMultipleThresholdImage(
     const std::string & inputFileName, const std::string & outputFileName,
-    const std::string & itkNotUsed( maskFileName ),
-    const double & inside, const double & outside,
+    const std::string & maskFileName,
     const unsigned int & bins, const unsigned int & numThresholds,
     const bool & useCompression );
 
   /** Function to perform Otsu thresholding with an adaptive threshold. */
-//   void AdaptiveOtsuThresholdImage(
-//     const std::string & inputFileName, const std::string & outputFileName,
-//     const unsigned int & radius, const unsigned int & bins,
-//     const unsigned int & controlPoints, const unsigned int & levels,
-//     const unsigned int & samples, const unsigned int & splineOrder );
+  void AdaptiveOtsuThresholdImage(
+    const std::string & inputFileName, const std::string & outputFileName,
+    const double & inside, const double & outside,
+    const unsigned int & radius, const unsigned int & bins,
+    const unsigned int & controlPoints, const unsigned int & levels,
+    const unsigned int & samples, const unsigned int & splineOrder,
+    const bool & useIntegralHistogram,
+    const bool & useCompression );
 
   /** Function to perform thresholding using .. . */
   void RobustAutomaticThresholdImage(
@@ -211,6 +242,13 @@ public:
     const unsigned int & bins, const unsigned int & mixtureType,
     const bool & useCompression );
 
+  /** Function to print the thresholds of all histogram based methods,
+   * computed from a single histogram. */
+  void ReportThresholds(
+    const std::string & inputFileName, const std::string & maskFileName,
+    const unsigned int & bins, const unsigned int & numThresholds,
+    const double & sigma, const unsigned int & iterations );
+
 }; // end class ITKToolsThresholdImage
 
 #include "thresholdimage.hxx"
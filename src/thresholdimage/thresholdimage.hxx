@@ -24,11 +24,15 @@
 #include "itkGradientMagnitudeRecursiveGaussianImageFilter.h"
 #include "itkBinaryThresholdImageFilter.h"
 #include "itkOtsuThresholdWithMaskImageFilter.h"
-#include "itkOtsuMultipleThresholdsImageFilter.h"
+#include "itkThresholdHistogram.h"
+#include "itkOtsuThresholdWithMaskImageCalculator.h"
+#include "itkOtsuMultipleThresholdsWithMaskImageCalculator.h"
+#include "itkThresholdLabelerImageFilter.h"
 #include "itkAdaptiveOtsuThresholdImageFilter.h"
 #include "itkRobustAutomaticThresholdImageFilter.h"
 #include "itkKappaSigmaThresholdImageFilter.h"
 #include "itkMinErrorThresholdImageFilter.h"
+#include "itkMinErrorThresholdImageCalculator.h"
 
 
 /**
@@ -153,9 +157,7 @@ ITKToolsThresholdImage< VDimension, TComponentType >
 ::OtsuMultipleThresholdImage(
   const std::string & inputFileName,
   const std::string & outputFileName,
-  const std::string & itkNotUsed( maskFileName ),
-  const double & inside,
-  const double & outside,
+  const std::string & maskFileName,
   const unsigned int & bins,
   const unsigned int & numThresholds,
   const bool & useCompression )
@@ -163,40 +165,49 @@ ITKToolsThresholdImage< VDimension, TComponentType >
   /** Typedef's. */
   const unsigned int ImageDimension = InputImageType::ImageDimension;
 
-  typedef typename InputImageType::PixelType            InputPixelType;
   typedef unsigned char                                 OutputPixelType;
   typedef unsigned char                                 MaskPixelType;
   typedef itk::Image< MaskPixelType, ImageDimension >   MaskImageType;
   typedef itk::Image< OutputPixelType, ImageDimension > OutputImageType;
   typedef itk::ImageFileReader< InputImageType >        ReaderType;
   typedef itk::ImageFileReader< MaskImageType >         MaskReaderType;
-  typedef itk::OtsuMultipleThresholdsImageFilter<
-    InputImageType, OutputImageType>                    ThresholderType;
+  typedef itk::OtsuMultipleThresholdsWithMaskImageCalculator<
+    InputImageType >                                    CalculatorType;
+  typedef itk::ThresholdLabelerImageFilter<
+    InputImageType, OutputImageType >                   LabelerType;
   typedef itk::ImageFileWriter< OutputImageType >       WriterType;
 
   /** Declarations. */
   typename ReaderType::Pointer reader1 = ReaderType::New();
-  //typename MaskReaderType::Pointer reader2 = MaskReaderType::New();
-  typename ThresholderType::Pointer thresholder = ThresholderType::New();
+  typename MaskReaderType::Pointer reader2 = MaskReaderType::New();
+  typename CalculatorType::Pointer calculator = CalculatorType::New();
+  typename LabelerType::Pointer labeler = LabelerType::New();
   typename WriterType::Pointer writer = WriterType::New();
 
   /** Read in the inputImage. */
   reader1->SetFileName( inputFileName.c_str() );
+  reader1->Update();
 
-  /** Apply the threshold. */
-  thresholder->SetInput( reader1->GetOutput() );
-  thresholder->SetNumberOfHistogramBins( bins );
-  //thresholder->SetInsideValue( static_cast<InputPixelType>( inside ) );
-  //thresholder->SetOutsideValue( static_cast<InputPixelType>( outside ) );
-  thresholder->SetNumberOfThresholds( numThresholds );
-//   if( maskFileName != "" )
-//   {
-//     reader2->SetFileName( maskFileName.c_str() );
-//     thresholder->SetMaskImage( reader2->GetOutput() );
-//   }
+  /** Compute the thresholds. */
+  calculator->SetImage( reader1->GetOutput() );
+  if( maskFileName != "" )
+  {
+    reader2->SetFileName( maskFileName.c_str() );
+    reader2->Update();
+    calculator->SetMaskImage( reader2->GetOutput() );
+  }
+  calculator->SetNumberOfHistogramBins( bins );
+  calculator->SetNumberOfThresholds( numThresholds );
+  calculator->Compute();
+
+  /** Label the classes. */
+  typename LabelerType::RealThresholdVector thresholds(
+    calculator->GetThresholds().begin(), calculator->GetThresholds().end() );
+  labeler->SetInput( reader1->GetOutput() );
+  labeler->SetRealThresholds( thresholds );
 
   /** Write the output image. */
-  writer->SetInput( thresholder->GetOutput() );
+  writer->SetInput( labeler->GetOutput() );
   writer->SetFileName( outputFileName.c_str() );
   writer->SetUseCompression( useCompression );
   writer->Update();
@@ -204,60 +215,66 @@ ITKToolsThresholdImage< VDimension, TComponentType >
 } // end OtsuMultipleThresholdImage()
 
 
-// /**
-//  * ******************* AdaptiveOtsuThresholdImage *******************
-//  */
-//
-// template< unsigned int VDimension, class TComponentType >
-// void
-// ITKToolsThresholdImage< VDimension, TComponentType >
-// ::AdaptiveOtsuThresholdImage(
-//   const std::string & inputFileName,
-//   const std::string & outputFileName,
-//   const unsigned int & radius,
-//   const unsigned int & bins,
-//   const unsigned int & controlPoints,
-//   const unsigned int & levels,
-//   const unsigned int & samples,
-//   const unsigned int & splineOrder )
-// {
-//   /** Typedef's. */
-//   const unsigned int ImageDimension = InputImageType::ImageDimension;
-//
-//   typedef unsigned char                                 OutputPixelType;
-//   typedef itk::Image< OutputPixelType, ImageDimension > OutputImageType;
-//   typedef itk::ImageFileReader< InputImageType >        ReaderType;
-//   typedef itk::AdaptiveOtsuThresholdImageFilter<
-//     InputImageType, OutputImageType>                    ThresholderType;
-//   typedef itk::ImageFileWriter< OutputImageType >       WriterType;
-//   typedef ThresholderType::InputSizeType                RadiusType;
-//
-//   /** Declarations. */
-//   typename ReaderType::Pointer reader = ReaderType::New();
-//   typename ThresholderType::Pointer thresholder = ThresholderType::New();
-//   typename WriterType::Pointer writer = WriterType::New();
-//   RadiusType Radius; Radius.Fill( radius );
-//
-//   /** Read in the inputImage. */
-//   reader->SetFileName( inputFileName.c_str() );
-//
-//   /** Apply the threshold. */
-//   thresholder->SetRadius( Radius );
-//   thresholder->SetNumberOfHistogramBins( bins );
-//   thresholder->SetNumberOfControlPoints( controlPoints );
-//   thresholder->SetNumberOfLevels( levels );
-//   thresholder->SetNumberOfSamples( samples );
-//   thresholder->SetSplineOrder( splineOrder );
-//   thresholder->SetInsideValue( 1 );
-//   thresholder->SetOutsideValue( 0 );
-//   thresholder->SetInput( reader->GetOutput() );
-//
-//   /** Write the output image. */
-//   writer->SetInput( thresholder->GetOutput() );
-//   writer->SetFileName( outputFileName.c_str() );
-//   writer->Update();
-//
-// } // end AdaptiveOtsuThresholdImage()
+/**
+ * ******************* AdaptiveOtsuThresholdImage *******************
+ */
+
+template< unsigned int VDimension, class TComponentType >
+void
+ITKToolsThresholdImage< VDimension, TComponentType >
+::AdaptiveOtsuThresholdImage(
+  const std::string & inputFileName,
+  const std::string & outputFileName,
+  const double & inside,
+  const double & outside,
+  const unsigned int & radius,
+  const unsigned int & bins,
+  const unsigned int & controlPoints,
+  const unsigned int & levels,
+  const unsigned int & samples,
+  const unsigned int & splineOrder,
+  const bool & useIntegralHistogram,
+  const bool & useCompression )
+{
+  /** Typedef's. */
+  const unsigned int ImageDimension = InputImageType::ImageDimension;
+
+  typedef unsigned char                                 OutputPixelType;
+  typedef itk::Image< OutputPixelType, ImageDimension > OutputImageType;
+  typedef itk::ImageFileReader< InputImageType >        ReaderType;
+  typedef itk::AdaptiveOtsuThresholdImageFilter<
+    InputImageType, OutputImageType>                    ThresholderType;
+  typedef itk::ImageFileWriter< OutputImageType >       WriterType;
+  typedef typename ThresholderType::InputSizeType       RadiusType;
+
+  /** Declarations. */
+  typename ReaderType::Pointer reader = ReaderType::New();
+  typename ThresholderType::Pointer thresholder = ThresholderType::New();
+  typename WriterType::Pointer writer = WriterType::New();
+  RadiusType Radius; Radius.Fill( radius );
+
+  /** Read in the inputImage. */
+  reader->SetFileName( inputFileName.c_str() );
+
+  /** Apply the threshold. */
+  thresholder->SetRadius( Radius );
+  thresholder->SetNumberOfHistogramBins( bins );
+  thresholder->SetNumberOfControlPoints( controlPoints );
+  thresholder->SetNumberOfLevels( levels );
+  thresholder->SetNumberOfSamples( samples );
+  thresholder->SetSplineOrder( splineOrder );
+  thresholder->SetUseIntegralHistogram( useIntegralHistogram );
+  thresholder->SetInsideValue( static_cast<OutputPixelType>( inside ) );
+  thresholder->SetOutsideValue( static_cast<OutputPixelType>( outside ) );
+  thresholder->SetInput( reader->GetOutput() );
+
+  /** Write the output image. */
+  writer->SetInput( thresholder->GetOutput() );
+  writer->SetFileName( outputFileName.c_str() );
+  writer->SetUseCompression( useCompression );
+  writer->Update();
+
+} // end AdaptiveOtsuThresholdImage()
 
 
 /**
@@ -432,4 +449,117 @@ ITKToolsThresholdImage< VDimension, TComponentType >
 } // end MinErrorThresholdImage()
 
 
+/**
+ * ******************* ReportThresholds *******************
+ */
+
+template< unsigned int VDimension, class TComponentType >
+void
+ITKToolsThresholdImage< VDimension, TComponentType >
+::ReportThresholds(
+  const std::string & inputFileName,
+  const std::string & maskFileName,
+  const unsigned int & bins,
+  const unsigned int & numThresholds,
+  const double & sigma,
+  const unsigned int & iterations )
+{
+  /** Typedef's. */
+  const unsigned int ImageDimension = InputImageType::ImageDimension;
+
+  typedef unsigned char                                 MaskPixelType;
+  typedef itk::Image< MaskPixelType, ImageDimension >   MaskImageType;
+  typedef itk::ImageFileReader< InputImageType >        ReaderType;
+  typedef itk::ImageFileReader< MaskImageType >         MaskReaderType;
+  typedef itk::ThresholdHistogram< InputImageType >     HistogramType;
+  typedef itk::OtsuThresholdWithMaskImageCalculator<
+    InputImageType >                                    OtsuCalculatorType;
+  typedef itk::OtsuMultipleThresholdsWithMaskImageCalculator<
+    InputImageType >                                    OtsuMultipleCalculatorType;
+  typedef itk::MinErrorThresholdImageCalculator<
+    InputImageType >                                    MinErrorCalculatorType;
+
+  /** Read in the inputImage and the mask. */
+  typename ReaderType::Pointer reader1 = ReaderType::New();
+  reader1->SetFileName( inputFileName.c_str() );
+  reader1->Update();
+
+  typename MaskReaderType::Pointer reader2 = MaskReaderType::New();
+  typename HistogramType::Pointer histogram = HistogramType::New();
+  histogram->SetImage( reader1->GetOutput() );
+  if( maskFileName != "" )
+  {
+    reader2->SetFileName( maskFileName.c_str() );
+    reader2->Update();
+    histogram->SetMaskImage( reader2->GetOutput() );
+  }
+
+  /** Compute the histogram once, for all methods. */
+  histogram->SetNumberOfHistogramBins( bins );
+  histogram->Compute();
+
+  typename OtsuCalculatorType::Pointer otsu = OtsuCalculatorType::New();
+  otsu->SetHistogram( histogram );
+  otsu->Compute();
+
+  typename OtsuMultipleCalculatorType::Pointer otsuMultiple
+    = OtsuMultipleCalculatorType::New();
+  otsuMultiple->SetHistogram( histogram );
+  otsuMultiple->SetNumberOfThresholds( numThresholds );
+  otsuMultiple->Compute();
+
+  typename MinErrorCalculatorType::Pointer minErrorPoisson
+    = MinErrorCalculatorType::New();
+  minErrorPoisson->SetHistogram( histogram );
+  minErrorPoisson->UseGaussianMixture( false );
+  minErrorPoisson->Compute();
+
+  typename MinErrorCalculatorType::Pointer minErrorGaussian
+    = MinErrorCalculatorType::New();
+  minErrorGaussian->SetHistogram( histogram );
+  minErrorGaussian->UseGaussianMixture( true );
+  minErrorGaussian->Compute();
+
+  /** Kappa-sigma clipping on the bin centers: iteratively, the threshold is
+   * the mean plus sigma times the standard deviation of the lower part.
+   */
+  double kappaSigma = static_cast<double>( histogram->GetMaximum() );
+  if( !histogram->IsDegenerate() )
+  {
+    const std::vector<double> & frequencies = histogram->GetFrequencies();
+    for( unsigned int i = 0; i < iterations; ++i )
+    {
+      double count = 0.0, sum = 0.0, sumOfSquares = 0.0;
+      for( unsigned int j = 0; j < frequencies.size(); ++j )
+      {
+        const double center = histogram->GetBinCenter( j );
+        if( center > kappaSigma ) break;
+        count += frequencies[ j ];
+        sum += frequencies[ j ] * center;
+        sumOfSquares += frequencies[ j ] * center * center;
+      }
+      if( count == 0.0 ) break;
+      const double mean = sum / count;
+      const double variance = vnl_math_max( 0.0, sumOfSquares / count - mean * mean );
+      kappaSigma = mean + sigma * vcl_sqrt( variance );
+    }
+  }
+
+  /** Report. */
+  std::cout << "OtsuThreshold: " << static_cast<double>( otsu->GetThreshold() ) << std::endl;
+  std::cout << "OtsuMultipleThreshold:";
+  for( unsigned int i = 0; i < otsuMultiple->GetThresholds().size(); ++i )
+  {
+    std::cout << " " << otsuMultiple->GetThresholds()[ i ];
+  }
+  std::cout << std::endl;
+  std::cout << "MinErrorThreshold (Poisson): "
+    << static_cast<double>( minErrorPoisson->GetThreshold() ) << std::endl;
+  std::cout << "MinErrorThreshold (Gaussian): "
+    << static_cast<double>( minErrorGaussian->GetThreshold() ) << std::endl;
+  std::cout << "KappaSigmaThreshold: " << kappaSigma << std::endl;
+
+} // end ReportThresholds()
+
+
 #endif // end #ifndef __thresholdimage_hxx_
@@ -20,9 +20,12 @@
 
 #include "ITKToolsBase.h"
 
-#include "itkImageSeriesReader.h"
+#include "itkStreamingImageSeriesReader.h"
+#include "itkChangeInformationImageFilter.h"
 #include "itkImageFileWriter.h"
 
+#include <algorithm>
+
 
 /** \class TileImages2D3DBase
  *
@@ -38,6 +41,7 @@ public:
   {
     this->m_OutputFileName = "";
     this->m_LastSpacing = 1.0;
+    this->m_NumberOfThreads = 0;
   };
   /** Destructor. */
   ~ITKToolsTileImages2D3DBase(){};
@@ -46,6 +50,7 @@ public:
   std::vector<std::string> m_InputFileNames;
   std::string m_OutputFileName;
   double m_LastSpacing;
+  unsigned int m_NumberOfThreads;
 
 }; // end class ITKToolsTileImages2D3DBase
 
@@ -74,33 +79,44 @@ public:
     /** Some typedef's. */
     typedef itk::Image<TComponentType, VDimension>      ImageType;
     typedef typename ImageType::SpacingType             SpacingType;
-    typedef itk::ImageSeriesReader<ImageType>           ImageSeriesReaderType;
+    typedef itk::StreamingImageSeriesReader<ImageType>  ImageSeriesReaderType;
+    typedef itk::ChangeInformationImageFilter<ImageType> ChangeInformationType;
     typedef itk::ImageFileWriter<ImageType>             ImageWriterType;
 
-    /** Create reader. */
+    /** Create reader. It reads the slices of a slab in parallel, one file
+     * per thread.
+     */
     typename ImageSeriesReaderType::Pointer reader = ImageSeriesReaderType::New();
     reader->SetFileNames( this->m_InputFileNames );
-
-    /** Update the reader. */
-    reader->Update();
-    typename ImageType::Pointer tiledImage = reader->GetOutput();
+    if( this->m_NumberOfThreads > 0 )
+    {
+      reader->SetNumberOfThreads( this->m_NumberOfThreads );
+    }
+    reader->UpdateOutputInformation();
 
     /** Get and set the spacing, if it was set by the user. */
+    typename ChangeInformationType::Pointer changeInformation = ChangeInformationType::New();
+    changeInformation->SetInput( reader->GetOutput() );
     if( this->m_LastSpacing > 0.0 )
     {
-      /** Make sure that changes are not undone. */
-      tiledImage->DisconnectPipeline();
-
       /** Set the spacing of the last dimension. */
-      SpacingType spacing = tiledImage->GetSpacing();
+      SpacingType spacing = reader->GetOutput()->GetSpacing();
       spacing[ VDimension - 1 ] = this->m_LastSpacing;
-      tiledImage->SetSpacing( spacing );
+      changeInformation->SetOutputSpacing( spacing );
+      changeInformation->ChangeSpacingOn();
     }
 
-    /** Write to disk. */
+    /** Write to disk, a slab of as many slices as files are read in parallel
+     * at a time. For file formats that can not be written in pieces, the
+     * writer requests the whole image at once.
+     */
+    const unsigned int numberOfFiles = this->m_InputFileNames.size();
+    const unsigned int slicesPerSlab = std::max( 1u,
+      static_cast<unsigned int>( reader->GetNumberOfThreads() ) );
     typename ImageWriterType::Pointer writer = ImageWriterType::New();
     writer->SetFileName( this->m_OutputFileName.c_str() );
-    writer->SetInput( tiledImage );
+    writer->SetInput( changeInformation->GetOutput() );
+    writer->SetNumberOfStreamDivisions( ( numberOfFiles + slicesPerSlab - 1 ) / slicesPerSlab );
     writer->Update();
 
   } // end Run()
@@ -0,0 +1,116 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkStreamingImageSeriesReader_h_
+#define __itkStreamingImageSeriesReader_h_
+
+#include "itkImageSource.h"
+#include "itkMultiThreader.h"
+
+#include <string>
+#include <vector>
+
+
+namespace itk
+{
+
+/** \class StreamingImageSeriesReader
+ * \brief Stacks a series of (N-1)-D files into an N-D image, reading only
+ * the files of the requested region.
+ *
+ * The output information is that of an itk::ImageSeriesReader with the same
+ * file names, so the spacing and direction of the last axis are derived
+ * from the origins of the files in the same way. Contrary to that reader,
+ * GenerateData reads only the slices of the requested region, so a
+ * streaming writer keeps the memory bounded to one slab of slices. The
+ * files of a slab are read in parallel, one per thread, so several files
+ * are in flight at once.
+ *
+ * All files need to have the size of the first one.
+ *
+ * \ingroup IOFilters Multithreaded
+ */
+template <class TOutputImage>
+class StreamingImageSeriesReader : public ImageSource<TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef StreamingImageSeriesReader        Self;
+  typedef ImageSource<TOutputImage>         Superclass;
+  typedef SmartPointer<Self>                Pointer;
+  typedef SmartPointer<const Self>          ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( StreamingImageSeriesReader, ImageSource );
+
+  /** Typedefs. */
+  itkStaticConstMacro( ImageDimension, unsigned int, TOutputImage::ImageDimension );
+  typedef TOutputImage                              OutputImageType;
+  typedef typename OutputImageType::PixelType       PixelType;
+  typedef typename OutputImageType::RegionType      RegionType;
+  typedef std::vector<std::string>                  FileNamesContainer;
+
+  /** Set/Get the file names, one per slice. */
+  void SetFileNames( const FileNamesContainer & fileNames )
+  {
+    this->m_FileNames = fileNames;
+    this->Modified();
+  }
+  const FileNamesContainer & GetFileNames( void ) const { return this->m_FileNames; }
+
+protected:
+  StreamingImageSeriesReader();
+  ~StreamingImageSeriesReader() {};
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** Take the information of an itk::ImageSeriesReader. */
+  virtual void GenerateOutputInformation( void );
+
+  /** Only whole slices are read. */
+  virtual void EnlargeOutputRequestedRegion( DataObject * output );
+
+  /** Read the slices of the requested region. */
+  virtual void GenerateData( void );
+
+  /** Static function used as a "callback" by the MultiThreader. */
+  static ITK_THREAD_RETURN_TYPE ThreaderCallback( void * arg );
+
+  /** Read every numberOfThreads-th slice of the region, from threadId on. */
+  void ThreadedReadSlices( ThreadIdType threadId, ThreadIdType numberOfThreads );
+
+private:
+  StreamingImageSeriesReader(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  FileNamesContainer  m_FileNames;
+
+  /** The first error of the threads, thrown after all have finished. */
+  std::vector<std::string>  m_ThreadErrors;
+
+}; // end class StreamingImageSeriesReader
+
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkStreamingImageSeriesReader.hxx"
+#endif
+
+#endif // end #ifndef __itkStreamingImageSeriesReader_h_
@@ -0,0 +1,187 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef _itkStreamingImageSeriesReader_hxx_
+#define _itkStreamingImageSeriesReader_hxx_
+
+#include "itkStreamingImageSeriesReader.h"
+
+#include "itkImageFileReader.h"
+#include "itkImageSeriesReader.h"
+
+#include <algorithm>
+
+
+namespace itk
+{
+
+template<class TOutputImage>
+StreamingImageSeriesReader<TOutputImage>
+::StreamingImageSeriesReader()
+{
+  this->SetNumberOfRequiredInputs( 0 );
+}
+
+
+template<class TOutputImage>
+void
+StreamingImageSeriesReader<TOutputImage>
+::GenerateOutputInformation( void )
+{
+  typedef ImageSeriesReader<OutputImageType>  SeriesReaderType;
+
+  if( this->m_FileNames.empty() )
+  {
+    itkExceptionMacro( << "No file names were set." );
+  }
+
+  /** The series reader only reads the headers of the first and last file. */
+  typename SeriesReaderType::Pointer seriesReader = SeriesReaderType::New();
+  seriesReader->SetFileNames( this->m_FileNames );
+  seriesReader->UpdateOutputInformation();
+
+  this->GetOutput()->CopyInformation( seriesReader->GetOutput() );
+
+} // end GenerateOutputInformation()
+
+
+template<class TOutputImage>
+void
+StreamingImageSeriesReader<TOutputImage>
+::EnlargeOutputRequestedRegion( DataObject * output )
+{
+  OutputImageType * image = dynamic_cast<OutputImageType *>( output );
+  if( !image ) return;
+
+  /** Keep the requested slices, but take them whole. */
+  const unsigned int lastAxis = ImageDimension - 1;
+  RegionType region = image->GetLargestPossibleRegion();
+  region.SetIndex( lastAxis, image->GetRequestedRegion().GetIndex( lastAxis ) );
+  region.SetSize( lastAxis, image->GetRequestedRegion().GetSize( lastAxis ) );
+  image->SetRequestedRegion( region );
+
+} // end EnlargeOutputRequestedRegion()
+
+
+template<class TOutputImage>
+void
+StreamingImageSeriesReader<TOutputImage>
+::GenerateData( void )
+{
+  OutputImageType * output = this->GetOutput();
+  output->SetBufferedRegion( output->GetRequestedRegion() );
+  output->Allocate();
+
+  /** One file per thread at a time. */
+  const SizeValueType numberOfSlices
+    = output->GetBufferedRegion().GetSize( ImageDimension - 1 );
+  if( numberOfSlices == 0 ) return;
+  const ThreadIdType numberOfThreads = static_cast<ThreadIdType>(
+    std::min<SizeValueType>( this->GetNumberOfThreads(), numberOfSlices ) );
+
+  this->m_ThreadErrors.assign( numberOfThreads, "" );
+  MultiThreader * threader = this->GetMultiThreader();
+  threader->SetNumberOfThreads( numberOfThreads );
+  threader->SetSingleMethod( this->ThreaderCallback, this );
+  threader->SingleMethodExecute();
+
+  for( ThreadIdType i = 0; i < this->m_ThreadErrors.size(); ++i )
+  {
+    if( !this->m_ThreadErrors[ i ].empty() )
+    {
+      itkExceptionMacro( << this->m_ThreadErrors[ i ] );
+    }
+  }
+
+} // end GenerateData()
+
+
+template<class TOutputImage>
+ITK_THREAD_RETURN_TYPE
+StreamingImageSeriesReader<TOutputImage>
+::ThreaderCallback( void * arg )
+{
+  MultiThreader::ThreadInfoStruct * info = static_cast<MultiThreader::ThreadInfoStruct *>( arg );
+  Self * self = static_cast<Self *>( info->UserData );
+
+  self->ThreadedReadSlices( info->ThreadID, info->NumberOfThreads );
+
+  return ITK_THREAD_RETURN_VALUE;
+
+} // end ThreaderCallback()
+
+
+template<class TOutputImage>
+void
+StreamingImageSeriesReader<TOutputImage>
+::ThreadedReadSlices( ThreadIdType threadId, ThreadIdType numberOfThreads )
+{
+  typedef ImageFileReader<OutputImageType>    ReaderType;
+
+  OutputImageType * output = this->GetOutput();
+  const unsigned int lastAxis = ImageDimension - 1;
+  const RegionType & region = output->GetBufferedRegion();
+  const SizeValueType numberOfSlices = region.GetSize( lastAxis );
+  const SizeValueType slicePixels = region.GetNumberOfPixels() / numberOfSlices;
+  const OffsetValueType firstFile = region.GetIndex( lastAxis )
+    - output->GetLargestPossibleRegion().GetIndex( lastAxis );
+
+  /** The slices are stored one after the other in the buffer. */
+  for( SizeValueType k = threadId; k < numberOfSlices; k += numberOfThreads )
+  {
+    const std::string & fileName = this->m_FileNames[ firstFile + k ];
+    try
+    {
+      typename ReaderType::Pointer reader = ReaderType::New();
+      reader->SetFileName( fileName );
+      reader->Update();
+
+      const OutputImageType * slice = reader->GetOutput();
+      if( slice->GetBufferedRegion().GetNumberOfPixels() != slicePixels )
+      {
+        this->m_ThreadErrors[ threadId ] = "The size of " + fileName
+          + " differs from the size of the first file.";
+        return;
+      }
+      std::copy( slice->GetBufferPointer(), slice->GetBufferPointer() + slicePixels,
+        output->GetBufferPointer() + k * slicePixels );
+    }
+    catch( ExceptionObject & excp )
+    {
+      this->m_ThreadErrors[ threadId ] = excp.GetDescription();
+      return;
+    }
+  }
+
+} // end ThreadedReadSlices()
+
+
+template<class TOutputImage>
+void
+StreamingImageSeriesReader<TOutputImage>
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "Number of files: " << this->m_FileNames.size() << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef _itkStreamingImageSeriesReader_hxx_
@@ -43,7 +43,8 @@ std::string GetHelpString( void )
     << "pxtileimages EITHER tiles a stack of 2D images into a 3D image,\n"
     << "OR tiles nD images to form another nD image.\n"
     << "In the last case the way to tile is specified by a layout.\n"
-    << "To stack a pile of 2D images an itk::SeriesFileReader is employed.\n"
+    << "A pile of 2D images is stacked slab by slab, so that only a few slices\n"
+    << "are in memory at a time.\n"
     << "If no layout is specified with \"-ly\" 2D-3D tiling is done,\n"
     << "otherwise 2D-2D or 3D-3D tiling is performed.\n"
     << "Usage:  \npxtileimages\n"
@@ -61,6 +62,9 @@ std::string GetHelpString( void )
     << "           example: in 2D for 4 images \"-ly 4 1\" (or \"-ly 0 1\") results in\n"
     << "             im1 im2 im3 im4\n"
     << "  [-d]     default value, by default 0.\n"
+    << "  [-threads] for 2D-3D tiling: the number of files that are read in\n"
+    << "           parallel; the output is written in slabs of that many slices\n"
+    << "           if its format supports it, e.g. .mhd. Default: the number of CPUs.\n"
     << "Supported pixel types: (unsigned) char, (unsigned) short, float.";
 
   return ss.str();
@@ -119,6 +123,10 @@ int main( int argc, char ** argv )
   double defaultvalue = 0.0;
   parser->GetCommandLineArgument( "-d", defaultvalue );
 
+  /** Get the number of files to read in parallel. */
+  unsigned int numberOfThreads = 0;
+  parser->GetCommandLineArgument( "-threads", numberOfThreads );
+
   /** Determine image properties. */
   itk::ImageIOBase::IOPixelType pixelType = itk::ImageIOBase::UNKNOWNPIXELTYPE;
   itk::ImageIOBase::IOComponentType componentType = itk::ImageIOBase::UNKNOWNCOMPONENTTYPE;
@@ -172,6 +180,7 @@ int main( int argc, char ** argv )
       filterTile2D3D->m_InputFileNames = inputFileNames;
       filterTile2D3D->m_OutputFileName = outputFileName;
       filterTile2D3D->m_LastSpacing = lastSpacing;
+      filterTile2D3D->m_NumberOfThreads = numberOfThreads;
 
       filterTile2D3D->Run();
 
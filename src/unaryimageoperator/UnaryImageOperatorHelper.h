@@ -21,7 +21,7 @@
 #include "ITKToolsHelpers.h"
 #include "ITKToolsBase.h"
 
-#include "itkUnaryFunctorImageFilter.h"
+#include "itkContiguousUnaryFunctorImageFilter.h"
 #include "itkUnaryFunctors.h"
 
 #include "itkImageFileReader.h"
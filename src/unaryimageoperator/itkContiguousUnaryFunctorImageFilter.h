@@ -0,0 +1,110 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkContiguousUnaryFunctorImageFilter_h_
+#define __itkContiguousUnaryFunctorImageFilter_h_
+
+#include "itkInPlaceImageFilter.h"
+
+
+namespace itk
+{
+
+/** \class ContiguousUnaryFunctorImageFilter
+ * \brief Applies a functor to every pixel, directly on the image buffers.
+ *
+ * This filter computes the same as the itk::UnaryFunctorImageFilter, but
+ * instead of walking the region with an iterator it applies the functor in
+ * a plain loop over runs of contiguous pixels. If the region of a thread
+ * spans whole rows (or slices) of the buffers, consecutive rows are merged
+ * into one run. The runs are processed in chunks of ChunkSize pixels, which
+ * is also the granularity of the progress reports.
+ *
+ * Every thread works on its own copy of the functor, so that the compiler
+ * knows that the output does not alias the functor arguments and can
+ * vectorise the loop for the simple functors.
+ *
+ * Contrary to the itk::UnaryFunctorImageFilter the functor does not need
+ * comparison operators.
+ *
+ * \ingroup IntensityImageFilters Multithreaded
+ */
+template <class TInputImage, class TOutputImage, class TFunction>
+class ContiguousUnaryFunctorImageFilter:
+    public InPlaceImageFilter<TInputImage,TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ContiguousUnaryFunctorImageFilter             Self;
+  typedef InPlaceImageFilter<TInputImage,TOutputImage>  Superclass;
+  typedef SmartPointer<Self>                            Pointer;
+  typedef SmartPointer<const Self>                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( ContiguousUnaryFunctorImageFilter, InPlaceImageFilter );
+
+  /** Typedef to describe the input/output image types. */
+  typedef TFunction                                     FunctorType;
+  typedef TInputImage                                   InputImageType;
+  typedef TOutputImage                                  OutputImageType;
+  typedef typename InputImageType::PixelType            InputImagePixelType;
+  typedef typename OutputImageType::PixelType           OutputImagePixelType;
+  typedef typename OutputImageType::RegionType          OutputImageRegionType;
+
+  /** Get/Set the functor. */
+  FunctorType & GetFunctor( void ) { return this->m_Functor; }
+  const FunctorType & GetFunctor( void ) const { return this->m_Functor; }
+  void SetFunctor( const FunctorType & functor )
+  {
+    this->m_Functor = functor;
+    this->Modified();
+  }
+
+  /** Set/Get the number of pixels per chunk. Default 16384. */
+  itkSetClampMacro( ChunkSize, unsigned int, 1, NumericTraits<unsigned int>::max() );
+  itkGetConstMacro( ChunkSize, unsigned int );
+
+protected:
+  ContiguousUnaryFunctorImageFilter();
+  ~ContiguousUnaryFunctorImageFilter() {};
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** Apply the functor to the region of this thread. */
+  virtual void ThreadedGenerateData(
+    const OutputImageRegionType & outputRegionForThread,
+    ThreadIdType threadId );
+
+private:
+  ContiguousUnaryFunctorImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  FunctorType   m_Functor;
+  unsigned int  m_ChunkSize;
+
+}; // end class ContiguousUnaryFunctorImageFilter
+
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkContiguousUnaryFunctorImageFilter.hxx"
+#endif
+
+#endif // end #ifndef __itkContiguousUnaryFunctorImageFilter_h_
@@ -0,0 +1,122 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef _itkContiguousUnaryFunctorImageFilter_hxx_
+#define _itkContiguousUnaryFunctorImageFilter_hxx_
+
+#include "itkContiguousUnaryFunctorImageFilter.h"
+
+#include "itkProgressReporter.h"
+
+
+namespace itk {
+
+template<class TInputImage, class TOutputImage, class TFunction>
+ContiguousUnaryFunctorImageFilter<TInputImage,TOutputImage,TFunction>
+::ContiguousUnaryFunctorImageFilter()
+{
+  this->SetNumberOfRequiredInputs( 1 );
+  this->InPlaceOff();
+  this->m_ChunkSize = 16384;
+}
+
+
+template<class TInputImage, class TOutputImage, class TFunction>
+void
+ContiguousUnaryFunctorImageFilter<TInputImage,TOutputImage,TFunction>
+::ThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread,
+  ThreadIdType threadId )
+{
+  typedef typename OutputImageType::IndexType   IndexType;
+  typedef typename OutputImageType::SizeType    SizeType;
+  const unsigned int dimension = OutputImageType::ImageDimension;
+
+  const InputImageType * input = this->GetInput();
+  OutputImageType * output = this->GetOutput();
+
+  const SizeType size = outputRegionForThread.GetSize();
+  const SizeType inputBufferSize = input->GetBufferedRegion().GetSize();
+  const SizeType outputBufferSize = output->GetBufferedRegion().GetSize();
+
+  /** A run is contiguous in both buffers: it covers dimensions 0..k-1
+   * completely and dimension k partly.
+   */
+  unsigned int k = 0;
+  while( k + 1 < dimension
+    && size[ k ] == inputBufferSize[ k ] && size[ k ] == outputBufferSize[ k ] )
+  {
+    ++k;
+  }
+  std::size_t runLength = 1;
+  for( unsigned int d = 0; d <= k; ++d ) runLength *= size[ d ];
+  if( runLength == 0 ) return;
+  const std::size_t numberOfRuns = outputRegionForThread.GetNumberOfPixels() / runLength;
+  const std::size_t chunkSize = this->m_ChunkSize;
+  const std::size_t chunksPerRun = ( runLength + chunkSize - 1 ) / chunkSize;
+
+  ProgressReporter progress( this, threadId, numberOfRuns * chunksPerRun );
+
+  /** A private copy of the functor; see the class documentation. */
+  FunctorType functor = this->m_Functor;
+
+  const IndexType regionIndex = outputRegionForThread.GetIndex();
+  IndexType index = regionIndex;
+  for( std::size_t run = 0; run < numberOfRuns; ++run )
+  {
+    const InputImagePixelType * in
+      = input->GetBufferPointer() + input->ComputeOffset( index );
+    OutputImagePixelType * out
+      = output->GetBufferPointer() + output->ComputeOffset( index );
+
+    for( std::size_t start = 0; start < runLength; start += chunkSize )
+    {
+      const std::size_t end = start + chunkSize < runLength
+        ? start + chunkSize : runLength;
+      for( std::size_t j = start; j < end; ++j )
+      {
+        out[ j ] = functor( in[ j ] );
+      }
+      progress.CompletedPixel();
+    }
+
+    /** The start of the next run. */
+    for( unsigned int d = k + 1; d < dimension; ++d )
+    {
+      if( ++index[ d ] < regionIndex[ d ] + static_cast<IndexValueType>( size[ d ] ) ) break;
+      index[ d ] = regionIndex[ d ];
+    }
+  } // end for runs
+
+} // end ThreadedGenerateData()
+
+
+template<class TInputImage, class TOutputImage, class TFunction>
+void
+ContiguousUnaryFunctorImageFilter<TInputImage,TOutputImage,TFunction>
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "ChunkSize: " << this->m_ChunkSize << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef _itkContiguousUnaryFunctorImageFilter_hxx_
@@ -656,10 +656,10 @@ struct UnaryFunctorFactory
       argument2 = static_cast<TArgument>( tempArgument2 );
     }
 
-    /** Create UnaryFunctorImageFilter with requested functor and set arguments. */
+    /** Create ContiguousUnaryFunctorImageFilter with requested functor and set arguments. */
     if( filterType == PLUS )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::PLUS< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument( argument );
@@ -667,7 +667,7 @@ struct UnaryFunctorFactory
     }
     else if( filterType == RMINUS )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::RMINUS< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument( argument );
@@ -675,7 +675,7 @@ struct UnaryFunctorFactory
     }
     else if( filterType == LMINUS )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::LMINUS< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument( argument );
@@ -683,7 +683,7 @@ struct UnaryFunctorFactory
     }
     else if( filterType == TIMES )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::TIMES< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument( argument );
@@ -691,7 +691,7 @@ struct UnaryFunctorFactory
     }
     else if( filterType == LDIVIDE )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::LDIVIDE< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument( argument );
@@ -699,7 +699,7 @@ struct UnaryFunctorFactory
     }
     else if( filterType == RDIVIDE )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::RDIVIDE< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument( argument );
@@ -707,7 +707,7 @@ struct UnaryFunctorFactory
     }
     else if( filterType == RMODINT )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::RMODINT< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument( argument );
@@ -715,7 +715,7 @@ struct UnaryFunctorFactory
     }
     else if( filterType == RMODDOUBLE )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::RMODDOUBLE< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument( argument );
@@ -723,7 +723,7 @@ struct UnaryFunctorFactory
     }
     else if( filterType == LMODINT )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::LMODINT< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument( argument );
@@ -731,7 +731,7 @@ struct UnaryFunctorFactory
     }
     else if( filterType == LMODDOUBLE )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::LMODDOUBLE< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument( argument );
@@ -739,7 +739,7 @@ struct UnaryFunctorFactory
     }
     else if( filterType == NLOG )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::NLOG< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument( argument );
@@ -748,7 +748,7 @@ struct UnaryFunctorFactory
     /** In the following filters, the argument is always double */
     else if( filterType == RPOWER )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::RPOWER< InputPixelType, double, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument( argument );
@@ -756,7 +756,7 @@ struct UnaryFunctorFactory
     }
     else if( filterType == LPOWER )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::LPOWER< InputPixelType, double, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument( argument );
@@ -764,14 +764,14 @@ struct UnaryFunctorFactory
     }
     else if( filterType == ERRFUNC )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::ERRFUNC< InputPixelType, double, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == NORMCDF )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::NORMCDF< InputPixelType, double, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument1( argument1 );
@@ -780,7 +780,7 @@ struct UnaryFunctorFactory
     }    
     else if( filterType == QFUNC )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::QFUNC< InputPixelType, double, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument1( argument1 );
@@ -791,126 +791,126 @@ struct UnaryFunctorFactory
     /** The following filters do not use the argument at all.*/
     else if( filterType == NEG )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::NEG< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == SIGNINT )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::SIGNINT< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == SIGNDOUBLE )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::SIGNDOUBLE< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == ABSINT )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::ABSINT< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == ABSDOUBLE )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::ABSDOUBLE< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == FLOOR )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::FLOOR< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == CEIL )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::CEIL< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == ROUND )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::ROUND< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == LN )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::LN< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == LOG10 )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::LOG10< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == EXP )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::EXP< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == SIN )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::SIN< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == COS )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::COS< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == TAN )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::TAN< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == ARCSIN )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::ARCSIN< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == ARCCOS )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::ARCCOS< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == ARCTAN )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::ARCTAN< InputPixelType, TArgument, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       return filter.GetPointer();
     }
     else if( filterType == LINEAR )
     {
-      typedef itk::UnaryFunctorImageFilter< TInputImage, TOutputImage,
+      typedef itk::ContiguousUnaryFunctorImageFilter< TInputImage, TOutputImage,
         itk::Functor::LINEAR< InputPixelType, double, OutputPixelType > >  FilterType;
       typename FilterType::Pointer filter = FilterType::New();
       filter->GetFunctor().SetArgument1( argument1 );
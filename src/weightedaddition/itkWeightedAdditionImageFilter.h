@@ -0,0 +1,112 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef __itkWeightedAdditionImageFilter_h_
+#define __itkWeightedAdditionImageFilter_h_
+
+#include "itkImageToImageFilter.h"
+#include "itkNumericTraits.h"
+
+
+namespace itk
+{
+
+/** \class WeightedAdditionImageFilter
+ * \brief Computes the weighted sum of N images in one pass.
+ *
+ * The output is sum_i w_i * x_i, where the images x_i and the weight images
+ * w_i are set with SetInputImage( i, x_i ) and SetWeightImage( i, w_i ).
+ * With NormalizeWeights on, the sum is divided by sum_i w_i, which gives the
+ * weighted average; where the weights sum to zero, the output is zero.
+ *
+ * Contrary to a pipeline of multiplications and an n-ary addition, no
+ * product images are created: each thread accumulates its region line by
+ * line, in RealType, directly from the input buffers. Since the filter only
+ * requests the region it outputs, a streaming writer keeps the memory
+ * bounded to one slab of all inputs.
+ *
+ * \ingroup IntensityImageFilters Multithreaded
+ */
+template <class TInputImage, class TOutputImage = TInputImage>
+class WeightedAdditionImageFilter:
+    public ImageToImageFilter<TInputImage,TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef WeightedAdditionImageFilter                   Self;
+  typedef ImageToImageFilter<TInputImage,TOutputImage>  Superclass;
+  typedef SmartPointer<Self>                            Pointer;
+  typedef SmartPointer<const Self>                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( WeightedAdditionImageFilter, ImageToImageFilter );
+
+  /** Typedef to describe the input/output image types. */
+  typedef TInputImage                                   InputImageType;
+  typedef typename InputImageType::PixelType            InputPixelType;
+  typedef TOutputImage                                  OutputImageType;
+  typedef typename OutputImageType::PixelType           OutputPixelType;
+  typedef typename OutputImageType::RegionType          OutputImageRegionType;
+  typedef typename NumericTraits<OutputPixelType>::RealType RealType;
+
+  /** Set the i-th image and its weight image. */
+  void SetInputImage( unsigned int i, const InputImageType * image )
+  {
+    this->SetNthInput( 2 * i, const_cast<InputImageType *>( image ) );
+  }
+  void SetWeightImage( unsigned int i, const InputImageType * weight )
+  {
+    this->SetNthInput( 2 * i + 1, const_cast<InputImageType *>( weight ) );
+  }
+
+  /** Set/Get whether to divide by the sum of the weights. Default false. */
+  itkSetMacro( NormalizeWeights, bool );
+  itkGetConstMacro( NormalizeWeights, bool );
+  itkBooleanMacro( NormalizeWeights );
+
+protected:
+  WeightedAdditionImageFilter();
+  ~WeightedAdditionImageFilter() {};
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** Check that every image has a weight image. */
+  virtual void BeforeThreadedGenerateData( void );
+
+  /** Accumulate the weighted sum of the region of this thread. */
+  virtual void ThreadedGenerateData(
+    const OutputImageRegionType & outputRegionForThread,
+    ThreadIdType threadId );
+
+private:
+  WeightedAdditionImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  bool m_NormalizeWeights;
+
+}; // end class WeightedAdditionImageFilter
+
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkWeightedAdditionImageFilter.hxx"
+#endif
+
+#endif // end #ifndef __itkWeightedAdditionImageFilter_h_
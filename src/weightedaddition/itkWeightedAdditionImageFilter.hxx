@@ -0,0 +1,150 @@
+/*=========================================================================
+*
+* Copyright Marius Staring, Stefan Klein, David Doria. 2011.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+*=========================================================================*/
+#ifndef _itkWeightedAdditionImageFilter_hxx_
+#define _itkWeightedAdditionImageFilter_hxx_
+
+#include "itkWeightedAdditionImageFilter.h"
+
+#include "itkImageLinearIteratorWithIndex.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
+#include <vector>
+
+
+namespace itk
+{
+
+template<class TInputImage, class TOutputImage>
+WeightedAdditionImageFilter<TInputImage,TOutputImage>
+::WeightedAdditionImageFilter()
+{
+  this->SetNumberOfRequiredInputs( 2 );
+  this->m_NormalizeWeights = false;
+}
+
+
+template<class TInputImage, class TOutputImage>
+void
+WeightedAdditionImageFilter<TInputImage,TOutputImage>
+::BeforeThreadedGenerateData( void )
+{
+  if( this->GetNumberOfInputs() % 2 != 0 )
+  {
+    itkExceptionMacro( << "Every input image needs a weight image, but "
+      << this->GetNumberOfInputs() << " images were set." );
+  }
+
+} // end BeforeThreadedGenerateData()
+
+
+template<class TInputImage, class TOutputImage>
+void
+WeightedAdditionImageFilter<TInputImage,TOutputImage>
+::ThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread,
+  ThreadIdType threadId )
+{
+  typedef typename OutputImageType::IndexType               IndexType;
+  typedef ImageLinearIteratorWithIndex<OutputImageType>     IteratorType;
+
+  const unsigned int numberOfImages = this->GetNumberOfInputs() / 2;
+  OutputImageType * output = this->GetOutput();
+
+  const std::size_t lineLength = outputRegionForThread.GetSize( 0 );
+  if( lineLength == 0 ) return;
+
+  ProgressReporter progress( this, threadId,
+    outputRegionForThread.GetNumberOfPixels() / lineLength );
+
+  /** The sums of one line. */
+  std::vector<RealType> sum( lineLength );
+  std::vector<RealType> weightSum( lineLength );
+
+  /** Pixels along dimension 0 are contiguous in all buffers. */
+  IteratorType it( output, outputRegionForThread );
+  it.SetDirection( 0 );
+  it.GoToBegin();
+  while( !it.IsAtEnd() )
+  {
+    const IndexType index = it.GetIndex();
+    std::fill( sum.begin(), sum.end(), NumericTraits<RealType>::Zero );
+    std::fill( weightSum.begin(), weightSum.end(), NumericTraits<RealType>::Zero );
+
+    /** Accumulate the images one by one, each line is read once. */
+    for( unsigned int i = 0; i < numberOfImages; ++i )
+    {
+      const InputImageType * image = this->GetInput( 2 * i );
+      const InputImageType * weight = this->GetInput( 2 * i + 1 );
+      const InputPixelType * x = image->GetBufferPointer() + image->ComputeOffset( index );
+      const InputPixelType * w = weight->GetBufferPointer() + weight->ComputeOffset( index );
+
+      for( std::size_t j = 0; j < lineLength; ++j )
+      {
+        sum[ j ] += static_cast<RealType>( w[ j ] ) * static_cast<RealType>( x[ j ] );
+      }
+      if( this->m_NormalizeWeights )
+      {
+        for( std::size_t j = 0; j < lineLength; ++j )
+        {
+          weightSum[ j ] += static_cast<RealType>( w[ j ] );
+        }
+      }
+    }
+
+    /** Write the line. */
+    OutputPixelType * out = output->GetBufferPointer() + output->ComputeOffset( index );
+    if( this->m_NormalizeWeights )
+    {
+      for( std::size_t j = 0; j < lineLength; ++j )
+      {
+        out[ j ] = weightSum[ j ] != NumericTraits<RealType>::Zero
+          ? static_cast<OutputPixelType>( sum[ j ] / weightSum[ j ] )
+          : NumericTraits<OutputPixelType>::Zero;
+      }
+    }
+    else
+    {
+      for( std::size_t j = 0; j < lineLength; ++j )
+      {
+        out[ j ] = static_cast<OutputPixelType>( sum[ j ] );
+      }
+    }
+
+    it.NextLine();
+    progress.CompletedPixel();
+  } // end while lines
+
+} // end ThreadedGenerateData()
+
+
+template<class TInputImage, class TOutputImage>
+void
+WeightedAdditionImageFilter<TInputImage,TOutputImage>
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "NormalizeWeights: " << this->m_NormalizeWeights << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef _itkWeightedAdditionImageFilter_hxx_
@@ -42,6 +42,10 @@ std::string GetHelpString( void )
     << "  -in      inputFilenames\n"
     << "  -w       weightFilenames\n"
     << "  -out     outputFilename; always written as float\n"
+    << "  [-norm]  divide by the sum of the weights, i.e. compute the weighted average;\n"
+    << "             where the weights sum to zero the output is zero\n"
+    << "  [-s]     number of streams, default equals number of inputs\n"
+    << "The weighted sum is computed in one pass, without intermediate images.\n"
     << "Supported: 2D, 3D, (unsigned) short, (unsigned) char, float.";
 
   return ss.str();
@@ -84,6 +88,12 @@ int main( int argc, char **argv )
   std::string outputFileName("");
   parser->GetCommandLineArgument( "-out", outputFileName );
 
+  const bool normalizeWeights = parser->ArgumentExists( "-norm" );
+
+  /** Support for streaming. */
+  unsigned int numberOfStreams = inputFileNames.size();
+  parser->GetCommandLineArgument( "-s", numberOfStreams );
+
   /** Determine image properties. */
   itk::ImageIOBase::IOPixelType pixelType = itk::ImageIOBase::UNKNOWNPIXELTYPE;
   itk::ImageIOBase::IOComponentType componentType = itk::ImageIOBase::UNKNOWNCOMPONENTTYPE;
@@ -119,6 +129,8 @@ int main( int argc, char **argv )
     filter->m_InputFileNames = inputFileNames;
     filter->m_WeightFileNames = weightFileNames;
     filter->m_OutputFileName = outputFileName;
+    filter->m_NormalizeWeights = normalizeWeights;
+    filter->m_NumberOfStreams = numberOfStreams;
 
     filter->Run();
 
@@ -23,8 +23,7 @@
 #include "itkImage.h"
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
-#include "itkNaryAddImageFilter.h"
-#include "itkMultiplyImageFilter.h"
+#include "itkWeightedAdditionImageFilter.h"
 
 
 /** \class ITKToolsWeightedAdditionBase
@@ -40,6 +39,8 @@ public:
   ITKToolsWeightedAdditionBase()
   {
     this->m_OutputFileName = "";
+    this->m_NormalizeWeights = false;
+    this->m_NumberOfStreams = 1;
   };
   /** Destructor. */
   ~ITKToolsWeightedAdditionBase(){};
@@ -48,6 +49,8 @@ public:
   std::vector<std::string> m_InputFileNames;
   std::vector<std::string> m_WeightFileNames;
   std::string m_OutputFileName;
+  bool m_NormalizeWeights;
+  unsigned int m_NumberOfStreams;
 
 }; // end class ITKToolsWeightedAdditionBase
 
@@ -75,15 +78,11 @@ public:
     /** TYPEDEF's. */
     typedef itk::Image< TComponentType, VDimension >      InputImageType;
     typedef itk::ImageFileReader< InputImageType >        ReaderType;
-    typedef itk::MultiplyImageFilter<
-      InputImageType, InputImageType, InputImageType>     MultiplierType;
-    typedef itk::NaryAddImageFilter<
-      InputImageType, InputImageType >                    AdderType;
+    typedef itk::WeightedAdditionImageFilter<
+      InputImageType, InputImageType >                    WeightedAdderType;
     typedef itk::ImageFileWriter< InputImageType >        WriterType;
-    typedef typename InputImageType::PixelType            PixelType;
     typedef typename ReaderType::Pointer                  ReaderPointer;
-    typedef typename MultiplierType::Pointer              MultiplierPointer;
-    typedef typename AdderType::Pointer                   AdderPointer;
+    typedef typename WeightedAdderType::Pointer           WeightedAdderPointer;
     typedef typename WriterType::Pointer                  WriterPointer;
 
     /** DECLARATION'S. */
@@ -95,8 +94,7 @@ public:
 
     std::vector< ReaderPointer > inReaders( nrInputs );
     std::vector< ReaderPointer > wReaders( nrInputs );
-    std::vector< MultiplierPointer > multipliers( nrInputs );
-    AdderPointer adder = AdderType::New();
+    WeightedAdderPointer adder = WeightedAdderType::New();
     WriterPointer writer = WriterType::New();
 
     for( unsigned int i = 0; i < nrInputs; ++i )
@@ -105,16 +103,15 @@ public:
       inReaders[ i ]->SetFileName( this->m_InputFileNames[ i ].c_str() );
       wReaders[ i ] = ReaderType::New();
       wReaders[ i ]->SetFileName( this->m_WeightFileNames[ i ].c_str() );
-      multipliers[ i ] = MultiplierType::New();
-      multipliers[ i ]->SetInput(0, inReaders[ i ]->GetOutput() );
-      multipliers[ i ]->SetInput(1, wReaders[ i ]->GetOutput() );
-      multipliers[ i ]->InPlaceOn();
-      adder->SetInput(i, multipliers[ i ]->GetOutput() );
+      adder->SetInputImage( i, inReaders[ i ]->GetOutput() );
+      adder->SetWeightImage( i, wReaders[ i ]->GetOutput() );
     }
+    adder->SetNormalizeWeights( this->m_NormalizeWeights );
 
-    /** Write the output image. */
+    /** Write the output image, slab by slab. */
     writer->SetFileName( this->m_OutputFileName.c_str() );
     writer->SetInput( adder->GetOutput() );
+    writer->SetNumberOfStreamDivisions( this->m_NumberOfStreams );
     writer->Update();
 
   } // end Run()